@@ -21,4 +21,7 @@ echo "  - build/src/cal/sage_cal"
 echo "  - build/src/ade/sage_ade"
 echo "  - build/src/rme/sage_rme"
 echo "  - build/src/poe/sage_poe"
+echo "  - build/src/rec/sage_rec"
+echo "  - build/src/rec/sage_archive"
+echo "  - build/src/replay/sage_replay"
 echo "  - build/tests/test_core"
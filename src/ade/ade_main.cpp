@@ -16,6 +16,10 @@
  * - Adaptive window sizing (adaptive_window.hpp)
  * - Winsorization for outlier resistance (winsorization.hpp)
  * - End-to-end latency tracking with percentiles (latency_tracker.hpp)
+ * - Per-venue L2 order books from depth streams (order_book.hpp)
+ * - Cross-venue best bid/offer, published on change (consolidated_bbo.hpp)
+ * - Consumed CAL stream republished on a lossy tap for the recorder
+ * - Virtual time under sage_replay (SAGE_REPLAY=1): deterministic output
  * 
  * See docs/ade_main_documentation.md for full details.
  */
@@ -30,7 +34,8 @@
 #include "../core/timing.hpp"
 #include "../core/cpu_affinity.hpp"
 #include "../core/shutdown.hpp"
-#include "../infra/ring_buffer.hpp"
+#include "../core/memory.hpp"
+#include "../infra/shm_segment.hpp"
 #include "../types/sage_message.hpp"
 #include "../hpcm/simd_ops.hpp"
 #include "tick_buffer.hpp"
@@ -41,6 +46,8 @@
 #include "winsorization.hpp"
 #include "latency_tracker.hpp"
 #include "normalizer.hpp"
+#include "order_book.hpp"
+#include "consolidated_bbo.hpp"
 
 using namespace sage;
 
@@ -53,15 +60,24 @@ constexpr size_t BATCH_SIZE = 16;
 constexpr int EWMA_HALF_LIFE = 50;      // Ticks for EWMA decay
 constexpr int REGIME_HALF_LIFE = 100;   // Ticks for regime detection
 constexpr int64_t MAX_ZSCORE = 3 * PRICE_SCALE;  // Z-score cap (winsorization)
+constexpr size_t BOOK_LEVELS = 1024;    // Ticks per book side (window around the market)
+constexpr size_t BOOK_VENUES = 2;       // Books per symbol, by exchange_id - 1
 
 
 // ============================================================================
 // Global State (Pre-allocated)
 // ============================================================================
 
-// Ring buffers for inter-process communication
-static RingBuffer<SageMessage, 65536> g_cal_to_ade_buffer;
-static RingBuffer<SageMessage, 65536> g_ade_to_mind_buffer;
+// Ring buffers for inter-process communication (shared memory)
+// Input is created by CAL; output is created here and consumed by RME
+// (MIND will be inserted between ADE and RME once deployed)
+static ShmMpscQueue<SageMessage, 65536> g_cal_to_ade_buffer;
+static ShmConflatingQueue<SageMessage, SHM_CONFLATION_KEYS> g_cal_to_ade_latest;
+static ShmRingBuffer<SageMessage, 65536> g_ade_to_rme_buffer;
+
+// Everything consumed from CAL, republished for lossy readers (sage_rec).
+// No gating consumers: publishing never waits, a slow reader loses data
+static ShmBroadcastRing<SageMessage, SHM_CAL_TAP_CAPACITY> g_cal_tap;
 
 // Z-score capper for winsorization (outlier resistance)
 static ade::ZScoreCapper g_zscore_capper(MAX_ZSCORE);
@@ -91,6 +107,11 @@ struct alignas(CACHE_LINE_SIZE) SymbolState {
     // Regime detection
     ade::VolRegimeDetector regime_detector; ///< Detects volatility regime changes
     
+    // Order books (depth streams), one per venue
+    ade::L2Book<BOOK_LEVELS> books[BOOK_VENUES];
+    ade::BookFeatures book_features[BOOK_VENUES];  ///< Refreshed on every level while synced
+    ade::ConsolidatedBBO bbo;                      ///< Venues' tops (quotes, synced books)
+    
     // Metadata
     uint64_t last_update_ns;              ///< Timestamp of last update
     uint64_t message_count;               ///< Total messages processed
@@ -100,6 +121,7 @@ struct alignas(CACHE_LINE_SIZE) SymbolState {
         : price_ewma(EWMA_HALF_LIFE)
         , vol_ewma(EWMA_HALF_LIFE)
         , regime_detector(REGIME_HALF_LIFE)
+        , book_features{}
         , last_update_ns(0)
         , message_count(0) {}
 };
@@ -108,7 +130,14 @@ struct alignas(CACHE_LINE_SIZE) SymbolState {
 static_assert(alignof(SymbolState) == CACHE_LINE_SIZE, 
               "SymbolState must be cache-line aligned");
 
-static std::array<SymbolState, MAX_SYMBOLS> g_symbol_states;
+using SymbolStateTable = std::array<SymbolState, MAX_SYMBOLS>;
+
+// Per-symbol state lives on huge pages (constructed at startup)
+static memory::HugePageArena g_state_arena;
+static SymbolStateTable* g_symbol_states = nullptr;
+
+// Startup memory provisioning (huge pages, prefault, mlock)
+static memory::MemoryProvisioner g_provisioner;
 
 
 // Metrics
@@ -116,6 +145,13 @@ static std::atomic<uint64_t> g_messages_processed{0};
 static std::atomic<uint64_t> g_signals_generated{0};
 static std::atomic<uint64_t> g_signals_gated{0};     // Signals suppressed by regime/winsorization
 static std::atomic<uint64_t> g_outliers_capped{0};   // Z-scores that were capped
+static std::atomic<uint64_t> g_bad_prints{0};        // Ticks CAL flagged outside its price band
+static std::atomic<uint64_t> g_stale_ticks{0};       // First tick after a gap CAL gave up on
+static std::atomic<uint64_t> g_resynced_ticks{0};    // Ticks CAL replayed after a gap
+static std::atomic<uint64_t> g_depth_updates{0};     // Book levels applied
+static std::atomic<uint64_t> g_book_resets{0};       // Books invalidated by a lost level
+static std::atomic<uint64_t> g_bbo_published{0};     // Consolidated top moves sent downstream
+static std::atomic<uint64_t> g_bbo_crossed{0};       // Moves into a crossed/locked market
 
 // Sequence counter
 static uint64_t g_sequence = 0;
@@ -127,6 +163,87 @@ static timing::TSCCalibrator g_tsc_calibrator;
 // Hot Path Processing
 // ============================================================================
 
+/**
+ * Stage attribution and end-to-end latency of one processed message
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void record_latency(const SageMessage& msg, uint64_t start_tsc) noexcept {
+    const uint64_t end_tsc = timing::rdtsc();
+    
+    // Stage attribution: CAL carries its receive and parse times in the
+    // header; publish → dequeue is queueing, the rest is this function
+    ade::LatencyBreakdown breakdown{};
+    breakdown.network_ns = msg.rx_delta_ns;
+    breakdown.parsing_ns = msg.parse_ns;
+    const uint64_t dequeued_ns = g_tsc_calibrator.tsc_to_realtime_ns(start_tsc);
+    const uint64_t published_ns = msg.timestamp_ns + msg.parse_ns;
+    breakdown.queue_ns = dequeued_ns > published_ns ? dequeued_ns - published_ns : 0;
+    breakdown.analytics_ns = g_tsc_calibrator.tsc_to_ns(end_tsc - start_tsc);
+    g_latency_tracker.record(breakdown);
+    
+    // End-to-end latency: kernel/NIC receive (CAL callback without one) → decision
+    g_latency_tracker.record_e2e(msg.timestamp_ns - msg.rx_delta_ns,
+                                 g_tsc_calibrator.tsc_to_realtime_ns(end_tsc));
+
+    g_messages_processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Send the symbol's consolidated top downstream (after it moved)
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void publish_bbo(const SymbolState& state, uint32_t symbol_id) noexcept {
+    const SageMessage out_msg = SageMessage::create_consolidated_quote(
+        g_tsc_calibrator.tsc_to_realtime_ns(timing::rdtsc()),
+        ++g_sequence,
+        state.bbo.quote(symbol_id)
+    );
+    if (g_ade_to_rme_buffer->try_push(out_msg)) {
+        g_bbo_published.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (state.bbo.crossed()) [[unlikely]] {
+        g_bbo_crossed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Apply one book level (MD_FLAG_DEPTH) to the symbol's book for its venue
+ *
+ * A snapshot's first level clears the book; a level CAL flagged stale
+ * follows a lost one, so the book is unusable until the next snapshot.
+ * The book's touch feeds the consolidated BBO while the book is synced.
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void process_depth(SymbolState& state, const MarketData& data) noexcept {
+    const size_t venue = static_cast<size_t>(data.exchange_id) - 1;
+    if (venue >= BOOK_VENUES) [[unlikely]] {
+        return;
+    }
+    ade::L2Book<BOOK_LEVELS>& book = state.books[venue];
+    if (data.flags & MD_FLAG_BOOK_RESET) {
+        book.begin_snapshot();
+    } else if ((data.flags & MD_FLAG_STALE) && book.synced()) [[unlikely]] {
+        book.invalidate();
+        g_book_resets.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    const ade::BookSide side = data.flags & MD_FLAG_BID ? ade::BookSide::BID : ade::BookSide::ASK;
+    book.update(side, data.price, data.quantity);
+    g_depth_updates.fetch_add(1, std::memory_order_relaxed);
+    
+    bool moved;
+    if (book.synced()) [[likely]] {
+        state.book_features[venue] = book.features();
+        const ade::BookLevel top = book.best(side);
+        moved = state.bbo.update(data.exchange_id, side, top.price, top.quantity);
+    } else {
+        moved = state.bbo.withdraw(data.exchange_id);
+    }
+    if (moved) {
+        publish_bbo(state, data.symbol_id);
+    }
+}
+
 /**
  * Process incoming market data tick
  * 
@@ -144,11 +261,39 @@ static void process_market_data(const SageMessage& msg) noexcept {
     
     const auto& data = msg.payload.market_data;
     
+    // Book level: updates the book, not the tick statistics
+    if (data.flags & MD_FLAG_DEPTH) {
+        process_depth((*g_symbol_states)[data.symbol_id & (MAX_SYMBOLS - 1)], data);
+        record_latency(msg, start_tsc);
+        return;
+    }
+    
+    // CAL's price band flagged this print: keep it out of the statistics
+    if (data.flags & MD_FLAG_OUTLIER) [[unlikely]] {
+        g_bad_prints.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    // Feed recovery: still valid ticks, counted so a gap is visible here
+    if (data.flags & (MD_FLAG_STALE | MD_FLAG_RESYNCED)) [[unlikely]] {
+        (data.flags & MD_FLAG_STALE ? g_stale_ticks : g_resynced_ticks)
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+    
     // Symbol lookup via bitmask
     // Note: CAL layer should validate symbol_id < MAX_SYMBOLS
     const size_t symbol_idx = data.symbol_id & (MAX_SYMBOLS - 1);
     
-    SymbolState& state = g_symbol_states[symbol_idx];
+    SymbolState& state = (*g_symbol_states)[symbol_idx];
+    
+    // Venue top of book (bookTicker / ticker): consolidate across venues
+    if ((data.flags & (MD_FLAG_BID | MD_FLAG_ASK)) && !(data.flags & MD_FLAG_TRADE)) {
+        if (state.bbo.update(data.exchange_id,
+                             data.flags & MD_FLAG_BID ? ade::BookSide::BID : ade::BookSide::ASK,
+                             data.price, data.quantity)) {
+            publish_bbo(state, data.symbol_id);
+        }
+    }
     
     // ========================================
     // Update all statistics (O(1) each)
@@ -221,12 +366,12 @@ static void process_market_data(const SageMessage& msg) noexcept {
 
         
         SageMessage out_msg = SageMessage::create_signal(
-            timing::get_monotonic_ns(),
+            g_tsc_calibrator.tsc_to_realtime_ns(timing::rdtsc()),
             ++g_sequence,
             sig
         );
         
-        if (g_ade_to_mind_buffer.try_push(out_msg)) {
+        if (g_ade_to_rme_buffer->try_push(out_msg)) {
             g_signals_generated.fetch_add(1, std::memory_order_relaxed);
         }
     } else if (std::abs(z_score) > PRICE_SCALE / 2) {
@@ -237,22 +382,7 @@ static void process_market_data(const SageMessage& msg) noexcept {
     // ========================================
     // Latency tracking
     // ========================================
-    const uint64_t end_tsc = timing::rdtsc();
-    g_latency_tracker.record_processing(start_tsc, end_tsc);
-    
-    // End-to-end latency (from message timestamp)
-    uint64_t now_ns = timing::get_monotonic_ns();
-    g_latency_tracker.record_e2e(msg.timestamp_ns, now_ns);
-    
-
-    // Track latency
-    const uint64_t latency_tsc = timing::rdtsc() - start_tsc;
-    g_total_latency_ns.fetch_add(
-        g_tsc_calibrator.tsc_to_ns(latency_tsc),
-        std::memory_order_relaxed
-    );
-    
-    g_messages_processed.fetch_add(1, std::memory_order_relaxed);
+    record_latency(msg, start_tsc);
 }
 
 // ============================================================================
@@ -263,7 +393,15 @@ SAGE_HOT
 static size_t process_batch() noexcept {
     SageMessage batch[BATCH_SIZE];
     
-    size_t count = g_cal_to_ade_buffer.try_pop_batch(batch, BATCH_SIZE);
+    size_t count = g_cal_to_ade_buffer->try_pop_batch(batch, BATCH_SIZE);
+    
+    // Queue drained: pick up the latest tick of each lane CAL conflated
+    // while we were behind (always newer than anything left in the queue)
+    if (count == 0) {
+        while (count < BATCH_SIZE && g_cal_to_ade_latest->try_pop(batch[count])) {
+            ++count;
+        }
+    }
     
     for (size_t i = 0; i < count; ++i) {
         // Prefetch next message
@@ -271,14 +409,23 @@ static size_t process_batch() noexcept {
             SAGE_PREFETCH_READ(&batch[i + 1]);
         }
         
+        if (timing::virtual_time()) [[unlikely]] {
+            timing::advance_virtual_time(batch[i].timestamp_ns);
+        }
+        
         if (batch[i].msg_type == MessageType::MARKET_DATA) {
             process_market_data(batch[i]);
         } else if (batch[i].msg_type == MessageType::HEARTBEAT) {
             // Forward heartbeat
-            g_ade_to_mind_buffer.try_push(batch[i]);
+            g_ade_to_rme_buffer->try_push(batch[i]);
         }
     }
     
+    // Tap after the batch is processed: the copy stays off the per-tick path
+    for (size_t i = 0; i < count; ++i) {
+        g_cal_tap->try_publish(batch[i]);
+    }
+    
     return count;
 }
 
@@ -291,6 +438,7 @@ static void heartbeat_thread() {
     
     while (!ShutdownManager::instance().is_shutdown_requested()) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        g_tsc_calibrator.sync_realtime();   // Track NTP/PTP steps of CLOCK_REALTIME
         
         uint64_t processed = g_messages_processed.load();
         uint64_t signals = g_signals_generated.load();
@@ -304,7 +452,16 @@ static void heartbeat_thread() {
                   << " signals=" << signals
                   << " gated=" << gated
                   << " outliers=" << outliers
-                  << " queue=" << g_cal_to_ade_buffer.size_approx()
+                  << " bad_prints=" << g_bad_prints.load()
+                  << " stale=" << g_stale_ticks.load()
+                  << " resynced=" << g_resynced_ticks.load()
+                  << " depth=" << g_depth_updates.load()
+                  << " book_resets=" << g_book_resets.load()
+                  << " bbo=" << g_bbo_published.load()
+                  << " bbo_crossed=" << g_bbo_crossed.load()
+                  << " queue=" << g_cal_to_ade_buffer->size_approx()
+                  << " conflated=" << g_cal_to_ade_latest->conflated_total()
+                  << " faults=" << g_provisioner.faults_since_warmup()
                   << std::endl;
         
         std::cout << "[ADE] Latency: p50=" << latency_summary.e2e_p50 << "ns"
@@ -312,6 +469,12 @@ static void heartbeat_thread() {
                   << " p99.9=" << latency_summary.e2e_p999 << "ns"
                   << " proc_mean=" << latency_summary.processing_mean << "ns"
                   << std::endl;
+        
+        std::cout << "[ADE] Stages: network_mean=" << latency_summary.network_mean << "ns"
+                  << " network_p99=" << latency_summary.network_p99 << "ns"
+                  << " parse_mean=" << latency_summary.parsing_mean << "ns"
+                  << " queue_mean=" << latency_summary.queue_mean << "ns"
+                  << std::endl;
     }
 }
 
@@ -323,10 +486,11 @@ static void heartbeat_thread() {
 int main() {
     std::cout << "[ADE] Starting Analytics & Decision Engine..." << std::endl;
     
-    // Initialize pre-allocated state
-    for (auto& state : g_symbol_states) {
-        state.last_update_ns = 0;
-        state.message_count = 0;
+    // Pre-allocate per-symbol state on huge pages
+    if (!g_state_arena.reserve(sizeof(SymbolStateTable)) ||
+        (g_symbol_states = g_state_arena.create<SymbolStateTable>()) == nullptr) {
+        std::cerr << "[ADE] Failed to allocate symbol state" << std::endl;
+        return 1;
     }
     
     // Pin to designated core
@@ -341,6 +505,49 @@ int main() {
     
     ShutdownManager::instance().install_signal_handlers();
     
+    // Fed by sage_replay: run on the capture's clock, not the wall clock
+    if (timing::replay_requested()) {
+        timing::enable_virtual_time();
+        std::cout << "[ADE] Replay: virtual time from message timestamps" << std::endl;
+    }
+    
+    // Output first so RME can attach while we wait for CAL
+    if (!g_ade_to_rme_buffer.create(SHM_ADE_TO_RME)) {
+        std::cerr << "[ADE] Failed to create shared memory " << SHM_ADE_TO_RME << std::endl;
+        return 1;
+    }
+    
+    if (!g_cal_tap.create(SHM_CAL_TAP)) {
+        std::cerr << "[ADE] Failed to create shared memory " << SHM_CAL_TAP << std::endl;
+        return 1;
+    }
+    
+    std::cout << "[ADE] Waiting for " << SHM_CAL_TO_ADE << "..." << std::endl;
+    if (!g_cal_to_ade_buffer.attach_blocking(SHM_CAL_TO_ADE, [] {
+            return ShutdownManager::instance().is_shutdown_requested();
+        })) {
+        std::cerr << "[ADE] Failed to attach " << SHM_CAL_TO_ADE << std::endl;
+        return 1;
+    }
+    if (!g_cal_to_ade_latest.attach(SHM_CAL_TO_ADE_LATEST)) {
+        std::cerr << "[ADE] Failed to attach " << SHM_CAL_TO_ADE_LATEST << std::endl;
+        return 1;
+    }
+    
+    // Fault in and lock everything the hot loop touches
+    g_provisioner.add("symbol_states", g_state_arena.data(), g_state_arena.capacity(),
+                      g_state_arena.is_hugetlb());
+    g_provisioner.add("cal_to_ade", g_cal_to_ade_buffer.base(), g_cal_to_ade_buffer.mapped_size());
+    g_provisioner.add("cal_to_ade_latest", g_cal_to_ade_latest.base(), g_cal_to_ade_latest.mapped_size());
+    g_provisioner.add("ade_to_rme", g_ade_to_rme_buffer.base(), g_ade_to_rme_buffer.mapped_size());
+    g_provisioner.add("cal_tap", g_cal_tap.base(), g_cal_tap.mapped_size());
+    g_provisioner.add_object("latency_tracker", g_latency_tracker);
+    const memory::ProvisionReport mem = g_provisioner.provision();
+    std::cout << "[ADE] Memory: " << mem.bytes / 1024 << "KB in " << mem.regions
+              << " regions, huge=" << mem.huge_regions
+              << " locked=" << mem.locked_regions << (mem.all_locked ? " +mlockall" : "")
+              << " warmup_faults=" << mem.after.minor - mem.before.minor << std::endl;
+    
     // Start heartbeat
     std::thread hb_thread(heartbeat_thread);
     
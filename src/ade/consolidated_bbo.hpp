@@ -0,0 +1,236 @@
+#pragma once
+
+/**
+ * SAGE Consolidated Best Bid/Offer
+ * Best price across venues for one symbol, 8 venue lanes per side
+ *
+ * Each side keeps every venue's top of book in one lane of an 8-wide
+ * array (lane = exchange_id, MAX_EXCHANGES lanes). An update writes its
+ * lane and recomputes the side with a vector max over all lanes: two AVX2
+ * registers, a few compares and blends, no branches per venue. Asks are
+ * stored negated so both sides reduce with the same max; an empty lane
+ * holds the lowest key and never wins.
+ *
+ * Ties: every venue at the best price counts toward the consolidated size
+ * and the venue mask; the reported venue is the lowest exchange_id.
+ *
+ * update() reports whether the consolidated top moved (either side's best
+ * price or leading venue changed). Size changes at an unchanged price are
+ * tracked but not reported, so downstream sees one message per move
+ * rather than one per quote.
+ *
+ * Not thread-safe: one writer (ADE's processing thread).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../types/fixed_point.hpp"
+#include "../types/sage_message.hpp"
+#include "order_book.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace sage {
+namespace ade {
+
+class ConsolidatedBBO {
+public:
+    static constexpr size_t LANES = MAX_EXCHANGES;
+    static_assert(LANES == 8, "one lane per venue: two AVX2 registers per side");
+
+    ConsolidatedBBO() noexcept { clear(); }
+
+    /**
+     * Withdraw every venue's quotes
+     */
+    void clear() noexcept {
+        for (Side& side : sides_) {
+            for (size_t i = 0; i < LANES; ++i) {
+                side.key[i] = EMPTY;
+                side.quantity[i] = 0;
+            }
+            side.best_key = EMPTY;
+            side.best_quantity = 0;
+            side.venues = 0;
+            side.venue = 0;
+        }
+    }
+
+    /**
+     * Set a venue's top of book on one side
+     * @param venue     exchange_id (lane)
+     * @param price     Venue's best price (<= 0 withdraws the side)
+     * @param quantity  Size at that price (0 withdraws the side)
+     * @return true if the consolidated top moved
+     */
+    SAGE_HOT
+    bool update(size_t venue, BookSide side, FixedPoint price, FixedPoint quantity) noexcept {
+        if (venue >= LANES) [[unlikely]] {
+            return false;
+        }
+        const size_t s = static_cast<size_t>(side);
+        Side& book = sides_[s];
+        const bool quoted = price.raw() > 0 && quantity.raw() > 0;
+        book.key[venue] = !quoted ? EMPTY : (side == BookSide::BID ? price.raw() : -price.raw());
+        book.quantity[venue] = quoted ? quantity.raw() : 0;
+        return recompute(book);
+    }
+
+    /**
+     * Withdraw both sides of one venue (disconnect, lost book)
+     * @return true if the consolidated top moved
+     */
+    bool withdraw(size_t venue) noexcept {
+        const bool bid = update(venue, BookSide::BID, FixedPoint(0), FixedPoint(0));
+        const bool ask = update(venue, BookSide::ASK, FixedPoint(0), FixedPoint(0));
+        return bid || ask;
+    }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
+    /**
+     * Consolidated best of a side: price and size summed over the venues
+     * at that price (zero if no venue quotes it)
+     */
+    SAGE_ALWAYS_INLINE
+    BookLevel best(BookSide side) const noexcept {
+        const Side& book = sides_[static_cast<size_t>(side)];
+        if (book.venues == 0) {
+            return {};
+        }
+        return {FixedPoint(side == BookSide::BID ? book.best_key : -book.best_key),
+                FixedPoint(book.best_quantity)};
+    }
+
+    /**
+     * Venue holding the best price (lowest exchange_id on ties; 0 if none)
+     */
+    uint8_t venue(BookSide side) const noexcept { return sides_[static_cast<size_t>(side)].venue; }
+
+    /**
+     * Venues at the best price, bit per exchange_id
+     */
+    uint8_t venues(BookSide side) const noexcept { return sides_[static_cast<size_t>(side)].venues; }
+
+    /**
+     * One venue's quote on a side (zero if it has none)
+     */
+    BookLevel venue_quote(size_t venue, BookSide side) const noexcept {
+        const Side& book = sides_[static_cast<size_t>(side)];
+        if (venue >= LANES || book.key[venue] == EMPTY) {
+            return {};
+        }
+        return {FixedPoint(side == BookSide::BID ? book.key[venue] : -book.key[venue]),
+                FixedPoint(book.quantity[venue])};
+    }
+
+    /**
+     * Best bid at or above the best ask: venues disagree (arbitrage, or a
+     * venue's quote is stale)
+     */
+    bool crossed() const noexcept {
+        return sides_[0].venues != 0 && sides_[1].venues != 0 &&
+               sides_[0].best_key >= -sides_[1].best_key;
+    }
+
+    /**
+     * The consolidated top as a downstream message payload
+     */
+    ConsolidatedQuote quote(uint32_t symbol_id) const noexcept {
+        const BookLevel bid = best(BookSide::BID);
+        const BookLevel ask = best(BookSide::ASK);
+        ConsolidatedQuote q{};
+        q.bid_price = bid.price;
+        q.bid_quantity = bid.quantity;
+        q.ask_price = ask.price;
+        q.ask_quantity = ask.quantity;
+        q.symbol_id = symbol_id;
+        q.bid_venue = sides_[0].venue;
+        q.ask_venue = sides_[1].venue;
+        q.bid_venues = sides_[0].venues;
+        q.ask_venues = sides_[1].venues;
+        return q;
+    }
+
+private:
+    static constexpr int64_t EMPTY = std::numeric_limits<int64_t>::min();
+
+    // One side: lanes first (one cache line each), then the reduced top
+    struct alignas(CACHE_LINE_SIZE) Side {
+        int64_t key[LANES];        // Price (bids) or -price (asks); EMPTY = no quote
+        int64_t quantity[LANES];
+        int64_t best_key;
+        int64_t best_quantity;     // Summed over the venues at best_key
+        uint8_t venues;            // Lanes at best_key
+        uint8_t venue;             // Lowest of them
+    };
+
+    /**
+     * Reduce a side's lanes; true if its best price or venue changed
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    static bool recompute(Side& side) noexcept {
+        int64_t best;
+        uint32_t mask;
+        int64_t quantity;
+#if defined(__AVX2__)
+        const __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(side.key));
+        const __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(side.key + 4));
+
+        // Lane-wise max, then across the register: halves, then pairs
+        __m256i max = _mm256_blendv_epi8(hi, lo, _mm256_cmpgt_epi64(lo, hi));
+        __m256i swapped = _mm256_permute4x64_epi64(max, 0x4E);
+        max = _mm256_blendv_epi8(swapped, max, _mm256_cmpgt_epi64(max, swapped));
+        swapped = _mm256_shuffle_epi32(max, 0x4E);
+        max = _mm256_blendv_epi8(swapped, max, _mm256_cmpgt_epi64(max, swapped));
+        best = _mm256_extract_epi64(max, 0);
+
+        // Lanes at the best price, and their summed size
+        const __m256i at_lo = _mm256_cmpeq_epi64(lo, max);
+        const __m256i at_hi = _mm256_cmpeq_epi64(hi, max);
+        mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(at_lo))) |
+               static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(at_hi))) << 4;
+        const __m256i sizes = _mm256_add_epi64(
+            _mm256_and_si256(at_lo, _mm256_load_si256(reinterpret_cast<const __m256i*>(side.quantity))),
+            _mm256_and_si256(at_hi, _mm256_load_si256(reinterpret_cast<const __m256i*>(side.quantity + 4))));
+        const __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(sizes), _mm256_extracti128_si256(sizes, 1));
+        quantity = _mm_cvtsi128_si64(_mm_add_epi64(pair, _mm_unpackhi_epi64(pair, pair)));
+#else
+        best = side.key[0];
+        for (size_t i = 1; i < LANES; ++i) {
+            best = side.key[i] > best ? side.key[i] : best;
+        }
+        mask = 0;
+        quantity = 0;
+        for (size_t i = 0; i < LANES; ++i) {
+            const bool at = side.key[i] == best;
+            mask |= static_cast<uint32_t>(at) << i;
+            quantity += at ? side.quantity[i] : 0;
+        }
+#endif
+        if (best == EMPTY) {
+            mask = 0;
+            quantity = 0;
+        }
+        const uint8_t venue = mask != 0 ? static_cast<uint8_t>(__builtin_ctz(mask)) : 0;
+        const bool moved = best != side.best_key || venue != side.venue;
+        side.best_key = best;
+        side.best_quantity = quantity;
+        side.venues = static_cast<uint8_t>(mask);
+        side.venue = venue;
+        return moved;
+    }
+
+    Side sides_[2];   // BookSide::BID, BookSide::ASK
+};
+
+} // namespace ade
+} // namespace sage
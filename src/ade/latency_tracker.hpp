@@ -4,7 +4,9 @@
  * SAGE Latency Tracker
  * End-to-end latency measurement with tail distribution metrics
  * 
- * Tracks latency from exchange timestamp through decision generation.
+ * Tracks latency from local receipt (kernel/NIC stamp) through decision
+ * generation. The venue leg before it (exchange event time -> receipt) is
+ * measured per venue in CAL (cal/feed_latency.hpp).
  * Provides percentile statistics (p50, p99, p99.9, p99.99) for monitoring.
  * 
  * Uses reservoir sampling for memory-efficient percentile estimation.
@@ -110,14 +112,47 @@ private:
     uint64_t max_latency_;
 };
 
+/**
+ * Stage latency breakdown
+ * 
+ * Attributes latency to specific pipeline stages for optimization.
+ */
+struct LatencyBreakdown {
+    uint64_t network_ns;      // Kernel/NIC receive → CAL callback
+    uint64_t parsing_ns;      // JSON parse time
+    uint64_t queue_ns;        // CAL publish → ADE dequeue
+    uint64_t analytics_ns;    // ADE processing
+    uint64_t signal_ns;       // Signal generation
+    uint64_t total_ns;        // Sum of all stages
+    
+    void record_total() noexcept {
+        total_ns = network_ns + parsing_ns + queue_ns + analytics_ns + signal_ns;
+    }
+    
+    // Identify bottleneck
+    const char* bottleneck() const noexcept {
+        uint64_t max_stage = 0;
+        const char* name = "unknown";
+        
+        if (network_ns > max_stage) { max_stage = network_ns; name = "network"; }
+        if (parsing_ns > max_stage) { max_stage = parsing_ns; name = "parsing"; }
+        if (queue_ns > max_stage) { max_stage = queue_ns; name = "queue"; }
+        if (analytics_ns > max_stage) { max_stage = analytics_ns; name = "analytics"; }
+        if (signal_ns > max_stage) { max_stage = signal_ns; name = "signal"; }
+        
+        return name;
+    }
+};
+
 /**
  * End-to-end latency tracker
  * 
  * Tracks latency across pipeline stages:
- * - Exchange → CAL (network + parsing)
+ * - Kernel/NIC receive → CAL callback (network, from SageMessage::rx_delta_ns)
+ * - CAL parsing (SageMessage::parse_ns)
  * - CAL → ADE (queue wait)
  * - ADE processing (analytics)
- * - Total end-to-end
+ * - Total end-to-end (wire receipt → decision)
  */
 class LatencyTracker {
 public:
@@ -125,15 +160,15 @@ public:
         : tsc_calibrator_() {}
     
     /**
-     * Record end-to-end latency from exchange timestamp
+     * Record end-to-end latency from local receipt
      * 
-     * @param exchange_ts Exchange timestamp (nanoseconds)
-     * @param decision_ts Decision timestamp (nanoseconds)
+     * @param receive_ts Receive timestamp (CLOCK_REALTIME ns)
+     * @param decision_ts Decision timestamp (CLOCK_REALTIME ns)
      */
     SAGE_HOT
-    void record_e2e(uint64_t exchange_ts, uint64_t decision_ts) noexcept {
-        if (decision_ts > exchange_ts) {
-            uint64_t latency = decision_ts - exchange_ts;
+    void record_e2e(uint64_t receive_ts, uint64_t decision_ts) noexcept {
+        if (decision_ts > receive_ts) {
+            uint64_t latency = decision_ts - receive_ts;
             e2e_histogram_.record(latency);
         }
     }
@@ -160,8 +195,21 @@ public:
         }
     }
     
+    /**
+     * Record the per-stage attribution of one message
+     */
+    SAGE_HOT
+    void record(const LatencyBreakdown& breakdown) noexcept {
+        network_histogram_.record(breakdown.network_ns);
+        parsing_histogram_.record(breakdown.parsing_ns);
+        queue_histogram_.record(breakdown.queue_ns);
+        processing_histogram_.record(breakdown.analytics_ns);
+    }
+    
     // Accessors for histograms
     const LatencyHistogram& e2e() const noexcept { return e2e_histogram_; }
+    const LatencyHistogram& network() const noexcept { return network_histogram_; }
+    const LatencyHistogram& parsing() const noexcept { return parsing_histogram_; }
     const LatencyHistogram& processing() const noexcept { return processing_histogram_; }
     const LatencyHistogram& queue() const noexcept { return queue_histogram_; }
     
@@ -174,6 +222,9 @@ public:
         uint64_t e2e_p999;
         uint64_t processing_mean;
         uint64_t queue_mean;
+        uint64_t network_mean;
+        uint64_t network_p99;
+        uint64_t parsing_mean;
         uint64_t total_samples;
     };
     
@@ -184,6 +235,9 @@ public:
             e2e_histogram_.p999(),
             processing_histogram_.mean(),
             queue_histogram_.mean(),
+            network_histogram_.mean(),
+            network_histogram_.p99(),
+            parsing_histogram_.mean(),
             e2e_histogram_.count()
         };
     }
@@ -195,6 +249,8 @@ public:
         e2e_histogram_.reset();
         processing_histogram_.reset();
         queue_histogram_.reset();
+        network_histogram_.reset();
+        parsing_histogram_.reset();
     }
 
 private:
@@ -202,38 +258,8 @@ private:
     LatencyHistogram e2e_histogram_;        // Exchange → decision
     LatencyHistogram processing_histogram_; // ADE internal processing
     LatencyHistogram queue_histogram_;      // Queue wait time
-};
-
-/**
- * Stage latency breakdown
- * 
- * Attributes latency to specific pipeline stages for optimization.
- */
-struct LatencyBreakdown {
-    uint64_t network_ns;      // Exchange → CAL receive
-    uint64_t parsing_ns;      // JSON parse time
-    uint64_t queue_ns;        // CAL → ADE queue wait
-    uint64_t analytics_ns;    // ADE processing
-    uint64_t signal_ns;       // Signal generation
-    uint64_t total_ns;        // Sum of all stages
-    
-    void record_total() noexcept {
-        total_ns = network_ns + parsing_ns + queue_ns + analytics_ns + signal_ns;
-    }
-    
-    // Identify bottleneck
-    const char* bottleneck() const noexcept {
-        uint64_t max_stage = 0;
-        const char* name = "unknown";
-        
-        if (network_ns > max_stage) { max_stage = network_ns; name = "network"; }
-        if (parsing_ns > max_stage) { max_stage = parsing_ns; name = "parsing"; }
-        if (queue_ns > max_stage) { max_stage = queue_ns; name = "queue"; }
-        if (analytics_ns > max_stage) { max_stage = analytics_ns; name = "analytics"; }
-        if (signal_ns > max_stage) { max_stage = signal_ns; name = "signal"; }
-        
-        return name;
-    }
+    LatencyHistogram network_histogram_;    // Kernel receive → CAL callback
+    LatencyHistogram parsing_histogram_;    // CAL parse
 };
 
 } // namespace ade
@@ -0,0 +1,401 @@
+#pragma once
+
+/**
+ * SAGE Level 2 Order Book
+ * Incremental price-level book over flat arrays indexed by tick
+ *
+ * Each side is one array of quantities with a slot per price tick, and a
+ * bitmap of occupied slots. The arrays cover a window of LEVELS ticks that
+ * moves with the market (the anchor): a tick's slot is its offset modulo
+ * LEVELS, so moving the window only clears the slots it leaves behind.
+ *
+ * - update: one divide (price -> tick), one slot, one bitmap word
+ * - best bid/offer: kept as ticks, O(1) to read; removing the best level
+ *   finds the next one through the bitmap, 64 ticks per step
+ * - top-N: walks the bitmap outward from the touch
+ * - no nodes, no allocation: the book is a fixed-size value, embedded in
+ *   ADE's SymbolState so features read it in the same pass
+ *
+ * Levels further than LEVELS / 2 ticks from the market are not kept (they
+ * are counted as dropped). A level arriving outside the window but close
+ * to the market moves the window, centered on the mid; levels that fall
+ * off the far edge are counted as evicted.
+ *
+ * Snapshots replace the book and mark it synced; deltas set a level's
+ * absolute quantity (0 removes it). Features are meaningful only while
+ * synced(): a lost delta (sequence gap) calls invalidate() until the next
+ * snapshot.
+ *
+ * Not thread-safe: one writer (ADE's processing thread).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../types/fixed_point.hpp"
+
+namespace sage {
+namespace ade {
+
+enum class BookSide : uint8_t { BID = 0, ASK = 1 };
+
+struct BookLevel {
+    FixedPoint price;
+    FixedPoint quantity;
+};
+
+/**
+ * Book-derived features (all FixedPoint, 0 when a side is empty)
+ */
+struct BookFeatures {
+    FixedPoint spread;       // Best ask - best bid
+    FixedPoint mid;          // (bid + ask) / 2
+    FixedPoint microprice;   // Size-weighted mid: leans toward the thinner side's price
+    FixedPoint imbalance;    // (bid qty - ask qty) / (bid qty + ask qty) over the top levels, [-1, 1]
+};
+
+/**
+ * @tparam Levels  Ticks covered per side (power of two, >= 128)
+ */
+template<size_t Levels = 1024>
+class L2Book {
+    static_assert(Levels >= 128 && (Levels & (Levels - 1)) == 0,
+                  "Levels must be a power of two >= 128");
+
+public:
+    static constexpr size_t LEVELS = Levels;
+
+    /**
+     * @param tick_size  Price increment; prices off this grid are rejected
+     */
+    explicit L2Book(FixedPoint tick_size = FixedPoint(PRICE_SCALE / 100)) noexcept {
+        set_tick_size(tick_size);
+    }
+
+    /**
+     * Change the tick size (cold: empties the book)
+     */
+    SAGE_COLD
+    void set_tick_size(FixedPoint tick_size) noexcept {
+        tick_ = tick_size.raw() > 0 ? tick_size.raw() : 1;
+        clear();
+    }
+
+    /**
+     * Empty both sides; not synced until the next snapshot
+     */
+    void clear() noexcept {
+        base_ = 0;
+        best_[0] = best_[1] = 0;
+        count_[0] = count_[1] = 0;
+        synced_ = false;
+        std::memset(bits_, 0, sizeof(bits_));
+        std::memset(quantity_, 0, sizeof(quantity_));
+    }
+
+    /**
+     * Start a full image delivered level by level (as CAL streams it):
+     * empties the book, which is synced again once the levels are in
+     */
+    void begin_snapshot() noexcept {
+        clear();
+        synced_ = true;
+    }
+
+    /**
+     * Replace the book with a full image
+     * Levels best first, as venues send them; another order still loads,
+     * but levels further than LEVELS / 2 from the first one are dropped.
+     */
+    void apply_snapshot(const BookLevel* bids, size_t bid_count,
+                        const BookLevel* asks, size_t ask_count) noexcept {
+        clear();
+        // Anchor on the touch first, so deep levels cannot pull the window away
+        if (bid_count > 0) {
+            update(BookSide::BID, bids[0].price, bids[0].quantity);
+        }
+        if (ask_count > 0) {
+            update(BookSide::ASK, asks[0].price, asks[0].quantity);
+        }
+        for (size_t i = 1; i < bid_count; ++i) {
+            update(BookSide::BID, bids[i].price, bids[i].quantity);
+        }
+        for (size_t i = 1; i < ask_count; ++i) {
+            update(BookSide::ASK, asks[i].price, asks[i].quantity);
+        }
+        synced_ = true;
+    }
+
+    /**
+     * Set a level's absolute quantity (0 removes it)
+     * @return false if the level was dropped (off the tick grid, negative,
+     *         or too far from the market)
+     */
+    SAGE_HOT
+    bool update(BookSide side, FixedPoint price, FixedPoint quantity) noexcept {
+        const int64_t raw = price.raw();
+        const int64_t tick = raw / tick_;
+        if (raw <= 0 || quantity.raw() < 0 || tick * tick_ != raw) [[unlikely]] {
+            ++dropped_;
+            return false;
+        }
+        if (tick < base_ || tick >= base_ + static_cast<int64_t>(Levels)) [[unlikely]] {
+            if (quantity.raw() == 0) {
+                return true;   // Removing a level the book never held
+            }
+            if (!make_room(tick)) {
+                ++dropped_;
+                return false;
+            }
+        }
+
+        const size_t s = static_cast<size_t>(side);
+        const size_t slot = static_cast<size_t>(tick) & MASK;
+        uint64_t& word = bits_[s][slot >> 6];
+        const uint64_t bit = 1ULL << (slot & 63);
+
+        if (quantity.raw() == 0) {
+            if ((word & bit) == 0) {
+                return true;
+            }
+            word &= ~bit;
+            quantity_[s][slot] = 0;
+            if (--count_[s] > 0 && tick == best_[s]) {
+                best_[s] = (side == BookSide::BID) ? next_below(0, tick) : next_above(1, tick);
+            }
+            return true;
+        }
+
+        quantity_[s][slot] = quantity.raw();
+        if ((word & bit) == 0) {
+            word |= bit;
+            if (count_[s]++ == 0 || better(side, tick, best_[s])) {
+                best_[s] = tick;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Mark the book unusable until the next snapshot (a delta was lost)
+     */
+    void invalidate() noexcept { synced_ = false; }
+    bool synced() const noexcept { return synced_; }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
+    bool empty(BookSide side) const noexcept { return count_[static_cast<size_t>(side)] == 0; }
+    size_t depth(BookSide side) const noexcept { return count_[static_cast<size_t>(side)]; }
+
+    /**
+     * Best level of a side (zero quantity if the side is empty)
+     */
+    SAGE_ALWAYS_INLINE
+    BookLevel best(BookSide side) const noexcept {
+        const size_t s = static_cast<size_t>(side);
+        if (count_[s] == 0) {
+            return {};
+        }
+        return {FixedPoint(best_[s] * tick_),
+                FixedPoint(quantity_[s][static_cast<size_t>(best_[s]) & MASK])};
+    }
+
+    BookLevel best_bid() const noexcept { return best(BookSide::BID); }
+    BookLevel best_ask() const noexcept { return best(BookSide::ASK); }
+
+    /**
+     * Copy up to n levels of a side, best first
+     * @return Levels written
+     */
+    SAGE_HOT
+    size_t top(BookSide side, BookLevel* out, size_t n) const noexcept {
+        const size_t s = static_cast<size_t>(side);
+        if (count_[s] == 0) {
+            return 0;
+        }
+        if (n > count_[s]) {
+            n = count_[s];
+        }
+        int64_t tick = best_[s];
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = {FixedPoint(tick * tick_), FixedPoint(quantity_[s][static_cast<size_t>(tick) & MASK])};
+            if (i + 1 < n) {
+                tick = (side == BookSide::BID) ? next_below(0, tick - 1) : next_above(1, tick + 1);
+            }
+        }
+        return n;
+    }
+
+    /**
+     * Spread, mid, microprice and imbalance over the top `levels` per side
+     */
+    SAGE_HOT
+    BookFeatures features(size_t levels = 5) const noexcept {
+        BookFeatures f{};
+        if (count_[0] == 0 || count_[1] == 0) {
+            return f;
+        }
+        const int64_t bid = best_[0] * tick_;
+        const int64_t ask = best_[1] * tick_;
+        const int64_t bid_qty = quantity_[0][static_cast<size_t>(best_[0]) & MASK];
+        const int64_t ask_qty = quantity_[1][static_cast<size_t>(best_[1]) & MASK];
+        f.spread = FixedPoint(ask - bid);
+        f.mid = FixedPoint(bid + (ask - bid) / 2);
+        f.microprice = FixedPoint(static_cast<int64_t>(
+            (static_cast<__int128>(ask) * bid_qty + static_cast<__int128>(bid) * ask_qty) /
+            (bid_qty + ask_qty)));
+
+        const __int128 bids = depth_quantity(0, levels);
+        const __int128 asks = depth_quantity(1, levels);
+        f.imbalance = FixedPoint(static_cast<int64_t>((bids - asks) * PRICE_SCALE / (bids + asks)));
+        return f;
+    }
+
+    FixedPoint tick_size() const noexcept { return FixedPoint(tick_); }
+
+    // Levels rejected by update() / pushed off the window by a move
+    uint64_t dropped() const noexcept { return dropped_; }
+    uint64_t evicted() const noexcept { return evicted_; }
+
+private:
+    static constexpr size_t MASK = Levels - 1;
+    static constexpr size_t WORDS = Levels / 64;
+
+    static bool better(BookSide side, int64_t tick, int64_t best) noexcept {
+        return side == BookSide::BID ? tick > best : tick < best;
+    }
+
+    /**
+     * Highest occupied tick <= from on side s (base_ - 1 if none)
+     */
+    SAGE_ALWAYS_INLINE
+    int64_t next_below(size_t s, int64_t from) const noexcept {
+        const int64_t top = base_ + static_cast<int64_t>(Levels) - 1;
+        int64_t tick = from < top ? from : top;
+        while (tick >= base_) {
+            const size_t slot = static_cast<size_t>(tick) & MASK;
+            const size_t offset = slot & 63;
+            const uint64_t word = bits_[s][slot >> 6] & (~0ULL >> (63 - offset));
+            if (word != 0) {
+                // Slots below the window's low edge belong to its top: not ours
+                const int64_t found = tick - static_cast<int64_t>(offset) +
+                                      (63 - __builtin_clzll(word));
+                return found >= base_ ? found : base_ - 1;
+            }
+            tick -= static_cast<int64_t>(offset) + 1;
+        }
+        return base_ - 1;
+    }
+
+    /**
+     * Lowest occupied tick >= from on side s (past the window if none)
+     */
+    SAGE_ALWAYS_INLINE
+    int64_t next_above(size_t s, int64_t from) const noexcept {
+        const int64_t end = base_ + static_cast<int64_t>(Levels);
+        int64_t tick = from > base_ ? from : base_;
+        while (tick < end) {
+            const size_t slot = static_cast<size_t>(tick) & MASK;
+            const size_t offset = slot & 63;
+            const uint64_t word = bits_[s][slot >> 6] & (~0ULL << offset);
+            if (word != 0) {
+                const int64_t found = tick - static_cast<int64_t>(offset) + __builtin_ctzll(word);
+                return found < end ? found : end;
+            }
+            tick += 64 - static_cast<int64_t>(offset);
+        }
+        return end;
+    }
+
+    __int128 depth_quantity(size_t s, size_t levels) const noexcept {
+        __int128 total = 0;
+        int64_t tick = best_[s];
+        for (size_t i = 0; i < levels && i < count_[s]; ++i) {
+            total += quantity_[s][static_cast<size_t>(tick) & MASK];
+            tick = (s == 0) ? next_below(0, tick - 1) : next_above(1, tick + 1);
+        }
+        return total;
+    }
+
+    /**
+     * Move the window so `tick` fits, if it is close enough to the market
+     */
+    SAGE_COLD
+    bool make_room(int64_t tick) noexcept {
+        constexpr int64_t HALF = static_cast<int64_t>(Levels / 2);
+        int64_t center = tick;
+        if (count_[0] > 0 && count_[1] > 0) {
+            center = best_[0] + (best_[1] - best_[0]) / 2;
+        } else if (count_[0] > 0) {
+            center = best_[0];
+        } else if (count_[1] > 0) {
+            center = best_[1];
+        }
+        const int64_t distance = tick > center ? tick - center : center - tick;
+        if (distance >= HALF) {
+            return false;
+        }
+        move_window(center - HALF);
+        return true;
+    }
+
+    SAGE_COLD
+    void move_window(int64_t base) noexcept {
+        const int64_t shift = base - base_;
+        const int64_t span = static_cast<int64_t>(Levels);
+        if (shift >= span || -shift >= span) {
+            evicted_ += count_[0] + count_[1];
+            const bool synced = synced_;
+            clear();
+            synced_ = synced;
+            base_ = base;
+            return;
+        }
+
+        // Clear the slots that leave: [base_, base) or [base + span, base_ + span)
+        const int64_t first = shift > 0 ? base_ : base + span;
+        const int64_t last = shift > 0 ? base : base_ + span;
+        for (int64_t tick = first; tick < last; ++tick) {
+            const size_t slot = static_cast<size_t>(tick) & MASK;
+            const uint64_t bit = 1ULL << (slot & 63);
+            for (size_t s = 0; s < 2; ++s) {
+                uint64_t& word = bits_[s][slot >> 6];
+                if (word & bit) {
+                    word &= ~bit;
+                    quantity_[s][slot] = 0;
+                    --count_[s];
+                    ++evicted_;
+                }
+            }
+        }
+        base_ = base;
+
+        // A best that left the window: the next one inside it
+        if (count_[0] > 0 && (best_[0] < base_ || best_[0] >= base_ + span)) {
+            best_[0] = next_below(0, base_ + span - 1);
+        }
+        if (count_[1] > 0 && (best_[1] < base_ || best_[1] >= base_ + span)) {
+            best_[1] = next_above(1, base_);
+        }
+    }
+
+    // Hot header: everything an update reads besides its slot and bitmap word
+    int64_t tick_;                  // Tick size (raw)
+    int64_t base_;                  // Lowest tick in the window
+    int64_t best_[2];               // Best tick per side (valid while count_ > 0)
+    uint32_t count_[2];             // Occupied levels per side
+    bool synced_;
+    uint64_t dropped_ = 0;
+    uint64_t evicted_ = 0;
+
+    uint64_t bits_[2][WORDS];       // Occupied slots
+    int64_t quantity_[2][Levels];   // Quantity (raw) per slot
+};
+
+} // namespace ade
+} // namespace sage
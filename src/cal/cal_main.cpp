@@ -4,17 +4,25 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <thread>
 #include <atomic>
+#include <cstdlib>
 
 #include "../core/compiler.hpp"
 #include "../core/constants.hpp"
 #include "../core/timing.hpp"
 #include "../core/cpu_affinity.hpp"
 #include "../core/shutdown.hpp"
-#include "../infra/ring_buffer.hpp"
+#include "../core/memory.hpp"
+#include "../core/config.hpp"
+#include "../infra/shm_segment.hpp"
 #include "../types/sage_message.hpp"
-#include "websocket_client.hpp"
+#include "../types/symbol_map.hpp"
+#include "connector_manager.hpp"
+#include "feed_arbiter.hpp"
+#include "feed_latency.hpp"
+#include "feed_recovery.hpp"
 #include "json_parser.hpp"
 #include "validator.hpp"
 
@@ -24,17 +32,27 @@ using namespace sage;
 // Global State
 // ============================================================================
 
-// Ring buffer for CAL -> ADE communication
-// In production: mmap'd shared memory
-static RingBuffer<SageMessage, 65536> g_cal_to_ade_buffer;
+// Queue for CAL -> ADE communication (shared memory, CAL creates)
+// MPSC: every connector thread and the heartbeat thread push into it
+static ShmMpscQueue<SageMessage, 65536> g_cal_to_ade_buffer;
+
+// Overload lane: latest tick per (symbol, venue, side) once the queue has overflowed
+static ShmConflatingQueue<SageMessage, SHM_CONFLATION_KEYS> g_cal_to_ade_latest;
+static std::atomic<bool> g_overloaded{false};
+
+// Startup memory provisioning (huge pages, prefault, mlock)
+static memory::MemoryProvisioner g_provisioner;
 
 // Metrics
 static std::atomic<uint64_t> g_messages_received{0};
 static std::atomic<uint64_t> g_messages_dropped{0};
 static std::atomic<uint64_t> g_validation_errors{0};
+static std::atomic<uint64_t> g_parse_errors{0};
+static std::atomic<uint64_t> g_depth_levels{0};
+static std::atomic<uint64_t> g_depth_dropped{0};
 
-// Sequence counter (not atomic - single producer)
-static uint64_t g_sequence = 0;
+// Sequence counter (shared by all connector threads)
+static std::atomic<uint64_t> g_sequence{0};
 
 // TSC calibrator (initialized once at startup)
 static timing::TSCCalibrator g_tsc_calibrator;
@@ -43,45 +61,327 @@ static timing::TSCCalibrator g_tsc_calibrator;
 // Message Processing (Hot Path)
 // ============================================================================
 
-SAGE_HOT SAGE_FLATTEN
-static void process_message(const char* data, size_t len) noexcept {
-    static cal::JsonParser parser;
+// One parser per venue, specialized on its schema; filled once in main()
+// before any connector starts
+template<ExchangeId Venue>
+static cal::VenueParser<Venue> g_parser;
+
+// Per-venue price bands (each venue is served by one network thread)
+template<ExchangeId Venue>
+static cal::PriceBandValidator g_price_band;
+
+// Per-venue merge of redundant connections (first arrival wins)
+template<ExchangeId Venue>
+static cal::FeedArbiter g_arbiter;
+
+// Per-venue exchange -> CAL latency, from the venue's event time
+template<ExchangeId Venue>
+static cal::FeedLatency g_feed_latency;
+
+// Per-venue sequence tracking. No venue snapshot (REST) client exists yet,
+// so a gap cannot be filled: the tick after it is published at once flagged
+// MD_FLAG_STALE instead of tearing the connection down
+template<ExchangeId Venue>
+static cal::FeedRecovery<cal::NoSnapshotSource> g_recovery{Venue};
+
+// Per-venue, per-symbol continuity of depth updates (Binance U/u ids)
+struct DepthStream {
+    uint64_t last_id;   // Last update id applied (0 = none yet)
+    bool lost;          // A level was lost: flag the next one stale
+};
+template<ExchangeId Venue>
+static DepthStream g_depth_streams[cal::MAX_VALID_SYMBOL_ID];
+
+// Stage timing of one received frame, stamped on every message it yields
+struct FrameTiming {
+    uint64_t receipt_ns;             // CAL callback, CLOCK_REALTIME
+    uint32_t rx_delta_ns;            // Kernel/NIC receive -> callback
+    uint16_t parse_ns;
+    timing::RxClock rx_clock;
+};
+
+SAGE_HOT SAGE_ALWAYS_INLINE
+static FrameTiming frame_timing(uint64_t received_tsc, uint64_t parsed_tsc,
+                                const timing::RxTimestamp& rx) noexcept {
+    FrameTiming frame;
+    frame.receipt_ns = g_tsc_calibrator.tsc_to_realtime_ns(received_tsc);
+    const uint64_t parse_ns = g_tsc_calibrator.tsc_to_realtime_ns(parsed_tsc) - frame.receipt_ns;
+    frame.parse_ns = static_cast<uint16_t>(std::min<uint64_t>(parse_ns, UINT16_MAX));
+    // A receive stamped "after" the callback is clock skew: report 0
+    const uint64_t rx_delta = frame.receipt_ns > rx.realtime_ns ? frame.receipt_ns - rx.realtime_ns : 0;
+    frame.rx_clock = rx.clock;
+    frame.rx_delta_ns = rx.clock == timing::RxClock::NONE
+        ? 0 : static_cast<uint32_t>(std::min<uint64_t>(rx_delta, UINT32_MAX));
+    return frame;
+}
+
+SAGE_HOT SAGE_ALWAYS_INLINE
+static SageMessage make_market_data(const MarketData& data, const FrameTiming& frame) noexcept {
+    SageMessage msg;
+    msg.timestamp_ns = frame.receipt_ns;
+    msg.sequence_id = g_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    msg.msg_type = MessageType::MARKET_DATA;
+    msg.rx_clock = frame.rx_clock;
+    msg.parse_ns = frame.parse_ns;
+    msg.rx_delta_ns = frame.rx_delta_ns;
+    msg.payload.market_data = data;
+    return msg;
+}
+
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void publish_market_data(const MarketData& data, const FrameTiming& frame) noexcept {
+    const SageMessage msg = make_market_data(data, frame);
     
-    // Get timestamp immediately (lowest latency)
-    const uint64_t timestamp = timing::rdtscp();
+    // Push to queue; on overflow switch to the conflating lane until ADE
+    // has drained it, so ADE sees the latest price instead of a backlog
+    if (!g_overloaded.load(std::memory_order_relaxed)) [[likely]] {
+        if (g_cal_to_ade_buffer->try_push(msg)) [[likely]] {
+            g_messages_received.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        g_overloaded.store(true, std::memory_order_relaxed);
+    } else if (g_cal_to_ade_latest->empty_approx() &&
+               g_cal_to_ade_buffer->try_push(msg)) {
+        g_overloaded.store(false, std::memory_order_relaxed);
+        g_messages_received.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     
-    // Parse JSON
-    auto result = parser.parse_trade(data, len);
-    if (!result) [[unlikely]] {
+    if (!g_cal_to_ade_latest->publish(conflation_key(data), msg)) [[unlikely]] {
+        g_messages_dropped.fetch_add(1, std::memory_order_relaxed);  // Unconflatable id
         return;
     }
     
-    // Validate
-    if (!cal::Validator::validate_market_data(*result)) [[unlikely]] {
+    g_messages_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Stateless checks + price band, then publish what passed
+template<ExchangeId Venue>
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void validate_and_publish(MarketData* records, uint32_t count, const FrameTiming& frame) noexcept {
+    const uint64_t accepted = g_price_band<Venue>.validate_batch(records, count);
+    if (accepted != (1ULL << count) - 1) [[unlikely]] {
+        g_validation_errors.fetch_add(count - static_cast<uint32_t>(__builtin_popcountll(accepted)),
+                                      std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (accepted & (1ULL << i)) [[likely]] {
+            publish_market_data(records[i], frame);
+        }
+    }
+}
+
+// Book levels are deltas: conflating them would corrupt ADE's book, so
+// they only take the queue. A level that does not fit is lost and the
+// next one is flagged stale, which makes ADE wait for a fresh snapshot.
+SAGE_HOT SAGE_ALWAYS_INLINE
+static void publish_depth(MarketData& level, DepthStream& stream, const FrameTiming& frame) noexcept {
+    if (stream.lost) [[unlikely]] {
+        level.flags |= MD_FLAG_STALE;
+    }
+    if (!g_cal_to_ade_buffer->try_push(make_market_data(level, frame))) [[unlikely]] {
+        g_depth_dropped.fetch_add(1, std::memory_order_relaxed);
+        stream.lost = true;
+        return;
+    }
+    stream.lost = false;
+    g_depth_levels.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Depth updates from the primary leg only: book deltas are not
+// arbitrated (a leg's copy would be applied twice) and are not
+// price-band checked (levels away from the touch are not outliers)
+template<ExchangeId Venue>
+SAGE_HOT
+static void process_depth(const char* data, size_t len, uint32_t leg, uint64_t received_tsc,
+                          const timing::RxTimestamp& rx) noexcept {
+    if (leg != 0) {
+        return;
+    }
+    cal::DepthMessage depth;
+    const cal::ParseStatus status = g_parser<Venue>.parse_depth(data, len, depth);
+    const uint64_t parsed_tsc = timing::rdtscp();
+    if (status != cal::ParseStatus::DEPTH) {
+        if (status != cal::ParseStatus::IGNORED) [[unlikely]] {
+            g_parse_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    if (depth.symbol_id >= cal::MAX_VALID_SYMBOL_ID) [[unlikely]] {
         g_validation_errors.fetch_add(1, std::memory_order_relaxed);
         return;
     }
+
+    // Update ids: a repeat is dropped, a hole means a lost delta
+    DepthStream& stream = g_depth_streams<Venue>[depth.symbol_id];
+    if (depth.snapshot) {
+        stream.lost = false;
+    } else if (depth.last_id != 0 && stream.last_id != 0) {
+        if (depth.last_id <= stream.last_id) {
+            return;
+        }
+        if (depth.first_id > stream.last_id + 1) [[unlikely]] {
+            stream.lost = true;
+        }
+    }
+    if (depth.last_id != 0) {
+        stream.last_id = depth.last_id;
+    }
+
+    const FrameTiming frame = frame_timing(received_tsc, parsed_tsc, rx);
+    const uint64_t arrival_ns = rx.clock != timing::RxClock::NONE ? rx.realtime_ns : frame.receipt_ns;
+    g_feed_latency<Venue>.record(depth.event_ns, arrival_ns);
+
+    if (depth.for_each([&stream, &frame](MarketData& level) {
+            publish_depth(level, stream, frame);
+        }) < 0) [[unlikely]] {
+        g_parse_errors.fetch_add(1, std::memory_order_relaxed);
+        stream.lost = true;   // Levels after the bad one are missing
+    }
+}
+
+template<ExchangeId Venue>
+SAGE_HOT SAGE_FLATTEN
+static void process_message(const char* data, size_t len, uint32_t leg,
+                            const timing::RxTimestamp& rx) noexcept {
+    // Get timestamp immediately (lowest latency)
+    const uint64_t timestamp = timing::rdtscp();
     
-    // Create message
-    SageMessage msg;
-    msg.timestamp_ns = g_tsc_calibrator.tsc_to_ns(timestamp);
-    msg.sequence_id = ++g_sequence;
-    msg.msg_type = MessageType::MARKET_DATA;
-    msg.payload.market_data = *result;
+    // Parse JSON straight into FixedPoint (trade -> 1 record, quote -> bid + ask),
+    // stamped with this connection's venue
+    cal::ParsedMessage parsed;
+    const cal::ParseStatus status = g_parser<Venue>.parse(data, len, parsed);
+    const uint64_t parsed_tsc = timing::rdtscp();
+    if (status == cal::ParseStatus::IGNORED) {
+        return;
+    }
+    if (status == cal::ParseStatus::DEPTH) {
+        process_depth<Venue>(data, len, leg, timestamp, rx);
+        return;
+    }
+    if (status == cal::ParseStatus::MALFORMED ||
+        status == cal::ParseStatus::UNKNOWN_SYMBOL) [[unlikely]] {
+        g_parse_errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     
-    // Push to ring buffer
-    if (!g_cal_to_ade_buffer.try_push(msg)) [[unlikely]] {
-        g_messages_dropped.fetch_add(1, std::memory_order_relaxed);
+    // A copy of a frame another leg already delivered
+    const FrameTiming frame = frame_timing(timestamp, parsed_tsc, rx);
+    const uint64_t now_ns = frame.receipt_ns;
+    if (!g_arbiter<Venue>.accept(parsed.records[0], leg, now_ns)) {
         return;
     }
     
-    g_messages_received.fetch_add(1, std::memory_order_relaxed);
+    // Venue event time -> first arrival here (wire time when the kernel stamped it)
+    const uint64_t arrival_ns = rx.clock != timing::RxClock::NONE ? rx.realtime_ns : now_ns;
+    g_feed_latency<Venue>.record(parsed.records[0].exchange_ts_ns, arrival_ns);
+    
+    // Sequence before validating: ticks held for a resync reach the band
+    // check in venue order, when they are released
+    const uint32_t count = std::min<uint32_t>(parsed.count, cal::ParsedMessage::MAX_RECORDS);
+    auto& recovery = g_recovery<Venue>;
+    uint64_t admitted = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        admitted |= static_cast<uint64_t>(recovery.admit(parsed.records[i], now_ns)) << i;
+    }
+    
+    if (admitted == (1ULL << count) - 1) [[likely]] {
+        validate_and_publish<Venue>(parsed.records, count, frame);
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            if (admitted & (1ULL << i)) {
+                validate_and_publish<Venue>(&parsed.records[i], 1, frame);
+            }
+        }
+    }
+    
+    // Resyncs that completed, holes this frame closed, expired attempts
+    recovery.poll(now_ns, [&frame](MarketData& record) {
+        validate_and_publish<Venue>(&record, 1, frame);
+    });
 }
 
+// Recovery timer: last poll() from the network loop (venue's thread only)
+constexpr uint64_t RECOVERY_TIMER_NS = NANOS_PER_MS;
+template<ExchangeId Venue>
+static uint64_t g_recovery_timer_ns = 0;
+
+// Expire recovery attempts while the venue sends nothing
+template<ExchangeId Venue>
+SAGE_COLD
+static void expire_recovery() noexcept {
+    const uint64_t now_tsc = timing::rdtscp();
+    const FrameTiming frame = frame_timing(now_tsc, now_tsc, timing::RxTimestamp{});
+    if (frame.receipt_ns - g_recovery_timer_ns<Venue> < RECOVERY_TIMER_NS) {
+        return;
+    }
+    g_recovery_timer_ns<Venue> = frame.receipt_ns;
+    g_recovery<Venue>.poll(frame.receipt_ns, [&frame](MarketData& record) {
+        validate_and_publish<Venue>(&record, 1, frame);
+    });
+}
+
+// Connector sink: frames go straight from the receive buffer to the venue's parser
+struct MarketDataSink {
+    template<ExchangeId Venue>
+    SAGE_ALWAYS_INLINE void on_message(const char* data, size_t len, uint32_t leg,
+                                       const timing::RxTimestamp& rx) const noexcept {
+        process_message<Venue>(data, len, leg, rx);
+    }
+
+    // Every network loop, data or not (one leg is enough: they share the thread)
+    template<ExchangeId Venue>
+    SAGE_ALWAYS_INLINE void on_tick(uint32_t leg) const noexcept {
+        if (leg == 0 && g_recovery<Venue>.recovering_count() > 0) [[unlikely]] {
+            expire_recovery<Venue>();
+        }
+    }
+};
+
 // ============================================================================
 // Heartbeat Thread
 // ============================================================================
 
+static uint64_t feed_gaps() noexcept {
+    return g_recovery<ExchangeId::BINANCE>.stats().gaps.load(std::memory_order_relaxed) +
+           g_recovery<ExchangeId::COINBASE>.stats().gaps.load(std::memory_order_relaxed);
+}
+
+static uint64_t feed_stale() noexcept {
+    return g_recovery<ExchangeId::BINANCE>.stats().stale.load(std::memory_order_relaxed) +
+           g_recovery<ExchangeId::COINBASE>.stats().stale.load(std::memory_order_relaxed);
+}
+
+template<ExchangeId Venue>
+static void print_feed_latency() {
+    const cal::FeedLatency& latency = g_feed_latency<Venue>;
+    if (latency.count() == 0 && latency.ahead() == 0) {
+        return;
+    }
+    std::cout << "[CAL] Feed " << cal::to_string(Venue) << ":"
+              << " mean=" << latency.mean() / 1000 << "us"
+              << " p50=" << latency.percentile(50.0) / 1000 << "us"
+              << " p99=" << latency.percentile(99.0) / 1000 << "us"
+              << " clock_ahead=" << latency.ahead()
+              << std::endl;
+}
+
+template<ExchangeId Venue>
+static void print_legs() {
+    const cal::FeedArbiter& arbiter = g_arbiter<Venue>;
+    if (arbiter.legs() < 2) {
+        return;
+    }
+    std::cout << "[CAL] Legs " << cal::to_string(Venue) << ":";
+    for (size_t i = 0; i < arbiter.legs(); ++i) {
+        const cal::ArbiterLegStats& leg = arbiter.leg(i);
+        std::cout << " [" << i << "] win=" << static_cast<int>(leg.win_rate() * 100.0) << "%"
+                  << " lag_p50=" << leg.lag.percentile(50.0) / 1000 << "us"
+                  << " lag_p99=" << leg.lag.percentile(99.0) / 1000 << "us";
+    }
+    std::cout << std::endl;
+}
+
 static void heartbeat_thread() {
     // Pin to OS core (not critical path)
     cpu::pin_to_core(CORE_OS);
@@ -91,22 +391,36 @@ static void heartbeat_thread() {
     while (!ShutdownManager::instance().is_shutdown_requested()) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
         
+        // Keep message timestamps on CLOCK_REALTIME as NTP/PTP slews it
+        g_tsc_calibrator.sync_realtime();
+        
         // Create heartbeat message
         SageMessage hb = SageMessage::create_heartbeat(
-            timing::get_monotonic_ns(),
+            timing::get_realtime_ns(),
             ++heartbeat_seq,
             1  // CAL component ID
         );
         
         // Best effort - don't block
-        g_cal_to_ade_buffer.try_push(hb);
+        g_cal_to_ade_buffer->try_push(hb);
         
         // Log stats
         std::cout << "[CAL] Stats: received=" << g_messages_received.load()
                   << " dropped=" << g_messages_dropped.load()
+                  << " conflated=" << g_cal_to_ade_latest->conflated_total()
                   << " errors=" << g_validation_errors.load()
-                  << " queue=" << g_cal_to_ade_buffer.size_approx()
+                  << " parse_errors=" << g_parse_errors.load()
+                  << " gaps=" << feed_gaps()
+                  << " stale=" << feed_stale()
+                  << " depth=" << g_depth_levels.load()
+                  << " depth_dropped=" << g_depth_dropped.load()
+                  << " queue=" << g_cal_to_ade_buffer->size_approx()
+                  << " faults=" << g_provisioner.faults_since_warmup()
                   << std::endl;
+        print_feed_latency<ExchangeId::BINANCE>();
+        print_feed_latency<ExchangeId::COINBASE>();
+        print_legs<ExchangeId::BINANCE>();
+        print_legs<ExchangeId::COINBASE>();
     }
 }
 
@@ -114,8 +428,26 @@ static void heartbeat_thread() {
 // Main
 // ============================================================================
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "[CAL] Starting Connector Abstraction Layer..." << std::endl;
+    
+    // Connectors come from sage.toml: argv[1], else $SAGE_CONFIG, else config/sage.toml
+    const char* config_path = (argc > 1) ? argv[1] : std::getenv("SAGE_CONFIG");
+    if (config_path == nullptr) {
+        config_path = "config/sage.toml";
+    }
+    config::ConfigFile config_file;
+    cal::CalConfig cal_config;
+    std::string config_error;
+    if (!config_file.load(config_path)) {
+        std::cerr << "[CAL] " << config_path << ": " << config_file.last_error() << std::endl;
+        return 1;
+    }
+    if (!cal::read_cal_config(config_file, cal_config, config_error)) {
+        std::cerr << "[CAL] " << config_path << ": " << config_error << std::endl;
+        return 1;
+    }
+    
     std::cout << "[CAL] TSC calibration: " << g_tsc_calibrator.get_ticks_per_ns() 
               << " ticks/ns" << std::endl;
     
@@ -132,17 +464,101 @@ int main() {
     // Install signal handlers
     ShutdownManager::instance().install_signal_handlers();
     
+    // Create shared-memory outputs (ADE attaches by name). The overload
+    // lane goes first: ADE attaches it once the main queue appears.
+    if (!g_cal_to_ade_latest.create(SHM_CAL_TO_ADE_LATEST)) {
+        std::cerr << "[CAL] Failed to create shared memory " << SHM_CAL_TO_ADE_LATEST << std::endl;
+        return 1;
+    }
+    if (!g_cal_to_ade_buffer.create(SHM_CAL_TO_ADE)) {
+        std::cerr << "[CAL] Failed to create shared memory " << SHM_CAL_TO_ADE << std::endl;
+        return 1;
+    }
+    std::cout << "[CAL] Publishing on " << SHM_CAL_TO_ADE << std::endl;
+    
+    // One connector per enabled exchange, spread over the network threads.
+    // Backend from [cal] io_backend unless SAGE_CAL_IO_BACKEND overrides it;
+    // io_uring falls back to epoll if the kernel refuses it
+    if (cal_config.network_cores.empty()) {
+        cal_config.network_cores.push_back(CORE_CAL);
+    }
+    if (const char* backend = std::getenv("SAGE_CAL_IO_BACKEND");
+        backend != nullptr && !cal::parse_io_backend(backend, cal_config.network.backend)) {
+        std::cerr << "[CAL] Unknown SAGE_CAL_IO_BACKEND " << backend << ", using "
+                  << cal::to_string(cal_config.network.backend) << std::endl;
+    }
+    MarketDataSink sink;
+    cal::ConnectorManager<MarketDataSink> connectors;
+    if (!connectors.configure(cal_config, sink)) {
+        std::cerr << "[CAL] Failed to set up connectors: " << connectors.last_error() << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < connectors.thread_count(); ++i) {
+        auto& network = connectors.thread(i);
+        std::cout << "[CAL] Network thread " << i << " on core " << cal_config.network_cores[i]
+                  << ": " << cal::to_string(network.backend());
+        if (network.backend() != cal_config.network.backend) {
+            std::cout << " (" << cal::to_string(cal_config.network.backend) << " unavailable: "
+                      << network.fallback_reason() << ")";
+        }
+        std::cout << std::endl;
+    }
+    
+    // Fault in and lock the outputs and receive buffers before the first tick arrives
+    g_provisioner.add("cal_to_ade", g_cal_to_ade_buffer.base(), g_cal_to_ade_buffer.mapped_size());
+    g_provisioner.add("cal_to_ade_latest", g_cal_to_ade_latest.base(), g_cal_to_ade_latest.mapped_size());
+    for (const auto& connector : connectors.connectors()) {
+        g_provisioner.add(connector.spec.name.c_str(), connector.client->buffer(),
+                          connector.client->buffer_size());
+    }
+    for (size_t i = 0; i < connectors.thread_count(); ++i) {
+        g_provisioner.add("uring_buffers", connectors.thread(i).buffer_memory(),
+                          connectors.thread(i).buffer_memory_size());
+    }
+    const memory::ProvisionReport mem = g_provisioner.provision();
+    std::cout << "[CAL] Memory: " << mem.bytes / 1024 << "KB in " << mem.regions
+              << " regions, huge=" << mem.huge_regions
+              << " locked=" << mem.locked_regions << (mem.all_locked ? " +mlockall" : "")
+              << " warmup_faults=" << mem.after.minor - mem.before.minor << std::endl;
+    
+    // Bad-print filter from [cal] price_band_*
+    g_price_band<ExchangeId::BINANCE>.configure(cal_config.price_band);
+    g_price_band<ExchangeId::COINBASE>.configure(cal_config.price_band);
+    std::cout << "[CAL] Price band: +/-" << cal_config.price_band.band_bps << "bps, "
+              << (cal_config.price_band.action == cal::BandAction::FLAG ? "flag" : "reject")
+              << " outliers" << std::endl;
+    
+    // Symbol names the connectors may deliver
+    for (const SymbolMapping& mapping : SYMBOLS) {
+        const bool added = (mapping.venue == ExchangeId::BINANCE)
+            ? g_parser<ExchangeId::BINANCE>.add_symbol(mapping.name, mapping.symbol_id)
+            : g_parser<ExchangeId::COINBASE>.add_symbol(mapping.name, mapping.symbol_id);
+        if (!added) {
+            std::cerr << "[CAL] Cannot register symbol " << mapping.name << " -> " << mapping.symbol_id
+                      << " (bad name or id, table full, or no perfect hash)" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "[CAL] Symbols: " << g_parser<ExchangeId::BINANCE>.symbols().size()
+              << " binance, " << g_parser<ExchangeId::COINBASE>.symbols().size()
+              << " coinbase" << std::endl;
+    
+    // Redundant connections per venue
+    g_arbiter<ExchangeId::BINANCE>.configure(cal_config.legs(ExchangeId::BINANCE));
+    g_arbiter<ExchangeId::COINBASE>.configure(cal_config.legs(ExchangeId::COINBASE));
+    
+    // Snapshot workers (off the network cores)
+    g_recovery<ExchangeId::BINANCE>.start();
+    g_recovery<ExchangeId::COINBASE>.start();
+    
     // Start heartbeat thread
     std::thread hb_thread(heartbeat_thread);
     
-    // Initialize WebSocket client
-    cal::WebSocketClient binance_ws(
-        "wss://stream.binance.com:9443/ws/btcusdt@trade",
-        process_message
-    );
-    
-    binance_ws.start();
-    std::cout << "[CAL] WebSocket client started" << std::endl;
+    connectors.start();
+    for (const auto& connector : connectors.connectors()) {
+        std::cout << "[CAL] Connector " << connector.spec.name << " on thread "
+                  << connector.thread << " (" << connector.spec.websocket.url << ")" << std::endl;
+    }
     
     // Main loop - minimal work, just check shutdown
     while (!ShutdownManager::instance().is_shutdown_requested()) {
@@ -153,13 +569,18 @@ int main() {
     std::cout << "[CAL] Shutting down..." << std::endl;
     
     // Cleanup
-    binance_ws.stop();
+    connectors.stop();
+    g_recovery<ExchangeId::BINANCE>.stop();
+    g_recovery<ExchangeId::COINBASE>.stop();
     hb_thread.join();
     
     // Final stats
     std::cout << "[CAL] Final stats: received=" << g_messages_received.load()
               << " dropped=" << g_messages_dropped.load()
               << " errors=" << g_validation_errors.load()
+              << " parse_errors=" << g_parse_errors.load()
+              << " gaps=" << feed_gaps()
+              << " stale=" << feed_stale()
               << std::endl;
     
     return 0;
@@ -0,0 +1,413 @@
+#pragma once
+
+/**
+ * SAGE CAL Connector Manager
+ * One WebSocket connector per enabled exchange in sage.toml, spread over
+ * one or more network threads
+ *
+ * Configuration (all startup-time):
+ *
+ *   [cal]
+ *   io_backend = "io_uring"          # or "epoll"
+ *   busy_poll = true
+ *   network_cores = [1, 6]           # one network thread per core
+ *   rx_timestamps = true             # kernel receive timestamps
+ *   hw_timestamps = false            # prefer NIC timestamps
+ *   price_band_bps = 1000            # see PriceBandValidator
+ *
+ *   [exchanges.binance]
+ *   enabled = true
+ *   websocket_url = "wss://..."      # venue endpoint (Host: header)
+ *   connect_url = "ws://127.0.0.1:9443/ws/btcusdt@trade"
+ *   subscribe = '{"method":"SUBSCRIBE",...}'   # optional
+ *   cal_thread = 0                   # optional; default round-robin
+ *
+ *   [exchanges.binance_b]            # redundant leg of the same feed
+ *   enabled = true
+ *   venue = "binance"                # default: the table name
+ *   connect_url = "ws://127.0.0.1:9445/ws/btcusdt@trade"
+ *
+ * Connections to one venue are its legs, numbered in file order (leg 0 is
+ * preferred); FeedArbiter merges them. Every leg of a venue runs on the
+ * same network thread, since the venue's parser and sequencing state are
+ * single-threaded.
+ *
+ * The client speaks plain ws:// only, so a wss:// venue needs a local TLS
+ * terminator and a connect_url pointing at it; read_cal_config() rejects a
+ * wss:// venue without one instead of failing at connect time.
+ *
+ * Each connector is bound to its venue when it is created. Every message
+ * is handed to Sink::on_message<Venue>(data, len, leg, rx), so the sink parses it
+ * with that venue's compile-time schema (VenueParser<Venue>) and the
+ * records come out stamped with the venue's exchange_id. The dispatch is
+ * one switch on a per-connection constant, perfectly predicted.
+ *
+ * Usage:
+ *   CalConfig cal;
+ *   read_cal_config(file, cal, error);
+ *   ConnectorManager<CalSink> manager;
+ *   manager.configure(cal, sink);
+ *   manager.start();
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../core/compiler.hpp"
+#include "../core/config.hpp"
+#include "../types/sage_message.hpp"
+#include "feed_arbiter.hpp"
+#include "network_thread.hpp"
+#include "validator.hpp"
+#include "websocket_client.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Venue Names
+// ============================================================================
+
+inline const char* to_string(ExchangeId venue) noexcept {
+    switch (venue) {
+        case ExchangeId::BINANCE:  return "binance";
+        case ExchangeId::COINBASE: return "coinbase";
+        default:                   return "unknown";
+    }
+}
+
+/**
+ * sage.toml exchange table name -> ExchangeId (UNKNOWN if not supported)
+ */
+inline ExchangeId exchange_from_name(std::string_view name) noexcept {
+    if (name == "binance") return ExchangeId::BINANCE;
+    if (name == "coinbase") return ExchangeId::COINBASE;
+    return ExchangeId::UNKNOWN;
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct ConnectorSpec {
+    std::string name;                // Exchange table name
+    ExchangeId venue = ExchangeId::UNKNOWN;
+    WebSocketConfig websocket;
+    int thread = -1;                 // Network thread index; -1 = round-robin
+    uint32_t leg = 0;                // Connection index within the venue (0 = preferred)
+};
+
+struct CalConfig {
+    NetworkConfig network;           // Template for every network thread
+    PriceBandConfig price_band;      // Per-venue bad-print filter
+    std::vector<int> network_cores;  // One thread per core; empty = one unpinned
+    std::vector<ConnectorSpec> connectors;
+
+    size_t legs(ExchangeId venue) const noexcept {
+        size_t count = 0;
+        for (const ConnectorSpec& spec : connectors) {
+            count += (spec.venue == venue);
+        }
+        return count;
+    }
+};
+
+/**
+ * [cal] integer that must lie in [min, UINT32_MAX]
+ * @return false (with error set) if out of range
+ */
+SAGE_COLD
+inline bool read_cal_uint32(const config::ConfigFile& file, const std::string& key, int64_t min,
+                            uint32_t& value, std::string& error) {
+    const int64_t read = file.get_int(key, value);
+    if (read < min || read > UINT32_MAX) {
+        error = key + ": must be between " + std::to_string(min) + " and " + std::to_string(UINT32_MAX);
+        return false;
+    }
+    value = static_cast<uint32_t>(read);
+    return true;
+}
+
+/**
+ * Read [cal] and the enabled [exchanges.*] tables
+ * @return false (with error set) on an unknown exchange, a bad backend
+ *         name, an out-of-range [cal] value, a wss:// venue without
+ *         connect_url, too many legs for a venue, or a type error
+ */
+SAGE_COLD
+inline bool read_cal_config(const config::ConfigFile& file, CalConfig& out, std::string& error) {
+    out = CalConfig{};
+
+    const std::string backend = file.get_string("cal.io_backend", "io_uring");
+    if (!parse_io_backend(backend.c_str(), out.network.backend)) {
+        error = "cal.io_backend: unknown backend " + backend;
+        return false;
+    }
+    out.network.busy_poll = file.get_bool("cal.busy_poll", out.network.busy_poll);
+    out.network.sqpoll = file.get_bool("cal.sqpoll", out.network.sqpoll);
+    if (!read_cal_uint32(file, "cal.buffer_count", 1, out.network.buffer_count, error) ||
+        !read_cal_uint32(file, "cal.buffer_size", 1, out.network.buffer_size, error)) {
+        return false;
+    }
+    const uint32_t buffers = out.network.buffer_count;
+    if ((buffers & (buffers - 1)) != 0 || buffers > 32768) {
+        error = "cal.buffer_count: must be a power of two <= 32768";
+        return false;
+    }
+
+    const std::string band_action = file.get_string("cal.price_band_action", "reject");
+    if (band_action != "reject" && band_action != "flag") {
+        error = "cal.price_band_action: expected \"reject\" or \"flag\", got " + band_action;
+        return false;
+    }
+    out.price_band.action = (band_action == "flag") ? BandAction::FLAG : BandAction::REJECT;
+    if (!read_cal_uint32(file, "cal.price_band_bps", 1, out.price_band.band_bps, error) ||
+        !read_cal_uint32(file, "cal.price_band_reanchor", 0, out.price_band.reanchor_after, error)) {
+        return false;
+    }
+
+    std::vector<int64_t> cores;
+    if (file.has("cal.network_cores") && !file.get_int_array("cal.network_cores", cores)) {
+        error = file.last_error();
+        return false;
+    }
+    out.network_cores.assign(cores.begin(), cores.end());
+
+    const bool rx_timestamps = file.get_bool("cal.rx_timestamps", true);
+    const bool hw_timestamps = file.get_bool("cal.hw_timestamps", false);
+
+    // [cal] type errors count even with no exchange enabled
+    if (!file.last_error().empty()) {
+        error = file.last_error();
+        return false;
+    }
+
+    for (const std::string& name : file.subtables("exchanges")) {
+        const std::string table = "exchanges." + name + ".";
+        if (!file.get_bool(table + "enabled", false)) {
+            continue;
+        }
+
+        ConnectorSpec spec;
+        spec.name = name;
+        spec.venue = exchange_from_name(file.get_string(table + "venue", name));
+        if (spec.venue == ExchangeId::UNKNOWN) {
+            error = "exchanges." + name + ": no connector for this exchange";
+            return false;
+        }
+        spec.leg = static_cast<uint32_t>(out.legs(spec.venue));
+        if (spec.leg >= FeedArbiter::MAX_LEGS) {
+            error = "exchanges." + name + ": more than " + std::to_string(FeedArbiter::MAX_LEGS) +
+                    " connections to " + to_string(spec.venue);
+            return false;
+        }
+
+        const std::string venue_url = file.get_string(table + "websocket_url");
+        spec.websocket.url = file.get_string(table + "connect_url", venue_url);
+        WebSocketUrl parsed;
+        if (!parse_websocket_url(spec.websocket.url, parsed)) {
+            error = table + "connect_url: invalid URL " + spec.websocket.url;
+            return false;
+        }
+        if (parsed.tls) {
+            error = table + "connect_url: wss:// needs a local TLS terminator (ws:// connect_url)";
+            return false;
+        }
+
+        // Behind a terminator the venue still expects its own Host:
+        WebSocketUrl venue;
+        if (spec.websocket.url != venue_url && parse_websocket_url(venue_url, venue)) {
+            spec.websocket.host_header = websocket_host(venue);
+        }
+        spec.websocket.subscribe_message = file.get_string(table + "subscribe");
+        spec.websocket.busy_poll = out.network.busy_poll;
+        spec.websocket.rx_timestamps = rx_timestamps;
+        spec.websocket.hw_timestamps = hw_timestamps;
+        spec.thread = static_cast<int>(file.get_int(table + "cal_thread", -1));
+
+        if (!file.last_error().empty()) {
+            error = file.last_error();
+            return false;
+        }
+        out.connectors.push_back(std::move(spec));
+    }
+    return true;
+}
+
+// ============================================================================
+// Per-Venue Dispatch
+// ============================================================================
+
+/**
+ * WebSocket handler bound to one venue
+ * @tparam Sink  provides template<ExchangeId> void on_message(const char*, size_t,
+ *               uint32_t leg, const timing::RxTimestamp& rx), and optionally
+ *               template<ExchangeId> void on_tick(uint32_t leg), called on
+ *               every network thread loop
+ */
+template<typename Sink>
+struct VenueHandler {
+    Sink* sink;
+    ExchangeId venue;
+    uint32_t leg;
+
+    SAGE_ALWAYS_INLINE void operator()(const char* data, size_t len,
+                                       const timing::RxTimestamp& rx) const noexcept {
+        switch (venue) {
+            case ExchangeId::BINANCE:
+                sink->template on_message<ExchangeId::BINANCE>(data, len, leg, rx);
+                return;
+            case ExchangeId::COINBASE:
+                sink->template on_message<ExchangeId::COINBASE>(data, len, leg, rx);
+                return;
+            default:
+                return;   // read_cal_config() never builds one
+        }
+    }
+
+    SAGE_ALWAYS_INLINE void tick() const noexcept {
+        if constexpr (requires(Sink& s) { s.template on_tick<ExchangeId::BINANCE>(0u); }) {
+            switch (venue) {
+                case ExchangeId::BINANCE:
+                    sink->template on_tick<ExchangeId::BINANCE>(leg);
+                    return;
+                case ExchangeId::COINBASE:
+                    sink->template on_tick<ExchangeId::COINBASE>(leg);
+                    return;
+                default:
+                    return;
+            }
+        }
+    }
+};
+
+// ============================================================================
+// Connector Manager
+// ============================================================================
+
+/**
+ * @tparam Sink        Message consumer shared by every connector; must be
+ *                     safe to call from every network thread at once
+ * @tparam MaxThreads  Network thread limit
+ */
+template<typename Sink, size_t MaxThreads = 8>
+class ConnectorManager {
+public:
+    using Client = WebSocketClient<VenueHandler<Sink>>;
+    using Thread = NetworkThread<Client>;
+
+    struct Connector {
+        ConnectorSpec spec;
+        std::unique_ptr<Client> client;
+        size_t thread;
+    };
+
+    ConnectorManager() = default;
+    ~ConnectorManager() { stop(); }
+
+    ConnectorManager(const ConnectorManager&) = delete;
+    ConnectorManager& operator=(const ConnectorManager&) = delete;
+
+    /**
+     * Create the network threads and one connector per spec, then set up
+     * each thread's backend (io_uring falls back to epoll per thread)
+     * @return false (see last_error()) on a bad thread assignment (out of
+     *         range, or legs of one venue split across threads), too many
+     *         connectors for a thread, or no usable backend
+     */
+    SAGE_COLD
+    bool configure(const CalConfig& config, Sink& sink) {
+        if (!connectors_.empty()) {
+            error_ = "already configured";
+            return false;
+        }
+        if (config.connectors.empty()) {
+            error_ = "no exchange enabled";
+            return false;
+        }
+
+        const size_t thread_count = config.network_cores.empty() ? 1 : config.network_cores.size();
+        if (thread_count > MaxThreads) {
+            error_ = "too many network cores (max " + std::to_string(MaxThreads) + ")";
+            return false;
+        }
+        for (size_t i = 0; i < thread_count; ++i) {
+            NetworkConfig network = config.network;
+            if (!config.network_cores.empty()) {
+                network.cpu_core = config.network_cores[i];
+            }
+            threads_.push_back(std::make_unique<Thread>(network));
+        }
+
+        // Round-robin per venue: a venue's legs follow its first connector
+        int venue_thread[256];
+        std::fill(std::begin(venue_thread), std::end(venue_thread), -1);
+        size_t next = 0;
+        for (const ConnectorSpec& spec : config.connectors) {
+            if (spec.thread >= static_cast<int>(thread_count)) {
+                error_ = spec.name + ": cal_thread " + std::to_string(spec.thread) +
+                         " out of range (" + std::to_string(thread_count) + " threads)";
+                return false;
+            }
+            int& assigned = venue_thread[static_cast<uint8_t>(spec.venue)];
+            if (assigned >= 0 && spec.thread >= 0 && spec.thread != assigned) {
+                error_ = spec.name + ": cal_thread " + std::to_string(spec.thread) +
+                         " splits " + to_string(spec.venue) + " across network threads";
+                return false;
+            }
+            if (assigned < 0) {
+                assigned = spec.thread >= 0 ? spec.thread : static_cast<int>(next++ % thread_count);
+            }
+
+            Connector connector;
+            connector.spec = spec;
+            connector.thread = static_cast<size_t>(assigned);
+            connector.client = std::make_unique<Client>(
+                spec.websocket, VenueHandler<Sink>{&sink, spec.venue, spec.leg});
+            if (!threads_[connector.thread]->add(*connector.client)) {
+                error_ = spec.name + ": network thread " + std::to_string(connector.thread) +
+                         " is full";
+                return false;
+            }
+            connectors_.push_back(std::move(connector));
+        }
+
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            if (!threads_[i]->init()) {
+                error_ = "network thread " + std::to_string(i) + ": no I/O backend";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void start() {
+        for (auto& thread : threads_) {
+            thread->start();
+        }
+    }
+
+    void stop() {
+        for (auto& thread : threads_) {
+            thread->stop();
+        }
+    }
+
+    const std::vector<Connector>& connectors() const noexcept { return connectors_; }
+    size_t thread_count() const noexcept { return threads_.size(); }
+    Thread& thread(size_t index) noexcept { return *threads_[index]; }
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    std::vector<Connector> connectors_;          // Outlives threads_ (declared first)
+    std::vector<std::unique_ptr<Thread>> threads_;
+    std::string error_;
+};
+
+} // namespace cal
+} // namespace sage
@@ -0,0 +1,153 @@
+#pragma once
+
+/**
+ * SAGE CAL Feed Arbiter
+ * First-arrival merge of redundant connections (A/B legs) to one venue
+ *
+ * The same venue stream is subscribed over two or more connections
+ * (different network paths, gateways or endpoints). Every frame is offered
+ * with the leg it came in on; the first copy of each venue message wins
+ * and later copies are dropped, so downstream sees one stream that is, at
+ * every instant, as fast as the fastest leg.
+ *
+ * Identity is (symbol, trade or quote stream, venue_seq). Per stream a
+ * sliding window remembers the highest id seen and which of the WINDOW ids
+ * below it have arrived (one bitmask, the anti-replay scheme of IPsec):
+ *   id above the window   first arrival, window slides
+ *   id inside the window  first arrival unless its bit is set
+ *   id below the window   dropped (a copy of something long delivered)
+ * Messages without an id cannot be matched and are taken from the
+ * preferred leg (0) only.
+ *
+ * Per leg: wins, dropped copies, and how far the leg trailed the winner
+ * (log2 histogram), to tell which path to keep.
+ *
+ * Threading: accept() belongs to the one network thread serving the venue
+ * (ConnectorManager keeps every leg of a venue on one thread). Stats are
+ * relaxed atomics, readable from any thread.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../core/compiler.hpp"
+#include "../types/sage_message.hpp"
+#include "feed_latency.hpp"
+#include "validator.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Per-Leg Statistics
+// ============================================================================
+
+/**
+ * Lag behind the winning leg: bucket 0 < 1us, bucket i < 2^i us
+ */
+using LagHistogram = Log2Histogram<16>;   // Last bucket: >= 16ms
+
+struct ArbiterLegStats {
+    std::atomic<uint64_t> wins{0};         // Frames this leg delivered first
+    std::atomic<uint64_t> duplicates{0};   // Copies dropped (another leg won)
+    LagHistogram lag;                      // How late this leg's copies were
+
+    /**
+     * Share of matched frames this leg won (0 before any traffic)
+     */
+    double win_rate() const noexcept {
+        const uint64_t w = wins.load(std::memory_order_relaxed);
+        const uint64_t total = w + duplicates.load(std::memory_order_relaxed);
+        return total == 0 ? 0.0 : static_cast<double>(w) / static_cast<double>(total);
+    }
+};
+
+// ============================================================================
+// Feed Arbiter
+// ============================================================================
+
+class FeedArbiter {
+public:
+    static constexpr size_t MAX_LEGS = 4;
+    static constexpr uint64_t WINDOW = 32;    // Ids remembered below the highest
+
+    /**
+     * Number of legs feeding this venue; with one leg accept() is a no-op
+     */
+    SAGE_COLD
+    void configure(size_t legs) noexcept {
+        legs_ = legs == 0 ? 1 : (legs > MAX_LEGS ? MAX_LEGS : legs);
+    }
+
+    /**
+     * Offer one parsed frame
+     * @param first   Its first record (a quote frame's bid and ask share an id)
+     * @param leg     Connection it arrived on (< MAX_LEGS)
+     * @return true if this is the first arrival: publish it
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    bool accept(const MarketData& first, uint32_t leg, uint64_t now_ns) noexcept {
+        if (legs_ == 1) [[likely]] {
+            return true;
+        }
+        const uint64_t seq = first.venue_seq;
+        if (seq == 0 || first.symbol_id >= MAX_VALID_SYMBOL_ID) [[unlikely]] {
+            unsequenced_.fetch_add(leg != 0, std::memory_order_relaxed);
+            return leg == 0;
+        }
+
+        Window& window = windows_[first.symbol_id][(first.flags & MD_FLAG_TRADE) ? 0 : 1];
+        ArbiterLegStats& stats = legs_stats_[leg];
+        if (seq > window.high) [[likely]] {
+            const uint64_t shift = seq - window.high;
+            window.seen = shift >= WINDOW ? 0 : static_cast<uint32_t>(window.seen << shift);
+            window.seen |= 1;   // Bit i: id high - i has arrived
+            window.high = seq;
+            window.arrival[seq % WINDOW] = static_cast<uint32_t>(now_ns);
+            stats.wins.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const uint64_t age = window.high - seq;
+        if (age >= WINDOW) {
+            stats.duplicates.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        const uint32_t bit = 1u << age;
+        if (window.seen & bit) {
+            stats.duplicates.fetch_add(1, std::memory_order_relaxed);
+            stats.lag.record(static_cast<uint32_t>(now_ns) - window.arrival[seq % WINDOW]);
+            return false;
+        }
+        window.seen |= bit;   // Late, but first: a leg is out of order or a leg lost it
+        window.arrival[seq % WINDOW] = static_cast<uint32_t>(now_ns);
+        stats.wins.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t legs() const noexcept { return legs_; }
+    const ArbiterLegStats& leg(size_t index) const noexcept { return legs_stats_[index]; }
+
+    /**
+     * Frames without a venue id that came in on a non-preferred leg
+     */
+    uint64_t unsequenced_dropped() const noexcept {
+        return unsequenced_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Window {
+        uint64_t high = 0;                  // Highest id seen
+        uint32_t seen = 0;                  // Bit i: id high - i arrived
+        uint32_t arrival[WINDOW] = {};      // First arrival, ns (low 32 bits)
+    };
+
+    size_t legs_{1};
+    Window windows_[MAX_VALID_SYMBOL_ID][2];   // [symbol][trade, quote]
+    ArbiterLegStats legs_stats_[MAX_LEGS];
+    std::atomic<uint64_t> unsequenced_{0};
+};
+
+} // namespace cal
+} // namespace sage
@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * SAGE CAL Feed Latency
+ * Exchange → CAL latency per venue, from the venue's own event time
+ *
+ * Every parsed record carries the venue's event time (MarketData::
+ * exchange_ts_ns: Binance "E", Coinbase "time"). Against the local receive
+ * time (kernel stamp when there is one, else the CAL callback; both
+ * CLOCK_REALTIME) it gives how stale a venue's data is on arrival: the
+ * number colocation and connector routing are decided on.
+ *
+ * The figure includes the offset between the venue's clock and ours, and
+ * the venue's resolution (Binance stamps milliseconds, Coinbase
+ * microseconds). A venue clock ahead of ours by more than the latency
+ * yields a negative sample; those are counted, not recorded.
+ *
+ * Threading: record() belongs to the network thread serving the venue;
+ * everything is relaxed atomics, readable from any thread.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../core/compiler.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Log2 Histogram
+// ============================================================================
+
+/**
+ * Bucket 0 < 1us, bucket i < 2^i us, the last bucket open-ended
+ */
+template<size_t Buckets>
+struct Log2Histogram {
+    static constexpr size_t NUM_BUCKETS = Buckets;
+
+    std::atomic<uint64_t> buckets[NUM_BUCKETS]{};
+
+    SAGE_ALWAYS_INLINE
+    void record(uint64_t ns) noexcept {
+        const uint64_t us = ns >> 10;   // ~microseconds
+        size_t bucket = us == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(us));
+        if (bucket >= NUM_BUCKETS) {
+            bucket = NUM_BUCKETS - 1;
+        }
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const noexcept {
+        uint64_t total = 0;
+        for (const auto& bucket : buckets) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * Upper bound (ns) of the bucket holding the pct-th percentile
+     */
+    uint64_t percentile(double pct) const noexcept {
+        const uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t target = static_cast<uint64_t>(static_cast<double>(total) * pct / 100.0);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            cumulative += buckets[i].load(std::memory_order_relaxed);
+            if (cumulative > target) {
+                return 1024ULL << i;
+            }
+        }
+        return 1024ULL << (NUM_BUCKETS - 1);
+    }
+};
+
+// ============================================================================
+// Feed Latency
+// ============================================================================
+
+class FeedLatency {
+public:
+    using Histogram = Log2Histogram<24>;   // Last bucket: >= ~4.3s
+
+    /**
+     * @param event_ns    Venue event time (0 = the venue sent none: ignored)
+     * @param receipt_ns  Local receive time, same clock
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void record(uint64_t event_ns, uint64_t receipt_ns) noexcept {
+        if (event_ns == 0) {
+            return;
+        }
+        if (receipt_ns < event_ns) [[unlikely]] {
+            ahead_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint64_t latency_ns = receipt_ns - event_ns;
+        histogram_.record(latency_ns);
+        total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+    }
+
+    const Histogram& histogram() const noexcept { return histogram_; }
+    uint64_t count() const noexcept { return histogram_.count(); }
+    uint64_t percentile(double pct) const noexcept { return histogram_.percentile(pct); }
+
+    uint64_t mean() const noexcept {
+        const uint64_t samples = count();
+        return samples == 0 ? 0 : total_ns_.load(std::memory_order_relaxed) / samples;
+    }
+
+    /**
+     * Samples stamped after they arrived (venue clock ahead of ours)
+     */
+    uint64_t ahead() const noexcept { return ahead_.load(std::memory_order_relaxed); }
+
+private:
+    Histogram histogram_;
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> ahead_{0};
+};
+
+} // namespace cal
+} // namespace sage
@@ -0,0 +1,519 @@
+#pragma once
+
+/**
+ * SAGE CAL Feed Recovery
+ * Per-(venue, symbol) sequence tracking, gap detection and resync
+ *
+ * Venue trade ids (MarketData::venue_seq) are contiguous per symbol. A
+ * dropped frame shows up as a jump; without this layer it would silently
+ * corrupt ADE's state. Instead of reconnecting the socket (seconds of
+ * blackout), the gap is filled out of band:
+ *
+ *   LIVE        in-order ticks pass straight through (one compare)
+ *     | gap: next expected id < received id
+ *     v
+ *   RECOVERING  the gap [next, received - 1] is requested from a
+ *               snapshot source on a worker thread; live ticks for the
+ *               symbol are buffered meanwhile
+ *     | snapshot arrives, or the missing ids turn up live (late on this
+ *     | connection, or from another leg via FeedArbiter)
+ *     v
+ *   resync      snapshot ticks, then the buffered ticks, are replayed in
+ *               order with MD_FLAG_RESYNCED; back to LIVE (or RECOVERING
+ *               again if the buffer still has a hole)
+ *
+ * A failed or timed-out request is retried up to max_attempts times, then
+ * abandoned: the buffered ticks are released and the first carries
+ * MD_FLAG_STALE, telling downstream that ticks before it are missing.
+ * Other symbols are never held up.
+ *
+ * Threading: admit() / poll() belong to the network thread that serves
+ * the venue. poll() runs after each frame's admit() calls and also from
+ * the thread's loop when the venue is quiet, so attempts expire on time
+ * without traffic. The Source runs on FeedRecovery's own worker thread and may
+ * block (it must bound its own I/O time):
+ *
+ *   bool fetch(const SnapshotRequest& request, Snapshot& out);
+ *     fill out.records (ascending venue_seq) and out.last_seq (the last
+ *     id the snapshot covers); false on failure
+ *
+ * A Source declaring `static constexpr bool CAN_FETCH = false` has no
+ * snapshot endpoint: a gap then releases the tick that revealed it at
+ * once with MD_FLAG_STALE, with no buffering, requests or worker thread.
+ *
+ * Requests and completions travel through SPSC rings; snapshot buffers
+ * come from a fixed pool, so a late completion after a timeout can never
+ * race a newer request for the same symbol.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../core/compiler.hpp"
+#include "../infra/ring_buffer.hpp"
+#include "../infra/wait_strategy.hpp"
+#include "../types/sage_message.hpp"
+#include "validator.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct RecoveryConfig {
+    uint16_t track_flags = MD_FLAG_TRADE;   // Records whose venue_seq is contiguous
+    size_t max_buffered = 4096;             // Live ticks held per symbol while recovering
+    uint64_t timeout_ns = 250000000;        // Per attempt
+    uint32_t max_attempts = 3;
+};
+
+struct SnapshotRequest {
+    ExchangeId venue;
+    uint32_t symbol_id;
+    uint64_t from_seq;       // First missing venue_seq
+    uint64_t to_seq;         // Last missing venue_seq
+    uint32_t slot;           // Snapshot buffer (internal)
+    uint32_t generation;     // Attempt it answers (internal)
+};
+
+struct Snapshot {
+    SnapshotRequest request;
+    bool ok;
+    uint64_t last_seq;                   // Last venue_seq the snapshot covers
+    std::vector<MarketData> records;     // Ascending venue_seq
+};
+
+/**
+ * Written by the network thread, readable from any thread
+ */
+struct RecoveryStats {
+    std::atomic<uint64_t> gaps{0};
+    std::atomic<uint64_t> recovered{0};       // Gaps closed by a snapshot
+    std::atomic<uint64_t> stale{0};           // Gaps given up on
+    std::atomic<uint64_t> replayed{0};        // Ticks released with MD_FLAG_RESYNCED
+    std::atomic<uint64_t> duplicates{0};      // Ids at or below the last delivered one
+    std::atomic<uint64_t> overflows{0};       // Ticks dropped: recovery buffer full
+};
+
+/**
+ * For venues with no snapshot endpoint: every gap goes straight to STALE
+ */
+struct NoSnapshotSource {
+    static constexpr bool CAN_FETCH = false;
+
+    bool fetch(const SnapshotRequest&, Snapshot&) noexcept { return false; }
+};
+
+/**
+ * Whether a Source can fill gaps (true unless it declares CAN_FETCH = false)
+ */
+template<typename Source>
+inline constexpr bool can_fetch_v = [] {
+    if constexpr (requires { Source::CAN_FETCH; }) {
+        return static_cast<bool>(Source::CAN_FETCH);
+    } else {
+        return true;
+    }
+}();
+
+// ============================================================================
+// Feed Recovery
+// ============================================================================
+
+/**
+ * @tparam Source       Snapshot fetcher (owned; see file comment)
+ * @tparam MaxInFlight  Snapshot buffers (outstanding requests across symbols)
+ */
+template<typename Source, size_t MaxInFlight = 16>
+class FeedRecovery {
+public:
+    explicit FeedRecovery(ExchangeId venue, RecoveryConfig config = {}) noexcept
+        : venue_(venue), config_(config) {
+        for (size_t i = 0; i < MaxInFlight; ++i) {
+            free_slots_[i] = static_cast<uint32_t>(i);
+        }
+        free_count_ = MaxInFlight;
+    }
+
+    ~FeedRecovery() { stop(); }
+
+    FeedRecovery(const FeedRecovery&) = delete;
+    FeedRecovery& operator=(const FeedRecovery&) = delete;
+
+    /**
+     * Change the policy (before any traffic)
+     */
+    SAGE_COLD
+    void configure(RecoveryConfig config) noexcept { config_ = config; }
+
+    Source& source() noexcept { return source_; }
+
+    // ========================================================================
+    // Worker Thread
+    // ========================================================================
+
+    void start() {
+        if constexpr (!can_fetch_v<Source>) {
+            return;   // Nothing to fetch: gaps never leave the network thread
+        }
+        if (running_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        worker_ = std::thread([this] {
+            SleepingWait wait(100, 1000);
+            SnapshotRequest request;
+            while (running_.load(std::memory_order_acquire)) {
+                if (!requests_.try_pop(request)) {
+                    wait.idle(requests_);
+                    continue;
+                }
+                wait.reset();
+                Snapshot& snapshot = slots_[request.slot];
+                snapshot.request = request;
+                snapshot.records.clear();
+                snapshot.last_seq = 0;
+                snapshot.ok = source_.fetch(request, snapshot);
+                completions_.try_push(request.slot);   // Ring > pool: never full
+            }
+        });
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // ========================================================================
+    // Network Thread
+    // ========================================================================
+
+    /**
+     * Sequence one parsed record
+     * @return true to publish it now (possibly flagged MD_FLAG_STALE);
+     *         false if it was buffered for a resync or is a duplicate
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    bool admit(MarketData& record, uint64_t now_ns) noexcept {
+        const uint64_t seq = record.venue_seq;
+        if ((record.flags & config_.track_flags) == 0 || seq == 0 ||
+            record.symbol_id >= MAX_VALID_SYMBOL_ID) {
+            return true;
+        }
+        Stream& stream = streams_[record.symbol_id];
+        if (!stream.recovering) [[likely]] {
+            if (seq == stream.next_seq || stream.next_seq == 0) [[likely]] {
+                stream.next_seq = seq + 1;
+                if (stream.stale) [[unlikely]] {
+                    record.flags |= MD_FLAG_STALE;
+                    stream.stale = false;
+                }
+                return true;
+            }
+            if (seq < stream.next_seq) {
+                stats_.duplicates.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if constexpr (!can_fetch_v<Source>) {
+                skip_gap(stream, record);
+                return true;
+            }
+            open_gap(stream, record, now_ns);
+            return false;
+        }
+
+        if (seq < stream.next_seq) {
+            stats_.duplicates.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (seq == stream.next_seq) {
+            stream.next_seq = seq + 1;   // The hole is filling live (another leg, reordering)
+            return true;
+        }
+        if (stream.buffer.size() >= config_.max_buffered) [[unlikely]] {
+            stats_.overflows.fetch_add(1, std::memory_order_relaxed);
+            stream.overflowed = true;
+            stream.deadline_ns = 0;        // Give up at the next poll()
+            stream.attempts = config_.max_attempts;
+            return false;
+        }
+        buffer(stream, record);
+        return false;
+    }
+
+    /**
+     * Apply finished snapshots, release holes closed live and expire
+     * attempts; call after admit() for a frame and periodically between
+     * frames (see recovering_count())
+     * @param emit  void(MarketData&) for each tick released in order
+     * @return Ticks released
+     */
+    template<typename Emit>
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    size_t poll(uint64_t now_ns, Emit&& emit) {
+        if (recovering_ == 0) [[likely]] {
+            return 0;
+        }
+        return poll_slow(now_ns, emit);
+    }
+
+    /**
+     * Symbols in recovery (0: poll() has nothing to do)
+     */
+    size_t recovering_count() const noexcept { return recovering_; }
+
+    bool recovering(uint64_t symbol_id) const noexcept {
+        return symbol_id < MAX_VALID_SYMBOL_ID && streams_[symbol_id].recovering;
+    }
+
+    /**
+     * Next venue_seq expected for a symbol (0 = no baseline yet)
+     */
+    uint64_t next_seq(uint64_t symbol_id) const noexcept {
+        return symbol_id < MAX_VALID_SYMBOL_ID ? streams_[symbol_id].next_seq : 0;
+    }
+
+    const RecoveryStats& stats() const noexcept { return stats_; }
+    ExchangeId venue() const noexcept { return venue_; }
+
+private:
+    struct Stream {
+        uint64_t next_seq = 0;          // 0: baseline on the next tick
+        uint64_t deadline_ns = 0;
+        uint32_t generation = 0;
+        uint32_t attempts = 0;
+        bool recovering = false;
+        bool stale = false;             // Flag the next delivered tick
+        bool overflowed = false;
+        std::vector<MarketData> buffer; // Live ticks during recovery, arrival order
+    };
+
+    /**
+     * Keep the buffer in venue order (legs and reordering can deliver late)
+     */
+    SAGE_COLD
+    void buffer(Stream& stream, const MarketData& record) {
+        auto& buffered = stream.buffer;
+        if (buffered.empty() || buffered.back().venue_seq < record.venue_seq) [[likely]] {
+            buffered.push_back(record);
+            return;
+        }
+        auto it = buffered.begin();
+        while (it->venue_seq < record.venue_seq) {
+            ++it;
+        }
+        if (it->venue_seq == record.venue_seq) {
+            stats_.duplicates.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffered.insert(it, record);
+    }
+
+    /**
+     * No snapshot to wait for: step over the gap and flag the tick after it
+     */
+    SAGE_COLD
+    void skip_gap(Stream& stream, MarketData& record) noexcept {
+        stats_.gaps.fetch_add(1, std::memory_order_relaxed);
+        stats_.stale.fetch_add(1, std::memory_order_relaxed);
+        record.flags |= MD_FLAG_STALE;
+        stream.next_seq = record.venue_seq + 1;
+    }
+
+    SAGE_COLD
+    void open_gap(Stream& stream, const MarketData& record, uint64_t now_ns) {
+        stats_.gaps.fetch_add(1, std::memory_order_relaxed);
+        stream.recovering = true;
+        stream.overflowed = false;
+        stream.attempts = 0;
+        stream.buffer.clear();
+        stream.buffer.reserve(config_.max_buffered);
+        stream.buffer.push_back(record);
+        ++recovering_;
+        request(stream, static_cast<uint32_t>(record.symbol_id), now_ns);
+    }
+
+    /**
+     * Ask for [next_seq, first buffered - 1]; on no free buffer or a full
+     * ring the attempt fails at the next poll()
+     */
+    SAGE_COLD
+    void request(Stream& stream, uint32_t symbol_id, uint64_t now_ns) noexcept {
+        ++stream.attempts;
+        ++stream.generation;
+        stream.deadline_ns = now_ns;
+        if (free_count_ == 0) {
+            return;
+        }
+        const uint32_t slot = free_slots_[--free_count_];
+        const SnapshotRequest request{venue_, symbol_id, stream.next_seq,
+                                      stream.buffer.front().venue_seq - 1, slot,
+                                      stream.generation};
+        if (!requests_.try_push(request)) {
+            free_slots_[free_count_++] = slot;
+            return;
+        }
+        stream.deadline_ns = now_ns + config_.timeout_ns;
+    }
+
+    template<typename Emit>
+    SAGE_COLD
+    size_t poll_slow(uint64_t now_ns, Emit& emit) {
+        size_t released = 0;
+
+        uint32_t slot;
+        while (completions_.try_pop(slot)) {
+            Snapshot& snapshot = slots_[slot];
+            const uint32_t symbol_id = snapshot.request.symbol_id;
+            Stream& stream = streams_[symbol_id];
+            if (stream.recovering && !stream.overflowed &&
+                snapshot.request.generation == stream.generation) {
+                if (snapshot.ok) {
+                    released += resync(stream, symbol_id, snapshot, now_ns, emit);
+                } else {
+                    stream.deadline_ns = now_ns;   // Retry (or give up) below
+                }
+            }
+            free_slots_[free_count_++] = slot;
+        }
+
+        for (uint32_t symbol_id = 0; symbol_id < MAX_VALID_SYMBOL_ID && recovering_ > 0; ++symbol_id) {
+            Stream& stream = streams_[symbol_id];
+            if (!stream.recovering) {
+                continue;
+            }
+            if (!stream.overflowed && stream.buffer.front().venue_seq <= stream.next_seq) {
+                released += resume(stream, symbol_id, now_ns, emit);   // Filled live
+                continue;
+            }
+            if (now_ns < stream.deadline_ns) {
+                continue;
+            }
+            if (stream.attempts < config_.max_attempts) {
+                request(stream, symbol_id, now_ns);
+            } else {
+                released += give_up(stream, emit);
+            }
+        }
+        return released;
+    }
+
+    template<typename Emit>
+    size_t resync(Stream& stream, uint32_t symbol_id, Snapshot& snapshot, uint64_t now_ns,
+                  Emit& emit) {
+        size_t released = 0;
+        for (MarketData& record : snapshot.records) {
+            if (record.venue_seq < stream.next_seq || record.venue_seq > snapshot.last_seq) {
+                continue;
+            }
+            record.symbol_id = symbol_id;
+            record.exchange_id = static_cast<uint8_t>(venue_);
+            record.flags |= MD_FLAG_RESYNCED;
+            stream.next_seq = record.venue_seq + 1;
+            emit(record);
+            ++released;
+        }
+        if (snapshot.last_seq >= stream.next_seq) {
+            stream.next_seq = snapshot.last_seq + 1;
+        }
+        stats_.replayed.fetch_add(released, std::memory_order_relaxed);
+        return released + resume(stream, symbol_id, now_ns, emit);
+    }
+
+    /**
+     * Replay the buffered ticks that are now in order; LIVE again if that
+     * empties the buffer, otherwise request the hole that is left
+     */
+    template<typename Emit>
+    size_t resume(Stream& stream, uint32_t symbol_id, uint64_t now_ns, Emit& emit) {
+        size_t released = 0;
+        size_t i = 0;
+        for (; i < stream.buffer.size(); ++i) {
+            MarketData& record = stream.buffer[i];
+            if (record.venue_seq < stream.next_seq) {
+                continue;
+            }
+            if (record.venue_seq > stream.next_seq) {
+                break;   // Still (or again) a hole
+            }
+            record.flags |= MD_FLAG_RESYNCED;
+            stream.next_seq = record.venue_seq + 1;
+            emit(record);
+            ++released;
+        }
+        stats_.replayed.fetch_add(released, std::memory_order_relaxed);
+
+        if (i == stream.buffer.size()) {
+            stats_.recovered.fetch_add(1, std::memory_order_relaxed);
+            finish(stream);
+        } else {
+            stream.buffer.erase(stream.buffer.begin(), stream.buffer.begin() + static_cast<long>(i));
+            stream.attempts = 0;
+            request(stream, symbol_id, now_ns);
+        }
+        return released;
+    }
+
+    /**
+     * Release what was buffered; the first tick carries MD_FLAG_STALE
+     */
+    template<typename Emit>
+    size_t give_up(Stream& stream, Emit& emit) {
+        stats_.stale.fetch_add(1, std::memory_order_relaxed);
+        bool first = true;
+        size_t released = 0;
+        for (MarketData& record : stream.buffer) {
+            if (record.venue_seq < stream.next_seq) {
+                continue;
+            }
+            if (first) {
+                record.flags |= MD_FLAG_STALE;
+                first = false;
+            }
+            stream.next_seq = record.venue_seq + 1;
+            emit(record);
+            ++released;
+        }
+        if (stream.overflowed) {
+            stream.next_seq = 0;   // Ticks were dropped: rebaseline, flag the next one
+            stream.stale = true;
+        }
+        finish(stream);
+        return released;
+    }
+
+    void finish(Stream& stream) noexcept {
+        stream.recovering = false;
+        stream.overflowed = false;
+        stream.buffer.clear();
+        --recovering_;
+    }
+
+    const ExchangeId venue_;
+    RecoveryConfig config_;
+    Source source_{};
+
+    Stream streams_[MAX_VALID_SYMBOL_ID];
+    size_t recovering_{0};
+
+    Snapshot slots_[MaxInFlight];
+    uint32_t free_slots_[MaxInFlight];
+    size_t free_count_{0};
+
+    RingBuffer<SnapshotRequest, 64> requests_;   // Network thread -> worker
+    RingBuffer<uint32_t, 64> completions_;       // Worker -> network thread
+    static_assert(MaxInFlight <= 64, "Completion ring must hold every snapshot buffer");
+
+    RecoveryStats stats_;
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+} // namespace cal
+} // namespace sage
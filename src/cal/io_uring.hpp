@@ -0,0 +1,512 @@
+#pragma once
+
+/**
+ * SAGE CAL io_uring Ring
+ * Minimal raw-syscall io_uring wrapper for the network thread (no liburing)
+ *
+ * Only what the receive path needs:
+ * - SQ/CQ rings mapped once; SQEs and CQEs are plain memory accesses,
+ *   the only syscall is io_uring_enter when something must be submitted
+ *   or when blocking for completions
+ * - Optional SQPOLL: a kernel thread consumes the SQ, so even submission
+ *   is syscall-free while it is awake
+ * - Without SQPOLL, cooperative task running (COOP_TASKRUN +
+ *   TASKRUN_FLAG, 5.19+): the kernel never interrupts the busy-polling
+ *   thread to post completions; it raises IORING_SQ_TASKRUN and submit()
+ *   enters only then
+ * - One registered provided-buffer ring (IORING_REGISTER_PBUF_RING):
+ *   the kernel picks a buffer per completion, so one multishot recv per
+ *   socket keeps receiving with no re-arm and no per-read syscall
+ *   (multishot recvmsg when the control data, i.e. receive timestamps,
+ *   is needed too)
+ *
+ * Needs Linux 6.0+ (multishot recv). Every setup step reports failure
+ * through a bool and last_error() so callers can fall back to epoll.
+ * Single-threaded: one owner submits and reaps.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/memory.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Syscalls
+// ============================================================================
+
+namespace uring {
+
+inline int setup(unsigned entries, io_uring_params* params) noexcept {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                 const void* arg, size_t arg_size) noexcept {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                    flags, arg, arg_size));
+}
+
+inline int register_op(int fd, unsigned opcode, const void* arg, unsigned nr_args) noexcept {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+SAGE_ALWAYS_INLINE uint32_t load_acquire(const uint32_t* p) noexcept {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+SAGE_ALWAYS_INLINE void store_release(uint32_t* p, uint32_t v) noexcept {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+} // namespace uring
+
+// ============================================================================
+// Ring
+// ============================================================================
+
+struct IoUringConfig {
+    unsigned entries = 256;          // SQ size (CQ is sized 4x for multishot bursts)
+    bool sqpoll = false;             // Kernel SQ polling thread
+    int sqpoll_cpu = -1;             // Pin the SQPOLL thread (-1 = unpinned)
+    unsigned sqpoll_idle_ms = 1000;  // SQPOLL thread sleeps after this much idle
+};
+
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring() { close(); }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * Create and map the rings
+     * @return false if io_uring is unavailable (old kernel, disabled by
+     *         sysctl/seccomp, no privilege for SQPOLL); see last_error()
+     */
+    SAGE_COLD
+    bool init(const IoUringConfig& config) noexcept {
+        close();
+
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = config.entries * 4;
+        if (config.sqpoll) {
+            params.flags |= IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = config.sqpoll_idle_ms;
+            if (config.sqpoll_cpu >= 0) {
+                params.flags |= IORING_SETUP_SQ_AFF;
+                params.sq_thread_cpu = static_cast<uint32_t>(config.sqpoll_cpu);
+            }
+        } else {
+            params.flags |= IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        }
+
+        fd_ = uring::setup(config.entries, &params);
+        if (fd_ < 0 && errno == EINVAL && !config.sqpoll) {
+            // Pre-5.19: completions interrupt the thread instead
+            params = io_uring_params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = config.entries * 4;
+            fd_ = uring::setup(config.entries, &params);
+        }
+        if (fd_ < 0) {
+            fd_ = -1;
+            return fail(errno == EPERM ? "io_uring not permitted" : "io_uring_setup failed");
+        }
+        features_ = params.features;
+        sqpoll_ = config.sqpoll;
+
+        // SQ and CQ rings (one mapping on 5.4+ kernels)
+        sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (features_ & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_map_size_ = cq_map_size_ = (sq_map_size_ > cq_map_size_) ? sq_map_size_ : cq_map_size_;
+        }
+
+        sq_map_ = map(sq_map_size_, IORING_OFF_SQ_RING);
+        cq_map_ = single_mmap ? sq_map_ : map(cq_map_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+        if (sq_map_ == nullptr || cq_map_ == nullptr || sqes_ == nullptr) {
+            close();
+            return fail("io_uring mmap failed");
+        }
+
+        auto* sq = static_cast<uint8_t*>(sq_map_);
+        sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+        sq_flags_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+        sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+
+        // Identity SQ index array: SQE i always sits in slot i
+        auto* array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        for (uint32_t i = 0; i < sq_entries_; ++i) {
+            array[i] = i;
+        }
+
+        auto* cq = static_cast<uint8_t*>(cq_map_);
+        cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        sq_local_tail_ = *sq_tail_;
+        sq_submitted_ = sq_local_tail_;
+        return true;
+    }
+
+    SAGE_COLD
+    void close() noexcept {
+        if (buf_ring_ != nullptr) {
+            if (fd_ >= 0) {
+                io_uring_buf_reg reg{};
+                reg.bgid = buf_group_;
+                uring::register_op(fd_, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+            }
+            memory::free_aligned(buf_ring_);
+            memory::free_aligned(buf_memory_);
+            buf_ring_ = nullptr;
+            buf_memory_ = nullptr;
+        }
+        if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+        if (cq_map_ != nullptr && cq_map_ != sq_map_) munmap(cq_map_, cq_map_size_);
+        if (sq_map_ != nullptr) munmap(sq_map_, sq_map_size_);
+        sqes_ = nullptr;
+        cq_map_ = nullptr;
+        sq_map_ = nullptr;
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // ========================================================================
+    // Provided Buffers
+    // ========================================================================
+
+    /**
+     * Allocate count buffers of buffer_size bytes and register them as
+     * buffer group `group` (count must be a power of two, <= 32768)
+     */
+    SAGE_COLD
+    bool setup_buffers(uint16_t group, uint32_t count, uint32_t buffer_size) noexcept {
+        if (count == 0 || (count & (count - 1)) != 0 || count > 32768) {
+            return fail("Buffer count must be a power of two <= 32768");
+        }
+
+        buf_ring_ = static_cast<io_uring_buf*>(
+            memory::alloc_aligned(count * sizeof(io_uring_buf), PAGE_SIZE));
+        buf_memory_ = static_cast<uint8_t*>(
+            memory::alloc_aligned(static_cast<size_t>(count) * buffer_size, PAGE_SIZE));
+        if (buf_ring_ == nullptr || buf_memory_ == nullptr) {
+            return fail("Buffer ring allocation failed");
+        }
+        std::memset(buf_ring_, 0, count * sizeof(io_uring_buf));
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+        reg.ring_entries = count;
+        reg.bgid = group;
+        if (uring::register_op(fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            memory::free_aligned(buf_ring_);
+            memory::free_aligned(buf_memory_);
+            buf_ring_ = nullptr;
+            buf_memory_ = nullptr;
+            return fail("IORING_REGISTER_PBUF_RING failed (kernel < 5.19?)");
+        }
+
+        buf_group_ = group;
+        buf_count_ = count;
+        buf_size_ = buffer_size;
+        buf_tail_ = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            stage_buffer(static_cast<uint16_t>(i));
+        }
+        publish_buffers();
+        return true;
+    }
+
+    SAGE_ALWAYS_INLINE uint8_t* buffer(uint16_t bid) noexcept {
+        return buf_memory_ + static_cast<size_t>(bid) * buf_size_;
+    }
+
+    /**
+     * Hand a consumed buffer back to the kernel
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void recycle_buffer(uint16_t bid) noexcept {
+        stage_buffer(bid);
+        publish_buffers();
+    }
+
+    // Buffer memory and size, for MemoryProvisioner
+    uint8_t* buffer_memory() noexcept { return buf_memory_; }
+    size_t buffer_memory_size() const noexcept { return static_cast<size_t>(buf_count_) * buf_size_; }
+
+    // ========================================================================
+    // Submission
+    // ========================================================================
+
+    /**
+     * Next free SQE (zeroed), or nullptr if the SQ is full
+     */
+    SAGE_HOT
+    io_uring_sqe* get_sqe() noexcept {
+        const uint32_t head = sqpoll_ ? uring::load_acquire(sq_head_) : *sq_head_;
+        if (sq_local_tail_ - head >= sq_entries_) [[unlikely]] {
+            return nullptr;
+        }
+        io_uring_sqe* sqe = &sqes_[sq_local_tail_ & sq_mask_];
+        ++sq_local_tail_;
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    /**
+     * Multishot recv on fd with kernel-selected buffers from the group
+     * (completions carry IORING_CQE_F_MORE until the request terminates)
+     */
+    void prep_recv_multishot(io_uring_sqe* sqe, int fd, uint64_t user_data) noexcept {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = buf_group_;
+        sqe->user_data = user_data;
+    }
+
+    /**
+     * Multishot recvmsg: like prep_recv_multishot, but each buffer starts
+     * with io_uring_recvmsg_out, then the name and control areas sized by
+     * message, then the payload (see recvmsg_payload()). message must
+     * outlive the request.
+     */
+    void prep_recvmsg_multishot(io_uring_sqe* sqe, int fd, const msghdr* message,
+                                uint64_t user_data) noexcept {
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(message);
+        sqe->len = 1;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = buf_group_;
+        sqe->user_data = user_data;
+    }
+
+    /**
+     * Split a multishot recvmsg buffer
+     * @return Payload bytes; control / control_length point at the control
+     *         data the kernel wrote
+     */
+    SAGE_ALWAYS_INLINE
+    static size_t recvmsg_payload(uint8_t* buffer, const msghdr& message, uint8_t*& payload,
+                                  const uint8_t*& control, size_t& control_length) noexcept {
+        io_uring_recvmsg_out out;
+        std::memcpy(&out, buffer, sizeof(out));
+        control = buffer + sizeof(out) + message.msg_namelen;
+        control_length = (out.flags & MSG_CTRUNC) ? 0 : out.controllen;
+        payload = buffer + sizeof(out) + message.msg_namelen + message.msg_controllen;
+        return out.payloadlen;
+    }
+
+    /**
+     * Cancel every request tagged with user_data (e.g. before closing its fd)
+     */
+    void prep_cancel(io_uring_sqe* sqe, uint64_t target, uint64_t user_data) noexcept {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = target;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = user_data;
+    }
+
+    /**
+     * Publish queued SQEs and optionally wait for completions
+     * @param wait_ms  0 = don't wait; >0 = wait up to wait_ms for one CQE
+     * @return Number of SQEs handed to the kernel, or -1 on error
+     */
+    SAGE_HOT
+    int submit(int wait_ms = 0) noexcept {
+        const uint32_t pending = sq_local_tail_ - sq_submitted_;
+        if (pending > 0) {
+            uring::store_release(sq_tail_, sq_local_tail_);
+            sq_submitted_ = sq_local_tail_;
+        }
+
+        // Completions waiting on us to enter (COOP_TASKRUN) or an overflowed CQ
+        unsigned flags = 0;
+        if (uring::load_acquire(sq_flags_) & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW)) {
+            flags |= IORING_ENTER_GETEVENTS;
+        }
+
+        unsigned to_submit = pending;
+        if (sqpoll_) {
+            // The SQPOLL thread picks up the tail; enter only to wake it
+            to_submit = 0;
+            if (pending > 0) {
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                if (uring::load_acquire(sq_flags_) & IORING_SQ_NEED_WAKEUP) {
+                    flags |= IORING_ENTER_SQ_WAKEUP;
+                }
+            }
+        }
+
+        if (wait_ms > 0) {
+            return enter_wait(to_submit, flags, wait_ms) < 0 ? -1 : static_cast<int>(pending);
+        }
+        if (to_submit == 0 && flags == 0) {
+            return 0;   // Nothing for the kernel: no syscall
+        }
+        const int ret = uring::enter(fd_, to_submit, 0, flags, nullptr, 0);
+        return (ret < 0 && errno != EINTR && errno != EBUSY) ? -1 : static_cast<int>(pending);
+    }
+
+    // ========================================================================
+    // Completion
+    // ========================================================================
+
+    /**
+     * Invoke fn(const io_uring_cqe&) for every ready CQE, then release them
+     * Pure memory access: no syscall.
+     * @return CQEs consumed
+     */
+    template<typename Fn>
+    SAGE_HOT
+    unsigned drain_completions(Fn&& fn) noexcept {
+        uint32_t head = *cq_head_;
+        const uint32_t tail = uring::load_acquire(cq_tail_);
+        const unsigned count = tail - head;
+        for (; head != tail; ++head) {
+            fn(cqes_[head & cq_mask_]);
+        }
+        if (count > 0) {
+            uring::store_release(cq_head_, head);
+        }
+        return count;
+    }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
+    bool valid() const noexcept { return fd_ >= 0; }
+    bool sqpoll() const noexcept { return sqpoll_; }
+    uint32_t features() const noexcept { return features_; }
+    uint32_t buffer_size() const noexcept { return buf_size_; }
+    const char* last_error() const noexcept { return last_error_; }
+
+private:
+    SAGE_COLD
+    void* map(size_t size, uint64_t offset) noexcept {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       fd_, static_cast<off_t>(offset));
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    SAGE_ALWAYS_INLINE void stage_buffer(uint16_t bid) noexcept {
+        io_uring_buf& entry = buf_ring_[buf_tail_ & (buf_count_ - 1)];
+        entry.addr = reinterpret_cast<uint64_t>(buffer(bid));
+        entry.len = buf_size_;
+        entry.bid = bid;
+        ++buf_tail_;
+    }
+
+    /**
+     * The ring tail overlays the resv field of entry 0 (struct
+     * io_uring_buf_ring). Addressed directly: the header's flexible-array
+     * union is laid out differently when compiled as C++.
+     */
+    SAGE_ALWAYS_INLINE void publish_buffers() noexcept {
+        __atomic_store_n(&buf_ring_[0].resv, buf_tail_, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * io_uring_enter blocking for one CQE with a timeout (EXT_ARG, 5.11+);
+     * older kernels fall back to a short sleep and a non-blocking enter
+     */
+    int enter_wait(unsigned to_submit, unsigned flags, int wait_ms) noexcept {
+        if (features_ & IORING_FEAT_EXT_ARG) {
+            __kernel_timespec ts{};
+            ts.tv_sec = wait_ms / 1000;
+            ts.tv_nsec = static_cast<long long>(wait_ms % 1000) * 1000000;
+            io_uring_getevents_arg arg{};
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+            const int ret = uring::enter(fd_, to_submit, 1,
+                                         flags | IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                         &arg, sizeof(arg));
+            return (ret < 0 && errno != ETIME && errno != EINTR) ? -1 : 0;
+        }
+        if (to_submit > 0 || flags != 0) {
+            if (uring::enter(fd_, to_submit, 0, flags, nullptr, 0) < 0 && errno != EINTR) {
+                return -1;
+            }
+        }
+        if (uring::load_acquire(cq_tail_) == *cq_head_) {
+            timespec ts{0, 1000000};   // 1ms
+            nanosleep(&ts, nullptr);
+        }
+        return 0;
+    }
+
+    SAGE_COLD
+    bool fail(const char* reason) noexcept {
+        last_error_ = reason;
+        return false;
+    }
+
+    int fd_{-1};
+    uint32_t features_{0};
+    bool sqpoll_{false};
+
+    // Submission ring
+    void* sq_map_{nullptr};
+    size_t sq_map_size_{0};
+    io_uring_sqe* sqes_{nullptr};
+    size_t sqes_size_{0};
+    uint32_t* sq_head_{nullptr};
+    uint32_t* sq_tail_{nullptr};
+    uint32_t* sq_flags_{nullptr};
+    uint32_t sq_mask_{0};
+    uint32_t sq_entries_{0};
+    uint32_t sq_local_tail_{0};   // SQEs handed out by get_sqe()
+    uint32_t sq_submitted_{0};    // SQEs published to the kernel
+
+    // Completion ring
+    void* cq_map_{nullptr};
+    size_t cq_map_size_{0};
+    uint32_t* cq_head_{nullptr};
+    uint32_t* cq_tail_{nullptr};
+    uint32_t cq_mask_{0};
+    io_uring_cqe* cqes_{nullptr};
+
+    // Provided-buffer ring
+    io_uring_buf* buf_ring_{nullptr};
+    uint8_t* buf_memory_{nullptr};
+    uint16_t buf_group_{0};
+    uint32_t buf_count_{0};
+    uint32_t buf_size_{0};
+    uint16_t buf_tail_{0};
+
+    const char* last_error_{""};
+};
+
+} // namespace cal
+} // namespace sage
@@ -1,61 +1,1189 @@
 #pragma once
 
-#include <string_view>
+/**
+ * SAGE CAL JSON Parser
+ * Exchange trade/quote payloads -> MarketData without going through double
+ *
+ * Not a general JSON parser. Exchange messages are small objects with a
+ * handful of interesting keys, so the parser:
+ * - finds string boundaries with SIMD: one pass per 64-byte block builds
+ *   a quote bitmask that is then consumed bit by bit, never byte by byte
+ * - treats any string followed by ':' as a key, classifies it by length
+ *   and bytes into one of a few fields and skips everything else
+ * - converts decimal strings ("67012.34000000") straight into FixedPoint
+ *   raw integers (one SSE4.1 shuffle + multiply-add ladder, SWAR fallback):
+ *   exact to 8 decimals, no strtod, no from_double rounding
+ *
+ * Supported payloads:
+ *   Binance   trade, aggTrade, bookTicker (spot: no "e"; futures:
+ *             "e":"bookTicker"), raw or inside a combined-stream wrapper
+ *             {"stream":...,"data":{...}}
+ *   Coinbase  match, last_match, ticker (best_bid/best_ask + sizes)
+ *
+ * Depth (Binance depthUpdate, Coinbase level2 snapshot / l2update) is
+ * reported as DEPTH by parse() and read by parse_depth(), which locates
+ * the level arrays; DepthMessage::for_each() then yields one MarketData
+ * per level (MD_FLAG_DEPTH) for ADE's order books.
+ *
+ * Anything else (subscription acks, heartbeats) is IGNORED.
+ * Venue message ids land in MarketData::venue_seq: trade ids ("t" /
+ * "trade_id", aggTrade "a" = aggregate trade id, never the ask of a
+ * bookTicker) for gap detection (feed_recovery.hpp), and the bookTicker
+ * update id ("u") so redundant connections can be merged (feed_arbiter.hpp).
+ * Venue event times land in MarketData::exchange_ts_ns as nanoseconds since
+ * the epoch: Binance "E" (epoch milliseconds), Coinbase "time" (ISO 8601,
+ * microseconds); Binance spot bookTicker carries none (0).
+ * Symbols are resolved through a minimal perfect hash built at startup
+ * (SymbolInterner, keyed by this parser's venue); unknown names are
+ * reported, never aliased onto another symbol.
+ *
+ * Key and event tables are compile-time venue schemas: BinanceParser and
+ * CoinbaseParser only match their own venue's keys and stamp their
+ * exchange_id as a constant; JsonParser accepts either and infers the
+ * venue from the symbol key (tools, mixed captures).
+ *
+ * Target latency: <200ns p50 per message (README: CAL parse + validate <500ns)
+ * Measure with tests/benchmark_parser over tests/data/market_data_corpus.jsonl.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
 #include <optional>
-#include <iostream>
-// In a real env, this includes simdjson.
-// Assuming simdjson is available in include path.
-// #include "simdjson.h" 
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
 #include "../types/sage_message.hpp"
 #include "../types/fixed_point.hpp"
-#include "validator.hpp"
+#include "symbol_interner.hpp"
 
 namespace sage {
 namespace cal {
 
-// Placeholder for simdjson dependency if missing
-// In production, build system ensures this exists.
-class JsonParser {
+// ============================================================================
+// Scanning Primitives
+// ============================================================================
+
+namespace detail {
+
+/**
+ * Positions of '"' in a message, indexed 64 bytes at a time
+ *
+ * One SIMD pass per 64-byte block builds a bitmask; next() pops set bits
+ * in order, so each quote is located exactly once however many strings
+ * the message holds. Never reads outside [data, end).
+ */
+class QuoteIndex {
+public:
+    QuoteIndex(const char* data, const char* end) noexcept
+        : data_(data), length_(static_cast<size_t>(end - data)), block_(0),
+          mask_(block_mask(0)) {}
+
+    /**
+     * Next quote in the message, or end
+     */
+    SAGE_ALWAYS_INLINE
+    const char* next() noexcept {
+        while (mask_ == 0) {
+            block_ += 64;
+            if (block_ >= length_) {
+                return data_ + length_;
+            }
+            mask_ = block_mask(block_);
+        }
+        const char* quote = data_ + block_ + static_cast<size_t>(__builtin_ctzll(mask_));
+        mask_ &= mask_ - 1;
+        return quote;
+    }
+
+    /**
+     * Closing quote of the string whose content starts at p (its opening
+     * quote having just been returned by next()), or end
+     */
+    SAGE_ALWAYS_INLINE
+    const char* string_end(const char* p) noexcept {
+        const char* quote = next();
+        const char* end = data_ + length_;
+        while (quote < end && quote > p && quote[-1] == '\\') [[unlikely]] {
+            // Escaped only if preceded by an odd number of backslashes
+            size_t backslashes = 0;
+            for (const char* b = quote - 1; b >= p && *b == '\\'; --b) {
+                ++backslashes;
+            }
+            if ((backslashes & 1) == 0) {
+                break;
+            }
+            quote = next();
+        }
+        return quote;
+    }
+
+private:
+    SAGE_ALWAYS_INLINE
+    uint64_t block_mask(size_t offset) const noexcept {
+        const size_t remaining = length_ - offset;
+        if (remaining >= 64) [[likely]] {
+            return quote_mask64(data_ + offset);
+        }
+        if (length_ >= 64) {
+            // Short last block: re-scan the final 64 bytes, keep the new part
+            return quote_mask64(data_ + length_ - 64) >> (64 - remaining);
+        }
+        // Message shorter than one block: scan a padded copy
+        char padded[64] = {};
+        std::memcpy(padded, data_ + offset, remaining);
+        return quote_mask64(padded);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t quote_mask64(const char* p) noexcept {
+#if defined(__AVX2__)
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote))) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)))) << 32);
+#elif defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('"');
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, quote)))) << (i * 16);
+        }
+        return mask;
+#else
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            mask |= static_cast<uint64_t>(p[i] == '"') << i;
+        }
+        return mask;
+#endif
+    }
+
+    const char* data_;
+    size_t length_;
+    size_t block_;      // Offset of the block mask_ describes
+    uint64_t mask_;     // Quotes in the block not yet returned
+};
+
+SAGE_ALWAYS_INLINE
+const char* skip_whitespace(const char* p, const char* end) noexcept {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * Length of the run of ASCII digits starting at p
+ * Reads whole 16-byte blocks only while they lie inside [p, end).
+ */
+SAGE_ALWAYS_INLINE
+size_t digit_run(const char* p, const char* end) noexcept {
+    size_t n = 0;
+#if defined(__SSE2__) || defined(__AVX2__)
+    const __m128i below = _mm_set1_epi8('0' - 1);
+    const __m128i above = _mm_set1_epi8('9' + 1);
+    while (end - (p + n) >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(block, below),
+                                             _mm_cmplt_epi8(block, above));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(digits));
+        if (mask != 0xFFFF) {
+            return n + static_cast<size_t>(__builtin_ctz(~mask));
+        }
+        n += 16;
+    }
+#endif
+    while (p + n < end && static_cast<unsigned char>(p[n] - '0') < 10) {
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * Eight ASCII digits (first digit in the lowest byte) -> value
+ */
+SAGE_ALWAYS_INLINE
+uint64_t parse_eight_digits(const char* digits) noexcept {
+    uint64_t chunk;
+    std::memcpy(&chunk, digits, sizeof(chunk));
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return chunk;
+}
+
+#if defined(__SSE4_1__)
+/**
+ * SIMD decimal conversion for the common shape: up to 7 integer digits,
+ * an optional fraction, 16 readable bytes at p and len <= 16
+ *
+ * Integer digits are shuffled right-aligned into lanes 0-7 and fraction
+ * digits left-aligned into lanes 8-15; one multiply-add ladder over the
+ * 16 lanes then yields integer * 10^8 + fraction, i.e. the raw value.
+ *
+ * @return false if this shape doesn't apply (caller takes the SWAR path)
+ */
+SAGE_ALWAYS_INLINE
+bool parse_decimal_simd(const char* p, size_t len, int64_t& raw) noexcept {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i digits = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    const uint32_t digit_mask = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmplt_epi8(_mm_xor_si128(digits, _mm_set1_epi8(static_cast<char>(0x80))),
+                       _mm_set1_epi8(static_cast<char>(0x80 + 10)))));
+    const uint32_t span_mask = (1u << len) - 1;
+
+    const size_t int_digits = static_cast<size_t>(__builtin_ctz(~(digit_mask & span_mask)));
+    size_t frac_digits = 0;
+    if (int_digits < len) {
+        // Exactly one '.', digits on both sides
+        if (p[int_digits] != '.' ||
+            ((digit_mask | (1u << int_digits)) & span_mask) != span_mask ||
+            int_digits + 1 == len) {
+            return false;
+        }
+        frac_digits = len - int_digits - 1;
+        if (frac_digits > 8) {
+            frac_digits = 8;   // Truncate past 10^-8
+        }
+    }
+    if (int_digits == 0 || int_digits > 7) {
+        return false;
+    }
+
+    // Lane i < 8:  byte i - (8 - int_digits)        (negative -> zero)
+    // Lane i >= 8: byte int_digits + 1 + (i - 8)    (past the fraction -> zero)
+    const __m128i lane = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const char n = static_cast<char>(int_digits);
+    const __m128i offset = _mm_setr_epi8(n - 8, n - 8, n - 8, n - 8, n - 8, n - 8, n - 8, n - 8,
+                                         n - 7, n - 7, n - 7, n - 7, n - 7, n - 7, n - 7, n - 7);
+    const __m128i past_fraction = _mm_cmpgt_epi8(lane, _mm_set1_epi8(static_cast<char>(7 + frac_digits)));
+    const __m128i index = _mm_or_si128(_mm_add_epi8(lane, offset),
+                                       _mm_and_si128(past_fraction, _mm_set1_epi8(static_cast<char>(0x80))));
+    const __m128i aligned = _mm_shuffle_epi8(digits, index);
+
+    // 16 digits -> 8 x 2 -> 4 x 4 -> 2 x 8
+    const __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(
+        10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i packed = _mm_packus_epi32(quads, quads);
+    const __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(
+        10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    const uint64_t integer = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    const uint64_t fraction = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+    raw = static_cast<int64_t>(integer * static_cast<uint64_t>(PRICE_SCALE) + fraction);
+    return true;
+}
+#endif
+
+} // namespace detail
+
+// ============================================================================
+// Decimal -> FixedPoint
+// ============================================================================
+
+/**
+ * Convert a decimal string to a FixedPoint raw value (10^8 scale)
+ *
+ * Accepts [-]digits[.digits]. Digits past the 8th decimal are truncated;
+ * exponents, empty parts and trailing bytes are rejected.
+ *
+ * @param buf_end  End of the enclosing buffer: SIMD may read up to here
+ *                 (never past it) while locating the end of the digits
+ * @return false if malformed or out of FixedPoint range
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+bool parse_decimal(const char* p, size_t len, const char* buf_end,
+                   FixedPoint& out) noexcept {
+    // Leaves headroom for any 8-digit fraction
+    constexpr uint64_t MAX_INTEGER_PART =
+        static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / PRICE_SCALE) - 1;
+
+#if defined(__SSE4_1__)
+    int64_t raw;
+    if (len <= 16 && buf_end - p >= 16 && detail::parse_decimal_simd(p, len, raw)) [[likely]] {
+        out = FixedPoint(raw);
+        return true;
+    }
+#endif
+
+    const char* end = p + len;
+    const bool negative = (p < end && *p == '-');
+    p += negative;
+
+    size_t int_digits = detail::digit_run(p, buf_end);
+    if (int_digits > static_cast<size_t>(end - p)) {
+        int_digits = static_cast<size_t>(end - p);
+    }
+    if (int_digits == 0 || int_digits > 16) [[unlikely]] {
+        return false;
+    }
+
+    // Right-align the integer digits in 16 '0's: two SWAR conversions
+    char int_buf[16];
+    std::memset(int_buf, '0', sizeof(int_buf));
+    std::memcpy(int_buf + sizeof(int_buf) - int_digits, p, int_digits);
+    const uint64_t integer = detail::parse_eight_digits(int_buf) * 100000000ULL +
+                             detail::parse_eight_digits(int_buf + 8);
+    p += int_digits;
+
+    uint64_t fraction = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        size_t frac_digits = detail::digit_run(p, buf_end);
+        if (frac_digits > static_cast<size_t>(end - p)) {
+            frac_digits = static_cast<size_t>(end - p);
+        }
+        if (frac_digits == 0) [[unlikely]] {
+            return false;
+        }
+
+        // Left-align in 8 '0's: "5" -> "50000000" is already scaled by 10^8
+        char frac_buf[8];
+        std::memset(frac_buf, '0', sizeof(frac_buf));
+        std::memcpy(frac_buf, p, frac_digits < 8 ? frac_digits : 8);
+        fraction = detail::parse_eight_digits(frac_buf);
+        p += frac_digits;
+    }
+
+    if (p != end || integer > MAX_INTEGER_PART) [[unlikely]] {
+        return false;
+    }
+
+    const int64_t value = static_cast<int64_t>(integer) * PRICE_SCALE +
+                          static_cast<int64_t>(fraction);
+    out = FixedPoint(negative ? -value : value);
+    return true;
+}
+
+// ============================================================================
+// Integers and Event Times
+// ============================================================================
+
+namespace detail {
+
+/**
+ * Plain unsigned decimal of up to 19 digits; 0 if it is anything else
+ */
+SAGE_ALWAYS_INLINE
+uint64_t parse_unsigned(const char* p, size_t len) noexcept {
+    if (len == 0 || len > 19) [[unlikely]] {
+        return 0;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const uint64_t digit = static_cast<uint64_t>(p[i] - '0');
+        if (digit > 9) [[unlikely]] {
+            return 0;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+/**
+ * Fixed-width field of an ISO 8601 timestamp; false on a non-digit
+ */
+SAGE_ALWAYS_INLINE
+bool fixed_digits(const char* p, size_t count, uint32_t& out) noexcept {
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t digit = static_cast<uint32_t>(p[i] - '0');
+        if (digit > 9) [[unlikely]] {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+/**
+ * Days from 1970-01-01 to a proleptic Gregorian date (year >= 1970)
+ */
+SAGE_ALWAYS_INLINE
+constexpr int64_t days_from_civil(uint32_t year, uint32_t month, uint32_t day) noexcept {
+    const int64_t y = static_cast<int64_t>(year) - (month <= 2);
+    const int64_t era = y / 400;
+    const int64_t year_of_era = y - era * 400;
+    const int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+} // namespace detail
+
+/**
+ * "YYYY-MM-DDTHH:MM:SS[.fraction]Z" -> nanoseconds since the epoch
+ * Fraction digits past the 9th are truncated; offsets other than Z are
+ * rejected.
+ * @return 0 if malformed
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+uint64_t parse_iso8601_ns(const char* p, size_t len) noexcept {
+    uint32_t year, month, day, hour, minute, second;
+    if (len < 20 || p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' ||
+        p[16] != ':' || p[len - 1] != 'Z' ||
+        !detail::fixed_digits(p, 4, year) || !detail::fixed_digits(p + 5, 2, month) ||
+        !detail::fixed_digits(p + 8, 2, day) || !detail::fixed_digits(p + 11, 2, hour) ||
+        !detail::fixed_digits(p + 14, 2, minute) || !detail::fixed_digits(p + 17, 2, second) ||
+        year < 1970 || month - 1 > 11 || day - 1 > 30 || hour > 23 || minute > 59 ||
+        second > 60) [[unlikely]] {
+        return 0;
+    }
+
+    uint64_t fraction_ns = 0;
+    if (len > 20) {
+        const size_t digits = len - 21;
+        if (p[19] != '.' || digits == 0) [[unlikely]] {
+            return 0;
+        }
+        uint64_t scale = 100000000;
+        for (size_t i = 0; i < digits; ++i) {
+            const uint64_t digit = static_cast<uint64_t>(p[20 + i] - '0');
+            if (digit > 9) [[unlikely]] {
+                return 0;
+            }
+            fraction_ns += digit * scale;
+            scale /= 10;
+        }
+    }
+
+    const int64_t days = detail::days_from_civil(year, month, day);
+    const uint64_t seconds = static_cast<uint64_t>(days) * 86400 +
+                             hour * 3600ULL + minute * 60ULL + second;
+    return seconds * NANOS_PER_SEC + fraction_ns;
+}
+
+// ============================================================================
+// Venue Schemas
+// ============================================================================
+
+/**
+ * Normalized fields every venue schema maps its keys onto
+ */
+enum class MessageField : uint8_t {
+    EVENT,        // "e" / "type"
+    SYMBOL,       // "s" / "product_id"
+    PRICE,        // "p" / "price"
+    QTY,          // "q" / "size"
+    BID_PRICE,    // "b" / "best_bid"
+    BID_QTY,      // "B" / "best_bid_size"
+    ASK_PRICE,    // "a" / "best_ask" (SEQUENCE in a Binance aggTrade)
+    ASK_QTY,      // "A" / "best_ask_size"
+    SEQUENCE,     // "t" "u" / "trade_id": venue message id (MarketData::venue_seq)
+    EVENT_TIME,   // "E" / "time": venue event time (MarketData::exchange_ts_ns)
+    NONE
+};
+
+enum class EventKind : uint8_t {
+    UNKNOWN, TRADE, QUOTE, DEPTH, BOOK_SNAPSHOT, IGNORED,
+    AGG_TRADE     // A trade whose "a" is its (aggregate) trade id
+};
+
+/**
+ * Keys of depth messages (parse_depth)
+ */
+enum class DepthField : uint8_t {
+    EVENT,        // "e" / "type"
+    SYMBOL,       // "s" / "product_id"
+    FIRST_ID,     // "U": first update id in the message
+    LAST_ID,      // "u": last update id
+    EVENT_TIME,   // "E" / "time"
+    BIDS,         // "b" / "bids": [[price, size], ...]
+    ASKS,         // "a" / "asks"
+    CHANGES,      // "changes": [[side, price, size], ...]
+    NONE
+};
+
+namespace detail {
+
+template<size_t N>
+SAGE_ALWAYS_INLINE bool is(const char* s, size_t length, const char (&literal)[N]) noexcept {
+    return length == N - 1 && std::memcmp(s, literal, N - 1) == 0;
+}
+
+} // namespace detail
+
+/**
+ * A schema provides:
+ *   VENUE            exchange_id stamped on every record (UNKNOWN = inferred)
+ *   UNTYPED_QUOTES   a message without an event field but with every quote
+ *                    field is a quote (Binance spot bookTicker)
+ *   classify_key     key -> MessageField (may set venue when inferring)
+ *   classify_event   event value -> EventKind
+ *   event_time       event time value -> ns since the epoch (0 = none)
+ *   classify_depth_key  key of a depth message -> DepthField
+ */
+struct BinanceSchema {
+    static constexpr ExchangeId VENUE = ExchangeId::BINANCE;
+    static constexpr bool UNTYPED_QUOTES = true;
+
+    SAGE_ALWAYS_INLINE
+    static MessageField classify_key(const char* key, size_t length, ExchangeId&) noexcept {
+        if (length != 1) {
+            return MessageField::NONE;
+        }
+        switch (key[0]) {
+            case 'e': return MessageField::EVENT;
+            case 's': return MessageField::SYMBOL;
+            case 'p': return MessageField::PRICE;
+            case 'q': return MessageField::QTY;
+            case 'b': return MessageField::BID_PRICE;
+            case 'B': return MessageField::BID_QTY;
+            case 'a': return MessageField::ASK_PRICE;
+            case 'A': return MessageField::ASK_QTY;
+            case 't': return MessageField::SEQUENCE;
+            case 'u': return MessageField::SEQUENCE;
+            case 'E': return MessageField::EVENT_TIME;
+            default:  return MessageField::NONE;
+        }
+    }
+
+    SAGE_ALWAYS_INLINE
+    static EventKind classify_event(const char* s, size_t length) noexcept {
+        if (detail::is(s, length, "trade")) {
+            return EventKind::TRADE;
+        }
+        if (detail::is(s, length, "aggTrade")) {
+            return EventKind::AGG_TRADE;
+        }
+        if (detail::is(s, length, "depthUpdate")) {
+            return EventKind::DEPTH;
+        }
+        return detail::is(s, length, "bookTicker") ? EventKind::QUOTE : EventKind::IGNORED;
+    }
+
+    SAGE_ALWAYS_INLINE
+    static DepthField classify_depth_key(const char* key, size_t length, ExchangeId&) noexcept {
+        if (length != 1) {
+            return DepthField::NONE;
+        }
+        switch (key[0]) {
+            case 'e': return DepthField::EVENT;
+            case 's': return DepthField::SYMBOL;
+            case 'U': return DepthField::FIRST_ID;
+            case 'u': return DepthField::LAST_ID;
+            case 'E': return DepthField::EVENT_TIME;
+            case 'b': return DepthField::BIDS;
+            case 'a': return DepthField::ASKS;
+            default:  return DepthField::NONE;
+        }
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t event_time(const char* s, size_t length) noexcept {
+        return detail::parse_unsigned(s, length) * 1000000;   // Epoch milliseconds
+    }
+};
+
+struct CoinbaseSchema {
+    static constexpr ExchangeId VENUE = ExchangeId::COINBASE;
+    static constexpr bool UNTYPED_QUOTES = false;
+
+    SAGE_ALWAYS_INLINE
+    static MessageField classify_key(const char* key, size_t length, ExchangeId&) noexcept {
+        switch (length) {
+            case 4:
+                if (detail::is(key, length, "type")) return MessageField::EVENT;
+                if (detail::is(key, length, "size")) return MessageField::QTY;
+                if (detail::is(key, length, "time")) return MessageField::EVENT_TIME;
+                return MessageField::NONE;
+            case 5:
+                return detail::is(key, length, "price") ? MessageField::PRICE : MessageField::NONE;
+            case 8:
+                if (detail::is(key, length, "best_bid")) return MessageField::BID_PRICE;
+                if (detail::is(key, length, "best_ask")) return MessageField::ASK_PRICE;
+                if (detail::is(key, length, "trade_id")) return MessageField::SEQUENCE;
+                return MessageField::NONE;
+            case 10:
+                return detail::is(key, length, "product_id") ? MessageField::SYMBOL
+                                                             : MessageField::NONE;
+            case 13:
+                if (detail::is(key, length, "best_bid_size")) return MessageField::BID_QTY;
+                if (detail::is(key, length, "best_ask_size")) return MessageField::ASK_QTY;
+                return MessageField::NONE;
+            default:
+                return MessageField::NONE;
+        }
+    }
+
+    SAGE_ALWAYS_INLINE
+    static EventKind classify_event(const char* s, size_t length) noexcept {
+        if (detail::is(s, length, "match") || detail::is(s, length, "last_match")) {
+            return EventKind::TRADE;
+        }
+        if (detail::is(s, length, "l2update")) {
+            return EventKind::DEPTH;
+        }
+        if (detail::is(s, length, "snapshot")) {
+            return EventKind::BOOK_SNAPSHOT;
+        }
+        return detail::is(s, length, "ticker") ? EventKind::QUOTE : EventKind::IGNORED;
+    }
+
+    SAGE_ALWAYS_INLINE
+    static DepthField classify_depth_key(const char* key, size_t length, ExchangeId&) noexcept {
+        switch (length) {
+            case 4:
+                if (detail::is(key, length, "type")) return DepthField::EVENT;
+                if (detail::is(key, length, "bids")) return DepthField::BIDS;
+                if (detail::is(key, length, "asks")) return DepthField::ASKS;
+                return detail::is(key, length, "time") ? DepthField::EVENT_TIME : DepthField::NONE;
+            case 7:
+                return detail::is(key, length, "changes") ? DepthField::CHANGES : DepthField::NONE;
+            case 10:
+                return detail::is(key, length, "product_id") ? DepthField::SYMBOL : DepthField::NONE;
+            default:
+                return DepthField::NONE;
+        }
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t event_time(const char* s, size_t length) noexcept {
+        return parse_iso8601_ns(s, length);
+    }
+};
+
+/**
+ * Either venue; the symbol key decides which one a message came from
+ */
+struct AnyVenueSchema {
+    static constexpr ExchangeId VENUE = ExchangeId::UNKNOWN;
+    static constexpr bool UNTYPED_QUOTES = true;
+
+    SAGE_ALWAYS_INLINE
+    static MessageField classify_key(const char* key, size_t length, ExchangeId& venue) noexcept {
+        const MessageField field = (length == 1)
+            ? BinanceSchema::classify_key(key, length, venue)
+            : CoinbaseSchema::classify_key(key, length, venue);
+        if (field == MessageField::SYMBOL) {
+            venue = (length == 1) ? ExchangeId::BINANCE : ExchangeId::COINBASE;
+        }
+        return field;
+    }
+
+    SAGE_ALWAYS_INLINE
+    static EventKind classify_event(const char* s, size_t length) noexcept {
+        const EventKind kind = BinanceSchema::classify_event(s, length);
+        return kind != EventKind::IGNORED ? kind : CoinbaseSchema::classify_event(s, length);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t event_time(const char* s, size_t length) noexcept {
+        return (length > 10 && s[10] == 'T') ? CoinbaseSchema::event_time(s, length)
+                                             : BinanceSchema::event_time(s, length);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static DepthField classify_depth_key(const char* key, size_t length, ExchangeId& venue) noexcept {
+        const DepthField field = (length == 1)
+            ? BinanceSchema::classify_depth_key(key, length, venue)
+            : CoinbaseSchema::classify_depth_key(key, length, venue);
+        if (field == DepthField::SYMBOL) {
+            venue = (length == 1) ? ExchangeId::BINANCE : ExchangeId::COINBASE;
+        }
+        return field;
+    }
+};
+
+template<ExchangeId Venue> struct VenueSchemaFor;
+template<> struct VenueSchemaFor<ExchangeId::BINANCE> { using type = BinanceSchema; };
+template<> struct VenueSchemaFor<ExchangeId::COINBASE> { using type = CoinbaseSchema; };
+
+// ============================================================================
+// Parser
+// ============================================================================
+
+enum class ParseStatus : uint8_t {
+    TRADE,            // records[0] = trade
+    QUOTE,            // records[0] = bid, records[1] = ask
+    IGNORED,          // Well-formed but not a trade/quote (acks, heartbeats)
+    MALFORMED,        // Truncated JSON, missing or unparseable fields
+    UNKNOWN_SYMBOL,   // Symbol not registered
+    DEPTH             // Depth update or book snapshot: read it with parse_depth()
+};
+
+struct ParsedMessage {
+    static constexpr size_t MAX_RECORDS = 2;
+
+    MarketData records[MAX_RECORDS];
+    uint32_t count;
+};
+
+/**
+ * A depth update or book snapshot located by parse_depth()
+ *
+ * for_each() yields its levels as MarketData: flags MD_FLAG_DEPTH plus
+ * MD_FLAG_BID / MD_FLAG_ASK, quantity = the level's new size (0 = the
+ * level is gone), venue_seq = last_id. The first level of a snapshot also
+ * carries MD_FLAG_BOOK_RESET. Levels point into the parsed buffer, which
+ * must outlive the call.
+ */
+struct DepthMessage {
+    uint32_t symbol_id;
+    ExchangeId venue;
+    bool snapshot;            // Full book image (replace), else changed levels
+    uint64_t first_id;        // First update id covered (Binance "U"; 0 = none)
+    uint64_t last_id;         // Last update id covered (Binance "u"; 0 = none)
+    uint64_t event_ns;        // Venue event time (0 = none)
+
+    const char* bids;         // '[' of each level array (nullptr = absent)
+    const char* asks;
+    const char* changes;
+    const char* end;
+
+    /**
+     * @param emit  void(MarketData&) per level, bids before asks
+     * @return Levels emitted, or -1 if an array is malformed (levels
+     *         before it were already emitted)
+     */
+    template<typename Emit>
+    SAGE_HOT
+    int for_each(Emit&& emit) const noexcept {
+        int emitted = 0;
+        uint16_t reset = snapshot ? MD_FLAG_BOOK_RESET : 0;
+        const char* arrays[3] = {bids, asks, changes};
+        for (size_t a = 0; a < 3; ++a) {
+            const char* p = arrays[a];
+            if (p == nullptr) {
+                continue;
+            }
+            ++p;   // Outer '['
+            for (;;) {
+                p = detail::skip_whitespace(p, end);
+                if (p == end) [[unlikely]] {
+                    return -1;
+                }
+                if (*p == ']') {
+                    break;
+                }
+                if (*p == ',') {
+                    ++p;
+                    continue;
+                }
+
+                // One level: [price, size] or [side, price, size]
+                struct { const char* data; size_t length; } fields[3];
+                size_t count = 0;
+                if (*p != '[' || !level_fields(p, fields, count)) [[unlikely]] {
+                    return -1;
+                }
+                const size_t first = (a == 2) ? 1 : 0;
+                if (count < first + 2) [[unlikely]] {
+                    return -1;
+                }
+                uint16_t side = (a == 0) ? MD_FLAG_BID : MD_FLAG_ASK;
+                if (a == 2) {
+                    if (detail::is(fields[0].data, fields[0].length, "buy")) {
+                        side = MD_FLAG_BID;
+                    } else if (!detail::is(fields[0].data, fields[0].length, "sell")) [[unlikely]] {
+                        return -1;
+                    }
+                }
+
+                MarketData level{};
+                if (!parse_decimal(fields[first].data, fields[first].length, end, level.price) ||
+                    !parse_decimal(fields[first + 1].data, fields[first + 1].length, end,
+                                   level.quantity)) [[unlikely]] {
+                    return -1;
+                }
+                level.symbol_id = symbol_id;
+                level.flags = static_cast<uint16_t>(MD_FLAG_DEPTH | side | reset);
+                level.exchange_id = static_cast<uint8_t>(venue);
+                level.venue_seq = last_id;
+                level.exchange_ts_ns = event_ns;
+                reset = 0;
+                emit(level);
+                ++emitted;
+            }
+        }
+        return emitted;
+    }
+
+private:
+    /**
+     * Strings (or bare tokens) of one "[...]" level; p ends past its ']'
+     */
+    template<typename Field>
+    SAGE_ALWAYS_INLINE
+    bool level_fields(const char*& p, Field (&fields)[3], size_t& count) const noexcept {
+        ++p;
+        for (;;) {
+            p = detail::skip_whitespace(p, end);
+            if (p == end) {
+                return false;
+            }
+            if (*p == ']') {
+                ++p;
+                return true;
+            }
+            if (*p == ',') {
+                ++p;
+                continue;
+            }
+            const char* start = p;
+            if (*p == '"') {
+                start = p + 1;
+                const char* close = static_cast<const char*>(
+                    std::memchr(start, '"', static_cast<size_t>(end - start)));
+                if (close == nullptr) {
+                    return false;
+                }
+                p = close + 1;
+                if (count < 3) {
+                    fields[count++] = {start, static_cast<size_t>(close - start)};
+                }
+                continue;
+            }
+            while (p < end && *p != ',' && *p != ']') {
+                ++p;
+            }
+            if (count < 3) {
+                fields[count++] = {start, static_cast<size_t>(p - start)};
+            }
+        }
+    }
+};
+
+template<typename Schema>
+class BasicJsonParser {
 public:
-    JsonParser() {
-        // parser_ = new simdjson::ondemand::parser();
-    }
-    
-    ~JsonParser() {
-        // delete parser_;
-    }
-
-    // Zero-copy parsing of raw buffer
-    // Returns std::nullopt if parse fails or validation fails
-    std::optional<MarketData> parse_trade(const char* json, size_t len) {
-        // Mock implementation for the "planning/structure" phase
-        // Real implementation would look like:
-        /*
-        simdjson::padded_string json_padded(json, len);
-        auto doc = parser_->iterate(json_padded);
-        double price = doc["p"].get_double();
-        double qty = doc["q"].get_double();
-        uint64_t sym = doc["s"].get_uint64();
-        
-        if (!Validator::is_safe_float(price) || !Validator::is_safe_float(qty)) {
+    static constexpr ExchangeId VENUE = Schema::VENUE;
+
+    /**
+     * Register a venue symbol name (startup only; rebuilds the hash)
+     * @return false if the name is too long, the id is not below
+     *         SymbolInterner::MAX_SYMBOL_ID, the table is full or the
+     *         hash could not be rebuilt with it (see SymbolInterner::add)
+     */
+    SAGE_COLD
+    bool add_symbol(std::string_view name, uint32_t symbol_id) noexcept {
+        return symbols_.add(Schema::VENUE, name, symbol_id);
+    }
+
+    const SymbolInterner& symbols() const noexcept { return symbols_; }
+
+    /**
+     * Parse one exchange message in place (zero-copy, no allocation)
+     * Reads only [json, json + len).
+     */
+    SAGE_HOT
+    ParseStatus parse(const char* json, size_t len, ParsedMessage& out) const noexcept {
+        const char* const end = json + len;
+        Span spans[FIELD_COUNT];
+        uint32_t seen = 0;
+        Kind kind = Kind::UNKNOWN;
+        bool aggregate = false;    // aggTrade: "a" is the trade id
+        ExchangeId venue = Schema::VENUE;
+        out.count = 0;
+
+        detail::QuoteIndex quotes(json, end);
+        const char* p = json;
+        for (;;) {
+            // Next string; it is a key iff a ':' follows
+            const char* key = quotes.next();
+            if (key == end) {
+                break;
+            }
+            ++key;
+            const char* key_end = quotes.string_end(key);
+            if (key_end == end) [[unlikely]] {
+                return ParseStatus::MALFORMED;
+            }
+            p = detail::skip_whitespace(key_end + 1, end);
+            if (p == end || *p != ':') {
+                continue;
+            }
+            ++p;
+
+            Field field = Schema::classify_key(key, static_cast<size_t>(key_end - key), venue);
+            if (field == Field::NONE) {
+                continue;   // A string value is popped as a non-key next round
+            }
+            if (field == Field::ASK_PRICE && aggregate) {
+                field = Field::SEQUENCE;
+            }
+
+            Span value;
+            if (!read_value(p, end, quotes, value)) [[unlikely]] {
+                return ParseStatus::MALFORMED;
+            }
+
+            const uint32_t index = static_cast<uint32_t>(field);
+            spans[index] = value;
+            seen |= 1u << index;
+
+            if (field == Field::EVENT) {
+                kind = Schema::classify_event(value.data, value.length);
+                if (kind == Kind::AGG_TRADE) {
+                    aggregate = true;
+                    kind = Kind::TRADE;
+                }
+                if (kind == Kind::IGNORED) {
+                    return ParseStatus::IGNORED;
+                }
+                if (kind == Kind::DEPTH || kind == Kind::BOOK_SNAPSHOT) {
+                    return ParseStatus::DEPTH;
+                }
+            }
+
+            // Stop as soon as everything this message needs is in hand
+            // (including its venue id and event time, if it has them)
+            if ((kind == Kind::TRADE && (seen & TRADE_STOP) == TRADE_STOP) ||
+                (kind == Kind::QUOTE && (seen & QUOTE_STOP) == QUOTE_STOP)) {
+                break;
+            }
+        }
+
+        // Binance spot bookTicker carries no event type
+        if (kind == Kind::UNKNOWN) {
+            if (!Schema::UNTYPED_QUOTES || (seen & QUOTE_FIELDS) != QUOTE_FIELDS) {
+                return ParseStatus::IGNORED;
+            }
+            kind = Kind::QUOTE;
+        }
+
+        // An "a" read before the event type was the aggTrade id all along
+        constexpr uint32_t ASK = 1u << static_cast<uint32_t>(Field::ASK_PRICE);
+        constexpr uint32_t SEQUENCE = 1u << static_cast<uint32_t>(Field::SEQUENCE);
+        if (aggregate && (seen & (ASK | SEQUENCE)) == ASK) {
+            spans[static_cast<uint32_t>(Field::SEQUENCE)] = spans[static_cast<uint32_t>(Field::ASK_PRICE)];
+            seen = (seen & ~ASK) | SEQUENCE;
+        }
+
+        const uint32_t required = (kind == Kind::TRADE) ? TRADE_FIELDS : QUOTE_FIELDS;
+        if ((seen & required) != required) [[unlikely]] {
+            return ParseStatus::MALFORMED;
+        }
+
+        const Span& symbol = spans[static_cast<uint32_t>(Field::SYMBOL)];
+        uint32_t symbol_id;
+        if (!symbols_.find(Schema::VENUE, symbol.data, symbol.length, end, symbol_id)) [[unlikely]] {
+            return ParseStatus::UNKNOWN_SYMBOL;
+        }
+
+        const uint64_t sequence = (seen & (1u << static_cast<uint32_t>(Field::SEQUENCE)))
+            ? parse_sequence(spans[static_cast<uint32_t>(Field::SEQUENCE)]) : 0;
+        const Span& time = spans[static_cast<uint32_t>(Field::EVENT_TIME)];
+        const uint64_t event_ns = (seen & (1u << static_cast<uint32_t>(Field::EVENT_TIME)))
+            ? Schema::event_time(time.data, time.length) : 0;
+
+        if (kind == Kind::TRADE) {
+            if (!make_record(spans, Field::PRICE, Field::QTY, end, symbol_id, MD_FLAG_TRADE,
+                             venue, sequence, event_ns, out.records[0])) [[unlikely]] {
+                return ParseStatus::MALFORMED;
+            }
+            out.count = 1;
+            return ParseStatus::TRADE;
+        }
+
+        if (!make_record(spans, Field::BID_PRICE, Field::BID_QTY, end, symbol_id,
+                         MD_FLAG_BID, venue, sequence, event_ns, out.records[0]) ||
+            !make_record(spans, Field::ASK_PRICE, Field::ASK_QTY, end, symbol_id,
+                         MD_FLAG_ASK, venue, sequence, event_ns, out.records[1])) [[unlikely]] {
+            return ParseStatus::MALFORMED;
+        }
+        out.count = 2;
+        return ParseStatus::QUOTE;
+    }
+
+    /**
+     * Trades only (quotes and everything else -> nullopt)
+     */
+    SAGE_HOT
+    std::optional<MarketData> parse_trade(const char* json, size_t len) const noexcept {
+        ParsedMessage msg;
+        if (parse(json, len, msg) != ParseStatus::TRADE) {
             return std::nullopt;
         }
+        return msg.records[0];
+    }
+
+    /**
+     * Locate a depth message's header fields and level arrays (no levels
+     * are converted until out.for_each())
+     * @return DEPTH, IGNORED, MALFORMED or UNKNOWN_SYMBOL
+     */
+    SAGE_HOT
+    ParseStatus parse_depth(const char* json, size_t len, DepthMessage& out) const noexcept {
+        const char* const end = json + len;
+        out = DepthMessage{};
+        out.end = end;
+        Span symbol{nullptr, 0};
+        Kind kind = Kind::UNKNOWN;
+        ExchangeId venue = Schema::VENUE;
+
+        detail::QuoteIndex quotes(json, end);
+        for (;;) {
+            // Same key walk as parse(); strings inside the level arrays are
+            // never followed by ':' and fall through as non-keys
+            const char* key = quotes.next();
+            if (key == end) {
+                break;
+            }
+            ++key;
+            const char* key_end = quotes.string_end(key);
+            if (key_end == end) [[unlikely]] {
+                return ParseStatus::MALFORMED;
+            }
+            const char* p = detail::skip_whitespace(key_end + 1, end);
+            if (p == end || *p != ':') {
+                continue;
+            }
+            ++p;
+
+            const DepthField field =
+                Schema::classify_depth_key(key, static_cast<size_t>(key_end - key), venue);
+            if (field == DepthField::NONE) {
+                continue;
+            }
+            if (field == DepthField::BIDS || field == DepthField::ASKS ||
+                field == DepthField::CHANGES) {
+                p = detail::skip_whitespace(p, end);
+                if (p == end || *p != '[') [[unlikely]] {
+                    return ParseStatus::MALFORMED;
+                }
+                (field == DepthField::BIDS ? out.bids
+                    : field == DepthField::ASKS ? out.asks : out.changes) = p;
+                continue;
+            }
+
+            Span value;
+            if (!read_value(p, end, quotes, value)) [[unlikely]] {
+                return ParseStatus::MALFORMED;
+            }
+            switch (field) {
+                case DepthField::EVENT:
+                    kind = Schema::classify_event(value.data, value.length);
+                    if (kind != Kind::DEPTH && kind != Kind::BOOK_SNAPSHOT) {
+                        return ParseStatus::IGNORED;
+                    }
+                    break;
+                case DepthField::SYMBOL:     symbol = value; break;
+                case DepthField::FIRST_ID:   out.first_id = parse_sequence(value); break;
+                case DepthField::LAST_ID:    out.last_id = parse_sequence(value); break;
+                case DepthField::EVENT_TIME:
+                    out.event_ns = Schema::event_time(value.data, value.length);
+                    break;
+                default: break;
+            }
+        }
 
-        return MarketData{
-            .price = FixedPoint::from_double(price),
-            .qty = FixedPoint::from_double(qty),
-            .symbol_id = sym
-        };
-        */
-        
-        // For now, return a dummy to allow compilation without deps
-         return std::nullopt; 
+        if (kind != Kind::DEPTH && kind != Kind::BOOK_SNAPSHOT) {
+            return ParseStatus::IGNORED;
+        }
+        if (symbol.data == nullptr ||
+            (out.bids == nullptr && out.asks == nullptr && out.changes == nullptr)) [[unlikely]] {
+            return ParseStatus::MALFORMED;
+        }
+        if (!symbols_.find(Schema::VENUE, symbol.data, symbol.length, end, out.symbol_id)) [[unlikely]] {
+            return ParseStatus::UNKNOWN_SYMBOL;
+        }
+        out.venue = venue;
+        out.snapshot = (kind == Kind::BOOK_SNAPSHOT);
+        return ParseStatus::DEPTH;
     }
 
 private:
-   // simdjson::ondemand::parser* parser_;
+    using Field = MessageField;
+    using Kind = EventKind;
+    static constexpr size_t FIELD_COUNT = static_cast<size_t>(Field::NONE);
+
+#define SAGE_FIELD_BIT(f) (1u << static_cast<uint32_t>(Field::f))
+    static constexpr uint32_t TRADE_FIELDS =
+        SAGE_FIELD_BIT(SYMBOL) | SAGE_FIELD_BIT(PRICE) | SAGE_FIELD_BIT(QTY);
+    static constexpr uint32_t QUOTE_FIELDS =
+        SAGE_FIELD_BIT(SYMBOL) | SAGE_FIELD_BIT(BID_PRICE) | SAGE_FIELD_BIT(BID_QTY) |
+        SAGE_FIELD_BIT(ASK_PRICE) | SAGE_FIELD_BIT(ASK_QTY);
+    static constexpr uint32_t TRADE_STOP =
+        TRADE_FIELDS | SAGE_FIELD_BIT(SEQUENCE) | SAGE_FIELD_BIT(EVENT_TIME);
+    static constexpr uint32_t QUOTE_STOP =
+        QUOTE_FIELDS | SAGE_FIELD_BIT(SEQUENCE) | SAGE_FIELD_BIT(EVENT_TIME);
+#undef SAGE_FIELD_BIT
+
+    struct Span {
+        const char* data;
+        size_t length;
+    };
+
+    /**
+     * Value after a key: quoted string (contents) or bare token
+     * p starts after the ':' and ends past the value.
+     */
+    SAGE_ALWAYS_INLINE
+    static bool read_value(const char*& p, const char* end, detail::QuoteIndex& quotes,
+                           Span& value) noexcept {
+        p = detail::skip_whitespace(p, end);
+        if (p < end && *p == '"') {
+            quotes.next();   // The opening quote at p
+            value.data = p + 1;
+            const char* value_end = quotes.string_end(value.data);
+            if (value_end == end) [[unlikely]] {
+                return false;
+            }
+            value.length = static_cast<size_t>(value_end - value.data);
+            p = value_end + 1;
+            return true;
+        }
+        value.data = p;
+        while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+               *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') {
+            ++p;
+        }
+        value.length = static_cast<size_t>(p - value.data);
+        return true;
+    }
+
+    /**
+     * Venue message id; 0 (none) if it is not a plain unsigned integer
+     */
+    SAGE_ALWAYS_INLINE
+    static uint64_t parse_sequence(const Span& span) noexcept {
+        return detail::parse_unsigned(span.data, span.length);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static bool make_record(const Span* spans, Field price_field, Field qty_field,
+                            const char* buf_end, uint32_t symbol_id, uint16_t flags,
+                            ExchangeId venue, uint64_t sequence, uint64_t event_ns,
+                            MarketData& out) noexcept {
+        const Span& price = spans[static_cast<uint32_t>(price_field)];
+        const Span& qty = spans[static_cast<uint32_t>(qty_field)];
+        out = MarketData{};
+        out.symbol_id = symbol_id;
+        out.flags = flags;
+        out.exchange_id = static_cast<uint8_t>(venue);
+        out.venue_seq = sequence;
+        out.exchange_ts_ns = event_ns;
+        return parse_decimal(price.data, price.length, buf_end, out.price) &&
+               parse_decimal(qty.data, qty.length, buf_end, out.quantity);
+    }
+
+    SymbolInterner symbols_;
 };
 
+using JsonParser = BasicJsonParser<AnyVenueSchema>;
+using BinanceParser = BasicJsonParser<BinanceSchema>;
+using CoinbaseParser = BasicJsonParser<CoinbaseSchema>;
+
+template<ExchangeId Venue>
+using VenueParser = BasicJsonParser<typename VenueSchemaFor<Venue>::type>;
+
 } // namespace cal
 } // namespace sage
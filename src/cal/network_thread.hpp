@@ -0,0 +1,495 @@
+#pragma once
+
+/**
+ * SAGE CAL Network Thread
+ * Drives many WebSocket connections from one thread, on either backend:
+ *
+ * - EPOLL:    one shared epoll set; a ready socket is drained with
+ *             non-blocking recv until EAGAIN (one syscall per read, plus
+ *             the epoll_wait itself)
+ * - IO_URING: one multishot recv per socket into a registered
+ *             provided-buffer ring; completions are reaped from shared
+ *             memory, so a busy-polling thread makes no syscalls at all
+ *             while data flows (optionally SQPOLL for submissions too).
+ *             A socket with receive timestamps gets a multishot recvmsg
+ *             instead, so each buffer also carries its control data.
+ *
+ * The backend is chosen at runtime. IO_URING falls back to EPOLL when the
+ * kernel, sysctl or seccomp policy refuses it; backend() reports what is
+ * actually in use.
+ *
+ * Either way every message reaches the client's handler (parse ->
+ * validate -> try_push in CAL) on this thread, decoded in place.
+ * Reconnects happen inline on the same thread with per-connection
+ * exponential backoff; a reconnect blocks the loop for up to the
+ * client's connect_timeout_ms.
+ *
+ * Usage:
+ *   NetworkThread<Client> net(config);
+ *   net.add(binance);
+ *   net.add(coinbase);
+ *   net.start();        // or init() + poll() on the caller's thread
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <sys/epoll.h>
+
+#include "../core/compiler.hpp"
+#include "../core/cpu_affinity.hpp"
+#include "io_uring.hpp"
+#include "websocket_client.hpp"
+
+namespace sage {
+namespace cal {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+enum class IoBackend : uint8_t {
+    EPOLL,
+    IO_URING
+};
+
+inline const char* to_string(IoBackend backend) noexcept {
+    return backend == IoBackend::IO_URING ? "io_uring" : "epoll";
+}
+
+/**
+ * "epoll" / "io_uring" (also "uring"); anything else -> false
+ */
+inline bool parse_io_backend(const char* name, IoBackend& out) noexcept {
+    if (name == nullptr) {
+        return false;
+    }
+    if (std::strcmp(name, "epoll") == 0) {
+        out = IoBackend::EPOLL;
+        return true;
+    }
+    if (std::strcmp(name, "io_uring") == 0 || std::strcmp(name, "uring") == 0) {
+        out = IoBackend::IO_URING;
+        return true;
+    }
+    return false;
+}
+
+struct NetworkConfig {
+    IoBackend backend = IoBackend::EPOLL;
+    bool busy_poll = true;           // Spin without blocking in the kernel
+    int poll_timeout_ms = 100;       // Blocking wait when not busy-polling
+    int cpu_core = -1;               // Pin the thread started by start()
+    int max_backoff_ms = 30000;      // Reconnect backoff cap
+
+    // IO_URING only
+    bool sqpoll = false;             // Kernel SQ polling thread
+    int sqpoll_cpu = -1;
+    uint32_t buffer_count = 256;     // Provided buffers (power of two)
+    uint32_t buffer_size = 16384;    // Bytes per provided buffer
+};
+
+/**
+ * Loop counters (written by the network thread, readable from any thread)
+ */
+struct NetworkStats {
+    std::atomic<uint64_t> loops{0};
+    std::atomic<uint64_t> wakeups{0};        // epoll events / recv CQEs
+    std::atomic<uint64_t> rearms{0};         // Multishot recv re-submitted
+    std::atomic<uint64_t> buffer_stalls{0};  // -ENOBUFS: provided buffers ran out
+    std::atomic<uint64_t> disconnects{0};
+};
+
+// ============================================================================
+// Network Thread
+// ============================================================================
+
+/**
+ * @tparam Client          WebSocketClient<...> (connect/drain/ingest/close)
+ * @tparam MaxConnections  Fixed connection table size
+ */
+template<typename Client, size_t MaxConnections = 32>
+class NetworkThread {
+public:
+    explicit NetworkThread(NetworkConfig config) : config_(config) {}
+
+    ~NetworkThread() {
+        stop();
+        shutdown();
+    }
+
+    NetworkThread(const NetworkThread&) = delete;
+    NetworkThread& operator=(const NetworkThread&) = delete;
+
+    /**
+     * Register a connection (before init()/start()); not owned
+     */
+    SAGE_COLD
+    bool add(Client& client) noexcept {
+        if (count_ >= MaxConnections || initialized_) {
+            return false;
+        }
+        slots_[count_++].client = &client;
+        ++disconnected_;
+        return true;
+    }
+
+    /**
+     * Set up the requested backend, falling back to epoll
+     * @return false only if no backend could be set up
+     */
+    SAGE_COLD
+    bool init() noexcept {
+        if (initialized_) {
+            return true;
+        }
+        backend_ = config_.backend;
+        if (backend_ == IoBackend::IO_URING && !init_uring()) {
+            fallback_reason_ = ring_.last_error();
+            ring_.close();
+            backend_ = IoBackend::EPOLL;
+        }
+        if (backend_ == IoBackend::EPOLL) {
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd_ < 0) {
+                return false;
+            }
+        }
+        initialized_ = true;
+        return true;
+    }
+
+    /**
+     * Drop every connection and release the backend
+     */
+    SAGE_COLD
+    void shutdown() noexcept {
+        for (size_t i = 0; i < count_; ++i) {
+            Slot& slot = slots_[i];
+            if (slot.client->connected()) {
+                slot.client->disconnect();
+            }
+            slot.live = false;
+            slot.backoff_ms = 100;
+            slot.retry_at = {};
+        }
+        disconnected_ = count_;
+        ring_.close();
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+        initialized_ = false;
+    }
+
+    // ========================================================================
+    // Threaded Operation
+    // ========================================================================
+
+    void start() {
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] {
+            if (config_.cpu_core >= 0) {
+                cpu::pin_to_core(config_.cpu_core);
+            }
+            if (!init()) {
+                return;
+            }
+            const int timeout_ms = config_.busy_poll ? 0 : config_.poll_timeout_ms;
+            while (running_.load(std::memory_order_acquire)) {
+                poll(timeout_ms);
+                if (disconnected_ == count_) [[unlikely]] {
+                    // Nothing to spin on until a reconnect is due
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+            shutdown();
+        });
+    }
+
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // ========================================================================
+    // Single-Step Operation
+    // ========================================================================
+
+    /**
+     * Reconnect what is due, wait up to timeout_ms, dispatch everything
+     * ready, then tick() every client (timers that must run without data)
+     * @return Messages delivered
+     */
+    SAGE_HOT
+    int poll(int timeout_ms) noexcept {
+        bump(stats_.loops);
+
+        if (disconnected_ > 0) [[unlikely]] {
+            reconnect_due();
+        }
+        const int delivered = backend_ == IoBackend::IO_URING ? poll_uring(timeout_ms)
+                                                              : poll_epoll(timeout_ms);
+        for (size_t i = 0; i < count_; ++i) {
+            slots_[i].client->tick();
+        }
+        return delivered;
+    }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
+    IoBackend backend() const noexcept { return backend_; }
+    const char* fallback_reason() const noexcept { return fallback_reason_; }
+    size_t connections() const noexcept { return count_; }
+    const NetworkStats& stats() const noexcept { return stats_; }
+
+    // io_uring provided buffers (empty on epoll), for MemoryProvisioner
+    uint8_t* buffer_memory() noexcept { return ring_.buffer_memory(); }
+    size_t buffer_memory_size() const noexcept { return ring_.buffer_memory_size(); }
+
+private:
+    static constexpr uint16_t BUFFER_GROUP = 0;
+    static constexpr uint64_t CANCEL_TAG = ~0ULL;
+
+    struct Slot {
+        Client* client{nullptr};
+        uint32_t generation{0};      // Tags CQEs so stale ones are ignored
+        bool live{false};
+        bool recvmsg{false};         // Armed with recvmsg (receive timestamps)
+        msghdr message{};            // recvmsg template (control area size)
+        int backoff_ms{100};
+        std::chrono::steady_clock::time_point retry_at{};
+    };
+
+    SAGE_ALWAYS_INLINE static void bump(std::atomic<uint64_t>& counter) noexcept {
+        WebSocketStats::bump(counter);
+    }
+
+    // ========================================================================
+    // Connection Management (cold)
+    // ========================================================================
+
+    SAGE_COLD
+    void reconnect_due() noexcept {
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count_; ++i) {
+            Slot& slot = slots_[i];
+            if (slot.live || now < slot.retry_at) {
+                continue;
+            }
+            if (!slot.client->connect()) {
+                slot.retry_at = now + std::chrono::milliseconds(slot.backoff_ms);
+                slot.backoff_ms = std::min(slot.backoff_ms * 2, config_.max_backoff_ms);
+                continue;
+            }
+            slot.backoff_ms = 100;
+            if (!attach(i)) {
+                slot.client->close();
+                slot.retry_at = now + std::chrono::milliseconds(slot.backoff_ms);
+            }
+        }
+    }
+
+    /**
+     * Register a freshly connected socket with the backend
+     */
+    SAGE_COLD
+    bool attach(size_t index) noexcept {
+        Slot& slot = slots_[index];
+        ++slot.generation;
+
+        if (backend_ == IoBackend::IO_URING) {
+            if (!arm(index)) {
+                return false;
+            }
+            ring_.submit();
+        } else {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = index;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, slot.client->fd(), &ev) != 0) {
+                return false;
+            }
+        }
+        slot.live = true;
+        --disconnected_;
+
+        // Frames that arrived with the handshake response
+        if (slot.client->ingest(nullptr, 0) < 0) {
+            detach(index);
+        }
+        return true;
+    }
+
+    SAGE_COLD
+    void detach(size_t index) noexcept {
+        Slot& slot = slots_[index];
+        if (!slot.live) {
+            return;
+        }
+        if (backend_ == IoBackend::IO_URING) {
+            if (io_uring_sqe* sqe = ring_.get_sqe()) {
+                ring_.prep_cancel(sqe, tag(index), CANCEL_TAG);
+                ring_.submit();
+            }
+        } else {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, slot.client->fd(), nullptr);
+        }
+        slot.client->close();
+        slot.live = false;
+        slot.retry_at = std::chrono::steady_clock::now();
+        ++disconnected_;
+        bump(stats_.disconnects);
+        WebSocketStats::bump(slot.client->stats().reconnects);
+    }
+
+    // ========================================================================
+    // EPOLL Backend
+    // ========================================================================
+
+    SAGE_HOT
+    int poll_epoll(int timeout_ms) noexcept {
+        epoll_event events[MaxConnections];
+        const int ready = epoll_wait(epoll_fd_, events, static_cast<int>(MaxConnections), timeout_ms);
+
+        int delivered = 0;
+        for (int i = 0; i < ready; ++i) {
+            const size_t index = static_cast<size_t>(events[i].data.u64);
+            bump(stats_.wakeups);
+            const int n = slots_[index].client->drain();
+            if (n < 0) [[unlikely]] {
+                detach(index);
+                continue;
+            }
+            delivered += n;
+        }
+        return delivered;
+    }
+
+    // ========================================================================
+    // IO_URING Backend
+    // ========================================================================
+
+    SAGE_COLD
+    bool init_uring() noexcept {
+        IoUringConfig ring_config;
+        ring_config.entries = 2 * static_cast<unsigned>(MaxConnections);
+        ring_config.sqpoll = config_.sqpoll;
+        ring_config.sqpoll_cpu = config_.sqpoll_cpu;
+        return ring_.init(ring_config) &&
+               ring_.setup_buffers(BUFFER_GROUP, config_.buffer_count, config_.buffer_size);
+    }
+
+    SAGE_ALWAYS_INLINE uint64_t tag(size_t index) const noexcept {
+        return (static_cast<uint64_t>(slots_[index].generation) << 32) | index;
+    }
+
+    bool arm(size_t index) noexcept {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        if (sqe == nullptr) [[unlikely]] {
+            return false;
+        }
+        Slot& slot = slots_[index];
+        slot.recvmsg = slot.client->rx_timestamps();
+        if (slot.recvmsg) {
+            slot.message = msghdr{};
+            slot.message.msg_controllen = RX_CONTROL_SIZE;
+            ring_.prep_recvmsg_multishot(sqe, slot.client->fd(), &slot.message, tag(index));
+        } else {
+            ring_.prep_recv_multishot(sqe, slot.client->fd(), tag(index));
+        }
+        return true;
+    }
+
+    SAGE_HOT
+    int poll_uring(int timeout_ms) noexcept {
+        ring_.submit(timeout_ms);
+
+        int delivered = 0;
+        bool rearmed = false;
+        ring_.drain_completions([&](const io_uring_cqe& cqe) {
+            if (cqe.user_data == CANCEL_TAG) {
+                return;
+            }
+            const size_t index = static_cast<size_t>(cqe.user_data & 0xFFFFFFFFu);
+            Slot& slot = slots_[index];
+            const bool current = slot.live && cqe.user_data == tag(index);
+
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                const auto bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                if (current && cqe.res > 0) [[likely]] {
+                    bump(stats_.wakeups);
+                    uint8_t* data = ring_.buffer(bid);
+                    size_t length = static_cast<size_t>(cqe.res);
+                    timing::RxTimestamp rx;
+                    if (slot.recvmsg) {
+                        const uint8_t* control;
+                        size_t control_length;
+                        length = IoUring::recvmsg_payload(data, slot.message, data,
+                                                          control, control_length);
+                        read_rx_timestamp(control, control_length, rx);
+                    }
+                    // recvmsg reports EOF as a header with an empty payload
+                    const int n = (slot.recvmsg && length == 0)
+                        ? -1 : slot.client->ingest(data, length, rx);
+                    if (n < 0) [[unlikely]] {
+                        detach(index);
+                    } else {
+                        delivered += n;
+                    }
+                }
+                ring_.recycle_buffer(bid);
+            }
+
+            if (!current || !slot.live || (cqe.flags & IORING_CQE_F_MORE)) [[likely]] {
+                return;
+            }
+            // Multishot request ended: out of buffers (recycled above, so
+            // re-arm) or the connection is gone
+            if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+                if (cqe.res == -ENOBUFS) {
+                    bump(stats_.buffer_stalls);
+                }
+                bump(stats_.rearms);
+                if (arm(index)) {
+                    rearmed = true;
+                    return;
+                }
+            }
+            detach(index);
+        });
+
+        if (rearmed) {
+            ring_.submit();
+        }
+        return delivered;
+    }
+
+    NetworkConfig config_;
+    IoBackend backend_{IoBackend::EPOLL};
+    const char* fallback_reason_{""};
+    bool initialized_{false};
+
+    Slot slots_[MaxConnections];
+    size_t count_{0};
+    size_t disconnected_{0};
+
+    int epoll_fd_{-1};
+    IoUring ring_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    NetworkStats stats_;
+};
+
+} // namespace cal
+} // namespace sage
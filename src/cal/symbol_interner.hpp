@@ -0,0 +1,291 @@
+#pragma once
+
+/**
+ * SAGE CAL Symbol Interner
+ * (venue, symbol name) -> dense symbol_id through a minimal perfect hash
+ *
+ * Built at startup from the configured symbols, read-only afterwards:
+ * - every key is packed into one 32-byte record: name (zero padded),
+ *   venue, length; the table is exactly as large as the key count
+ * - a lookup hashes the packed key, reads one pilot for its bucket and
+ *   lands on the only slot that key can occupy (hash-and-displace, as in
+ *   PTHash): no probe loop, no data-dependent branches before the compare
+ * - the slot is verified with one 32-byte SIMD compare (AVX2; SWAR
+ *   otherwise), so an unknown name is rejected, never aliased
+ *
+ * Ids must be below MAX_SYMBOL_ID (ADE / RME table size), so indices
+ * downstream are collision-free by construction instead of masked.
+ * Several keys may share an id ("BTCUSDT" on Binance, "BTC-USD" on
+ * Coinbase are one instrument).
+ *
+ * Every add() rebuilds the hash: O(keys) with a few hundred keys at most,
+ * startup only.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../types/sage_message.hpp"
+#include "validator.hpp"
+
+namespace sage {
+namespace cal {
+
+class SymbolInterner {
+public:
+    static constexpr size_t MAX_NAME_LENGTH = 24;
+    static constexpr size_t MAX_KEYS = 512;
+    static constexpr uint32_t MAX_SYMBOL_ID = MAX_VALID_SYMBOL_ID;   // ADE / RME MAX_SYMBOLS
+
+    /**
+     * Register (or re-point) a name and rebuild the hash
+     * @return false if the name is empty / too long, the id is out of
+     *         range, the table is full or no perfect hash was found with
+     *         the name added (the table then stays as it was)
+     */
+    SAGE_COLD
+    bool add(ExchangeId venue, std::string_view name, uint32_t symbol_id) noexcept {
+        if (name.empty() || name.size() > MAX_NAME_LENGTH || symbol_id >= MAX_SYMBOL_ID) {
+            return false;
+        }
+        Entry entry = make_entry(venue, name.data(), name.size());
+        entry.word[3] |= static_cast<uint64_t>(symbol_id) << 32;
+
+        size_t index = 0;
+        while (index < count_ && !same_key(keys_[index], entry)) {
+            ++index;
+        }
+        if (index == MAX_KEYS) {
+            return false;
+        }
+        const Entry previous = keys_[index];
+        const size_t previous_count = count_;
+        keys_[index] = entry;
+        count_ += (index == count_);
+        if (build()) [[likely]] {
+            return true;
+        }
+        // Keep serving the keys that did hash (their build succeeded before)
+        keys_[index] = previous;
+        count_ = previous_count;
+        build();
+        return false;
+    }
+
+    /**
+     * Resolve a name in place
+     * @param buf_end  End of the readable buffer around name; with 32
+     *                 bytes to spare the key is built with one SIMD load
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    bool find(ExchangeId venue, const char* name, size_t length, const char* buf_end,
+              uint32_t& symbol_id) const noexcept {
+        if (length == 0 || length > MAX_NAME_LENGTH || count_ == 0) [[unlikely]] {
+            return false;
+        }
+
+#if defined(__AVX2__)
+        alignas(32) Entry key;
+        __m256i packed;
+        if (buf_end - name >= 32) [[likely]] {
+            const __m256i mask = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(LENGTH_MASK + 32 - length));
+            packed = _mm256_and_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(name)), mask);
+            packed = _mm256_or_si256(packed, _mm256_set_epi64x(
+                static_cast<int64_t>(tag(venue, length)), 0, 0, 0));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(key.word), packed);
+        } else {
+            key = make_entry(venue, name, length);
+            packed = _mm256_load_si256(reinterpret_cast<const __m256i*>(key.word));
+        }
+        const Entry& slot = table_[slot_of(key)];
+        const __m256i diff = _mm256_xor_si256(
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(slot.word)), packed);
+        if (!_mm256_testz_si256(diff, _mm256_set_epi64x(
+                static_cast<int64_t>(TAG_MASK), -1, -1, -1))) [[unlikely]] {
+            return false;
+        }
+#else
+        const Entry key = make_entry(venue, name, length);
+        const Entry& slot = table_[slot_of(key)];
+        if (!same_key(slot, key)) [[unlikely]] {
+            return false;
+        }
+#endif
+        symbol_id = static_cast<uint32_t>(slot.word[3] >> 32);
+        return true;
+    }
+
+    SAGE_ALWAYS_INLINE
+    bool find(ExchangeId venue, std::string_view name, uint32_t& symbol_id) const noexcept {
+        return find(venue, name.data(), name.size(), name.data() + name.size(), symbol_id);
+    }
+
+    size_t size() const noexcept { return count_; }
+
+private:
+    /**
+     * Packed key: bytes 0-23 name, 24 venue, 25 length, 28-31 symbol_id
+     * (ignored by hash and compare)
+     */
+    struct alignas(32) Entry {
+        uint64_t word[4];
+    };
+    static_assert(sizeof(Entry) == 32, "Entry must be 32 bytes");
+
+    static constexpr uint64_t TAG_MASK = 0xFFFFFFFFULL;
+    static constexpr uint64_t SEED = 0x5AFE5EED5AFE5EEDULL;
+    static constexpr uint32_t MAX_PILOT = 65535;
+
+    // 32 x 0xFF then 32 x 0x00: loading at 32 - n keeps the first n bytes
+    alignas(64) static constexpr uint8_t LENGTH_MASK[64] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    };
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t tag(ExchangeId venue, size_t length) noexcept {
+        return static_cast<uint64_t>(venue) | (static_cast<uint64_t>(length) << 8);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static Entry make_entry(ExchangeId venue, const char* name, size_t length) noexcept {
+        Entry entry{};
+        std::memcpy(entry.word, name, length);
+        entry.word[3] = tag(venue, length);
+        return entry;
+    }
+
+    SAGE_ALWAYS_INLINE
+    static bool same_key(const Entry& a, const Entry& b) noexcept {
+        return ((a.word[0] ^ b.word[0]) | (a.word[1] ^ b.word[1]) | (a.word[2] ^ b.word[2]) |
+                ((a.word[3] ^ b.word[3]) & TAG_MASK)) == 0;
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t mix(uint64_t h) noexcept {
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static uint64_t hash(const Entry& key, uint64_t seed) noexcept {
+        uint64_t h = (key.word[0] ^ seed) * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (h >> 29) ^ key.word[1]) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 32) ^ key.word[2]) * 0x94D049BB133111EBULL;
+        h = (h ^ (h >> 29) ^ (key.word[3] & TAG_MASK)) * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+    // [0, n) without a division
+    SAGE_ALWAYS_INLINE
+    static size_t reduce(uint64_t h, size_t n) noexcept {
+        return static_cast<size_t>((static_cast<unsigned __int128>(h) * n) >> 64);
+    }
+
+    SAGE_ALWAYS_INLINE
+    static size_t place(uint64_t h, uint16_t pilot, size_t n) noexcept {
+        return reduce(mix(h ^ (static_cast<uint64_t>(pilot) * 0xC6A4A7935BD1E995ULL)), n);
+    }
+
+    SAGE_ALWAYS_INLINE
+    size_t slot_of(const Entry& key) const noexcept {
+        const uint64_t h = hash(key, seed_);
+        return place(h, pilots_[reduce(h, buckets_)], count_);
+    }
+
+    /**
+     * Hash-and-displace: buckets of about two keys, largest first, each
+     * gets the first pilot that sends all its keys to free slots
+     */
+    SAGE_COLD
+    bool build() noexcept {
+        buckets_ = count_ / 2 + 1;
+        for (uint64_t attempt = 0; attempt < 64; ++attempt) {
+            seed_ = mix(SEED + attempt);
+            if (try_build()) {
+                return true;
+            }
+        }
+        return false;     // Unreachable in practice; add() restores the last good table
+    }
+
+    SAGE_COLD
+    bool try_build() noexcept {
+        uint64_t hashes[MAX_KEYS];
+        uint16_t order[MAX_KEYS];        // Key indices grouped by bucket
+        uint16_t bucket_order[MAX_KEYS]; // Buckets, largest first
+        uint16_t bucket_size[MAX_KEYS] = {};
+        uint16_t bucket_start[MAX_KEYS + 1] = {};
+        bool taken[MAX_KEYS] = {};
+
+        for (size_t i = 0; i < count_; ++i) {
+            hashes[i] = hash(keys_[i], seed_);
+            ++bucket_size[reduce(hashes[i], buckets_)];
+        }
+        for (size_t b = 0; b < buckets_; ++b) {
+            bucket_start[b + 1] = static_cast<uint16_t>(bucket_start[b] + bucket_size[b]);
+            bucket_order[b] = static_cast<uint16_t>(b);
+        }
+        uint16_t fill[MAX_KEYS] = {};
+        for (size_t i = 0; i < count_; ++i) {
+            const size_t b = reduce(hashes[i], buckets_);
+            order[bucket_start[b] + fill[b]++] = static_cast<uint16_t>(i);
+        }
+        std::stable_sort(bucket_order, bucket_order + buckets_, [&](uint16_t a, uint16_t b) {
+            return bucket_size[a] > bucket_size[b];
+        });
+
+        for (size_t n = 0; n < buckets_; ++n) {
+            const uint16_t b = bucket_order[n];
+            const uint16_t* members = order + bucket_start[b];
+            const size_t size = bucket_size[b];
+            pilots_[b] = 0;
+            if (size == 0) {
+                continue;
+            }
+
+            bool placed = false;
+            for (uint32_t pilot = 0; pilot <= MAX_PILOT && !placed; ++pilot) {
+                size_t slots[MAX_KEYS];
+                placed = true;
+                for (size_t k = 0; k < size && placed; ++k) {
+                    slots[k] = place(hashes[members[k]], static_cast<uint16_t>(pilot), count_);
+                    placed = !taken[slots[k]] &&
+                             std::find(slots, slots + k, slots[k]) == slots + k;
+                }
+                if (placed) {
+                    pilots_[b] = static_cast<uint16_t>(pilot);
+                    for (size_t k = 0; k < size; ++k) {
+                        taken[slots[k]] = true;
+                        table_[slots[k]] = keys_[members[k]];
+                    }
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Entry table_[MAX_KEYS]{};            // Slot -> key (hot)
+    uint16_t pilots_[MAX_KEYS]{};        // Bucket -> displacement (hot)
+    uint64_t seed_{SEED};
+    size_t buckets_{1};
+    size_t count_{0};
+    Entry keys_[MAX_KEYS]{};             // Insertion order (cold, rebuild input)
+};
+
+} // namespace cal
+} // namespace sage
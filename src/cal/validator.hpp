@@ -10,11 +10,25 @@
  * different symbols if external IDs are not controlled.
  * 
  * Use validate_symbol_id() to reject unknown symbols at ingress.
+ * Venue names are interned into ids below MAX_VALID_SYMBOL_ID by
+ * SymbolInterner (symbol_interner.hpp).
+ *
+ * PRICE BANDS:
+ * Validator is stateless. PriceBandValidator adds the per-symbol state:
+ * a reference price and a band around it, so a bad print (fat finger,
+ * venue glitch, parse of the wrong field) is rejected or flagged in CAL
+ * instead of skewing ADE's rolling statistics.
  */
 
 #include <cmath>
+#include <cstdint>
 #include <limits>
-#include <unordered_set>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../core/compiler.hpp"
 #include "../types/sage_message.hpp"
 
 namespace sage {
@@ -85,9 +99,7 @@ public:
             return {ValidationStatus::REJECT, "Qty <= 0"};
         }
 
-        // Note: Comparison against previous price for spike detection
-        // requires state, which Validator doesn't have.
-        // Stateful spike detection should be done at a higher layer.
+        // Spike detection needs per-symbol state: see PriceBandValidator
 
         return {ValidationStatus::ACCEPT, nullptr};
     }
@@ -121,11 +133,247 @@ public:
     }
 };
 
+// ============================================================================
+// Price Bands
+// ============================================================================
+
+enum class BandAction : uint8_t {
+    REJECT,   // Drop out-of-band ticks
+    FLAG      // Pass them on with MD_FLAG_OUTLIER (ADE skips its statistics)
+};
+
+struct PriceBandConfig {
+    uint32_t band_bps = Validator::MAX_PRICE_SPIKE_PERCENT * 100;   // +/- around the reference
+    BandAction action = BandAction::REJECT;
+    uint32_t reanchor_after = 3;   // Consecutive agreeing outliers that move the reference
+};
+
+/**
+ * Stateful per-symbol price band filter
+ *
+ * Each symbol keeps a reference price (the last accepted tick) and the
+ * band [reference - delta, reference + delta] precomputed from it, so
+ * the hot-path check is two integer compares. The band fraction is held
+ * as a 32-bit fixed-point multiplier: moving the reference is one
+ * 64x64->128 multiply and a shift, never a division.
+ *
+ * - The first tick of a symbol is accepted and seeds the reference
+ * - An out-of-band tick is rejected (or flagged, per BandAction); the
+ *   reference does not move
+ * - reanchor_after consecutive out-of-band ticks that agree with each
+ *   other (within the band of the first) are a real move, not a bad
+ *   print: the last one is accepted as the new reference (WARN)
+ *
+ * validate_batch() checks a whole frame at once (AVX2: four records per
+ * step, gathered bounds). The frame is checked against the references as
+ * they were at its start; each symbol's reference then moves to its last
+ * accepted price in the frame.
+ *
+ * Not thread-safe: one instance per connector thread (cal_main keeps one
+ * per venue, and each venue is served by exactly one network thread).
+ */
+class PriceBandValidator {
+public:
+    explicit PriceBandValidator(PriceBandConfig config = {}) noexcept { configure(config); }
+
+    /**
+     * Change the band; clears every reference (cold)
+     */
+    SAGE_COLD
+    void configure(PriceBandConfig config) noexcept {
+        config_ = config;
+        band_q32_ = (static_cast<uint64_t>(config.band_bps) << 32) / 10000;
+        for (size_t i = 0; i < MAX_VALID_SYMBOL_ID; ++i) {
+            reset(i);
+        }
+    }
+
+    /**
+     * Forget a symbol's reference (e.g. after a resubscribe)
+     */
+    SAGE_COLD
+    void reset(uint64_t symbol_id) noexcept {
+        if (symbol_id < MAX_VALID_SYMBOL_ID) {
+            bands_[symbol_id] = SymbolBand{};
+        }
+    }
+
+    /**
+     * Stateless checks, then the band
+     * @return ACCEPT, WARN (accepted: re-anchored or flagged) or REJECT
+     */
+    SAGE_HOT
+    ValidationResult validate(MarketData& data) noexcept {
+        const ValidationResult basic = Validator::validate_market_data(data);
+        if (basic.status != ValidationStatus::ACCEPT) [[unlikely]] {
+            return basic;
+        }
+        SymbolBand& band = bands_[data.symbol_id];
+        const int64_t price = data.price.raw();
+        if (price >= band.low && price <= band.high) [[likely]] {
+            move_reference(band, price);
+            return {ValidationStatus::ACCEPT, nullptr};
+        }
+        return outlier(band, data);
+    }
+
+    /**
+     * Validate records[0, count) (count <= 64) against the references at
+     * the start of the frame
+     * @return Bit i set if records[i] may be published
+     */
+    SAGE_HOT
+    uint64_t validate_batch(MarketData* records, size_t count) noexcept {
+        uint64_t valid = 0;    // Passed the stateless checks
+        uint64_t in_band = 0;  // ... and the band
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        const __m256i max_id = _mm256_set1_epi64x(static_cast<int64_t>(MAX_VALID_SYMBOL_ID));
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i id_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+        const long long* lows = reinterpret_cast<const long long*>(&bands_[0].low);
+        const long long* highs = reinterpret_cast<const long long*>(&bands_[0].high);
+        for (; i + 4 <= count; i += 4) {
+            // First 32 bytes of four records -> price / quantity / symbol_id lanes
+            // (symbol_id shares its 8 bytes with flags and exchange_id)
+            const __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(records + i));
+            const __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(records + i + 1));
+            const __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(records + i + 2));
+            const __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(records + i + 3));
+            const __m256i t0 = _mm256_unpacklo_epi64(r0, r1);   // p0 p1 | s0 s1
+            const __m256i t1 = _mm256_unpackhi_epi64(r0, r1);   // q0 q1 | v0 v1
+            const __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+            const __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+            const __m256i price = _mm256_permute2x128_si256(t0, t2, 0x20);
+            const __m256i symbol = _mm256_and_si256(_mm256_permute2x128_si256(t0, t2, 0x31),
+                                                    id_mask);
+            const __m256i qty = _mm256_permute2x128_si256(t1, t3, 0x20);
+
+            // symbol_id < MAX (zero-extended, so never negative), price > 0, qty > 0
+            const __m256i id_ok = _mm256_cmpgt_epi64(max_id, symbol);
+            const __m256i ok = _mm256_and_si256(id_ok, _mm256_and_si256(
+                _mm256_cmpgt_epi64(price, zero), _mm256_cmpgt_epi64(qty, zero)));
+
+            // Bounds for in-range ids (others read symbol 0, masked out above)
+            const __m256i index = _mm256_slli_epi64(_mm256_and_si256(symbol, id_ok), 3);
+            const __m256i low = _mm256_i64gather_epi64(lows, index, 8);
+            const __m256i high = _mm256_i64gather_epi64(highs, index, 8);
+            const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(low, price),
+                                                    _mm256_cmpgt_epi64(price, high));
+
+            const uint64_t ok_bits = static_cast<uint64_t>(
+                _mm256_movemask_pd(_mm256_castsi256_pd(ok)));
+            const uint64_t band_bits = static_cast<uint64_t>(
+                _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(outside, ok))));
+            valid |= ok_bits << i;
+            in_band |= band_bits << i;
+        }
+#endif
+        for (; i < count; ++i) {
+            const MarketData& data = records[i];
+            if (Validator::validate_market_data(data).status != ValidationStatus::ACCEPT) {
+                continue;
+            }
+            valid |= 1ULL << i;
+            const SymbolBand& band = bands_[data.symbol_id];
+            const int64_t price = data.price.raw();
+            in_band |= static_cast<uint64_t>(price >= band.low && price <= band.high) << i;
+        }
+
+        // Outliers (rare) and reference moves, in frame order
+        uint64_t accepted = in_band;
+        for (uint64_t pending = valid; pending != 0; pending &= pending - 1) {
+            const size_t r = static_cast<size_t>(__builtin_ctzll(pending));
+            SymbolBand& band = bands_[records[r].symbol_id];
+            if (in_band & (1ULL << r)) [[likely]] {
+                move_reference(band, records[r].price.raw());
+            } else if (outlier(band, records[r]).status != ValidationStatus::REJECT) {
+                accepted |= 1ULL << r;
+            }
+        }
+        return accepted;
+    }
+
+    /**
+     * Current reference price (0 if the symbol has not traded)
+     */
+    FixedPoint reference(uint64_t symbol_id) const noexcept {
+        return FixedPoint(symbol_id < MAX_VALID_SYMBOL_ID ? bands_[symbol_id].reference : 0);
+    }
+
+    const PriceBandConfig& config() const noexcept { return config_; }
+    uint64_t outliers() const noexcept { return outliers_; }
+    uint64_t reanchors() const noexcept { return reanchors_; }
+
+private:
+    /**
+     * One cache line per symbol: the hot check touches low/high only
+     */
+    struct alignas(64) SymbolBand {
+        int64_t low = std::numeric_limits<int64_t>::min();    // Unseeded: anything goes
+        int64_t high = std::numeric_limits<int64_t>::max();
+        int64_t reference = 0;
+        int64_t candidate = 0;     // First of the current run of outliers
+        uint32_t run = 0;          // Length of that run
+    };
+    static_assert(sizeof(SymbolBand) == 64, "SymbolBand must be one cache line");
+
+    SAGE_ALWAYS_INLINE
+    int64_t delta(int64_t price) const noexcept {
+        return static_cast<int64_t>((static_cast<unsigned __int128>(price) * band_q32_) >> 32);
+    }
+
+    SAGE_ALWAYS_INLINE
+    void move_reference(SymbolBand& band, int64_t price) noexcept {
+        const int64_t d = delta(price);
+        band.reference = price;
+        band.low = price - d;
+        band.high = price + d;
+        band.run = 0;
+    }
+
+    SAGE_COLD
+    ValidationResult outlier(SymbolBand& band, MarketData& data) noexcept {
+        const int64_t price = data.price.raw();
+        const int64_t d = delta(band.candidate);
+        if (band.run > 0 && price >= band.candidate - d && price <= band.candidate + d) {
+            ++band.run;
+        } else {
+            band.candidate = price;
+            band.run = 1;
+        }
+        if (band.run >= config_.reanchor_after) {
+            ++reanchors_;
+            move_reference(band, price);
+            return {ValidationStatus::WARN, "Price band re-anchored"};
+        }
+
+        ++outliers_;
+        if (config_.action == BandAction::FLAG) {
+            data.flags |= MD_FLAG_OUTLIER;
+            return {ValidationStatus::WARN, "Price outside band (flagged)"};
+        }
+        return {ValidationStatus::REJECT, "Price outside band"};
+    }
+
+    SymbolBand bands_[MAX_VALID_SYMBOL_ID];
+    PriceBandConfig config_;
+    uint64_t band_q32_{0};
+    uint64_t outliers_{0};
+    uint64_t reanchors_{0};
+};
+
+// ============================================================================
+// Symbol Table
+// ============================================================================
+
 /**
  * Symbol table for validated symbols
  * 
- * Provides O(1) lookup for symbol validation at ingress.
- * Build at startup from configuration, then use for every message.
+ * One bit per id below MAX_VALID_SYMBOL_ID: a single load and mask per
+ * lookup, no hashing. Build at startup from configuration, then use for
+ * every message.
  * 
  * USAGE:
  *   SymbolTable symbols;
@@ -140,32 +388,40 @@ public:
     /**
      * Register a valid symbol ID
      */
-    void add_symbol(uint64_t symbol_id, const char* /* symbol_name */ = nullptr) {
-        if (symbol_id < MAX_VALID_SYMBOL_ID) {
-            valid_symbols_.insert(symbol_id);
+    void add_symbol(uint64_t symbol_id, const char* /* symbol_name */ = nullptr) noexcept {
+        if (symbol_id < MAX_VALID_SYMBOL_ID && !is_valid(symbol_id)) {
+            bits_[symbol_id / 64] |= 1ULL << (symbol_id % 64);
+            ++count_;
         }
     }
     
     /**
      * Check if symbol ID is registered
-     * O(1) average case
+     * O(1), branch-free for in-range ids
      */
     bool is_valid(uint64_t symbol_id) const noexcept {
-        return valid_symbols_.find(symbol_id) != valid_symbols_.end();
+        return symbol_id < MAX_VALID_SYMBOL_ID &&
+               ((bits_[symbol_id / 64] >> (symbol_id % 64)) & 1) != 0;
     }
     
     /**
      * Get count of registered symbols
      */
-    size_t count() const noexcept { return valid_symbols_.size(); }
+    size_t count() const noexcept { return count_; }
     
     /**
      * Clear all registered symbols
      */
-    void clear() { valid_symbols_.clear(); }
+    void clear() noexcept {
+        for (uint64_t& word : bits_) {
+            word = 0;
+        }
+        count_ = 0;
+    }
 
 private:
-    std::unordered_set<uint64_t> valid_symbols_;
+    uint64_t bits_[MAX_VALID_SYMBOL_ID / 64] = {};
+    size_t count_{0};
 };
 
 } // namespace cal
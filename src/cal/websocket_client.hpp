@@ -1,68 +1,966 @@
 #pragma once
 
-#include <string>
-#include <functional>
-#include <thread>
+/**
+ * SAGE CAL WebSocket Client
+ * Market data connection on a raw non-blocking socket + epoll
+ *
+ * - HTTP/1.1 upgrade handshake, Sec-WebSocket-Accept verified
+ * - Frames are decoded in place in one contiguous receive buffer; each
+ *   complete text/binary message is handed to the handler as a pointer
+ *   into that buffer: no copy, no per-message allocation, no std::function
+ * - Fragmented messages are stitched together in place (continuation
+ *   payloads are moved down over the headers in between)
+ * - Ping -> pong; close -> close echo, then reconnect with backoff
+ * - Busy-poll mode: epoll_wait(0) spin with SO_BUSY_POLL on the socket;
+ *   otherwise epoll_wait blocks up to poll_timeout_ms
+ * - Or driven from outside (NetworkThread): drain() after readiness, or
+ *   ingest() with bytes an io_uring recv already delivered
+ *
+ * TLS is not handled here. For wss:// venues run a local terminator
+ * (stunnel, haproxy) and connect to it with ws://, setting host_header
+ * to the venue's host name.
+ *
+ * Receive timestamps: with rx_timestamps the socket asks the kernel for
+ * SO_TIMESTAMPING software (and, with hw_timestamps, NIC) receive times,
+ * falling back to SO_TIMESTAMPNS; each recv then carries one in its
+ * control data. A message is stamped with the receive that completed it
+ * (for TCP: the newest segment in that read).
+ *
+ * Handler: any callable `void(const char* data, size_t len) noexcept`, or
+ * `void(const char* data, size_t len, const timing::RxTimestamp& rx)
+ * noexcept` to get the receive timestamp, invoked on the I/O thread. data
+ * is valid only for the duration of the call.
+ */
+
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <linux/net_tstamp.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
-// Mocking boost::asio includes for structure
-// #include <boost/asio.hpp>
-// #include <boost/beast.hpp>
+#include "../core/compiler.hpp"
+#include "../core/cpu_affinity.hpp"
+#include "../core/memory.hpp"
+#include "../core/timing.hpp"
+#include "websocket_protocol.hpp"
 
 namespace sage {
 namespace cal {
 
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct WebSocketConfig {
+    std::string url;                 // ws://host[:port]/path
+    std::string host_header;         // Host: override (behind a TLS terminator)
+    std::string subscribe_message;   // Sent as text after every handshake
+    bool busy_poll = true;           // Spin on epoll_wait(0) + SO_BUSY_POLL
+    int poll_timeout_ms = 100;       // epoll_wait timeout when not busy-polling
+    int connect_timeout_ms = 5000;   // TCP connect + handshake
+    int max_backoff_ms = 30000;      // Reconnect backoff cap
+    int cpu_core = -1;               // Pin the I/O thread started by start()
+    bool rx_timestamps = true;       // Kernel receive timestamps on every recv
+    bool hw_timestamps = false;      // Prefer NIC timestamps (needs hwstamp rx filter on)
+};
+
+struct WebSocketUrl {
+    std::string host;
+    std::string port;
+    std::string path;
+    bool tls;
+};
+
+/**
+ * Split ws://host[:port][/path] (wss:// is recognized and flagged)
+ */
+inline bool parse_websocket_url(const std::string& url, WebSocketUrl& out) {
+    size_t pos;
+    if (url.compare(0, 5, "ws://") == 0) {
+        out.tls = false;
+        pos = 5;
+    } else if (url.compare(0, 6, "wss://") == 0) {
+        out.tls = true;
+        pos = 6;
+    } else {
+        return false;
+    }
+
+    const size_t path_start = url.find('/', pos);
+    const std::string authority = url.substr(pos, path_start == std::string::npos
+                                                      ? std::string::npos : path_start - pos);
+    out.path = (path_start == std::string::npos) ? "/" : url.substr(path_start);
+
+    const size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        out.host = authority.substr(0, colon);
+        out.port = authority.substr(colon + 1);
+    } else {
+        out.host = authority;
+        out.port = out.tls ? "443" : "80";
+    }
+    return !out.host.empty() && !out.port.empty();
+}
+
+/**
+ * Host: header value for a URL (RFC 7230 5.4: port only if not the
+ * scheme's default)
+ */
+inline std::string websocket_host(const WebSocketUrl& url) {
+    return url.port == (url.tls ? "443" : "80") ? url.host : url.host + ":" + url.port;
+}
+
+/**
+ * Counters (written by the I/O thread, readable from any thread)
+ */
+struct WebSocketStats {
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> pings{0};
+    std::atomic<uint64_t> reconnects{0};
+    std::atomic<uint64_t> protocol_errors{0};
+
+    SAGE_ALWAYS_INLINE static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// ============================================================================
+// Receive Timestamps
+// ============================================================================
+
+// Control buffer for one recvmsg: SCM_TIMESTAMPING carries three timespecs
+constexpr size_t RX_CONTROL_SIZE = CMSG_SPACE(3 * sizeof(struct timespec));
+
+/**
+ * Pull the receive time out of recvmsg control data (SCM_TIMESTAMPING:
+ * raw hardware if present, else software; or SCM_TIMESTAMPNS)
+ * @return false if the control data holds no timestamp
+ */
+SAGE_ALWAYS_INLINE bool read_rx_timestamp(const uint8_t* control, size_t length,
+                                          timing::RxTimestamp& out) noexcept {
+    size_t offset = 0;
+    while (offset + sizeof(cmsghdr) <= length) {
+        cmsghdr header;
+        std::memcpy(&header, control + offset, sizeof(header));
+        if (header.cmsg_len < sizeof(cmsghdr) || offset + header.cmsg_len > length) {
+            return false;
+        }
+        const uint8_t* data = control + offset + CMSG_LEN(0);
+        if (header.cmsg_level == SOL_SOCKET &&
+            header.cmsg_len >= CMSG_LEN(3 * sizeof(struct timespec)) &&
+            header.cmsg_type == SCM_TIMESTAMPING) {
+            struct timespec ts[3];
+            std::memcpy(ts, data, sizeof(ts));
+            const bool hardware = ts[2].tv_sec != 0 || ts[2].tv_nsec != 0;
+            const struct timespec& chosen = hardware ? ts[2] : ts[0];
+            out.realtime_ns = static_cast<uint64_t>(chosen.tv_sec) * NANOS_PER_SEC +
+                              static_cast<uint64_t>(chosen.tv_nsec);
+            out.clock = hardware ? timing::RxClock::HARDWARE : timing::RxClock::SOFTWARE;
+            return out.realtime_ns != 0;
+        }
+        if (header.cmsg_level == SOL_SOCKET && header.cmsg_type == SCM_TIMESTAMPNS &&
+            header.cmsg_len >= CMSG_LEN(sizeof(struct timespec))) {
+            struct timespec ts;
+            std::memcpy(&ts, data, sizeof(ts));
+            out.realtime_ns = static_cast<uint64_t>(ts.tv_sec) * NANOS_PER_SEC +
+                              static_cast<uint64_t>(ts.tv_nsec);
+            out.clock = timing::RxClock::SOFTWARE;
+            return true;
+        }
+        offset += CMSG_ALIGN(header.cmsg_len);
+    }
+    return false;
+}
+
+// ============================================================================
+// Client
+// ============================================================================
+
+/**
+ * @tparam Handler     Callable void(const char*, size_t[, const timing::RxTimestamp&]) noexcept
+ * @tparam BufferSize  Receive buffer; bounds the largest (reassembled) message
+ */
+template<typename Handler, size_t BufferSize = 1024 * 1024>
 class WebSocketClient {
+    static_assert(BufferSize >= 16 * 1024, "Receive buffer must be at least 16KB");
+
 public:
-    using MessageCallback = std::function<void(const char* data, size_t len)>;
+    WebSocketClient(WebSocketConfig config, Handler handler)
+        : config_(std::move(config)), handler_(std::move(handler)) {
+        buffer_ = static_cast<uint8_t*>(memory::alloc_aligned(BufferSize));
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
 
-    WebSocketClient(const std::string& uri, MessageCallback callback) 
-        : uri_(uri), callback_(callback), running_(false) {}
+        uint64_t seed = 0;
+        if (getrandom(&seed, sizeof(seed), 0) != static_cast<ssize_t>(sizeof(seed))) {
+            seed = timing::rdtsc();
+        }
+        rng_state_ = seed | 1;
+    }
 
+    ~WebSocketClient() {
+        stop();
+        close_socket();
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+        memory::free_aligned(buffer_);
+    }
+
+    WebSocketClient(const WebSocketClient&) = delete;
+    WebSocketClient& operator=(const WebSocketClient&) = delete;
+
+    // ========================================================================
+    // Threaded Operation
+    // ========================================================================
+
+    /**
+     * Run connect/poll/reconnect on a dedicated I/O thread
+     */
     void start() {
-        running_ = true;
-        thread_ = std::thread(&WebSocketClient::io_loop, this);
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] {
+            if (config_.cpu_core >= 0) {
+                cpu::pin_to_core(config_.cpu_core);
+            }
+            run();
+        });
     }
 
     void stop() {
-        running_ = false;
+        running_.store(false, std::memory_order_release);
         if (thread_.joinable()) {
             thread_.join();
         }
     }
 
+    // ========================================================================
+    // Single-Step Operation
+    // ========================================================================
+
+    /**
+     * TCP connect + opening handshake (blocks up to connect_timeout_ms)
+     * Sends subscribe_message, if any, once upgraded.
+     */
+    SAGE_COLD
+    bool connect() {
+        close_socket();
+
+        WebSocketUrl url;
+        if (!parse_websocket_url(config_.url, url)) {
+            return fail("Invalid WebSocket URL");
+        }
+        if (url.tls) {
+            return fail("wss:// needs a local TLS terminator; connect with ws://");
+        }
+
+        if (!open_socket(url) || !handshake(url)) {
+            close_socket();
+            return false;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd_;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &ev) != 0) {
+            close_socket();
+            return fail("epoll_ctl failed");
+        }
+
+        if (!config_.subscribe_message.empty() &&
+            !send_text(config_.subscribe_message.data(), config_.subscribe_message.size())) {
+            close_socket();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Wait up to timeout_ms for data, then receive and dispatch everything
+     * available
+     * @return Messages delivered, or -1 if the connection is gone
+     */
+    SAGE_HOT
+    int poll(int timeout_ms) noexcept {
+        if (fd_ < 0) {
+            return -1;
+        }
+
+        // Frames already buffered (e.g. right after the handshake)
+        int delivered = 0;
+        if (write_ != read_) [[unlikely]] {
+            delivered = process();
+            if (delivered < 0) {
+                return -1;
+            }
+        }
+
+        epoll_event ev;
+        const int ready = epoll_wait(epoll_fd_, &ev, 1, timeout_ms);
+        if (ready <= 0) {
+            return delivered;
+        }
+
+        const int n = drain();
+        return n < 0 ? -1 : delivered + n;
+    }
+
+    /**
+     * recv until the socket would block, dispatching as data arrives
+     * (for an external readiness loop that owns the waiting)
+     * @return Messages delivered, or -1 if the connection is gone
+     */
+    SAGE_HOT
+    int drain() noexcept {
+        int delivered = 0;
+        for (;;) {
+            const ssize_t received = receive();
+            if (received < 0) {
+                return -1;
+            }
+            if (received == 0) {
+                return delivered;
+            }
+            const int n = process();
+            if (n < 0) {
+                return -1;
+            }
+            delivered += n;
+        }
+    }
+
+    /**
+     * Dispatch bytes received by someone else (io_uring provided buffers)
+     * rx: when they were received (from that recvmsg's control data)
+     *
+     * Whole, unfragmented frames are decoded straight out of data with no
+     * copy; only a trailing partial frame (or anything following a
+     * fragment) is copied into the receive buffer to wait for the rest.
+     * data may be modified in place (unmasking) and is not retained.
+     * Call with len == 0 after connect() to flush frames that arrived
+     * with the handshake response.
+     *
+     * @return Messages delivered, or -1 on close / protocol error
+     */
+    SAGE_HOT
+    int ingest(uint8_t* data, size_t len, const timing::RxTimestamp& rx = {}) noexcept {
+        int delivered = 0;
+        rx_ = rx;
+
+        if (read_ == write_ && !fragmented_) [[likely]] {
+            size_t pos = 0;
+            while (pos < len) {
+                ws::FrameHeader header;
+                const ws::FrameStatus status = ws::parse_frame_header(data + pos, len - pos, header);
+                if (status == ws::FrameStatus::PROTOCOL_ERROR) [[unlikely]] {
+                    return protocol_error(ws::CLOSE_PROTOCOL_ERROR);
+                }
+                if (status == ws::FrameStatus::INCOMPLETE ||
+                    header.header_length + header.payload_length > len - pos ||
+                    header.opcode == ws::Opcode::CONTINUATION || !header.fin) {
+                    break;   // Partial or fragmented: the buffered path takes it from here
+                }
+
+                uint8_t* payload = data + pos + header.header_length;
+                pos += static_cast<size_t>(header.header_length + header.payload_length);
+                const int n = dispatch(header, payload, static_cast<size_t>(header.payload_length));
+                if (n < 0) {
+                    return -1;
+                }
+                delivered += n;
+            }
+            data += pos;
+            len -= pos;
+        }
+
+        if (len > 0) {
+            if (BufferSize - write_ < len) {
+                compact();
+                if (BufferSize - write_ < len) [[unlikely]] {
+                    return protocol_error(ws::CLOSE_TOO_BIG);
+                }
+            }
+            std::memcpy(buffer_ + write_, data, len);
+            write_ += len;
+        }
+        if (read_ != write_) {
+            const int n = process();
+            if (n < 0) {
+                return -1;
+            }
+            delivered += n;
+        }
+        return delivered;
+    }
+
+    /**
+     * Timer hook for the handler (Handler::tick(), if it has one): called
+     * once per loop by whoever drives this client, with or without data
+     */
+    SAGE_ALWAYS_INLINE
+    void tick() noexcept {
+        if constexpr (requires(Handler& h) { h.tick(); }) {
+            handler_.tick();
+        }
+    }
+
+    /**
+     * Send a (masked) text frame, e.g. a subscription request
+     */
+    bool send_text(const char* data, size_t len) noexcept {
+        return send_frame(ws::Opcode::TEXT, reinterpret_cast<const uint8_t*>(data), len);
+    }
+
+    /**
+     * Close handshake (best effort) and drop the socket
+     */
+    void disconnect(uint16_t code = ws::CLOSE_NORMAL) noexcept {
+        if (fd_ < 0) {
+            return;
+        }
+        const uint8_t payload[2] = {static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(code)};
+        send_frame(ws::Opcode::CLOSE, payload, sizeof(payload));
+        close_socket();
+    }
+
+    /**
+     * Drop the socket without a close handshake (connection already lost)
+     */
+    void close() noexcept {
+        close_socket();
+    }
+
+    // ========================================================================
+    // Queries
+    // ========================================================================
+
+    bool connected() const noexcept { return fd_ >= 0; }
+    int fd() const noexcept { return fd_; }
+    const WebSocketConfig& config() const noexcept { return config_; }
+    WebSocketStats& stats() noexcept { return stats_; }
+    const WebSocketStats& stats() const noexcept { return stats_; }
+    const char* last_error() const noexcept { return last_error_; }
+
+    // Whether the socket was set up for receive timestamps (and how)
+    bool rx_timestamps() const noexcept { return rx_timestamping_; }
+    const timing::RxTimestamp& last_rx() const noexcept { return rx_; }
+
+    // Receive buffer, for MemoryProvisioner
+    uint8_t* buffer() noexcept { return buffer_; }
+    static constexpr size_t buffer_size() noexcept { return BufferSize; }
+
 private:
-    std::string uri_;
-    MessageCallback callback_;
-    std::atomic<bool> running_;
-    std::thread thread_;
+    static constexpr size_t MIN_RECV_SPACE = 4096;
+    static constexpr size_t SEND_CHUNK = 4096;
 
-    void io_loop() {
-        // Pin to Core 1 implementation
-        // ...
-        
+    // ========================================================================
+    // I/O Thread
+    // ========================================================================
+
+    /**
+     * Connect/poll/reconnect loop of the I/O thread, until stop()
+     */
+    void run() {
         int backoff_ms = 100;
-        
-        while (running_) {
-            try {
-                // Connect logic...
-                // Handshake...
-                // Read loop...
-                    // On message: callback_(buffer, len);
-                    
-                // If disconnect:
-                throw std::runtime_error("Disconnected");
-                
-            } catch (...) {
-                if (!running_) break;
-                
-                // Exponential backoff
-                std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
-                backoff_ms = std::min(backoff_ms * 2, 30000); // Capped at 30s
+
+        while (running_.load(std::memory_order_acquire)) {
+            if (fd_ < 0) {
+                if (connect()) {
+                    backoff_ms = 100;
+                    continue;
+                }
+                // Exponential backoff, checking for stop() every 10ms
+                for (int waited = 0; waited < backoff_ms &&
+                     running_.load(std::memory_order_acquire); waited += 10) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                backoff_ms = std::min(backoff_ms * 2, config_.max_backoff_ms);
+                continue;
+            }
+
+            if (poll(config_.busy_poll ? 0 : config_.poll_timeout_ms) < 0) {
+                close_socket();
+                WebSocketStats::bump(stats_.reconnects);
+            }
+            tick();
+        }
+
+        if (fd_ >= 0) {
+            disconnect();
+        }
+    }
+
+    // ========================================================================
+    // Frame Processing
+    // ========================================================================
+
+    /**
+     * Decode and dispatch every complete frame in [read_, write_)
+     * @return Messages delivered, or -1 on close / protocol error
+     */
+    SAGE_HOT
+    int process() noexcept {
+        int delivered = 0;
+
+        for (;;) {
+            const size_t available = write_ - read_;
+            ws::FrameHeader header;
+            const ws::FrameStatus status = ws::parse_frame_header(buffer_ + read_, available, header);
+            if (status == ws::FrameStatus::INCOMPLETE) {
+                break;
+            }
+            if (status == ws::FrameStatus::PROTOCOL_ERROR) [[unlikely]] {
+                return protocol_error(ws::CLOSE_PROTOCOL_ERROR);
+            }
+
+            const uint64_t frame_length = header.header_length + header.payload_length;
+            if (frame_length + (fragmented_ ? fragment_length_ : 0) > BufferSize) [[unlikely]] {
+                return protocol_error(ws::CLOSE_TOO_BIG);
+            }
+            if (available < frame_length) {
+                break;   // Payload still arriving
             }
+
+            uint8_t* payload = buffer_ + read_ + header.header_length;
+            read_ += static_cast<size_t>(frame_length);
+            const int n = dispatch(header, payload, static_cast<size_t>(header.payload_length));
+            if (n < 0) {
+                return -1;
+            }
+            delivered += n;
+        }
+
+        // Everything consumed: rewind for free instead of compacting later
+        if (read_ == write_ && !fragmented_) {
+            read_ = 0;
+            write_ = 0;
+        }
+        return delivered;
+    }
+
+    /**
+     * Act on one complete frame
+     * Continuation payloads must live in buffer_ (ingest() never passes
+     * fragments from outside it).
+     * @return 1 if a message was delivered, 0 if not, -1 on close / error
+     */
+    SAGE_HOT
+    int dispatch(const ws::FrameHeader& header, uint8_t* payload, size_t length) noexcept {
+        if (header.masked) [[unlikely]] {
+            ws::apply_mask(payload, length, header.mask_key);   // Servers shouldn't, but may
+        }
+
+        switch (header.opcode) {
+            case ws::Opcode::TEXT:
+            case ws::Opcode::BINARY:
+                if (fragmented_) [[unlikely]] {
+                    return protocol_error(ws::CLOSE_PROTOCOL_ERROR);
+                }
+                if (header.fin) [[likely]] {
+                    deliver(payload, length);
+                    return 1;
+                }
+                fragmented_ = true;
+                fragment_start_ = static_cast<size_t>(payload - buffer_);
+                fragment_length_ = length;
+                return 0;
+
+            case ws::Opcode::CONTINUATION:
+                if (!fragmented_) [[unlikely]] {
+                    return protocol_error(ws::CLOSE_PROTOCOL_ERROR);
+                }
+                // Close the gap left by the headers in between
+                std::memmove(buffer_ + fragment_start_ + fragment_length_, payload, length);
+                fragment_length_ += length;
+                if (header.fin) {
+                    fragmented_ = false;
+                    deliver(buffer_ + fragment_start_, fragment_length_);
+                    return 1;
+                }
+                return 0;
+
+            case ws::Opcode::PING:
+                WebSocketStats::bump(stats_.pings);
+                return send_frame(ws::Opcode::PONG, payload, length) ? 0 : -1;
+
+            case ws::Opcode::PONG:
+                return 0;
+
+            case ws::Opcode::CLOSE:
+                // Echo the status code and give up the connection
+                send_frame(ws::Opcode::CLOSE, payload, length >= 2 ? 2 : 0);
+                fail("Server closed the connection");
+                return -1;
         }
+        return 0;
+    }
+
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void deliver(const uint8_t* data, size_t length) noexcept {
+        WebSocketStats::bump(stats_.messages);
+        WebSocketStats::bump(stats_.bytes, length);
+        if constexpr (std::is_invocable_v<Handler&, const char*, size_t, const timing::RxTimestamp&>) {
+            handler_(reinterpret_cast<const char*>(data), length, rx_);
+        } else {
+            handler_(reinterpret_cast<const char*>(data), length);
+        }
+    }
+
+    SAGE_COLD
+    int protocol_error(uint16_t code) noexcept {
+        WebSocketStats::bump(stats_.protocol_errors);
+        fail(code == ws::CLOSE_TOO_BIG ? "Message exceeds receive buffer"
+                                       : "WebSocket protocol error");
+        const uint8_t payload[2] = {static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(code)};
+        send_frame(ws::Opcode::CLOSE, payload, sizeof(payload));
+        return -1;
+    }
+
+    // ========================================================================
+    // Socket I/O
+    // ========================================================================
+
+    /**
+     * One non-blocking recv into the buffer tail
+     * @return Bytes received, 0 if nothing pending, -1 if the peer is gone
+     */
+    SAGE_HOT
+    ssize_t receive() noexcept {
+        if (BufferSize - write_ < MIN_RECV_SPACE) {
+            compact();
+        }
+        ssize_t n;
+        if (rx_timestamping_) {
+            alignas(cmsghdr) uint8_t control[RX_CONTROL_SIZE];
+            iovec iov{buffer_ + write_, BufferSize - write_};
+            msghdr message{};
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            n = ::recvmsg(fd_, &message, 0);
+            if (n > 0 && !read_rx_timestamp(control, message.msg_controllen, rx_)) {
+                rx_ = {};
+            }
+        } else {
+            n = ::recv(fd_, buffer_ + write_, BufferSize - write_, 0);
+        }
+        if (n > 0) [[likely]] {
+            write_ += static_cast<size_t>(n);
+            return n;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return 0;
+        }
+        fail(n == 0 ? "Connection closed by peer" : "recv failed");
+        return -1;
+    }
+
+    /**
+     * Move live bytes (partial message + unparsed frames) to the front
+     */
+    void compact() noexcept {
+        const size_t pending = write_ - read_;
+        if (fragmented_) {
+            std::memmove(buffer_, buffer_ + fragment_start_, fragment_length_);
+            std::memmove(buffer_ + fragment_length_, buffer_ + read_, pending);
+            fragment_start_ = 0;
+            read_ = fragment_length_;
+        } else {
+            std::memmove(buffer_, buffer_ + read_, pending);
+            read_ = 0;
+        }
+        write_ = read_ + pending;
+    }
+
+    /**
+     * Send one frame, masked with a fresh key (RFC 6455 5.3)
+     */
+    bool send_frame(ws::Opcode opcode, const uint8_t* payload, size_t length) noexcept {
+        if (fd_ < 0) {
+            return false;
+        }
+        const uint32_t mask_key = next_mask_key();
+
+        uint8_t chunk[ws::MAX_FRAME_HEADER + SEND_CHUNK];
+        size_t used = ws::encode_frame_header(chunk, opcode, true, length, true, mask_key);
+
+        // Mask into the stack chunk; the caller's payload is left untouched
+        size_t offset = 0;
+        while (offset < length || used > 0) {
+            const size_t n = std::min(length - offset, sizeof(chunk) - used);
+            std::memcpy(chunk + used, payload + offset, n);
+            ws::apply_mask(chunk + used, n, mask_key, offset);
+            if (!send_all(chunk, used + n)) {
+                return false;
+            }
+            offset += n;
+            used = 0;
+        }
+        return true;
+    }
+
+    bool send_all(const uint8_t* data, size_t length) noexcept {
+        while (length > 0) {
+            const ssize_t n = ::send(fd_, data, length, MSG_NOSIGNAL);
+            if (n > 0) {
+                data += n;
+                length -= static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!wait_for(POLLOUT, config_.connect_timeout_ms)) {
+                    return fail("send timed out");
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return fail("send failed");
+        }
+        return true;
+    }
+
+    bool wait_for(short events, int timeout_ms) noexcept {
+        pollfd pfd{fd_, events, 0};
+        return ::poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & events) != 0;
     }
+
+    // ========================================================================
+    // Connection Setup (cold)
+    // ========================================================================
+
+    SAGE_COLD
+    bool open_socket(const WebSocketUrl& url) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &result) != 0 || !result) {
+            return fail("DNS resolution failed");
+        }
+
+        bool connected = false;
+        for (addrinfo* ai = result; ai != nullptr && !connected; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           ai->ai_protocol);
+            if (fd_ < 0) {
+                continue;
+            }
+            const int one = 1;
+            setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_BUSY_POLL
+            if (config_.busy_poll) {
+                const int busy_poll_us = 50;   // Best effort (may need CAP_NET_ADMIN)
+                setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us));
+            }
+#endif
+            if (::connect(fd_, ai->ai_addr, ai->ai_addrlen) == 0 ||
+                (errno == EINPROGRESS && wait_for(POLLOUT, config_.connect_timeout_ms))) {
+                int error = 0;
+                socklen_t error_length = sizeof(error);
+                getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &error_length);
+                connected = (error == 0);
+            }
+            if (!connected) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+        freeaddrinfo(result);
+        if (connected) {
+            enable_rx_timestamps();
+        }
+        return connected || fail("TCP connect failed");
+    }
+
+    /**
+     * SO_TIMESTAMPING (software, plus raw hardware if asked), else
+     * SO_TIMESTAMPNS; best effort, receive works either way
+     */
+    SAGE_COLD
+    void enable_rx_timestamps() noexcept {
+        rx_timestamping_ = false;
+        rx_ = {};
+        if (!config_.rx_timestamps) {
+            return;
+        }
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (config_.hw_timestamps) {
+            flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        }
+        const int one = 1;
+        rx_timestamping_ =
+            setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0 ||
+            setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0;
+    }
+
+    SAGE_COLD
+    bool handshake(const WebSocketUrl& url) {
+        uint8_t nonce[16];
+        for (size_t i = 0; i < sizeof(nonce); i += 4) {
+            const uint32_t r = next_mask_key();
+            std::memcpy(nonce + i, &r, sizeof(r));
+        }
+        char key[ws::HANDSHAKE_KEY_LENGTH + 1];
+        ws::base64_encode(nonce, sizeof(nonce), key);
+
+        const std::string host = config_.host_header.empty() ? websocket_host(url) : config_.host_header;
+        const std::string request =
+            "GET " + url.path + " HTTP/1.1\r\n"
+            "Host: " + host + "\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Key: " + key + "\r\n"
+            "Sec-WebSocket-Version: 13\r\n\r\n";
+        if (!send_all(reinterpret_cast<const uint8_t*>(request.data()), request.size())) {
+            return false;
+        }
+
+        // Read the response headers into the receive buffer
+        read_ = 0;
+        write_ = 0;
+        fragmented_ = false;
+        size_t header_end = 0;
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(config_.connect_timeout_ms);
+        while (header_end == 0) {
+            if (std::chrono::steady_clock::now() > deadline || write_ >= MIN_RECV_SPACE) {
+                return fail("Handshake response timed out or too large");
+            }
+            if (!wait_for(POLLIN, 100)) {
+                continue;
+            }
+            const ssize_t n = ::recv(fd_, buffer_ + write_, MIN_RECV_SPACE - write_, 0);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                return fail("Connection closed during handshake");
+            }
+            write_ += static_cast<size_t>(n);
+            for (size_t i = 3; i < write_; ++i) {
+                if (std::memcmp(buffer_ + i - 3, "\r\n\r\n", 4) == 0) {
+                    header_end = i + 1;
+                    break;
+                }
+            }
+        }
+
+        const char* response = reinterpret_cast<const char*>(buffer_);
+        if (header_end < 12 || std::memcmp(response, "HTTP/1.1 101", 12) != 0) {
+            return fail("Server refused the WebSocket upgrade");
+        }
+
+        char expected[ws::ACCEPT_KEY_LENGTH + 1];
+        ws::websocket_accept_key(key, ws::HANDSHAKE_KEY_LENGTH, expected);
+        if (!header_has_value(response, header_end, "Sec-WebSocket-Accept", expected)) {
+            return fail("Bad Sec-WebSocket-Accept");
+        }
+
+        // Frames that arrived with the response stay buffered for poll()
+        // (without a receive timestamp: the handshake reads with plain recv)
+        read_ = header_end;
+        return true;
+    }
+
+    /**
+     * Case-insensitive header name, exact value (surrounding spaces ignored)
+     */
+    static bool header_has_value(const char* headers, size_t length,
+                                 const char* name, const char* value) noexcept {
+        const size_t name_length = std::strlen(name);
+        const size_t value_length = std::strlen(value);
+        const char* end = headers + length;
+
+        for (const char* line = headers; line < end;) {
+            const char* eol = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            if (eol == nullptr) {
+                break;
+            }
+            if (static_cast<size_t>(eol - line) > name_length &&
+                strncasecmp(line, name, name_length) == 0 && line[name_length] == ':') {
+                const char* v = line + name_length + 1;
+                while (v < eol && *v == ' ') ++v;
+                const char* v_end = eol;
+                while (v_end > v && (v_end[-1] == '\r' || v_end[-1] == ' ')) --v_end;
+                return static_cast<size_t>(v_end - v) == value_length &&
+                       std::memcmp(v, value, value_length) == 0;
+            }
+            line = eol + 1;
+        }
+        return false;
+    }
+
+    void close_socket() noexcept {
+        if (fd_ >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd_, nullptr);
+            ::close(fd_);
+            fd_ = -1;
+        }
+        read_ = 0;
+        write_ = 0;
+        fragmented_ = false;
+    }
+
+    SAGE_COLD
+    bool fail(const char* reason) noexcept {
+        last_error_ = reason;
+        return false;
+    }
+
+    /**
+     * xorshift64* (mask keys need to be unpredictable to intermediaries,
+     * not cryptographically strong)
+     */
+    SAGE_ALWAYS_INLINE uint32_t next_mask_key() noexcept {
+        rng_state_ ^= rng_state_ >> 12;
+        rng_state_ ^= rng_state_ << 25;
+        rng_state_ ^= rng_state_ >> 27;
+        return static_cast<uint32_t>((rng_state_ * 0x2545F4914F6CDD1DULL) >> 32);
+    }
+
+    WebSocketConfig config_;
+    Handler handler_;
+
+    int fd_{-1};
+    int epoll_fd_{-1};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // Receive buffer: [read_, write_) is unparsed; an in-progress fragmented
+    // message occupies [fragment_start_, fragment_start_ + fragment_length_)
+    uint8_t* buffer_{nullptr};
+    size_t read_{0};
+    size_t write_{0};
+    bool fragmented_{false};
+    size_t fragment_start_{0};
+    size_t fragment_length_{0};
+
+    bool rx_timestamping_{false};
+    timing::RxTimestamp rx_;         // Receive that completed the current data
+
+    uint64_t rng_state_{0};
+    const char* last_error_{""};
+    WebSocketStats stats_;
 };
 
 } // namespace cal
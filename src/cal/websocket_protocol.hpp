@@ -0,0 +1,321 @@
+#pragma once
+
+/**
+ * SAGE WebSocket Protocol (RFC 6455)
+ * Frame headers, masking and the opening-handshake key check
+ *
+ * Stateless building blocks for WebSocketClient and the test server:
+ * - parse_frame_header / encode_frame_header: the 2-14 byte frame header
+ * - apply_mask: XOR (un)masking, 32 bytes per step on AVX2, 16 on SSE2
+ * - websocket_accept_key: SHA-1 + base64 of key + RFC GUID
+ *
+ * Nothing here allocates; everything works on caller-owned buffers.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../core/compiler.hpp"
+
+namespace sage {
+namespace cal {
+namespace ws {
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+enum class Opcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+// Close status codes used by the client
+constexpr uint16_t CLOSE_NORMAL = 1000;
+constexpr uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+constexpr uint16_t CLOSE_TOO_BIG = 1009;
+
+constexpr size_t MAX_FRAME_HEADER = 14;
+constexpr size_t MAX_CONTROL_PAYLOAD = 125;
+
+struct FrameHeader {
+    uint64_t payload_length;
+    uint32_t mask_key;          // As transmitted (byte 0 in the low byte)
+    uint8_t header_length;      // 2..14
+    Opcode opcode;
+    bool fin;
+    bool masked;
+
+    bool is_control() const noexcept {
+        return (static_cast<uint8_t>(opcode) & 0x8) != 0;
+    }
+};
+
+enum class FrameStatus : uint8_t {
+    COMPLETE,       // Header fully decoded
+    INCOMPLETE,     // Need more bytes
+    PROTOCOL_ERROR  // RSV bits, bad opcode, oversized/fragmented control frame
+};
+
+/**
+ * Decode a frame header from the start of data
+ */
+SAGE_HOT SAGE_ALWAYS_INLINE
+FrameStatus parse_frame_header(const uint8_t* data, size_t available,
+                               FrameHeader& out) noexcept {
+    if (available < 2) {
+        return FrameStatus::INCOMPLETE;
+    }
+    const uint8_t b0 = data[0];
+    const uint8_t b1 = data[1];
+
+    if ((b0 & 0x70) != 0) [[unlikely]] {
+        return FrameStatus::PROTOCOL_ERROR;   // No extensions negotiated
+    }
+    const uint8_t opcode = b0 & 0x0F;
+    if ((opcode > 0x2 && opcode < 0x8) || opcode > 0xA) [[unlikely]] {
+        return FrameStatus::PROTOCOL_ERROR;
+    }
+
+    out.fin = (b0 & 0x80) != 0;
+    out.opcode = static_cast<Opcode>(opcode);
+    out.masked = (b1 & 0x80) != 0;
+
+    size_t length = 2;
+    uint64_t payload = b1 & 0x7F;
+    if (payload == 126) {
+        if (available < 4) return FrameStatus::INCOMPLETE;
+        payload = (static_cast<uint64_t>(data[2]) << 8) | data[3];
+        length = 4;
+    } else if (payload == 127) {
+        if (available < 10) return FrameStatus::INCOMPLETE;
+        uint64_t be;
+        std::memcpy(&be, data + 2, sizeof(be));
+        payload = __builtin_bswap64(be);
+        if (payload >> 63) [[unlikely]] {
+            return FrameStatus::PROTOCOL_ERROR;
+        }
+        length = 10;
+    }
+
+    out.mask_key = 0;
+    if (out.masked) {
+        if (available < length + 4) return FrameStatus::INCOMPLETE;
+        std::memcpy(&out.mask_key, data + length, sizeof(out.mask_key));
+        length += 4;
+    }
+
+    if (out.is_control() && (!out.fin || payload > MAX_CONTROL_PAYLOAD)) [[unlikely]] {
+        return FrameStatus::PROTOCOL_ERROR;
+    }
+
+    out.payload_length = payload;
+    out.header_length = static_cast<uint8_t>(length);
+    return FrameStatus::COMPLETE;
+}
+
+/**
+ * Encode a frame header
+ * @param out  At least MAX_FRAME_HEADER bytes
+ * @return Header length
+ */
+SAGE_ALWAYS_INLINE
+size_t encode_frame_header(uint8_t* out, Opcode opcode, bool fin, uint64_t payload_length,
+                           bool masked, uint32_t mask_key) noexcept {
+    out[0] = static_cast<uint8_t>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode));
+    const uint8_t mask_bit = masked ? 0x80 : 0x00;
+
+    size_t length;
+    if (payload_length < 126) {
+        out[1] = static_cast<uint8_t>(mask_bit | payload_length);
+        length = 2;
+    } else if (payload_length <= 0xFFFF) {
+        out[1] = mask_bit | 126;
+        out[2] = static_cast<uint8_t>(payload_length >> 8);
+        out[3] = static_cast<uint8_t>(payload_length);
+        length = 4;
+    } else {
+        out[1] = mask_bit | 127;
+        const uint64_t be = __builtin_bswap64(payload_length);
+        std::memcpy(out + 2, &be, sizeof(be));
+        length = 10;
+    }
+
+    if (masked) {
+        std::memcpy(out + length, &mask_key, sizeof(mask_key));
+        length += 4;
+    }
+    return length;
+}
+
+/**
+ * XOR data with the repeating 4-byte mask key, in place
+ * Masking is an involution: the same call masks and unmasks.
+ *
+ * @param offset  Position of data[0] within the frame payload (for
+ *                payloads processed in pieces)
+ */
+SAGE_HOT
+inline void apply_mask(uint8_t* data, size_t length, uint32_t mask_key,
+                       size_t offset = 0) noexcept {
+    // Rotate so key byte 0 lines up with data[0]
+    const unsigned shift = static_cast<unsigned>(offset & 3) * 8;
+    const uint32_t key = shift ? ((mask_key >> shift) | (mask_key << (32 - shift))) : mask_key;
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i key256 = _mm256_set1_epi32(static_cast<int>(key));
+    for (; i + 32 <= length; i += 32) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key256));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i key128 = _mm_set1_epi32(static_cast<int>(key));
+    for (; i + 16 <= length; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key128));
+    }
+#endif
+    const uint64_t key64 = (static_cast<uint64_t>(key) << 32) | key;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        word ^= key64;
+        std::memcpy(data + i, &word, sizeof(word));
+    }
+    for (; i < length; ++i) {
+        data[i] ^= static_cast<uint8_t>(key >> ((i & 3) * 8));
+    }
+}
+
+// ============================================================================
+// Opening Handshake
+// ============================================================================
+
+/**
+ * SHA-1 digest (handshake only; not used for anything security-relevant)
+ */
+inline void sha1(const uint8_t* data, size_t length, uint8_t digest[20]) noexcept {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    auto rotl = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+    auto process = [&](const uint8_t* block) {
+        uint32_t w[80];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = (static_cast<uint32_t>(block[t * 4]) << 24) |
+                   (static_cast<uint32_t>(block[t * 4 + 1]) << 16) |
+                   (static_cast<uint32_t>(block[t * 4 + 2]) << 8) |
+                   static_cast<uint32_t>(block[t * 4 + 3]);
+        }
+        for (int t = 16; t < 80; ++t) {
+            w[t] = rotl(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int t = 0; t < 80; ++t) {
+            uint32_t f, k;
+            if (t < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (t < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (t < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            const uint32_t temp = rotl(a, 5) + f + e + k + w[t];
+            e = d; d = c; c = rotl(b, 30); b = a; a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    };
+
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        process(data + i);
+    }
+
+    // Final block(s): remainder, 0x80, zero pad, 64-bit big-endian bit length
+    uint8_t tail[128] = {};
+    const size_t rest = length - i;
+    std::memcpy(tail, data + i, rest);
+    tail[rest] = 0x80;
+    const size_t tail_length = (rest < 56) ? 64 : 128;
+    const uint64_t bits = static_cast<uint64_t>(length) * 8;
+    for (size_t b = 0; b < 8; ++b) {
+        tail[tail_length - 1 - b] = static_cast<uint8_t>(bits >> (b * 8));
+    }
+    process(tail);
+    if (tail_length == 128) {
+        process(tail + 64);
+    }
+
+    for (int t = 0; t < 5; ++t) {
+        digest[t * 4] = static_cast<uint8_t>(h[t] >> 24);
+        digest[t * 4 + 1] = static_cast<uint8_t>(h[t] >> 16);
+        digest[t * 4 + 2] = static_cast<uint8_t>(h[t] >> 8);
+        digest[t * 4 + 3] = static_cast<uint8_t>(h[t]);
+    }
+}
+
+/**
+ * Standard base64 with padding
+ * @param out  At least 4 * ((length + 2) / 3) + 1 bytes (NUL-terminated)
+ * @return Encoded length
+ */
+inline size_t base64_encode(const uint8_t* data, size_t length, char* out) noexcept {
+    static constexpr char ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        const uint32_t v = (static_cast<uint32_t>(data[i]) << 16) |
+                           (static_cast<uint32_t>(data[i + 1]) << 8) | data[i + 2];
+        out[o++] = ALPHABET[(v >> 18) & 0x3F];
+        out[o++] = ALPHABET[(v >> 12) & 0x3F];
+        out[o++] = ALPHABET[(v >> 6) & 0x3F];
+        out[o++] = ALPHABET[v & 0x3F];
+    }
+    if (i < length) {
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < length) {
+            v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        out[o++] = ALPHABET[(v >> 18) & 0x3F];
+        out[o++] = ALPHABET[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < length) ? ALPHABET[(v >> 6) & 0x3F] : '=';
+        out[o++] = '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+constexpr size_t HANDSHAKE_KEY_LENGTH = 24;   // base64 of 16 bytes
+constexpr size_t ACCEPT_KEY_LENGTH = 28;      // base64 of a SHA-1 digest
+
+/**
+ * Sec-WebSocket-Accept for a Sec-WebSocket-Key
+ * @param out  At least ACCEPT_KEY_LENGTH + 1 bytes
+ */
+inline void websocket_accept_key(const char* key, size_t key_length, char* out) noexcept {
+    static constexpr char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    uint8_t input[128];
+    if (key_length > sizeof(input) - (sizeof(GUID) - 1)) {
+        key_length = sizeof(input) - (sizeof(GUID) - 1);
+    }
+    std::memcpy(input, key, key_length);
+    std::memcpy(input + key_length, GUID, sizeof(GUID) - 1);
+
+    uint8_t digest[20];
+    sha1(input, key_length + sizeof(GUID) - 1, digest);
+    base64_encode(digest, sizeof(digest), out);
+}
+
+} // namespace ws
+} // namespace cal
+} // namespace sage
@@ -0,0 +1,369 @@
+#pragma once
+
+/**
+ * SAGE Configuration File
+ * Minimal TOML reader for config/sage.toml (startup only, never hot)
+ *
+ * Supported subset:
+ * - [table] and [dotted.table] headers
+ * - key = value with bare keys
+ * - "basic" strings (\" \\ \n \t escapes) and 'literal' strings
+ * - integers (optional sign, '_' separators), floats, true / false
+ * - single-line arrays of the above
+ * - # comments, also after a value
+ *
+ * Not supported (rejected with an error, never misread): inline tables,
+ * multi-line strings and arrays, arrays of tables, dates.
+ *
+ * Keys are looked up by their full dotted path ("exchanges.binance.enabled").
+ * Getters return the default for a missing key and report a present key
+ * of the wrong type through last_error().
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sage {
+namespace config {
+
+class ConfigFile {
+public:
+    enum class Type : uint8_t { STRING, INTEGER, FLOAT, BOOLEAN, ARRAY };
+
+    struct Value {
+        Type type;
+        std::string text;             // Decoded string / numeric token
+        std::vector<Value> items;     // ARRAY elements
+    };
+
+    /**
+     * Read and parse a file
+     * @return false if unreadable or malformed (see last_error())
+     */
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            error_ = "Cannot open " + path;
+            return false;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        return parse(text.str());
+    }
+
+    bool parse(std::string_view text) {
+        entries_.clear();
+        error_.clear();
+
+        std::string table;
+        size_t line_number = 0;
+        size_t pos = 0;
+        while (pos <= text.size()) {
+            size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) {
+                eol = text.size();
+            }
+            std::string_view line = text.substr(pos, eol - pos);
+            pos = eol + 1;
+            ++line_number;
+
+            skip_space(line);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            if (line[0] == '[') {
+                const size_t close = line.find(']');
+                if (line.size() > 1 && line[1] == '[') {
+                    return fail(line_number, "arrays of tables are not supported");
+                }
+                if (close == std::string_view::npos) {
+                    return fail(line_number, "unterminated table header");
+                }
+                std::string_view rest = line.substr(close + 1);
+                skip_space(rest);
+                if (!rest.empty() && rest[0] != '#') {
+                    return fail(line_number, "unexpected text after table header");
+                }
+                table = std::string(trim(line.substr(1, close - 1)));
+                if (table.empty() || !valid_key(table, true)) {
+                    return fail(line_number, "invalid table name");
+                }
+                continue;
+            }
+
+            const size_t equals = line.find('=');
+            if (equals == std::string_view::npos) {
+                return fail(line_number, "expected key = value");
+            }
+            const std::string_view key = trim(line.substr(0, equals));
+            if (!valid_key(key, false)) {
+                return fail(line_number, "invalid key");
+            }
+
+            std::string_view rest = line.substr(equals + 1);
+            skip_space(rest);
+            Value value;
+            if (!parse_value(rest, value, line_number)) {
+                return false;
+            }
+            skip_space(rest);
+            if (!rest.empty() && rest[0] != '#') {
+                return fail(line_number, "unexpected text after value");
+            }
+
+            std::string path = table.empty() ? std::string(key) : table + "." + std::string(key);
+            if (find(path) != nullptr) {
+                return fail(line_number, "duplicate key " + path);
+            }
+            entries_.push_back({std::move(path), std::move(value)});
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Lookup
+    // ========================================================================
+
+    const Value* find(std::string_view key) const noexcept {
+        for (const auto& entry : entries_) {
+            if (entry.first == key) {
+                return &entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+    bool has(std::string_view key) const noexcept { return find(key) != nullptr; }
+
+    std::string get_string(std::string_view key, std::string fallback = {}) const {
+        const Value* value = typed(key, Type::STRING);
+        return value ? value->text : fallback;
+    }
+
+    int64_t get_int(std::string_view key, int64_t fallback = 0) const {
+        const Value* value = typed(key, Type::INTEGER);
+        return value ? to_int(*value) : fallback;
+    }
+
+    double get_double(std::string_view key, double fallback = 0.0) const {
+        const Value* value = find(key);
+        if (value && (value->type == Type::FLOAT || value->type == Type::INTEGER)) {
+            return std::strtod(value->text.c_str(), nullptr);
+        }
+        typed(key, Type::FLOAT);   // Records the type error, if any
+        return fallback;
+    }
+
+    bool get_bool(std::string_view key, bool fallback = false) const {
+        const Value* value = typed(key, Type::BOOLEAN);
+        return value ? value->text == "true" : fallback;
+    }
+
+    /**
+     * Integer array; false if missing or not an array of integers
+     */
+    bool get_int_array(std::string_view key, std::vector<int64_t>& out) const {
+        const Value* value = typed(key, Type::ARRAY);
+        if (value == nullptr) {
+            return false;
+        }
+        out.clear();
+        for (const Value& item : value->items) {
+            if (item.type != Type::INTEGER) {
+                error_ = std::string(key) + ": expected an array of integers";
+                return false;
+            }
+            out.push_back(to_int(item));
+        }
+        return true;
+    }
+
+    /**
+     * Names of the tables directly under prefix, in file order
+     * ("exchanges" -> {"binance", "coinbase"})
+     */
+    std::vector<std::string> subtables(std::string_view prefix) const {
+        std::vector<std::string> names;
+        const std::string lead = std::string(prefix) + ".";
+        for (const auto& entry : entries_) {
+            const std::string& path = entry.first;
+            if (path.compare(0, lead.size(), lead) != 0) {
+                continue;
+            }
+            const size_t dot = path.find('.', lead.size());
+            if (dot == std::string::npos) {
+                continue;   // A key of prefix itself
+            }
+            std::string name = path.substr(lead.size(), dot - lead.size());
+            bool known = false;
+            for (const auto& existing : names) {
+                known = known || existing == name;
+            }
+            if (!known) {
+                names.push_back(std::move(name));
+            }
+        }
+        return names;
+    }
+
+    size_t size() const noexcept { return entries_.size(); }
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    static void skip_space(std::string_view& s) noexcept {
+        while (!s.empty() && (s[0] == ' ' || s[0] == '\t' || s[0] == '\r')) {
+            s.remove_prefix(1);
+        }
+    }
+
+    static std::string_view trim(std::string_view s) noexcept {
+        skip_space(s);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+
+    static bool valid_key(std::string_view key, bool dotted) noexcept {
+        if (key.empty() || key.front() == '.' || key.back() == '.') {
+            return false;
+        }
+        for (const char c : key) {
+            const bool bare = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                              (c >= '0' && c <= '9') || c == '_' || c == '-';
+            if (!bare && !(dotted && c == '.')) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int64_t to_int(const Value& value) noexcept {
+        return std::strtoll(value.text.c_str(), nullptr, 10);
+    }
+
+    bool parse_value(std::string_view& s, Value& out, size_t line_number) {
+        if (s.empty()) {
+            return fail(line_number, "missing value");
+        }
+
+        if (s[0] == '"' || s[0] == '\'') {
+            const char quote = s[0];
+            if (s.substr(0, 3) == std::string_view(quote == '"' ? "\"\"\"" : "'''")) {
+                return fail(line_number, "multi-line strings are not supported");
+            }
+            out.type = Type::STRING;
+            size_t i = 1;
+            for (; i < s.size() && s[i] != quote; ++i) {
+                if (quote == '"' && s[i] == '\\' && i + 1 < s.size()) {
+                    const char e = s[++i];
+                    out.text += (e == 'n') ? '\n' : (e == 't') ? '\t' : e;
+                } else {
+                    out.text += s[i];
+                }
+            }
+            if (i >= s.size()) {
+                return fail(line_number, "unterminated string");
+            }
+            s.remove_prefix(i + 1);
+            return true;
+        }
+
+        if (s[0] == '[') {
+            out.type = Type::ARRAY;
+            s.remove_prefix(1);
+            for (;;) {
+                skip_space(s);
+                if (s.empty() || s[0] == '#') {
+                    return fail(line_number, "multi-line arrays are not supported");
+                }
+                if (s[0] == ']') {
+                    s.remove_prefix(1);
+                    return true;
+                }
+                Value item;
+                if (!parse_value(s, item, line_number)) {
+                    return false;
+                }
+                if (item.type == Type::ARRAY) {
+                    return fail(line_number, "nested arrays are not supported");
+                }
+                out.items.push_back(std::move(item));
+                skip_space(s);
+                if (!s.empty() && s[0] == ',') {
+                    s.remove_prefix(1);
+                } else if (s.empty() || s[0] != ']') {
+                    return fail(line_number, "expected ',' or ']' in array");
+                }
+            }
+        }
+
+        if (s[0] == '{') {
+            return fail(line_number, "inline tables are not supported");
+        }
+
+        // Bare token: boolean or number
+        size_t length = 0;
+        while (length < s.size() && s[length] != ',' && s[length] != ']' && s[length] != '#' &&
+               s[length] != ' ' && s[length] != '\t' && s[length] != '\r') {
+            ++length;
+        }
+        const std::string_view token = s.substr(0, length);
+        s.remove_prefix(length);
+
+        if (token == "true" || token == "false") {
+            out.type = Type::BOOLEAN;
+            out.text = std::string(token);
+            return true;
+        }
+
+        std::string number;
+        bool is_float = false;
+        for (size_t i = 0; i < token.size(); ++i) {
+            const char c = token[i];
+            if (c == '_') {
+                continue;
+            }
+            const bool sign = (c == '+' || c == '-') &&
+                              (i == 0 || token[i - 1] == 'e' || token[i - 1] == 'E');
+            const bool exponent_or_point = c == '.' || c == 'e' || c == 'E';
+            if (!(c >= '0' && c <= '9') && !sign && !exponent_or_point) {
+                return fail(line_number, "invalid value " + std::string(token));
+            }
+            is_float = is_float || exponent_or_point;
+            number += c;
+        }
+        if (number.empty() || number == "+" || number == "-") {
+            return fail(line_number, "invalid value " + std::string(token));
+        }
+        out.type = is_float ? Type::FLOAT : Type::INTEGER;
+        out.text = std::move(number);
+        return true;
+    }
+
+    const Value* typed(std::string_view key, Type type) const {
+        const Value* value = find(key);
+        if (value != nullptr && value->type != type) {
+            error_ = std::string(key) + ": wrong type";
+            return nullptr;
+        }
+        return value;
+    }
+
+    bool fail(size_t line_number, const std::string& reason) {
+        error_ = "line " + std::to_string(line_number) + ": " + reason;
+        return false;
+    }
+
+    std::vector<std::pair<std::string, Value>> entries_;
+    mutable std::string error_;
+};
+
+} // namespace config
+} // namespace sage
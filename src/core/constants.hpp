@@ -99,10 +99,77 @@ constexpr int CORE_POE = 5;
 /// Ring buffer magic (ASCII: "SAGEBUF0")
 constexpr uint64_t MAGIC_RING_BUFFER = 0x5341474542554630ULL;
 
+/// Broadcast (SPMC) ring magic (ASCII: "SAGEBCR0")
+constexpr uint64_t MAGIC_BROADCAST_RING = 0x5341474542435230ULL;
+
+/// MPSC queue magic (ASCII: "SAGEMPS0")
+constexpr uint64_t MAGIC_MPSC_QUEUE = 0x534147454D505330ULL;
+
+/// Variable-length byte ring magic (ASCII: "SAGEBYT0")
+constexpr uint64_t MAGIC_BYTE_RING = 0x5341474542595430ULL;
+
+/// Conflating queue magic (ASCII: "SAGECFQ0")
+constexpr uint64_t MAGIC_CONFLATING_QUEUE = 0x5341474543465130ULL;
+
+/// Risk state (positions + totals) magic (ASCII: "SAGERSK0")
+constexpr uint64_t MAGIC_RISK_STATE = 0x5341474552534B30ULL;
+
 /// Message magic (ASCII: "SAGEMSG0")
 constexpr uint64_t MAGIC_MESSAGE = 0x534147454D534730ULL;
 
+/// Capture file header magic (ASCII: "SAGECAP0")
+constexpr uint64_t MAGIC_CAPTURE_FILE = 0x5341474543415030ULL;
+
+/// Capture index block magic (ASCII: "SAGEIDX0")
+constexpr uint64_t MAGIC_CAPTURE_INDEX = 0x5341474549445830ULL;
+
+/// Tick archive file header magic (ASCII: "SAGEARC0")
+constexpr uint64_t MAGIC_ARCHIVE_FILE = 0x5341474541524330ULL;
+
+/// Tick archive block magic (ASCII: "SAGEBLK0")
+constexpr uint64_t MAGIC_ARCHIVE_BLOCK = 0x53414745424C4B30ULL;
+
 /// Shared memory magic (ASCII: "SAGESHM0")
 constexpr uint64_t MAGIC_SHM = 0x5341474553484D30ULL;
 
+// ============================================================================
+// SHARED MEMORY CHANNELS
+// ============================================================================
+
+/// Shared memory layout version (bump on any header/object layout change)
+constexpr uint32_t SHM_LAYOUT_VERSION = 2;
+
+/// CAL -> ADE market data (created by CAL)
+constexpr const char* SHM_CAL_TO_ADE = "/sage_cal_to_ade";
+
+/// CAL -> ADE latest tick per symbol while the queue is overloaded (created by CAL)
+constexpr const char* SHM_CAL_TO_ADE_LATEST = "/sage_cal_to_ade_latest";
+
+/// Symbol ids that can be conflated (valid ids are [0, this))
+constexpr size_t SHM_CONFLATION_SYMBOLS = 256;
+
+/// Conflation lanes per (symbol, venue): trade, bid, ask, other
+constexpr size_t SHM_CONFLATION_SIDES = 4;
+
+/// Conflation keys: one per (symbol, venue, side), see conflation_key()
+constexpr size_t SHM_CONFLATION_KEYS =
+    SHM_CONFLATION_SYMBOLS * MAX_EXCHANGES * SHM_CONFLATION_SIDES;
+
+/// CAL market data as ADE consumed it, for lossy readers such as the
+/// recorder (created by ADE; broadcast ring, never blocks ADE)
+constexpr const char* SHM_CAL_TAP = "/sage_cal_tap";
+
+/// Tap capacity in messages (16MB: ~50ms of slack at 5M msgs/sec for a
+/// reader that stalls, e.g. a recorder rotating files)
+constexpr size_t SHM_CAL_TAP_CAPACITY = 262144;
+
+/// ADE -> RME signals (created by ADE; MIND will sit here once deployed)
+constexpr const char* SHM_ADE_TO_RME = "/sage_ade_to_rme";
+
+/// RME -> POE approved orders (created by RME)
+constexpr const char* SHM_RME_TO_POE = "/sage_rme_to_poe";
+
+/// RME positions and risk totals, seqlock-published for readers (created by RME)
+constexpr const char* SHM_RISK_STATE = "/sage_risk_state";
+
 } // namespace sage
@@ -8,9 +8,15 @@
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
+#include <cstdlib>
+
+#include <new>
+#include <utility>
 
 #ifdef __linux__
 #include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 #endif
@@ -47,30 +53,78 @@ inline void free_aligned(void* ptr) noexcept {
 // Huge Pages (2MB)
 // ============================================================================
 
+/**
+ * Round size up to a whole number of huge pages
+ */
+constexpr size_t huge_page_round(size_t size) noexcept {
+    return (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+/**
+ * Ask for transparent huge pages on an existing mapping
+ * Works for anonymous and (with shmem_enabled=advise) shared memory.
+ * Only whole, 2MB-aligned huge pages inside the range are affected.
+ */
+inline bool advise_huge_pages(void* ptr, size_t size) noexcept {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    return madvise(ptr, size, MADV_HUGEPAGE) == 0;
+#else
+    (void)ptr;
+    (void)size;
+    return false;
+#endif
+}
+
 /**
  * Allocate memory using 2MB huge pages
  * Reduces TLB misses for large buffers
+ *
+ * Tries hugetlbfs pages first, then 2MB-aligned regular pages advised
+ * for transparent huge pages.
+ *
+ * @param hugetlb  If non-null, set to true when hugetlbfs pages were used
  */
-inline void* alloc_huge_pages(size_t size) noexcept {
+inline void* alloc_huge_pages(size_t size, bool* hugetlb = nullptr) noexcept {
 #ifdef __linux__
     // Round up to huge page boundary
-    size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    size = huge_page_round(size);
     
     void* ptr = mmap(nullptr, size,
                      PROT_READ | PROT_WRITE,
                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
                      -1, 0);
+    if (hugetlb != nullptr) {
+        *hugetlb = (ptr != MAP_FAILED);
+    }
     
     if (ptr == MAP_FAILED) {
-        // Fallback to regular pages
-        ptr = mmap(nullptr, size,
-                   PROT_READ | PROT_WRITE,
-                   MAP_PRIVATE | MAP_ANONYMOUS,
-                   -1, 0);
+        // Fallback to regular pages, over-mapped so we can 2MB-align for THP
+        const size_t padded = size + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, padded,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1, 0);
+        if (raw == MAP_FAILED) {
+            return nullptr;
+        }
+        
+        const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        const size_t head = aligned - base;
+        if (head > 0) {
+            munmap(raw, head);
+        }
+        munmap(reinterpret_cast<void*>(aligned + size), padded - head - size);
+        
+        ptr = reinterpret_cast<void*>(aligned);
+        advise_huge_pages(ptr, size);
     }
     
-    return (ptr == MAP_FAILED) ? nullptr : ptr;
+    return ptr;
 #else
+    if (hugetlb != nullptr) {
+        *hugetlb = false;
+    }
     return alloc_aligned(size, PAGE_SIZE);
 #endif
 }
@@ -137,6 +191,7 @@ inline bool lock_all_memory() noexcept {
 /**
  * Touch all pages to fault them into memory
  * Call after allocation to avoid page faults in hot path
+ * WARNING: writes zeros - only for fresh, unconstructed memory
  */
 inline void prefault_pages(void* ptr, size_t size) noexcept {
     volatile char* p = static_cast<volatile char*>(ptr);
@@ -145,6 +200,82 @@ inline void prefault_pages(void* ptr, size_t size) noexcept {
     }
 }
 
+/**
+ * Fault pages in writable WITHOUT modifying their contents
+ * Safe on live objects and on shared memory another process owns.
+ */
+inline void populate_pages(void* ptr, size_t size) noexcept {
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+    // Linux 5.14+: one syscall, no data touched
+    const uintptr_t base = reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1);
+    const size_t len = reinterpret_cast<uintptr_t>(ptr) + size - base;
+    if (madvise(reinterpret_cast<void*>(base), len, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    // Fallback: atomic no-op RMW per page (write-faults, value unchanged)
+    char* p = static_cast<char*>(ptr);
+    for (size_t i = 0; i < size; i += PAGE_SIZE) {
+        __atomic_fetch_add(&p[i], 0, __ATOMIC_RELAXED);
+    }
+    if (size > 0) {
+        __atomic_fetch_add(&p[size - 1], 0, __ATOMIC_RELAXED);
+    }
+}
+
+// ============================================================================
+// Page Fault Accounting
+// ============================================================================
+
+/**
+ * Process-wide page fault counters (getrusage)
+ */
+struct PageFaultStats {
+    uint64_t minor;   // Resolved without I/O (first touch, COW)
+    uint64_t major;   // Required I/O
+};
+
+inline PageFaultStats page_faults() noexcept {
+#ifdef __linux__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return {static_cast<uint64_t>(usage.ru_minflt),
+                static_cast<uint64_t>(usage.ru_majflt)};
+    }
+#endif
+    return {0, 0};
+}
+
+/**
+ * Pages of [ptr, ptr + size) currently resident (mincore)
+ * Scoped to one region, unlike page_faults(): unaffected by whatever else
+ * the process (or a sanitizer's shadow memory) faults in meanwhile.
+ * @return Resident page count, 0 if unknown
+ */
+inline size_t resident_pages(const void* ptr, size_t size) noexcept {
+#ifdef __linux__
+    const uintptr_t base = reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1);
+    const size_t pages = (reinterpret_cast<uintptr_t>(ptr) + size - base + PAGE_SIZE - 1) / PAGE_SIZE;
+    unsigned char vec[256];
+    size_t resident = 0;
+    for (size_t done = 0; done < pages;) {
+        const size_t chunk = pages - done < sizeof(vec) ? pages - done : sizeof(vec);
+        if (mincore(reinterpret_cast<void*>(base + done * PAGE_SIZE), chunk * PAGE_SIZE, vec) != 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            resident += vec[i] & 1;
+        }
+        done += chunk;
+    }
+    return resident;
+#else
+    (void)ptr;
+    (void)size;
+    return 0;
+#endif
+}
+
 // ============================================================================
 // Cache Line Operations
 // ============================================================================
@@ -203,6 +334,48 @@ inline int shm_create(const char* name, size_t size, bool& created) noexcept {
 #endif
 }
 
+/**
+ * Open an existing shared memory segment (never creates)
+ * Returns file descriptor or -1 if the segment does not exist
+ */
+inline int shm_open_existing(const char* name) noexcept {
+#ifdef __linux__
+    return shm_open(name, O_RDWR, 0600);
+#else
+    (void)name;
+    return -1;
+#endif
+}
+
+/**
+ * Current size of a shared memory segment (0 on error)
+ */
+inline size_t shm_size(int fd) noexcept {
+#ifdef __linux__
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(st.st_size);
+#else
+    (void)fd;
+    return 0;
+#endif
+}
+
+/**
+ * Close shared memory file descriptor (mapping stays valid)
+ */
+inline void shm_close(int fd) noexcept {
+#ifdef __linux__
+    if (fd >= 0) {
+        close(fd);
+    }
+#else
+    (void)fd;
+#endif
+}
+
 /**
  * Map shared memory into address space
  */
@@ -242,5 +415,165 @@ inline void shm_remove(const char* name) noexcept {
 #endif
 }
 
+// ============================================================================
+// Startup Provisioning
+// ============================================================================
+
+/**
+ * Bump allocator over one huge-page mapping for process-local hot state
+ * (symbol tables, position arrays). Objects are placement-constructed and
+ * never individually freed; the whole arena lives for the process.
+ */
+class HugePageArena {
+public:
+    HugePageArena() noexcept = default;
+    
+    ~HugePageArena() noexcept {
+        if (base_ != nullptr) {
+            free_huge_pages(base_, capacity_);
+        }
+    }
+    
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+    
+    /**
+     * Map the arena (rounded up to whole huge pages)
+     */
+    SAGE_COLD
+    bool reserve(size_t size) noexcept {
+        if (base_ != nullptr) {
+            return false;
+        }
+        capacity_ = huge_page_round(size);
+        base_ = static_cast<char*>(alloc_huge_pages(capacity_, &hugetlb_));
+        used_ = 0;
+        return base_ != nullptr;
+    }
+    
+    /**
+     * Construct a T in the arena
+     * @return nullptr if the arena is exhausted
+     */
+    template<typename T, typename... Args>
+    SAGE_COLD
+    T* create(Args&&... args) noexcept {
+        const size_t offset = (used_ + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (base_ == nullptr || offset + sizeof(T) > capacity_) {
+            return nullptr;
+        }
+        used_ = offset + sizeof(T);
+        return new (base_ + offset) T(std::forward<Args>(args)...);
+    }
+    
+    void* data() const noexcept { return base_; }
+    size_t capacity() const noexcept { return capacity_; }
+    size_t used() const noexcept { return used_; }
+    bool is_hugetlb() const noexcept { return hugetlb_; }
+
+private:
+    char* base_{nullptr};
+    size_t capacity_{0};
+    size_t used_{0};
+    bool hugetlb_{false};
+};
+
+/**
+ * Outcome of MemoryProvisioner::provision()
+ */
+struct ProvisionReport {
+    size_t regions;             // Regions provisioned
+    size_t bytes;               // Total bytes
+    size_t locked_regions;      // Regions successfully mlock()ed
+    size_t huge_regions;        // Regions advised for / backed by huge pages
+    bool all_locked;            // mlockall(CURRENT | FUTURE) succeeded
+    PageFaultStats before;      // Faults before provisioning
+    PageFaultStats after;       // Faults after provisioning (warm baseline)
+};
+
+/**
+ * Startup pass that makes hot memory fault-free
+ *
+ * Register every ring, table and state array, then call provision() once
+ * before entering the hot loop. For each region:
+ *   1. advise transparent huge pages (whole 2MB pages only)
+ *   2. populate writable without touching contents
+ *   3. mlock so it is never reclaimed
+ * then (optionally) mlockall() the rest of the process.
+ * Afterwards faults_since_warmup() should stay flat; a rising value
+ * means something on the hot path is touching unprovisioned memory.
+ */
+class MemoryProvisioner {
+public:
+    static constexpr size_t MAX_REGIONS = 32;
+    
+    /**
+     * Register a region (cold path)
+     * @return false if the table is full
+     */
+    bool add(const char* name, void* ptr, size_t size, bool hugetlb = false) noexcept {
+        if (count_ >= MAX_REGIONS || ptr == nullptr || size == 0) {
+            return false;
+        }
+        regions_[count_++] = {name, ptr, size, hugetlb, false};
+        return true;
+    }
+    
+    /**
+     * Register a statically allocated object
+     */
+    template<typename T>
+    bool add_object(const char* name, T& object) noexcept {
+        return add(name, &object, sizeof(T));
+    }
+    
+    /**
+     * Provision all registered regions
+     * @param lock_all  Also mlockall(CURRENT | FUTURE) the whole process
+     */
+    SAGE_COLD
+    ProvisionReport provision(bool lock_all = true) noexcept {
+        ProvisionReport report{};
+        report.before = page_faults();
+        
+        for (size_t i = 0; i < count_; ++i) {
+            Region& r = regions_[i];
+            const bool huge = r.hugetlb || (r.size >= HUGE_PAGE_SIZE &&
+                                            advise_huge_pages(r.ptr, r.size));
+            populate_pages(r.ptr, r.size);
+            r.locked = lock_memory(r.ptr, r.size);
+            
+            report.bytes += r.size;
+            report.locked_regions += r.locked;
+            report.huge_regions += huge;
+        }
+        report.regions = count_;
+        report.all_locked = lock_all && lock_all_memory();
+        report.after = page_faults();
+        baseline_ = report.after;
+        return report;
+    }
+    
+    /**
+     * Minor faults taken since provision() (should stay ~0 on the hot path)
+     */
+    uint64_t faults_since_warmup() const noexcept {
+        return page_faults().minor - baseline_.minor;
+    }
+
+private:
+    struct Region {
+        const char* name;
+        void* ptr;
+        size_t size;
+        bool hugetlb;
+        bool locked;
+    };
+    
+    Region regions_[MAX_REGIONS]{};
+    size_t count_{0};
+    PageFaultStats baseline_{0, 0};
+};
+
 } // namespace memory
 } // namespace sage
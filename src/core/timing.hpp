@@ -5,8 +5,11 @@
  * Nanosecond-precision timing using TSC (Time Stamp Counter)
  */
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <thread>
 #include "compiler.hpp"
 #include "constants.hpp"
@@ -54,13 +57,94 @@ SAGE_ALWAYS_INLINE uint64_t rdtsc_serialized() noexcept {
     return (static_cast<uint64_t>(hi) << 32) | lo;
 }
 
+// ============================================================================
+// Virtual Time (Replay)
+// ============================================================================
+
+/**
+ * Process-wide replay clock
+ *
+ * Under sage_replay a component must not stamp or decide anything on the
+ * wall clock: its processing thread advances virtual time to the timestamp
+ * of each message before processing it, and get_monotonic_ns(),
+ * get_realtime_ns() and TSCCalibrator::tsc_to_realtime_ns() return that
+ * instead. Output then depends only on the capture, not on replay speed or
+ * scheduling, so replays of the same files produce the same messages.
+ *
+ * rdtsc() and tsc_to_ns() durations stay real: measured processing cost
+ * is what a replay is for.
+ *
+ * Off unless enable_virtual_time() ran at startup; the live cost is one
+ * predictable branch per clock read.
+ */
+namespace detail {
+inline std::atomic<bool> g_virtual_time{false};
+inline std::atomic<uint64_t> g_virtual_now_ns{0};
+} // namespace detail
+
+/**
+ * SAGE_REPLAY is set (non-empty, not "0"): the process is fed by sage_replay
+ */
+inline bool replay_requested() noexcept {
+    const char* value = std::getenv("SAGE_REPLAY");
+    return value != nullptr && value[0] != '\0' && !(value[0] == '0' && value[1] == '\0');
+}
+
+/**
+ * Switch every clock read in this process to virtual time (startup only)
+ */
+inline void enable_virtual_time(uint64_t start_ns = 0) noexcept {
+    detail::g_virtual_now_ns.store(start_ns, std::memory_order_relaxed);
+    detail::g_virtual_time.store(true, std::memory_order_release);
+}
+
+/**
+ * Back to the real clocks (tests; a replay never switches back)
+ */
+inline void disable_virtual_time() noexcept {
+    detail::g_virtual_time.store(false, std::memory_order_release);
+}
+
+SAGE_ALWAYS_INLINE bool virtual_time() noexcept {
+    return detail::g_virtual_time.load(std::memory_order_relaxed);
+}
+
+/**
+ * Move virtual time to a message's timestamp (never backwards, so
+ * monotonic reads stay monotonic across out-of-order venues)
+ */
+SAGE_ALWAYS_INLINE void advance_virtual_time(uint64_t ns) noexcept {
+    if (ns > detail::g_virtual_now_ns.load(std::memory_order_relaxed)) {
+        detail::g_virtual_now_ns.store(ns, std::memory_order_relaxed);
+    }
+}
+
+SAGE_ALWAYS_INLINE uint64_t virtual_now_ns() noexcept {
+    return detail::g_virtual_now_ns.load(std::memory_order_relaxed);
+}
+
 // ============================================================================
 // TSC Calibration
 // ============================================================================
 
+/**
+ * A TSCCalibrator's conversion state (recorded with captures, so TSC
+ * readings taken on the recording host can be mapped back to time)
+ */
+struct TSCCalibration {
+    uint64_t ticks_per_ns_fp16;   // TSC ticks per ns (16.16)
+    uint64_t ns_per_tick_q32;     // ns per TSC tick (32.32)
+    uint64_t base_tsc;            // TSC reading at realtime_base_ns
+    int64_t realtime_base_ns;     // CLOCK_REALTIME at base_tsc
+};
+
 /**
  * TSC frequency calibrator
- * Converts TSC ticks to nanoseconds
+ * Converts TSC ticks to nanoseconds, and TSC readings to CLOCK_REALTIME
+ * (the clock kernel receive timestamps and venue event times use)
+ *
+ * The realtime mapping drifts with NTP/PTP slewing; sync_realtime() from
+ * a housekeeping thread once a second keeps it within a few microseconds.
  */
 class TSCCalibrator {
 public:
@@ -90,6 +174,46 @@ public:
         
         // Also store as double for convenience
         ticks_per_ns_ = static_cast<double>(elapsed_tsc) / elapsed_ns;
+        
+        // Nanoseconds per tick (32.32) for the multiply-only realtime path
+        ns_per_tick_q32_ = static_cast<uint64_t>(
+            (static_cast<unsigned __int128>(elapsed_ns) << 32) / elapsed_tsc);
+        base_tsc_ = rdtscp();
+        sync_realtime();
+    }
+    
+    /**
+     * Re-anchor the realtime mapping (cheap: three clock reads)
+     * Takes the sample with the tightest TSC bracket.
+     */
+    void sync_realtime() noexcept {
+        uint64_t best_window = UINT64_MAX;
+        int64_t best_base = 0;
+        for (int i = 0; i < 3; ++i) {
+            struct timespec ts;
+            const uint64_t before = rdtscp();
+            clock_gettime(CLOCK_REALTIME, &ts);
+            const uint64_t after = rdtscp();
+            if (after - before < best_window) {
+                best_window = after - before;
+                const uint64_t realtime = static_cast<uint64_t>(ts.tv_sec) * NANOS_PER_SEC +
+                                          static_cast<uint64_t>(ts.tv_nsec);
+                best_base = static_cast<int64_t>(realtime) -
+                            ticks_to_ns(static_cast<int64_t>(before + (after - before) / 2 - base_tsc_));
+            }
+        }
+        realtime_base_ns_.store(best_base, std::memory_order_relaxed);
+    }
+    
+    /**
+     * CLOCK_REALTIME nanoseconds at a TSC reading (no division, no syscall)
+     */
+    SAGE_ALWAYS_INLINE uint64_t tsc_to_realtime_ns(uint64_t tsc) const noexcept {
+        if (virtual_time()) [[unlikely]] {
+            return virtual_now_ns();
+        }
+        return static_cast<uint64_t>(realtime_base_ns_.load(std::memory_order_relaxed) +
+                                     ticks_to_ns(static_cast<int64_t>(tsc - base_tsc_)));
     }
     
     SAGE_ALWAYS_INLINE uint64_t tsc_to_ns(uint64_t tsc) const noexcept {
@@ -101,10 +225,41 @@ public:
     }
     
     double get_ticks_per_ns() const noexcept { return ticks_per_ns_; }
+    
+    TSCCalibration calibration() const noexcept {
+        return {ticks_per_ns_fp16_, ns_per_tick_q32_, base_tsc_,
+                realtime_base_ns_.load(std::memory_order_relaxed)};
+    }
 
 private:
+    SAGE_ALWAYS_INLINE int64_t ticks_to_ns(int64_t ticks) const noexcept {
+        return static_cast<int64_t>((static_cast<__int128>(ticks) *
+                                     static_cast<__int128>(ns_per_tick_q32_)) >> 32);
+    }
+    
     uint64_t ticks_per_ns_fp16_{0};  // Fixed-point (16.16)
     double ticks_per_ns_{0.0};
+    uint64_t ns_per_tick_q32_{0};    // Fixed-point (32.32)
+    uint64_t base_tsc_{0};
+    std::atomic<int64_t> realtime_base_ns_{0};   // CLOCK_REALTIME at base_tsc_
+};
+
+// ============================================================================
+// Receive Timestamps
+// ============================================================================
+
+/**
+ * Where a receive timestamp came from (SageMessage::rx_clock)
+ */
+enum class RxClock : uint8_t {
+    NONE = 0,        // Not available: only the userspace callback time is known
+    SOFTWARE = 1,    // Kernel network stack (SO_TIMESTAMPING / SO_TIMESTAMPNS)
+    HARDWARE = 2     // NIC (SO_TIMESTAMPING raw hardware; PHC synced to CLOCK_REALTIME)
+};
+
+struct RxTimestamp {
+    uint64_t realtime_ns = 0;          // CLOCK_REALTIME
+    RxClock clock = RxClock::NONE;
 };
 
 // ============================================================================
@@ -116,6 +271,9 @@ private:
  * More portable but higher latency (~20ns)
  */
 SAGE_ALWAYS_INLINE uint64_t get_monotonic_ns() noexcept {
+    if (virtual_time()) [[unlikely]] {
+        return virtual_now_ns();
+    }
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return static_cast<uint64_t>(ts.tv_sec) * NANOS_PER_SEC + ts.tv_nsec;
@@ -126,6 +284,9 @@ SAGE_ALWAYS_INLINE uint64_t get_monotonic_ns() noexcept {
  * Use for timestamps in logs/audit
  */
 SAGE_ALWAYS_INLINE uint64_t get_realtime_ns() noexcept {
+    if (virtual_time()) [[unlikely]] {
+        return virtual_now_ns();
+    }
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
     return static_cast<uint64_t>(ts.tv_sec) * NANOS_PER_SEC + ts.tv_nsec;
@@ -0,0 +1,313 @@
+#pragma once
+
+/**
+ * SAGE Broadcast Ring (SPMC, disruptor-style)
+ * One producer, up to MAX_CONSUMERS independent readers of the same stream
+ *
+ * Every consumer sees every message without the data being copied into
+ * per-consumer queues. Each consumer owns a cache-line isolated cursor;
+ * the producer only reads those cursors when its cached gate runs out.
+ *
+ * Consumer modes:
+ * - GATING:  producer never overwrites unread data (ADE, risk feed).
+ *            The slowest gating consumer applies back-pressure.
+ * - LOSSY:   producer ignores this cursor (recorder, monitoring).
+ *            A lagging lossy reader is skipped forward and the number of
+ *            overwritten messages is counted in overruns().
+ *
+ * Self-contained (no pointers), so it can live in a ShmSegment.
+ *
+ * Target latency: <25ns publish with gating consumers keeping up
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+
+namespace sage {
+
+enum class ConsumerMode : uint32_t {
+    INACTIVE = 0,
+    GATING = 1,
+    LOSSY = 2
+};
+
+/**
+ * Single-producer broadcast ring
+ *
+ * @tparam T            Element type (trivially copyable)
+ * @tparam N            Capacity (power of 2)
+ * @tparam MaxConsumers Maximum registered consumers
+ */
+template<typename T, size_t N, size_t MaxConsumers = MAX_CONSUMERS>
+class BroadcastRing {
+    static_assert((N & (N - 1)) == 0, "Capacity must be power of 2");
+    static_assert(N >= 16, "Capacity must be at least 16");
+    static_assert(MaxConsumers >= 1 && MaxConsumers <= MAX_CONSUMERS,
+                  "Consumer count out of range");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t CAPACITY = N;
+    static constexpr size_t MASK = N - 1;
+    static constexpr uint64_t MAGIC = MAGIC_BROADCAST_RING;
+
+    BroadcastRing() noexcept {
+        head_.store(0, std::memory_order_relaxed);
+        registered_.store(0, std::memory_order_relaxed);
+        for (auto& c : consumers_) {
+            c.cursor.store(0, std::memory_order_relaxed);
+            c.overruns.store(0, std::memory_order_relaxed);
+            c.mode.store(static_cast<uint32_t>(ConsumerMode::INACTIVE),
+                         std::memory_order_relaxed);
+            c.cached_head = 0;
+        }
+    }
+
+    // ========================================================================
+    // Registration (startup / cold path)
+    // ========================================================================
+
+    /**
+     * Register a consumer starting at the current head
+     * Gating consumers should register before the producer starts
+     * publishing; lossy consumers may join at any time.
+     * @return consumer id, or -1 if all slots are taken
+     */
+    SAGE_COLD
+    int add_consumer(ConsumerMode mode = ConsumerMode::GATING) noexcept {
+        for (size_t i = 0; i < MaxConsumers; ++i) {
+            Consumer& c = consumers_[i];
+            uint32_t expected = static_cast<uint32_t>(ConsumerMode::INACTIVE);
+            // Claim the slot with a placeholder so racing registrations
+            // don't take the same id
+            if (!c.mode.compare_exchange_strong(expected,
+                    static_cast<uint32_t>(ConsumerMode::LOSSY),
+                    std::memory_order_acq_rel)) {
+                continue;
+            }
+
+            const uint64_t head = head_.load(std::memory_order_acquire);
+            c.cursor.store(head, std::memory_order_relaxed);
+            c.cached_head = head;
+            c.overruns.store(0, std::memory_order_relaxed);
+            c.mode.store(static_cast<uint32_t>(mode), std::memory_order_release);
+
+            // Producer scans [0, registered_) when refreshing its gate
+            size_t reg = registered_.load(std::memory_order_relaxed);
+            while (reg < i + 1 &&
+                   !registered_.compare_exchange_weak(reg, i + 1,
+                        std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    /**
+     * Unregister a consumer (stops gating the producer immediately)
+     */
+    SAGE_COLD
+    void remove_consumer(int id) noexcept {
+        consumers_[static_cast<size_t>(id)].mode.store(
+            static_cast<uint32_t>(ConsumerMode::INACTIVE), std::memory_order_release);
+    }
+
+    // ========================================================================
+    // Producer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Publish an element to all consumers (non-blocking)
+     * @return false if the slowest gating consumer is a full ring behind
+     */
+    SAGE_HOT SAGE_FLATTEN
+    bool try_publish(const T& item) noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+
+        if (head - cached_gate_ >= N) [[unlikely]] {
+            cached_gate_ = min_gating_cursor(head);
+            if (head - cached_gate_ >= N) {
+                return false;  // Slowest gating consumer is full
+            }
+        }
+
+        // Lossy readers validate against head after copying; this fence
+        // orders the previous head store before the slot overwrite
+        // (compiles to nothing on x86)
+        std::atomic_thread_fence(std::memory_order_release);
+
+        SAGE_PREFETCH_WRITE(&buffer_[(head + 1) & MASK]);
+        buffer_[head & MASK] = item;
+
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Publish with spin-wait (blocks while a gating consumer is full)
+     */
+    SAGE_HOT
+    void publish_blocking(const T& item) noexcept {
+        while (!try_publish(item)) [[unlikely]] {
+            SAGE_CPU_PAUSE();
+        }
+    }
+
+    // ========================================================================
+    // Consumer Interface (one thread per consumer id)
+    // ========================================================================
+
+    /**
+     * Consume the next element for this consumer (non-blocking)
+     * @return true if an element was read, false if caught up
+     */
+    SAGE_HOT SAGE_FLATTEN
+    bool try_consume(int id, T& item) noexcept {
+        return try_consume_batch(id, &item, 1) == 1;
+    }
+
+    /**
+     * Consume up to max_count elements with a single cursor store
+     * @return Number of elements read
+     */
+    SAGE_HOT
+    size_t try_consume_batch(int id, T* items, size_t max_count) noexcept {
+        Consumer& c = consumers_[static_cast<size_t>(id)];
+        uint64_t cursor = c.cursor.load(std::memory_order_relaxed);
+
+        if (c.cached_head == cursor) {
+            c.cached_head = head_.load(std::memory_order_acquire);
+            if (c.cached_head == cursor) {
+                return 0;  // Caught up
+            }
+        }
+
+        const bool lossy = c.mode.load(std::memory_order_relaxed) ==
+                           static_cast<uint32_t>(ConsumerMode::LOSSY);
+
+        if (lossy && c.cached_head - cursor >= N) [[unlikely]] {
+            cursor = skip_overrun(c, cursor, c.cached_head);
+        }
+
+        const uint64_t available = c.cached_head - cursor;
+        const size_t to_read = (available < max_count)
+                                   ? static_cast<size_t>(available) : max_count;
+
+        for (size_t i = 0; i < to_read; ++i) {
+            items[i] = buffer_[(cursor + i) & MASK];
+        }
+
+        if (lossy) [[unlikely]] {
+            // Discard anything the producer may have overwritten mid-copy
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t head_now = head_.load(std::memory_order_relaxed);
+            if (head_now - cursor >= N) {
+                c.cached_head = head_now;
+                skip_overrun(c, cursor, head_now);
+                return 0;
+            }
+        }
+
+        c.cursor.store(cursor + to_read, std::memory_order_release);
+        return to_read;
+    }
+
+    // ========================================================================
+    // Monitoring (thread-safe, approximate)
+    // ========================================================================
+
+    /**
+     * Messages published but not yet consumed by this consumer
+     */
+    uint64_t lag(int id) const noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        return head - consumers_[static_cast<size_t>(id)].cursor.load(
+            std::memory_order_relaxed);
+    }
+
+    /**
+     * Messages a lossy consumer lost to overwrite
+     */
+    uint64_t overruns(int id) const noexcept {
+        return consumers_[static_cast<size_t>(id)].overruns.load(
+            std::memory_order_relaxed);
+    }
+
+    uint64_t published() const noexcept {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+    size_t consumer_count() const noexcept {
+        size_t count = 0;
+        for (const auto& c : consumers_) {
+            count += c.mode.load(std::memory_order_relaxed) !=
+                     static_cast<uint32_t>(ConsumerMode::INACTIVE);
+        }
+        return count;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return N;
+    }
+
+private:
+    /**
+     * Per-consumer state (one cache line, written only by its consumer)
+     */
+    struct SAGE_CACHE_ALIGNED Consumer {
+        std::atomic<uint64_t> cursor;     // Next sequence to read
+        std::atomic<uint64_t> overruns;   // Lossy mode: messages skipped
+        std::atomic<uint32_t> mode;       // ConsumerMode
+        uint64_t cached_head;             // Consumer's cached head
+    };
+    static_assert(sizeof(Consumer) == CACHE_LINE_SIZE, "Consumer must be one cache line");
+
+    SAGE_COLD
+    uint64_t min_gating_cursor(uint64_t head) const noexcept {
+        uint64_t min_cursor = head;
+        const size_t reg = registered_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < reg; ++i) {
+            const Consumer& c = consumers_[i];
+            if (c.mode.load(std::memory_order_acquire) !=
+                static_cast<uint32_t>(ConsumerMode::GATING)) {
+                continue;
+            }
+            const uint64_t cursor = c.cursor.load(std::memory_order_acquire);
+            if (cursor < min_cursor) {
+                min_cursor = cursor;
+            }
+        }
+        return min_cursor;
+    }
+
+    SAGE_COLD
+    uint64_t skip_overrun(Consumer& c, uint64_t cursor, uint64_t head) noexcept {
+        // Resume half a ring behind head to leave room before the next lap
+        const uint64_t resume = head - N / 2;
+        c.overruns.fetch_add(resume - cursor, std::memory_order_relaxed);
+        c.cursor.store(resume, std::memory_order_release);
+        return resume;
+    }
+
+    // Producer state (one cache line)
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> head_{0};
+    uint64_t cached_gate_{0};                 // Producer's cached min cursor
+    std::atomic<size_t> registered_{0};       // High-water consumer slot
+
+    // Consumer cursors (one cache line each)
+    Consumer consumers_[MaxConsumers];
+
+    // Data buffer (separate cache lines from control)
+    union {
+        SAGE_CACHE_ALIGNED T buffer_[N];
+    };
+};
+
+} // namespace sage
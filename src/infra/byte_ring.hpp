@@ -0,0 +1,261 @@
+#pragma once
+
+/**
+ * SAGE Variable-Length Byte Ring (SPSC, bip-buffer style)
+ * Raw exchange frames (recv -> parse) and encoded FIX (encode -> send)
+ *
+ * Every record is handed out as ONE contiguous region, so the writer can
+ * recv()/encode directly into the ring and the reader can parse/send
+ * directly out of it - no wrap-splitting, no side buffers.
+ *
+ * Layout of a record (8-byte aligned):
+ *
+ *   ┌──────────┬──────────┬─────────────────────────┬─────┐
+ *   │ len (4B) │ rsvd(4B) │ payload (len bytes)     │ pad │
+ *   └──────────┴──────────┴─────────────────────────┴─────┘
+ *
+ * When a record doesn't fit before the physical end of the buffer, the
+ * producer writes a WRAP marker header and starts the record at offset 0.
+ * The skipped tail is counted as used until the consumer passes it.
+ *
+ * Positions are monotonic byte counters (like RingBuffer's head/tail), so
+ * full/empty never alias. Self-contained (no pointers), so it can live in
+ * a ShmSegment.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+
+namespace sage {
+
+/**
+ * Lock-free SPSC ring of variable-length byte records
+ *
+ * @tparam N  Capacity in bytes (power of 2)
+ */
+template<size_t N>
+class ByteRing {
+    static_assert((N & (N - 1)) == 0, "Capacity must be power of 2");
+    static_assert(N >= 1024, "Capacity must be at least 1KB");
+
+public:
+    using value_type = uint8_t;
+
+    static constexpr size_t CAPACITY = N;
+    static constexpr size_t MASK = N - 1;
+    static constexpr uint64_t MAGIC = MAGIC_BYTE_RING;
+
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t ALIGNMENT = 8;
+
+    /**
+     * Largest payload that is always placeable, even right before a wrap
+     */
+    static constexpr size_t MAX_RECORD_SIZE = N / 2 - HEADER_SIZE;
+
+    ByteRing() noexcept {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    // ========================================================================
+    // Producer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Reserve a contiguous region of max_len bytes
+     * Nothing is visible to the consumer until commit().
+     *
+     * @return Writable region, or nullptr if full / max_len > MAX_RECORD_SIZE
+     */
+    SAGE_HOT
+    uint8_t* try_reserve(size_t max_len) noexcept {
+        if (max_len > MAX_RECORD_SIZE) [[unlikely]] {
+            return nullptr;
+        }
+
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const size_t index = static_cast<size_t>(head & MASK);
+        const size_t to_end = N - index;
+        const size_t record = record_size(max_len);
+
+        // Not enough room before the end: burn the tail and wrap
+        const size_t skip = (record > to_end) ? to_end : 0;
+        const size_t needed = skip + record;
+
+        if (N - (head - cached_tail_) < needed) [[unlikely]] {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (N - (head - cached_tail_) < needed) {
+                return nullptr;  // Ring full
+            }
+        }
+
+        reserved_skip_ = skip;
+        reserved_len_ = max_len;
+        return &buffer_[((head + skip) & MASK) + HEADER_SIZE];
+    }
+
+    /**
+     * Publish the last reservation with its actual length (len <= reserved)
+     * One release store per record.
+     */
+    SAGE_HOT
+    void commit(size_t len) noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+
+        if (reserved_skip_ != 0) [[unlikely]] {
+            write_header(static_cast<size_t>(head & MASK), WRAP_MARKER);
+        }
+
+        if (len > reserved_len_) [[unlikely]] {
+            len = reserved_len_;
+        }
+
+        const uint64_t start = head + reserved_skip_;
+        write_header(static_cast<size_t>(start & MASK), static_cast<uint32_t>(len));
+
+        head_.store(start + record_size(len), std::memory_order_release);
+        reserved_skip_ = 0;
+        reserved_len_ = 0;
+    }
+
+    /**
+     * Copy a record in (convenience for callers that already have bytes)
+     * @return false if full or too large
+     */
+    SAGE_HOT
+    bool try_write(const void* data, size_t len) noexcept {
+        uint8_t* dst = try_reserve(len);
+        if (dst == nullptr) {
+            return false;
+        }
+        std::memcpy(dst, data, len);
+        commit(len);
+        return true;
+    }
+
+    // ========================================================================
+    // Consumer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Expose the next record in place
+     * The region stays valid (the producer cannot reuse it) until release().
+     *
+     * @param len  Set to the record's payload length
+     * @return Readable region, or nullptr if empty
+     */
+    SAGE_HOT
+    const uint8_t* try_peek(size_t& len) noexcept {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (cached_head_ == tail) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (cached_head_ == tail) {
+                return nullptr;  // Ring empty
+            }
+        }
+
+        size_t index = static_cast<size_t>(tail & MASK);
+        uint32_t length = read_header(index);
+
+        // Producer wrapped here: hand the skipped tail back immediately.
+        // A WRAP marker is always published together with the record after
+        // it, so the ring cannot be empty at offset 0.
+        if (length == WRAP_MARKER) [[unlikely]] {
+            tail += N - index;
+            tail_.store(tail, std::memory_order_release);
+            index = 0;
+            length = read_header(0);
+        }
+
+        len = length;
+        return &buffer_[index + HEADER_SIZE];
+    }
+
+    /**
+     * Consume the record returned by the last try_peek()
+     */
+    SAGE_HOT
+    void release() noexcept {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t length = read_header(static_cast<size_t>(tail & MASK));
+        tail_.store(tail + record_size(length), std::memory_order_release);
+    }
+
+    /**
+     * Copy the next record out (convenience)
+     * @return Payload length, 0 if empty; records larger than max_len are
+     *         truncated to max_len but still consumed
+     */
+    SAGE_HOT
+    size_t try_read(void* out, size_t max_len) noexcept {
+        size_t len = 0;
+        const uint8_t* src = try_peek(len);
+        if (src == nullptr) {
+            return 0;
+        }
+        const size_t n = (len < max_len) ? len : max_len;
+        std::memcpy(out, src, n);
+        release();
+        return n;
+    }
+
+    // ========================================================================
+    // Capacity Queries (thread-safe but approximate)
+    // ========================================================================
+
+    /**
+     * Bytes in use, including headers, padding and wrap skips
+     */
+    size_t bytes_used_approx() const noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        return static_cast<size_t>(head - tail);
+    }
+
+    bool empty_approx() const noexcept {
+        return bytes_used_approx() == 0;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return N;
+    }
+
+private:
+    static constexpr uint32_t WRAP_MARKER = 0xFFFFFFFFu;
+
+    static constexpr size_t record_size(size_t len) noexcept {
+        return (HEADER_SIZE + len + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    SAGE_ALWAYS_INLINE void write_header(size_t index, uint32_t len) noexcept {
+        std::memcpy(&buffer_[index], &len, sizeof(len));
+    }
+
+    SAGE_ALWAYS_INLINE uint32_t read_header(size_t index) const noexcept {
+        uint32_t len;
+        std::memcpy(&len, &buffer_[index], sizeof(len));
+        return len;
+    }
+
+    // Producer state (one cache line)
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_{0};       // Producer's cached tail
+    size_t reserved_skip_{0};       // Wrap skip of the open reservation
+    size_t reserved_len_{0};        // Length of the open reservation
+
+    // Consumer state (one cache line)
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_{0};       // Consumer's cached head
+
+    // Data buffer (separate cache lines from control)
+    SAGE_CACHE_ALIGNED uint8_t buffer_[N];
+};
+
+} // namespace sage
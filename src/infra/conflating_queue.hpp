@@ -0,0 +1,213 @@
+#pragma once
+
+/**
+ * SAGE Conflating Queue
+ * Latest-value-per-key channel for market data under overload
+ *
+ * Instead of queueing every tick, each key (symbol) owns one slot that
+ * always holds its newest value. A slow consumer therefore sees at most
+ * one update per key, never a stale backlog; superseded updates are
+ * counted, not lost silently.
+ *
+ * Design:
+ * - Per-key slot guarded by a seqlock (producers never wait on the
+ *   consumer; two producers updating the same key serialize for one copy).
+ * - A key is enqueued on an MpscQueue of indices only on its clean ->
+ *   pending transition, so the index queue never holds a key twice and
+ *   can never overflow.
+ * - The consumer clears `pending` before copying, so an update that lands
+ *   mid-read re-enqueues the key instead of being missed; a re-enqueued
+ *   key whose version was already delivered is skipped.
+ *
+ * Multi-producer, single-consumer. Self-contained (no pointers), so it
+ * can live in a ShmSegment.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "mpsc_queue.hpp"
+
+namespace sage {
+
+/**
+ * Multi-producer, single-consumer conflating queue keyed by a small integer
+ *
+ * @tparam T        Element type (trivially copyable)
+ * @tparam MaxKeys  Number of keys; valid keys are [0, MaxKeys) (power of 2)
+ */
+template<typename T, size_t MaxKeys>
+class ConflatingQueue {
+    static_assert((MaxKeys & (MaxKeys - 1)) == 0, "Key count must be power of 2");
+    static_assert(MaxKeys >= 16, "Key count must be at least 16");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t CAPACITY = MaxKeys;
+    static constexpr uint64_t MAGIC = MAGIC_CONFLATING_QUEUE;
+
+    ConflatingQueue() noexcept {
+        for (auto& slot : slots_) {
+            slot.sequence.store(0, std::memory_order_relaxed);
+            slot.pending.store(0, std::memory_order_relaxed);
+            slot.updates.store(0, std::memory_order_relaxed);
+            slot.read_sequence = 0;
+        }
+        conflated_.store(0, std::memory_order_relaxed);
+    }
+
+    // ========================================================================
+    // Producer Interface (Any Thread, never waits on the consumer)
+    // ========================================================================
+
+    /**
+     * Replace the latest value for key
+     * @return false only if key is out of range
+     */
+    SAGE_HOT
+    bool publish(size_t key, const T& item) noexcept {
+        if (key >= MaxKeys) [[unlikely]] {
+            return false;
+        }
+        Slot& slot = slots_[key];
+
+        // Seqlock write (odd = write in progress)
+        uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1) == 0 &&
+                slot.sequence.compare_exchange_weak(seq, seq + 1,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+            SAGE_CPU_PAUSE();
+            seq = slot.sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.data = item;
+        slot.sequence.store(seq + 2, std::memory_order_release);
+
+        // Superseded an unread value?
+        if (slot.updates.fetch_add(1, std::memory_order_relaxed) != 0) {
+            conflated_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // First update since the consumer last read it: announce the key
+        if (slot.pending.exchange(1, std::memory_order_acq_rel) == 0) {
+            ready_.push_blocking(static_cast<uint32_t>(key));
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Consumer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Pop the latest value of the next updated key
+     * @param conflated  Set to the number of updates this one superseded
+     * @return false if no key has pending updates
+     */
+    SAGE_HOT
+    bool try_pop(T& item, uint32_t& conflated) noexcept {
+        uint32_t key;
+        while (ready_.try_pop(key)) {
+            Slot& slot = slots_[key];
+
+            // Re-arm before reading: a concurrent publish re-enqueues the key
+            slot.pending.store(0, std::memory_order_seq_cst);
+            const uint32_t updates = slot.updates.exchange(0, std::memory_order_relaxed);
+
+            const uint64_t seq = read_slot(slot, item);
+
+            // Already delivered this version (publish raced the last read)
+            if (seq == slot.read_sequence) [[unlikely]] {
+                continue;
+            }
+            slot.read_sequence = seq;
+            conflated = (updates > 1) ? updates - 1 : 0;
+            return true;
+        }
+        return false;
+    }
+
+    SAGE_HOT
+    bool try_pop(T& item) noexcept {
+        uint32_t conflated;
+        return try_pop(item, conflated);
+    }
+
+    // ========================================================================
+    // Monitoring (thread-safe, approximate)
+    // ========================================================================
+
+    /**
+     * Keys with an unread update
+     */
+    size_t pending_approx() const noexcept {
+        return ready_.size_approx();
+    }
+
+    bool empty_approx() const noexcept {
+        return ready_.empty_approx();
+    }
+
+    /**
+     * Total updates replaced before the consumer read them
+     */
+    uint64_t conflated_total() const noexcept {
+        return conflated_.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return MaxKeys;
+    }
+
+private:
+    struct SAGE_CACHE_ALIGNED Slot {
+        std::atomic<uint64_t> sequence;   // Seqlock (odd while writing)
+        std::atomic<uint32_t> pending;    // 1 while the key sits in ready_
+        std::atomic<uint32_t> updates;    // Publishes since last read
+        uint64_t read_sequence;           // Consumer only: last version read
+        union {
+            T data;   // Never default-constructed (see RingBuffer)
+        };
+
+        Slot() noexcept {}
+    };
+
+    /**
+     * Seqlock read, retrying while a producer is mid-write
+     * @return The stable sequence the copy corresponds to
+     */
+    SAGE_ALWAYS_INLINE
+    static uint64_t read_slot(const Slot& slot, T& item) noexcept {
+        for (;;) {
+            const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            if (seq & 1) [[unlikely]] {
+                SAGE_CPU_PAUSE();
+                continue;
+            }
+            item = slot.data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == seq) [[likely]] {
+                return seq;
+            }
+        }
+    }
+
+    // Keys with unread updates, in first-update order
+    MpscQueue<uint32_t, MaxKeys> ready_;
+
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> conflated_{0};
+
+    Slot slots_[MaxKeys];
+};
+
+} // namespace sage
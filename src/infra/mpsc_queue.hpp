@@ -0,0 +1,196 @@
+#pragma once
+
+/**
+ * SAGE Lock-Free MPSC Queue
+ * Many producers (exchange connectors, heartbeat) into one consumer (ADE)
+ *
+ * Design (per-slot sequence stamps, Vyukov-style):
+ * - Each slot carries a sequence number that encodes who owns it:
+ *     seq == pos        free for the producer that claims pos
+ *     seq == pos + 1    published, readable by the consumer
+ *     seq == pos + N    released by the consumer for the next lap
+ * - Producers claim a position with one fetch_add on tail_ (no CAS
+ *   retry loop), after a read-only full check on the slot at the current
+ *   tail: a full queue fails the push without claiming anything, and
+ *   producers never read the consumer's cache line.
+ * - Producers that pass the check together can claim up to (producers - 1)
+ *   positions past the last free slot; those wait for the consumer to
+ *   free their slot. The wait only happens within that many slots of
+ *   full, and is the price of a claim that cannot fail under contention.
+ * - The consumer is wait-free and touches only the slot it reads.
+ *
+ * Self-contained (no pointers), so it can live in a ShmSegment.
+ *
+ * Target latency: <40ns push under moderate contention
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+
+namespace sage {
+
+/**
+ * Lock-free MPSC (Multi Producer Single Consumer) bounded queue
+ *
+ * @tparam T     Element type (should be trivially copyable)
+ * @tparam N     Capacity (must be power of 2)
+ */
+template<typename T, size_t N>
+class MpscQueue {
+    static_assert((N & (N - 1)) == 0, "Capacity must be power of 2");
+    static_assert(N >= 16, "Capacity must be at least 16");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t CAPACITY = N;
+    static constexpr size_t MASK = N - 1;
+    static constexpr uint64_t MAGIC = MAGIC_MPSC_QUEUE;
+
+    MpscQueue() noexcept {
+        tail_.store(0, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < N; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // ========================================================================
+    // Producer Interface (Any Thread)
+    // ========================================================================
+
+    /**
+     * Attempt to push an element
+     * @return true if successful, false if queue is full
+     *
+     * Fails without claiming when the slot at the tail still holds last
+     * lap's element. A claim made in a race just short of full may wait
+     * for the consumer to free its slot (see the file header).
+     */
+    SAGE_HOT SAGE_FLATTEN
+    bool try_push(const T& item) noexcept {
+        // Full check: read-only, so a full queue costs no claim
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t seq = slots_[tail & MASK].sequence.load(std::memory_order_acquire);
+        if (static_cast<int64_t>(seq - tail) < 0) [[unlikely]] {
+            return false;
+        }
+
+        const uint64_t pos = tail_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots_[pos & MASK];
+        while (slot.sequence.load(std::memory_order_acquire) != pos) [[unlikely]] {
+            SAGE_CPU_PAUSE();
+        }
+
+        slot.data = item;
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Push with spin-wait (blocks if full)
+     */
+    SAGE_HOT
+    void push_blocking(const T& item) noexcept {
+        while (!try_push(item)) [[unlikely]] {
+            SAGE_CPU_PAUSE();
+        }
+    }
+
+    // ========================================================================
+    // Consumer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Attempt to pop the next element in claim order
+     * @return true if successful, false if empty (or next slot in flight)
+     */
+    SAGE_HOT SAGE_FLATTEN
+    bool try_pop(T& item) noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head & MASK];
+
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+
+        SAGE_PREFETCH_READ(&slots_[(head + 1) & MASK]);
+
+        item = slot.data;
+        slot.sequence.store(head + N, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Pop multiple elements, stopping at the first unpublished slot
+     * @return Number of elements actually popped
+     */
+    SAGE_HOT
+    size_t try_pop_batch(T* items, size_t max_count) noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t count = 0;
+
+        while (count < max_count) {
+            Slot& slot = slots_[(head + count) & MASK];
+            if (slot.sequence.load(std::memory_order_acquire) != head + count + 1) {
+                break;
+            }
+            items[count] = slot.data;
+            slot.sequence.store(head + count + N, std::memory_order_release);
+            ++count;
+        }
+
+        if (count > 0) {
+            head_.store(head + count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    // ========================================================================
+    // Capacity Queries (thread-safe but approximate)
+    // ========================================================================
+
+    size_t size_approx() const noexcept {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        return (tail > head) ? static_cast<size_t>(tail - head) : 0;
+    }
+
+    bool empty_approx() const noexcept {
+        return size_approx() == 0;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return N;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        union {
+            T data;   // Never default-constructed (see RingBuffer)
+        };
+
+        Slot() noexcept {}
+    };
+
+    // Producer claim counter (contended by producers only)
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> tail_{0};
+    char pad1_[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+    // Consumer position (written by the consumer only)
+    SAGE_CACHE_ALIGNED std::atomic<uint64_t> head_{0};
+    char pad2_[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+    // Slots (separate cache lines from control)
+    SAGE_CACHE_ALIGNED Slot slots_[N];
+};
+
+} // namespace sage
@@ -10,6 +10,8 @@
  * - Power-of-2 capacity for bitmasking
  * - Acquire-release memory ordering
  * - No dynamic allocation
+ * - Zero-copy claim/commit and peek/release spans for bursts
+ * - Optional futex wakeup for sleeping consumers (see wait_strategy.hpp)
  * 
  * Target latency: <20ns push/pop
  */
@@ -22,6 +24,7 @@
 
 #include "../core/compiler.hpp"
 #include "../core/constants.hpp"
+#include "wait_strategy.hpp"
 
 namespace sage {
 
@@ -38,8 +41,11 @@ class RingBuffer {
     static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
     
 public:
+    using value_type = T;
+    
     static constexpr size_t CAPACITY = N;
     static constexpr size_t MASK = N - 1;
+    static constexpr uint64_t MAGIC = MAGIC_RING_BUFFER;
     
     RingBuffer() noexcept {
         head_.store(0, std::memory_order_relaxed);
@@ -76,6 +82,7 @@ public:
         
         // Publish to consumer
         head_.store(next_head, std::memory_order_release);
+        signal_.notify();
         
         return true;
     }
@@ -180,6 +187,121 @@ public:
         return to_pop;
     }
     
+    /**
+     * Push multiple elements with a single head_ publish
+     * @return Number of elements actually pushed (may be < count if full)
+     */
+    SAGE_HOT
+    size_t try_push_batch(const T* items, size_t count) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        
+        size_t free_slots = N - (head - cached_tail_);
+        if (free_slots < count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            free_slots = N - (head - cached_tail_);
+        }
+        
+        const size_t to_push = (free_slots < count) ? free_slots : count;
+        if (to_push == 0) {
+            return 0;
+        }
+        
+        for (size_t i = 0; i < to_push; ++i) {
+            buffer_[(head + i) & MASK] = items[i];
+        }
+        
+        // Publish all at once
+        head_.store(head + to_push, std::memory_order_release);
+        signal_.notify();
+        
+        return to_push;
+    }
+    
+    // ========================================================================
+    // Zero-Copy Producer Interface (Single Thread)
+    // ========================================================================
+    
+    /**
+     * Reserve up to max_count contiguous slots for in-place construction
+     * The span stops at the physical end of the buffer; claim again after
+     * commit() to continue from the start. Nothing is visible to the
+     * consumer until commit().
+     *
+     * @param slots  Set to the first reserved slot
+     * @return Number of slots reserved (0 if full)
+     */
+    SAGE_HOT
+    size_t try_claim(size_t max_count, T*& slots) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        
+        size_t free_slots = N - (head - cached_tail_);
+        if (free_slots < max_count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            free_slots = N - (head - cached_tail_);
+        }
+        
+        const size_t index = head & MASK;
+        const size_t contiguous = N - index;
+        size_t count = (free_slots < max_count) ? free_slots : max_count;
+        count = (contiguous < count) ? contiguous : count;
+        
+        slots = &buffer_[index];
+        return count;
+    }
+    
+    /**
+     * Publish the first count slots from the last try_claim()
+     * One release store regardless of count.
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void commit(size_t count) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        head_.store(head + count, std::memory_order_release);
+        signal_.notify();
+    }
+    
+    // ========================================================================
+    // Zero-Copy Consumer Interface (Single Thread)
+    // ========================================================================
+    
+    /**
+     * Expose up to max_count readable elements in place
+     * The span stops at the physical end of the buffer. Elements stay
+     * valid (the producer cannot overwrite them) until release().
+     *
+     * @param items  Set to the first readable element
+     * @return Number of readable elements (0 if empty)
+     */
+    SAGE_HOT
+    size_t peek_span(const T*& items, size_t max_count) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        
+        if (cached_head_ - tail < max_count) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (cached_head_ == tail) {
+                return 0;
+            }
+        }
+        
+        const size_t index = tail & MASK;
+        const size_t contiguous = N - index;
+        size_t count = cached_head_ - tail;
+        count = (max_count < count) ? max_count : count;
+        count = (contiguous < count) ? contiguous : count;
+        
+        items = &buffer_[index];
+        return count;
+    }
+    
+    /**
+     * Hand the first count elements of the last peek_span() back to the producer
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void release(size_t count) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(tail + count, std::memory_order_release);
+    }
+    
     // ========================================================================
     // Capacity Queries (thread-safe but approximate)
     // ========================================================================
@@ -202,6 +324,13 @@ public:
         return N;
     }
     
+    /**
+     * Wakeup word for SleepingWait consumers
+     */
+    WaitSignal& wait_signal() noexcept {
+        return signal_;
+    }
+    
 private:
     // Producer state (one cache line)
     SAGE_CACHE_ALIGNED std::atomic<size_t> head_{0};
@@ -213,8 +342,16 @@ private:
     size_t cached_head_{0};  // Consumer's cached head
     char pad2_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
     
+    // Sleeping-consumer wakeup (written only when a consumer parks)
+    WaitSignal signal_;
+    
     // Data buffer (separate cache lines from control)
-    SAGE_CACHE_ALIGNED T buffer_[N];
+    // Anonymous union: slots are never default-constructed, so T only needs
+    // to be trivially copyable and the ring can be placement-constructed
+    // over raw (e.g. shared) memory without touching every page.
+    union {
+        SAGE_CACHE_ALIGNED T buffer_[N];
+    };
 };
 
 // ============================================================================
@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * SAGE Seqlock Cell
+ * Single-writer "latest value" publication with consistent lock-free reads
+ *
+ * The writer updates the value in place; any number of readers (other
+ * threads or other processes via shared memory) copy it out and retry if
+ * a write overlapped the copy. Readers never write, so they add no cache
+ * traffic to the writer's hot loop beyond sharing the line.
+ *
+ * Protocol:
+ *   writer: seq = odd -> write value -> seq = even (next)
+ *   reader: s1 = seq (even) -> copy -> s2 = seq; retry if s1 != s2
+ *
+ * Self-contained (no pointers), so cells can live in shared memory.
+ *
+ * Target latency: <10ns write, <15ns uncontended read for 64B values
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+
+namespace sage {
+
+/**
+ * Seqlock-protected value cell
+ *
+ * @tparam T  Value type (trivially copyable; copied out by readers)
+ */
+template<typename T>
+class SAGE_CACHE_ALIGNED SeqlockCell {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    SeqlockCell() noexcept {
+        sequence_.store(0, std::memory_order_relaxed);
+        value_ = T{};
+    }
+
+    // ========================================================================
+    // Writer Interface (Single Thread)
+    // ========================================================================
+
+    /**
+     * Replace the value
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void store(const T& value) noexcept {
+        update([&value](T& v) { v = value; });
+    }
+
+    /**
+     * Modify the value in place (fn receives T&)
+     * Keep fn short: readers spin while it runs.
+     */
+    template<typename Fn>
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    void update(Fn&& fn) noexcept {
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        fn(value_);
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Direct read for the writer thread only (no retry needed)
+     */
+    SAGE_ALWAYS_INLINE
+    const T& writer_view() const noexcept {
+        return value_;
+    }
+
+    // ========================================================================
+    // Reader Interface (Any Thread / Process)
+    // ========================================================================
+
+    /**
+     * Copy a consistent snapshot, retrying while a write is in progress
+     */
+    SAGE_HOT
+    T load() const noexcept {
+        T out;
+        while (!try_load(out)) {
+            SAGE_CPU_PAUSE();
+        }
+        return out;
+    }
+
+    /**
+     * Single attempt
+     * @return false if a write overlapped the copy (out is then garbage)
+     */
+    SAGE_HOT SAGE_ALWAYS_INLINE
+    bool try_load(T& out) const noexcept {
+        const uint64_t seq = sequence_.load(std::memory_order_acquire);
+        if (seq & 1) [[unlikely]] {
+            return false;
+        }
+        out = value_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == seq;
+    }
+
+    /**
+     * Number of completed writes (cheap change detection for pollers)
+     */
+    SAGE_ALWAYS_INLINE
+    uint64_t version() const noexcept {
+        return sequence_.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    std::atomic<uint64_t> sequence_{0};   // Odd while a write is in progress
+    T value_;
+};
+
+} // namespace sage
@@ -0,0 +1,347 @@
+#pragma once
+
+/**
+ * SAGE Shared Memory Segments
+ * Named, validated POSIX shared memory for cross-process IPC
+ *
+ * A segment holds a cache-aligned header followed by one self-contained
+ * object (no pointers, no heap) that is placement-constructed in place:
+ *
+ *   ┌──────────────────────────────┐
+ *   │ ShmHeader (64B)              │  magic, version, capacity, elem size
+ *   ├──────────────────────────────┤
+ *   │ Obj (e.g. RingBuffer<T, N>)  │  constructed once by the creator
+ *   └──────────────────────────────┘
+ *
+ * Protocol:
+ * - The producer create()s the segment, constructs Obj, then publishes
+ *   state = READY with a release store.
+ * - Consumers attach() by name; the header is checked against the
+ *   consumer's compile-time view (magic, version, capacity, element size,
+ *   segment size) so mismatched binaries fail fast instead of corrupting.
+ *
+ * Shareable types expose: value_type, CAPACITY, MAGIC.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <chrono>
+#include <type_traits>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/memory.hpp"
+#include "ring_buffer.hpp"
+#include "broadcast_ring.hpp"
+#include "mpsc_queue.hpp"
+#include "byte_ring.hpp"
+#include "conflating_queue.hpp"
+
+namespace sage {
+
+// ============================================================================
+// Segment Header
+// ============================================================================
+
+enum class ShmState : uint32_t {
+    INITIALIZING = 0,
+    READY = 1
+};
+
+enum class ShmStatus : uint8_t {
+    OK,
+    OPEN_FAILED,        // shm_open failed (segment missing on attach)
+    MMAP_FAILED,        // mmap failed
+    NOT_READY,          // Creator has not finished construction yet
+    BAD_MAGIC,          // Not a SAGE segment / wrong object type
+    VERSION_MISMATCH,   // Built against a different SHM_LAYOUT_VERSION
+    LAYOUT_MISMATCH     // Capacity, element size or segment size differ
+};
+
+/**
+ * Segment header (exactly one cache line)
+ * Written once by the creator before state becomes READY.
+ */
+struct SAGE_CACHE_ALIGNED ShmHeader {
+    uint64_t magic;                  // MAGIC_SHM
+    uint64_t object_magic;           // Obj::MAGIC (e.g. MAGIC_RING_BUFFER)
+    uint64_t capacity;               // Obj::CAPACITY
+    uint64_t segment_size;           // sizeof(header + object)
+    uint32_t version;                // SHM_LAYOUT_VERSION
+    uint32_t element_size;           // sizeof(Obj::value_type)
+    int32_t creator_pid;             // For diagnostics only
+    std::atomic<uint32_t> state;     // ShmState
+};
+static_assert(sizeof(ShmHeader) == CACHE_LINE_SIZE, "ShmHeader must be one cache line");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Header state must be lock-free to live in shared memory");
+
+// ============================================================================
+// Shared Memory Segment
+// ============================================================================
+
+/**
+ * Named shared memory holder for a single placement-constructed object
+ *
+ * @tparam Obj  Self-contained, pointer-free type exposing value_type,
+ *              CAPACITY and MAGIC (e.g. RingBuffer<SageMessage, 65536>)
+ *
+ * Not thread-safe: create/attach/detach during startup and shutdown only.
+ * Access to the object itself follows Obj's own concurrency contract.
+ */
+template<typename Obj>
+class ShmSegment {
+    static_assert(std::is_trivially_destructible_v<Obj>,
+                  "Shared objects are never destroyed, only unmapped");
+    static_assert(std::atomic<size_t>::is_always_lock_free,
+                  "Shared objects rely on address-free lock-free atomics");
+
+    struct Layout {
+        ShmHeader header;
+        Obj object;
+    };
+
+public:
+    static constexpr size_t SEGMENT_SIZE = sizeof(Layout);
+    static constexpr uint64_t CAPACITY = Obj::CAPACITY;
+    static constexpr uint32_t ELEMENT_SIZE =
+        static_cast<uint32_t>(sizeof(typename Obj::value_type));
+
+    ShmSegment() noexcept = default;
+
+    ~ShmSegment() noexcept {
+        detach();
+    }
+
+    // Non-copyable (owns a mapping)
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    /**
+     * Create a fresh segment and construct the object (producer side)
+     * Any stale segment with the same name is removed first.
+     * The creator unlinks the name again on detach().
+     */
+    SAGE_COLD
+    bool create(const char* name) noexcept {
+        detach();
+
+        memory::shm_remove(name);
+
+        bool created = false;
+        int fd = memory::shm_create(name, SEGMENT_SIZE, created);
+        if (fd < 0 || !created) {
+            memory::shm_close(fd);
+            status_ = ShmStatus::OPEN_FAILED;
+            return false;
+        }
+
+        void* ptr = memory::shm_map(fd, SEGMENT_SIZE);
+        memory::shm_close(fd);
+        if (ptr == nullptr) {
+            memory::shm_remove(name);
+            status_ = ShmStatus::MMAP_FAILED;
+            return false;
+        }
+
+        Layout* layout = static_cast<Layout*>(ptr);
+
+        ShmHeader& hdr = layout->header;
+        hdr.magic = MAGIC_SHM;
+        hdr.object_magic = Obj::MAGIC;
+        hdr.capacity = CAPACITY;
+        hdr.segment_size = SEGMENT_SIZE;
+        hdr.version = SHM_LAYOUT_VERSION;
+        hdr.element_size = ELEMENT_SIZE;
+#ifdef __linux__
+        hdr.creator_pid = static_cast<int32_t>(getpid());
+#else
+        hdr.creator_pid = 0;
+#endif
+        new (&hdr.state) std::atomic<uint32_t>(
+            static_cast<uint32_t>(ShmState::INITIALIZING));
+
+        new (&layout->object) Obj();
+
+        // Publish: everything above happens-before any consumer's validate
+        hdr.state.store(static_cast<uint32_t>(ShmState::READY),
+                        std::memory_order_release);
+
+        layout_ = layout;
+        set_name(name);
+        owner_ = true;
+        status_ = ShmStatus::OK;
+        return true;
+    }
+
+    /**
+     * Attach to an existing segment created by another process
+     * Non-blocking: returns false (see status()) if missing or invalid.
+     */
+    SAGE_COLD
+    bool attach(const char* name) noexcept {
+        detach();
+
+        int fd = memory::shm_open_existing(name);
+        if (fd < 0) {
+            status_ = ShmStatus::OPEN_FAILED;
+            return false;
+        }
+
+        // Creator may be between shm_open and ftruncate
+        const size_t size = memory::shm_size(fd);
+        if (size < sizeof(ShmHeader)) {
+            memory::shm_close(fd);
+            status_ = ShmStatus::NOT_READY;
+            return false;
+        }
+        if (size != SEGMENT_SIZE) {
+            memory::shm_close(fd);
+            status_ = ShmStatus::LAYOUT_MISMATCH;
+            return false;
+        }
+
+        void* ptr = memory::shm_map(fd, SEGMENT_SIZE);
+        memory::shm_close(fd);
+        if (ptr == nullptr) {
+            status_ = ShmStatus::MMAP_FAILED;
+            return false;
+        }
+
+        Layout* layout = static_cast<Layout*>(ptr);
+        status_ = validate(layout->header);
+        if (status_ != ShmStatus::OK) {
+            memory::shm_unmap(ptr, SEGMENT_SIZE);
+            return false;
+        }
+
+        layout_ = layout;
+        set_name(name);
+        owner_ = false;
+        return true;
+    }
+
+    /**
+     * Attach, polling until the creator has published the segment
+     * Gives up only on a hard layout error or when should_stop() is true.
+     */
+    template<typename StopPredicate>
+    SAGE_COLD
+    bool attach_blocking(const char* name, StopPredicate&& should_stop,
+                         uint32_t poll_ms = 100) noexcept {
+        while (!should_stop()) {
+            if (attach(name)) {
+                return true;
+            }
+            if (status_ != ShmStatus::OPEN_FAILED &&
+                status_ != ShmStatus::NOT_READY) {
+                return false;  // Incompatible segment - retrying won't help
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+        }
+        return false;
+    }
+
+    /**
+     * Unmap the segment (creator also removes the name)
+     */
+    void detach() noexcept {
+        if (layout_ == nullptr) {
+            return;
+        }
+        memory::shm_unmap(layout_, SEGMENT_SIZE);
+        if (owner_) {
+            memory::shm_remove(name_);
+        }
+        layout_ = nullptr;
+        name_[0] = '\0';
+        owner_ = false;
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    SAGE_ALWAYS_INLINE Obj& get() noexcept { return layout_->object; }
+    SAGE_ALWAYS_INLINE const Obj& get() const noexcept { return layout_->object; }
+
+    SAGE_ALWAYS_INLINE Obj* operator->() noexcept { return &layout_->object; }
+    SAGE_ALWAYS_INLINE const Obj* operator->() const noexcept { return &layout_->object; }
+
+    const ShmHeader& header() const noexcept { return layout_->header; }
+    
+    /// Whole mapping (header + object), e.g. for memory provisioning
+    void* base() const noexcept { return layout_; }
+    static constexpr size_t mapped_size() noexcept { return SEGMENT_SIZE; }
+
+    bool is_attached() const noexcept { return layout_ != nullptr; }
+    bool is_owner() const noexcept { return owner_; }
+    ShmStatus status() const noexcept { return status_; }
+
+private:
+    static constexpr size_t MAX_NAME_LEN = 64;
+
+    void set_name(const char* name) noexcept {
+        std::strncpy(name_, name, MAX_NAME_LEN - 1);
+        name_[MAX_NAME_LEN - 1] = '\0';
+    }
+
+    static ShmStatus validate(ShmHeader& hdr) noexcept {
+        const uint32_t state = hdr.state.load(std::memory_order_acquire);
+        if (state != static_cast<uint32_t>(ShmState::READY)) {
+            return ShmStatus::NOT_READY;
+        }
+        if (hdr.magic != MAGIC_SHM || hdr.object_magic != Obj::MAGIC) {
+            return ShmStatus::BAD_MAGIC;
+        }
+        if (hdr.version != SHM_LAYOUT_VERSION) {
+            return ShmStatus::VERSION_MISMATCH;
+        }
+        if (hdr.capacity != CAPACITY ||
+            hdr.element_size != ELEMENT_SIZE ||
+            hdr.segment_size != SEGMENT_SIZE) {
+            return ShmStatus::LAYOUT_MISMATCH;
+        }
+        return ShmStatus::OK;
+    }
+
+    Layout* layout_{nullptr};
+    char name_[MAX_NAME_LEN]{};
+    bool owner_{false};
+    ShmStatus status_{ShmStatus::OK};
+};
+
+// ============================================================================
+// Type Aliases
+// ============================================================================
+
+/// Named shared-memory SPSC ring (producer create()s, consumer attach()es)
+template<typename T, size_t N>
+using ShmRingBuffer = ShmSegment<RingBuffer<T, N>>;
+
+/// Named shared-memory broadcast ring (producer create()s, each reader
+/// attach()es and registers its own consumer id)
+template<typename T, size_t N>
+using ShmBroadcastRing = ShmSegment<BroadcastRing<T, N>>;
+
+/// Named shared-memory MPSC queue (producer create()s, consumer attach()es)
+template<typename T, size_t N>
+using ShmMpscQueue = ShmSegment<MpscQueue<T, N>>;
+
+/// Named shared-memory byte ring (raw frames / encoded FIX between stages)
+template<size_t N>
+using ShmByteRing = ShmSegment<ByteRing<N>>;
+
+/// Named shared-memory conflating queue (latest value per key)
+template<typename T, size_t MaxKeys>
+using ShmConflatingQueue = ShmSegment<ConflatingQueue<T, MaxKeys>>;
+
+} // namespace sage
@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * SAGE Consumer Wait Strategies
+ * What a consumer does when its ring is empty
+ *
+ * Strategies (pick per stage, hot path stays on BusySpinWait):
+ * - BusySpinWait:   pause() and retry. Lowest latency, burns a core.
+ *                   ADE / RME / POE.
+ * - BackoffWait:    cpu::spin_wait (pause -> pause x8 -> sched_yield).
+ *                   Shares a core politely, wakes within a scheduler tick.
+ * - SleepingWait:   spin briefly, then sleep on a futex in the ring's
+ *                   WaitSignal. The producer only pays for a syscall when
+ *                   a sleeper has flagged itself. Recorder, monitoring.
+ *
+ * All strategies share one loop shape:
+ *
+ *   while (running) {
+ *       if (ring.try_pop(msg)) { handle(msg); wait.reset(); }
+ *       else                   { wait.idle(ring); }
+ *   }
+ *
+ * Futex (not eventfd) is used because the word lives inside the ring and
+ * therefore works across processes in shared memory with no fd passing.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/cpu_affinity.hpp"
+
+namespace sage {
+
+// ============================================================================
+// Wait Signal (lives inside the ring)
+// ============================================================================
+
+/**
+ * Producer -> sleeping consumer wakeup word (one cache line)
+ *
+ * The producer reads `sleepers` (relaxed) after each publish; the line is
+ * only written when a consumer goes to sleep, so it stays shared-clean in
+ * the producer's cache on the fast path.
+ *
+ * No fence on the producer side: a publish racing the sleeper's flag store
+ * can miss its wake, which the sleeper's timeout bounds (max_sleep_us).
+ */
+struct SAGE_CACHE_ALIGNED WaitSignal {
+    std::atomic<uint32_t> epoch{0};      // Futex word, bumped on every wake
+    std::atomic<uint32_t> sleepers{0};   // Consumers currently parked
+
+    /**
+     * Producer side: wake a parked consumer, if any (one relaxed load otherwise)
+     */
+    SAGE_ALWAYS_INLINE void notify() noexcept {
+        if (sleepers.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+            wake();
+        }
+    }
+
+    SAGE_COLD
+    void wake() noexcept {
+        epoch.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+        // Non-private futex: the word may be in shared memory
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE,
+                INT32_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    /**
+     * Consumer side: sleep until woken, epoch moves, or timeout
+     * Caller must re-check its ring after flagging itself (see SleepingWait).
+     */
+    SAGE_COLD
+    void wait(uint32_t seen_epoch, uint32_t timeout_us) noexcept {
+#ifdef __linux__
+        struct timespec ts;
+        ts.tv_sec = timeout_us / 1000000;
+        ts.tv_nsec = static_cast<long>(timeout_us % 1000000) * 1000;
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT,
+                seen_epoch, &ts, nullptr, 0);
+#else
+        (void)seen_epoch;
+        (void)timeout_us;
+        cpu::pause();
+#endif
+    }
+};
+static_assert(sizeof(WaitSignal) == CACHE_LINE_SIZE, "WaitSignal must be one cache line");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Futex word must be a plain lock-free 32-bit atomic");
+
+// ============================================================================
+// Strategies
+// ============================================================================
+
+/**
+ * Spin with pause() - hot path default
+ */
+class BusySpinWait {
+public:
+    template<typename Ring>
+    SAGE_ALWAYS_INLINE void idle(Ring&) noexcept {
+        cpu::pause();
+    }
+
+    SAGE_ALWAYS_INLINE void reset() noexcept {}
+};
+
+/**
+ * Exponential backoff via cpu::spin_wait, yielding the core once spinning
+ * stops paying off
+ */
+class BackoffWait {
+public:
+    explicit BackoffWait(uint32_t max_spins = 4096) noexcept
+        : max_spins_(max_spins) {}
+
+    template<typename Ring>
+    void idle(Ring& ring) noexcept {
+        cpu::spin_wait([&ring] { return !ring.empty_approx(); }, max_spins_);
+    }
+
+    SAGE_ALWAYS_INLINE void reset() noexcept {}
+
+private:
+    uint32_t max_spins_;
+};
+
+/**
+ * Spin, then park on the ring's futex until the producer publishes
+ *
+ * @param spin_limit    idle() calls spent spinning before the first sleep
+ * @param max_sleep_us  Upper bound on one sleep (also how quickly the
+ *                      caller notices shutdown or a missed wake)
+ */
+class SleepingWait {
+public:
+    explicit SleepingWait(uint32_t spin_limit = 1000,
+                          uint32_t max_sleep_us = 1000) noexcept
+        : spin_limit_(spin_limit), max_sleep_us_(max_sleep_us) {}
+
+    template<typename Ring>
+    void idle(Ring& ring) noexcept {
+        if (idle_count_ < spin_limit_) {
+            ++idle_count_;
+            cpu::pause();
+            return;
+        }
+
+        WaitSignal& signal = ring.wait_signal();
+        const uint32_t seen = signal.epoch.load(std::memory_order_acquire);
+
+        // Flag first, then re-check: a publish after the re-check sees the
+        // flag (or the sleep times out)
+        signal.sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (ring.empty_approx()) {
+            signal.wait(seen, max_sleep_us_);
+        }
+        signal.sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    SAGE_ALWAYS_INLINE void reset() noexcept {
+        idle_count_ = 0;
+    }
+
+private:
+    uint32_t spin_limit_;
+    uint32_t max_sleep_us_;
+    uint32_t idle_count_{0};
+};
+
+} // namespace sage
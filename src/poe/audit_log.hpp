@@ -30,6 +30,7 @@
 #include <cstring>
 #include <mutex>
 #include "../core/compiler.hpp"
+#include "../core/timing.hpp"
 #include "../types/sage_message.hpp"
 
 #ifdef _WIN32
@@ -258,9 +259,10 @@ private:
     /**
      * Get UTC timestamp (ISO 8601 format)
      * UTC is mandatory for audit logs - no DST issues, monotonic across rotation.
+     * Follows virtual time under replay (timing::get_realtime_ns).
      */
     static void get_timestamp_utc(char* buffer, size_t size) noexcept {
-        time_t now = time(nullptr);
+        time_t now = static_cast<time_t>(timing::get_realtime_ns() / NANOS_PER_SEC);
         struct tm* tm_info = gmtime(&now);  // UTC, not local time!
         strftime(buffer, size, "%Y-%m-%dT%H:%M:%SZ", tm_info);
     }
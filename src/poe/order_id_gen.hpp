@@ -17,6 +17,12 @@ public:
         counter_.store(0);
     }
     
+    // Start over from a given epoch (replay: ids depend only on the run)
+    void restart(uint32_t epoch_seconds) noexcept {
+        startup_ts_ = epoch_seconds;
+        counter_.store(0, std::memory_order_relaxed);
+    }
+    
     // Generate globally unique, time-sortable order ID
     uint64_t generate() {
         uint32_t count = counter_.fetch_add(1, std::memory_order_relaxed);
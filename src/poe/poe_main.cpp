@@ -28,7 +28,8 @@
 #include "../core/timing.hpp"
 #include "../core/cpu_affinity.hpp"
 #include "../core/shutdown.hpp"
-#include "../infra/ring_buffer.hpp"
+#include "../core/memory.hpp"
+#include "../infra/shm_segment.hpp"
 #include "../types/sage_message.hpp"
 #include "order_id_gen.hpp"
 #include "audit_log.hpp"
@@ -48,14 +49,17 @@ constexpr int FSYNC_INTERVAL_MS = 50;  // Fsync every 50ms for durability
 // Global State
 // ============================================================================
 
-// Ring buffer
-static RingBuffer<SageMessage, 65536> g_rme_to_poe_buffer;
+// Ring buffer (shared memory, created by RME)
+static ShmRingBuffer<SageMessage, 65536> g_rme_to_poe_buffer;
+
+// Startup memory provisioning (huge pages, prefault, mlock)
+static memory::MemoryProvisioner g_provisioner;
 
 // Order ID generator
 static poe::OrderIDGenerator g_order_id_gen;
 
-// Audit log
-static poe::AuditLog g_audit_log("sage_audit.log");
+// Audit log (a replay's orders never go into the live audit trail)
+static poe::AuditLog g_audit_log(timing::replay_requested() ? "sage_audit_replay.log" : "sage_audit.log");
 
 // Pre-allocated FIX message buffer
 static thread_local char g_fix_buffer[FIX_BUFFER_SIZE];
@@ -180,8 +184,9 @@ static void heartbeat_thread() {
                   << " failed=" << failed
                   << " bytes=" << bytes
                   << " avg_latency=" << avg_latency_ns << "ns"
-                  << " queue=" << g_rme_to_poe_buffer.size_approx()
+                  << " queue=" << g_rme_to_poe_buffer->size_approx()
                   << " audit_entries=" << g_audit_log.entries_logged()
+                  << " faults=" << g_provisioner.faults_since_warmup()
                   << std::endl;
         
         // Flush for visibility (sync thread handles durability)
@@ -210,12 +215,35 @@ int main() {
     
     ShutdownManager::instance().install_signal_handlers();
     
+    // Fed by sage_replay: run on the capture's clock, not the wall clock
+    if (timing::replay_requested()) {
+        timing::enable_virtual_time();
+        g_order_id_gen.restart(0);   // Run-relative ids, never a live id
+        std::cout << "[POE] Replay: virtual time from message timestamps" << std::endl;
+    }
+    
     // Register shutdown handler to sync audit log (durability on shutdown)
     ShutdownManager::instance().register_handler([]() {
         std::cout << "[POE] Syncing audit log to disk..." << std::endl;
         g_audit_log.sync();  // sync(), not just flush()
     });
     
+    std::cout << "[POE] Waiting for " << SHM_RME_TO_POE << "..." << std::endl;
+    if (!g_rme_to_poe_buffer.attach_blocking(SHM_RME_TO_POE, [] {
+            return ShutdownManager::instance().is_shutdown_requested();
+        })) {
+        std::cerr << "[POE] Failed to attach " << SHM_RME_TO_POE << std::endl;
+        return 1;
+    }
+    
+    // Fault in and lock everything the hot loop touches
+    g_provisioner.add("rme_to_poe", g_rme_to_poe_buffer.base(), g_rme_to_poe_buffer.mapped_size());
+    const memory::ProvisionReport mem = g_provisioner.provision();
+    std::cout << "[POE] Memory: " << mem.bytes / 1024 << "KB in " << mem.regions
+              << " regions, huge=" << mem.huge_regions
+              << " locked=" << mem.locked_regions << (mem.all_locked ? " +mlockall" : "")
+              << " warmup_faults=" << mem.after.minor - mem.before.minor << std::endl;
+    
     // Start background fsync thread (audit durability)
     std::thread sync_thread(fsync_thread);
     
@@ -227,7 +255,10 @@ int main() {
     // Main processing loop
     while (!ShutdownManager::instance().is_shutdown_requested()) {
         SageMessage msg;
-        if (g_rme_to_poe_buffer.try_pop(msg)) {
+        if (g_rme_to_poe_buffer->try_pop(msg)) {
+            if (timing::virtual_time()) [[unlikely]] {
+                timing::advance_virtual_time(msg.timestamp_ns);
+            }
             if (msg.msg_type == MessageType::ORDER_REQUEST) {
                 process_order(msg);
             } else if (msg.msg_type == MessageType::SHUTDOWN) {
@@ -0,0 +1,209 @@
+#pragma once
+
+/**
+ * SAGE Tick Archive Format
+ * Compressed, columnar long-term storage of market data ticks
+ *
+ * Captures (capture_format.hpp) keep every SageMessage as 64 raw bytes,
+ * which is right for recording and replay but wasteful for months of
+ * history: consecutive ticks of a symbol share most of their bits. An
+ * archive regroups ticks per symbol into blocks and stores each field as
+ * a bit-packed column (bitpack.hpp):
+ *
+ *   ┌────────────────────────────────────────┐
+ *   │ ArchiveFileHeader (4KB)                │  schema, symbol map, totals
+ *   ├────────────────────────────────────────┤
+ *   │ block: ArchiveBlockHeader (192B)       │  one symbol, <= 4096 ticks
+ *   │        column 0 .. 8, bit-packed       │  in recorded order
+ *   ├────────────────────────────────────────┤
+ *   │ block ...                              │
+ *   ├────────────────────────────────────────┤
+ *   │ ArchiveIndexEntry × block_count        │  by symbol, then time
+ *   └────────────────────────────────────────┘
+ *
+ * Columns hold zigzag deltas from the previous tick of the block or, for
+ * the per-tick diagnostics, raw values; each at the narrowest width that
+ * fits the whole block. Deltas are stored in units of their greatest
+ * common divisor in the block (the block header keeps it as the column's
+ * scale, with the first value as its base): FixedPoint prices move in
+ * whole ticks and sizes in whole lots, so a price delta of a few ticks
+ * packs into a few bits rather than the ~20 its raw value needs. A tick
+ * round-trips to the same 64 SageMessage bytes.
+ *
+ * The index at the end lists every block with its symbol and time range,
+ * so a reader finds a symbol's blocks from a given time by binary search
+ * without touching block data. index_offset stays 0 until the writer has
+ * finished the file: an archive without it is incomplete.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../core/constants.hpp"
+#include "../types/sage_message.hpp"
+#include "capture_format.hpp"
+#include "bitpack.hpp"
+
+namespace sage {
+namespace rec {
+
+/// Bump on any change to the structures or columns below
+constexpr uint32_t ARCHIVE_SCHEMA_VERSION = 1;
+
+constexpr size_t ARCHIVE_HEADER_SIZE = 4096;
+constexpr size_t ARCHIVE_BLOCK_HEADER_SIZE = 192;
+constexpr size_t ARCHIVE_BLOCK_TICKS = 4096;      // 16 miniblocks
+constexpr size_t ARCHIVE_BLOCK_ALIGN = 64;
+
+static_assert(ARCHIVE_BLOCK_TICKS % MINIBLOCK_VALUES == 0, "blocks hold whole miniblocks");
+
+// ============================================================================
+// Columns
+// ============================================================================
+
+enum class ArchiveColumn : uint8_t {
+    TIMESTAMP = 0,      // SageMessage::timestamp_ns
+    SEQUENCE = 1,       // SageMessage::sequence_id
+    PRICE = 2,          // MarketData::price (FixedPoint raw)
+    QUANTITY = 3,       // MarketData::quantity (FixedPoint raw)
+    EXCHANGE_TS = 4,    // MarketData::exchange_ts_ns
+    VENUE_SEQ = 5,      // MarketData::venue_seq
+    ATTRIBUTES = 6,     // flags | exchange_id << 16 | reserved << 24 | rx_clock << 32
+    PARSE_NS = 7,       // SageMessage::parse_ns (raw)
+    RX_DELTA_NS = 8,    // SageMessage::rx_delta_ns (raw)
+    COUNT = 9
+};
+
+constexpr size_t ARCHIVE_COLUMNS = static_cast<size_t>(ArchiveColumn::COUNT);
+
+/**
+ * Delta-coded columns (the rest are stored raw: per-tick diagnostics
+ * with no relation to the previous tick)
+ */
+constexpr bool column_is_delta(size_t column) noexcept {
+    return column < static_cast<size_t>(ArchiveColumn::PARSE_NS);
+}
+
+/**
+ * One column's value for a market data record
+ */
+inline int64_t column_value(const SageMessage& msg, size_t column) noexcept {
+    const MarketData& md = msg.payload.market_data;
+    switch (static_cast<ArchiveColumn>(column)) {
+        case ArchiveColumn::TIMESTAMP:   return static_cast<int64_t>(msg.timestamp_ns);
+        case ArchiveColumn::SEQUENCE:    return static_cast<int64_t>(msg.sequence_id);
+        case ArchiveColumn::PRICE:       return md.price.raw();
+        case ArchiveColumn::QUANTITY:    return md.quantity.raw();
+        case ArchiveColumn::EXCHANGE_TS: return static_cast<int64_t>(md.exchange_ts_ns);
+        case ArchiveColumn::VENUE_SEQ:   return static_cast<int64_t>(md.venue_seq);
+        case ArchiveColumn::ATTRIBUTES:
+            return static_cast<int64_t>(md.flags | uint64_t{md.exchange_id} << 16 |
+                                        uint64_t{md.reserved} << 24 |
+                                        uint64_t{static_cast<uint8_t>(msg.rx_clock)} << 32);
+        case ArchiveColumn::PARSE_NS:    return msg.parse_ns;
+        case ArchiveColumn::RX_DELTA_NS: return msg.rx_delta_ns;
+        default:                         return 0;
+    }
+}
+
+// ============================================================================
+// File Structures
+// ============================================================================
+
+/**
+ * File header (first page)
+ */
+struct ArchiveFileHeader {
+    uint64_t magic;                  // MAGIC_ARCHIVE_FILE
+    uint32_t schema_version;         // ARCHIVE_SCHEMA_VERSION
+    uint32_t shm_layout_version;     // SHM_LAYOUT_VERSION (SageMessage layout)
+    uint32_t header_size;            // ARCHIVE_HEADER_SIZE
+    uint32_t block_ticks;            // ARCHIVE_BLOCK_TICKS
+    uint64_t created_ns;             // CLOCK_REALTIME
+    uint64_t tick_count;
+    uint64_t block_count;
+    uint64_t index_offset;           // ArchiveIndexEntry[block_count]; 0 = unfinished
+    uint64_t first_ts_ns;            // Earliest / latest tick
+    uint64_t last_ts_ns;
+    uint32_t symbol_count;
+    uint32_t reserved;
+    CaptureSymbol symbols[CAPTURE_MAX_SYMBOLS];   // From the source captures
+
+    uint8_t padding[ARCHIVE_HEADER_SIZE - 80 - CAPTURE_MAX_SYMBOLS * sizeof(CaptureSymbol)];
+};
+static_assert(sizeof(ArchiveFileHeader) == ARCHIVE_HEADER_SIZE, "ArchiveFileHeader must be one page");
+
+/**
+ * Block header; the block's columns follow in ArchiveColumn order, each
+ * packed_words(ticks, width[c]) words
+ */
+struct ArchiveBlockHeader {
+    uint64_t magic;                  // MAGIC_ARCHIVE_BLOCK
+    uint32_t symbol_id;
+    uint32_t ticks;
+    uint32_t bytes;                  // Whole block, header included (ARCHIVE_BLOCK_ALIGN multiple)
+    uint32_t reserved;
+    uint64_t first_ts_ns;            // Earliest / latest timestamp_ns
+    uint64_t last_ts_ns;
+    int64_t base[ARCHIVE_COLUMNS];   // Delta columns: value before the first delta
+    uint32_t scale[ARCHIVE_COLUMNS]; // Delta columns: unit of the stored deltas (>= 1)
+    uint8_t width[ARCHIVE_COLUMNS];  // Bits per value
+    uint8_t padding[ARCHIVE_BLOCK_HEADER_SIZE - 40 - ARCHIVE_COLUMNS * 13];
+};
+static_assert(sizeof(ArchiveBlockHeader) == ARCHIVE_BLOCK_HEADER_SIZE, "ArchiveBlockHeader must be 192 bytes");
+
+/**
+ * Index entry (one per block)
+ */
+struct ArchiveIndexEntry {
+    uint32_t symbol_id;
+    uint32_t ticks;
+    uint64_t first_ts_ns;
+    uint64_t last_ts_ns;
+    uint64_t offset;                 // File offset of the block header
+};
+static_assert(sizeof(ArchiveIndexEntry) == 32, "ArchiveIndexEntry must be 32 bytes");
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+/**
+ * Size of a block with these column widths (header included, aligned)
+ */
+constexpr size_t archive_block_bytes(const uint8_t* width, size_t ticks) noexcept {
+    size_t bytes = ARCHIVE_BLOCK_HEADER_SIZE;
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+        bytes += packed_words(ticks, width[c]) * sizeof(uint64_t);
+    }
+    return (bytes + ARCHIVE_BLOCK_ALIGN - 1) & ~(ARCHIVE_BLOCK_ALIGN - 1);
+}
+
+/**
+ * Check a mapped file's header against this build
+ * @return nullptr if valid, else what is wrong
+ */
+inline const char* validate_header(const ArchiveFileHeader& header, size_t mapped_size) noexcept {
+    if (mapped_size < ARCHIVE_HEADER_SIZE || header.magic != MAGIC_ARCHIVE_FILE) {
+        return "not a SAGE tick archive";
+    }
+    if (header.schema_version != ARCHIVE_SCHEMA_VERSION || header.header_size != ARCHIVE_HEADER_SIZE ||
+        header.block_ticks != ARCHIVE_BLOCK_TICKS) {
+        return "unsupported archive schema version";
+    }
+    if (header.shm_layout_version != SHM_LAYOUT_VERSION) {
+        return "archived with a different SageMessage layout";
+    }
+    if (header.index_offset == 0) {
+        return "archive incomplete (writer did not finish)";
+    }
+    if (header.symbol_count > CAPTURE_MAX_SYMBOLS || header.index_offset < ARCHIVE_HEADER_SIZE ||
+        header.index_offset > mapped_size ||
+        header.block_count > (mapped_size - header.index_offset) / sizeof(ArchiveIndexEntry)) {
+        return "corrupt archive header";
+    }
+    return nullptr;
+}
+
+} // namespace rec
+} // namespace sage
@@ -0,0 +1,177 @@
+/**
+ * SAGE Archive - Tick Archive Conversion
+ * Packs capture files into a compressed, columnar tick archive
+ *
+ * Architecture Notes:
+ * - Offline: reads finished (or live) captures through CaptureReader and
+ *   writes one archive (archive_format.hpp). Not pinned, no shared memory.
+ * - Market data only: other records (heartbeats) are counted and dropped.
+ * - --verify rereads the captures and checks that every archived tick
+ *   decodes to the same 64 bytes it was recorded as.
+ *
+ * Usage: sage_archive [--verify] <out.sarc> <file.cap | directory>...
+ * Directories contribute every *.cap inside in name order (= recording order).
+ */
+
+#include <iostream>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/timing.hpp"
+#include "../types/sage_message.hpp"
+#include "capture_reader.hpp"
+#include "archive_reader.hpp"
+#include "archive_writer.hpp"
+
+using namespace sage;
+
+// ============================================================================
+// Verification
+// ============================================================================
+
+/**
+ * Every market data record of the captures against the archive, in order
+ * @return Mismatched (or missing) ticks
+ */
+static uint64_t verify(const std::vector<std::string>& files, const rec::ArchiveReader& archive) {
+    // Per symbol: the block being compared and the position in it
+    struct Cursor {
+        size_t entry = SIZE_MAX;
+        size_t tick = 0;
+        std::unique_ptr<rec::ArchiveBlock> block = std::make_unique<rec::ArchiveBlock>();
+    };
+    std::unordered_map<uint32_t, Cursor> cursors;
+    uint64_t mismatches = 0;
+
+    rec::CaptureReader capture;
+    for (const std::string& path : files) {
+        if (!capture.open(path)) {
+            continue;
+        }
+        const SageMessage* run;
+        uint64_t next = 0;
+        while (const size_t count = capture.span(next, run)) {
+            next += count;
+            for (size_t i = 0; i < count; ++i) {
+                if (run[i].msg_type != MessageType::MARKET_DATA) {
+                    continue;
+                }
+                const uint32_t symbol_id = run[i].payload.market_data.symbol_id;
+                Cursor& cursor = cursors[symbol_id];
+                if (cursor.entry == SIZE_MAX || cursor.tick == cursor.block->count) {
+                    cursor.entry = cursor.entry == SIZE_MAX ? archive.find(symbol_id) : cursor.entry + 1;
+                    cursor.tick = 0;
+                    if (cursor.entry >= archive.blocks() || archive.entry(cursor.entry).symbol_id != symbol_id ||
+                        archive.decode(cursor.entry, *cursor.block) == 0) {
+                        cursor.block->count = 0;
+                        ++mismatches;
+                        continue;
+                    }
+                }
+                const SageMessage decoded = cursor.block->message(cursor.tick++);
+                mismatches += std::memcmp(&decoded, &run[i], sizeof(SageMessage)) != 0;
+            }
+        }
+    }
+    return mismatches;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    bool check = false;
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--verify") == 0) {
+        check = true;
+        ++arg;
+    }
+    if (argc - arg < 2) {
+        std::cerr << "Usage: sage_archive [--verify] <out.sarc> <file.cap | directory>..." << std::endl;
+        return 1;
+    }
+    const std::string output = argv[arg++];
+    std::vector<std::string> files;
+    for (; arg < argc; ++arg) {
+        if (!rec::list_capture_files(argv[arg], files)) {
+            std::cerr << "[ARCHIVE] " << argv[arg] << ": no such capture file or directory" << std::endl;
+            return 1;
+        }
+    }
+
+    timing::TSCCalibrator tsc;
+    rec::ArchiveWriter writer;
+    rec::CaptureReader capture;
+    uint64_t records = 0;
+    const uint64_t start = timing::rdtsc();
+
+    for (const std::string& path : files) {
+        if (!capture.open(path)) {
+            std::cerr << "[ARCHIVE] " << capture.last_error() << std::endl;
+            continue;
+        }
+        const rec::CaptureFileHeader& header = capture.header();
+        if (!writer.is_open()) {
+            // The first capture's symbol table describes the archive
+            if (!writer.open(output, header.symbols, header.symbol_count)) {
+                std::cerr << "[ARCHIVE] " << writer.last_error() << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "[ARCHIVE] " << path << ": " << capture.records() << " records" << std::endl;
+
+        const SageMessage* run;
+        uint64_t next = 0;
+        while (const size_t count = capture.span(next, run)) {
+            for (size_t i = 0; i < count; ++i) {
+                if (!writer.append(run[i])) {
+                    std::cerr << "[ARCHIVE] " << writer.last_error() << std::endl;
+                    return 1;
+                }
+            }
+            next += count;
+            records += count;
+        }
+    }
+    if (!writer.is_open()) {
+        std::cerr << "[ARCHIVE] No readable capture files" << std::endl;
+        return 1;
+    }
+    if (!writer.close()) {
+        std::cerr << "[ARCHIVE] " << writer.last_error() << std::endl;
+        return 1;
+    }
+    const uint64_t elapsed_ns = tsc.tsc_to_ns(timing::rdtsc() - start);
+
+    std::cout << "[ARCHIVE] " << output << ": records=" << records
+              << " ticks=" << writer.ticks()
+              << " skipped=" << writer.skipped()
+              << " blocks=" << writer.blocks()
+              << " bytes=" << writer.bytes()
+              << " ratio=" << static_cast<double>(writer.ticks() * sizeof(SageMessage)) /
+                              static_cast<double>(writer.bytes()) << "x"
+              << " bits/tick=" << (writer.ticks() > 0 ? writer.bytes() * 8 / writer.ticks() : 0)
+              << " time=" << elapsed_ns / NANOS_PER_MS << "ms"
+              << std::endl;
+
+    if (check) {
+        rec::ArchiveReader archive;
+        if (!archive.open(output)) {
+            std::cerr << "[ARCHIVE] " << archive.last_error() << std::endl;
+            return 1;
+        }
+        const uint64_t mismatches = verify(files, archive);
+        std::cout << "[ARCHIVE] Verify: " << (mismatches == 0 ? "OK" : "FAILED")
+                  << " mismatches=" << mismatches << std::endl;
+        if (mismatches != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+/**
+ * SAGE Tick Archive Reader
+ * Memory-mapped, read-only access to a tick archive, decoded by block
+ *
+ * find() locates a symbol's blocks from a point in time through the
+ * index (binary search, no block data touched); decode() unpacks one
+ * block's columns into an ArchiveBlock with the bitpack kernels, AVX2
+ * where the build has it. Backtests that want columns read them straight
+ * from the ArchiveBlock; message() rebuilds the original SageMessage.
+ *
+ * Blocks are per symbol: merging several symbols into one time-ordered
+ * stream is the caller's (decode one block per symbol, merge by
+ * timestamp).
+ *
+ * Not thread-safe: one reader per thread (the mapping is read-only, so
+ * any number of readers can share a file).
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../types/sage_message.hpp"
+#include "archive_format.hpp"
+#include "bitpack.hpp"
+
+namespace sage {
+namespace rec {
+
+/**
+ * One decoded block: a column per field, ticks in recorded order
+ * (~300KB: allocate one and reuse it across decode() calls)
+ */
+struct SAGE_CACHE_ALIGNED ArchiveBlock {
+    int64_t columns[ARCHIVE_COLUMNS][ARCHIVE_BLOCK_TICKS];
+    uint32_t symbol_id = 0;
+    uint32_t count = 0;
+
+    const int64_t* column(ArchiveColumn c) const noexcept {
+        return columns[static_cast<size_t>(c)];
+    }
+
+    uint64_t timestamp_ns(size_t i) const noexcept {
+        return static_cast<uint64_t>(column(ArchiveColumn::TIMESTAMP)[i]);
+    }
+
+    FixedPoint price(size_t i) const noexcept {
+        return FixedPoint(column(ArchiveColumn::PRICE)[i]);
+    }
+
+    FixedPoint quantity(size_t i) const noexcept {
+        return FixedPoint(column(ArchiveColumn::QUANTITY)[i]);
+    }
+
+    /**
+     * Tick i as the SageMessage it was recorded as
+     */
+    SageMessage message(size_t i) const noexcept {
+        const uint64_t attributes = static_cast<uint64_t>(column(ArchiveColumn::ATTRIBUTES)[i]);
+        MarketData data{};
+        data.price = price(i);
+        data.quantity = quantity(i);
+        data.symbol_id = symbol_id;
+        data.flags = static_cast<uint16_t>(attributes);
+        data.exchange_id = static_cast<uint8_t>(attributes >> 16);
+        data.reserved = static_cast<uint8_t>(attributes >> 24);
+        data.venue_seq = static_cast<uint64_t>(column(ArchiveColumn::VENUE_SEQ)[i]);
+        data.exchange_ts_ns = static_cast<uint64_t>(column(ArchiveColumn::EXCHANGE_TS)[i]);
+        SageMessage msg = SageMessage::create_market_data(
+            timestamp_ns(i), static_cast<uint64_t>(column(ArchiveColumn::SEQUENCE)[i]), data);
+        msg.rx_clock = static_cast<timing::RxClock>(static_cast<uint8_t>(attributes >> 32));
+        msg.parse_ns = static_cast<uint16_t>(column(ArchiveColumn::PARSE_NS)[i]);
+        msg.rx_delta_ns = static_cast<uint32_t>(column(ArchiveColumn::RX_DELTA_NS)[i]);
+        return msg;
+    }
+};
+
+class ArchiveReader {
+public:
+    ArchiveReader() noexcept = default;
+
+    ~ArchiveReader() noexcept {
+        close();
+    }
+
+    // Non-copyable (owns a mapping)
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    /**
+     * Map an archive and check its header against this build
+     * @return false (see last_error()) if unreadable, incompatible or unfinished
+     */
+    SAGE_COLD
+    bool open(const std::string& path) {
+        close();
+        path_ = path;
+#ifdef __linux__
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return fail("open");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return fail("stat");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* ptr = size_ >= ARCHIVE_HEADER_SIZE
+            ? ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            size_ = 0;
+            error_ = path + ": not a SAGE tick archive";
+            return false;
+        }
+        base_ = static_cast<const uint8_t*>(ptr);
+#else
+        return fail("tick archives need Linux");
+#endif
+        header_ = reinterpret_cast<const ArchiveFileHeader*>(base_);
+        if (const char* problem = validate_header(*header_, size_)) {
+            error_ = path + ": " + problem;
+            close();
+            return false;
+        }
+        index_ = reinterpret_cast<const ArchiveIndexEntry*>(base_ + header_->index_offset);
+        return true;
+    }
+
+    void close() noexcept {
+#ifdef __linux__
+        if (base_ != nullptr) {
+            ::munmap(const_cast<uint8_t*>(base_), size_);
+        }
+#endif
+        base_ = nullptr;
+        header_ = nullptr;
+        index_ = nullptr;
+        size_ = 0;
+    }
+
+    // ========================================================================
+    // Index
+    // ========================================================================
+
+    size_t blocks() const noexcept { return static_cast<size_t>(header_->block_count); }
+
+    /**
+     * Index entries are sorted by symbol, then time
+     */
+    const ArchiveIndexEntry& entry(size_t i) const noexcept { return index_[i]; }
+
+    /**
+     * First block of symbol_id that can hold ticks at or after
+     * timestamp_ns; its successors follow while entry(i).symbol_id matches
+     * @return Index position (blocks() or another symbol's block if none)
+     */
+    size_t find(uint32_t symbol_id, uint64_t timestamp_ns = 0) const noexcept {
+        const ArchiveIndexEntry* end = index_ + blocks();
+        const auto by_symbol = [](const ArchiveIndexEntry& e, uint32_t id) { return e.symbol_id < id; };
+        const ArchiveIndexEntry* first = std::lower_bound(index_, end, symbol_id, by_symbol);
+        const ArchiveIndexEntry* last = std::partition_point(first, end, [&](const ArchiveIndexEntry& e) {
+            return e.symbol_id == symbol_id;
+        });
+        // Past every block that starts at or before the time, then back
+        // over those still running at it (time ranges can overlap a little)
+        const ArchiveIndexEntry* it = std::partition_point(first, last, [&](const ArchiveIndexEntry& e) {
+            return e.first_ts_ns <= timestamp_ns;
+        });
+        while (it != first && (it - 1)->last_ts_ns >= timestamp_ns) {
+            --it;
+        }
+        return static_cast<size_t>(it - index_);
+    }
+
+    // ========================================================================
+    // Decoding
+    // ========================================================================
+
+    /**
+     * Decode block i (index position) into out
+     * @return Ticks decoded (0 if the block is corrupt)
+     */
+    SAGE_HOT
+    size_t decode(size_t i, ArchiveBlock& out, UnpackPath path = UnpackPath::NATIVE) const noexcept {
+        const uint64_t offset = index_[i].offset;
+        if (offset < ARCHIVE_HEADER_SIZE || offset + ARCHIVE_BLOCK_HEADER_SIZE > header_->index_offset) {
+            return 0;
+        }
+        const ArchiveBlockHeader& block = *reinterpret_cast<const ArchiveBlockHeader*>(base_ + offset);
+        if (block.magic != MAGIC_ARCHIVE_BLOCK || block.ticks == 0 || block.ticks > ARCHIVE_BLOCK_TICKS ||
+            *std::max_element(block.width, block.width + ARCHIVE_COLUMNS) > 64 ||
+            *std::min_element(block.scale, block.scale + ARCHIVE_COLUMNS) == 0 ||
+            block.bytes != archive_block_bytes(block.width, block.ticks) ||
+            offset + block.bytes > header_->index_offset) [[unlikely]] {
+            return 0;
+        }
+        const size_t miniblocks = (block.ticks + MINIBLOCK_VALUES - 1) / MINIBLOCK_VALUES;
+        const uint64_t* packed = reinterpret_cast<const uint64_t*>(base_ + offset + ARCHIVE_BLOCK_HEADER_SIZE);
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            unpack(packed, block.width[c], miniblocks, column_is_delta(c), block.base[c], block.scale[c],
+                   out.columns[c], path);
+            packed += miniblocks * BITPACK_LANES * block.width[c];
+        }
+        out.symbol_id = block.symbol_id;
+        out.count = block.ticks;
+        return block.ticks;
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    bool is_open() const noexcept { return base_ != nullptr; }
+    const ArchiveFileHeader& header() const noexcept { return *header_; }
+    size_t file_size() const noexcept { return size_; }
+    const std::string& path() const noexcept { return path_; }
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    SAGE_COLD
+    bool fail(const char* what) {
+        error_ = path_ + ": " + what + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const uint8_t* base_ = nullptr;
+    const ArchiveFileHeader* header_ = nullptr;
+    const ArchiveIndexEntry* index_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+    std::string error_;
+};
+
+} // namespace rec
+} // namespace sage
@@ -0,0 +1,290 @@
+#pragma once
+
+/**
+ * SAGE Tick Archive Writer
+ * Regroups market data records into per-symbol, bit-packed column blocks
+ *
+ * Ticks are buffered per symbol until a block's worth (4096) has
+ * arrived, then encoded and appended to the file; close() flushes the
+ * partial blocks, writes the index sorted by symbol and time, and only
+ * then fills in the header's index_offset (see archive_format.hpp).
+ *
+ * Archiving is offline (captures are converted after the fact), so this
+ * favours simple over fast: plain write() of whole blocks, a hash map of
+ * per-symbol buffers, scalar packing. Records other than MARKET_DATA are
+ * not archived (counted in skipped()).
+ *
+ * Not thread-safe: one writer thread.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../core/timing.hpp"
+#include "../types/sage_message.hpp"
+#include "archive_format.hpp"
+#include "bitpack.hpp"
+
+namespace sage {
+namespace rec {
+
+class ArchiveWriter {
+public:
+    ArchiveWriter() noexcept = default;
+
+    ~ArchiveWriter() noexcept {
+        close();
+    }
+
+    // Non-copyable (owns a file)
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    /**
+     * Create (or replace) an archive file
+     * @param symbols  Symbol table for the header (a capture's, usually)
+     * @return false (see last_error()) if the file cannot be created
+     */
+    SAGE_COLD
+    bool open(const std::string& path, const CaptureSymbol* symbols, size_t symbol_count) {
+        close();
+        path_ = path;
+        error_.clear();
+        header_ = ArchiveFileHeader{};
+        header_.magic = MAGIC_ARCHIVE_FILE;
+        header_.schema_version = ARCHIVE_SCHEMA_VERSION;
+        header_.shm_layout_version = SHM_LAYOUT_VERSION;
+        header_.header_size = ARCHIVE_HEADER_SIZE;
+        header_.block_ticks = ARCHIVE_BLOCK_TICKS;
+        header_.created_ns = timing::get_realtime_ns();
+        header_.first_ts_ns = UINT64_MAX;
+        header_.symbol_count = static_cast<uint32_t>(std::min(symbol_count, CAPTURE_MAX_SYMBOLS));
+        if (header_.symbol_count > 0) {
+            std::memcpy(header_.symbols, symbols, header_.symbol_count * sizeof(CaptureSymbol));
+        }
+        pending_.clear();
+        index_.clear();
+        skipped_ = 0;
+#ifdef __linux__
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return fail("open " + path);
+        }
+#else
+        return fail("tick archives need Linux");
+#endif
+        // Header (index_offset = 0) until close() has written the index
+        offset_ = 0;
+        return write_all(&header_, sizeof(header_));
+    }
+
+    /**
+     * Add one record
+     * @return false on a write error (the writer is then closed)
+     */
+    bool append(const SageMessage& msg) {
+        if (fd_ < 0) {
+            return false;
+        }
+        if (msg.msg_type != MessageType::MARKET_DATA) {
+            ++skipped_;
+            return true;
+        }
+        std::vector<SageMessage>& ticks = pending_[msg.payload.market_data.symbol_id];
+        if (ticks.capacity() == 0) {
+            ticks.reserve(ARCHIVE_BLOCK_TICKS);
+        }
+        ticks.push_back(msg);
+        if (ticks.size() == ARCHIVE_BLOCK_TICKS && !write_block(ticks)) {
+            abort_file();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Flush partial blocks, write the index and the final header
+     * @return false (see last_error()) if the archive could not be finished
+     */
+    SAGE_COLD
+    bool close() {
+        if (fd_ < 0) {
+            return false;
+        }
+        // Partial blocks in symbol order (the index is sorted anyway)
+        std::vector<uint32_t> symbols;
+        for (const auto& [symbol_id, ticks] : pending_) {
+            if (!ticks.empty()) {
+                symbols.push_back(symbol_id);
+            }
+        }
+        std::sort(symbols.begin(), symbols.end());
+        for (const uint32_t symbol_id : symbols) {
+            if (!write_block(pending_[symbol_id])) {
+                abort_file();
+                return false;
+            }
+        }
+
+        // Each symbol's blocks are already in time order: a stable sort keeps it
+        std::stable_sort(index_.begin(), index_.end(), [](const ArchiveIndexEntry& a, const ArchiveIndexEntry& b) {
+            return a.symbol_id < b.symbol_id;
+        });
+        header_.index_offset = offset_;
+        header_.block_count = index_.size();
+        if (header_.tick_count == 0) {
+            header_.first_ts_ns = 0;
+        }
+        bool ok = write_all(index_.data(), index_.size() * sizeof(ArchiveIndexEntry));
+#ifdef __linux__
+        ok = ok && (::pwrite(fd_, &header_, sizeof(header_), 0) == static_cast<ssize_t>(sizeof(header_)) ||
+                    fail("write " + path_));
+        ok = ok && (::fsync(fd_) == 0 || fail("fsync " + path_));
+        ::close(fd_);
+#endif
+        fd_ = -1;
+        pending_.clear();
+        return ok;
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    uint64_t ticks() const noexcept { return header_.tick_count; }        // Written to blocks
+    uint64_t blocks() const noexcept { return index_.size(); }
+    uint64_t bytes() const noexcept { return offset_; }                    // File size so far
+    uint64_t skipped() const noexcept { return skipped_; }                 // Not MARKET_DATA
+    const std::string& path() const noexcept { return path_; }
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    /**
+     * Encode one symbol's buffered ticks as a block and append it
+     */
+    bool write_block(std::vector<SageMessage>& ticks) {
+        const size_t count = ticks.size();
+        const size_t padded = (count + MINIBLOCK_VALUES - 1) / MINIBLOCK_VALUES * MINIBLOCK_VALUES;
+
+        ArchiveBlockHeader block{};
+        block.magic = MAGIC_ARCHIVE_BLOCK;
+        block.symbol_id = ticks.front().payload.market_data.symbol_id;
+        block.ticks = static_cast<uint32_t>(count);
+        block.first_ts_ns = UINT64_MAX;
+        for (const SageMessage& msg : ticks) {
+            block.first_ts_ns = std::min(block.first_ts_ns, msg.timestamp_ns);
+            block.last_ts_ns = std::max(block.last_ts_ns, msg.timestamp_ns);
+        }
+
+        // Transform every column (padding: zero deltas / zero values), then size
+        values_.resize(ARCHIVE_COLUMNS * ARCHIVE_BLOCK_TICKS);
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            uint64_t* column = values_.data() + c * ARCHIVE_BLOCK_TICKS;
+            const bool delta = column_is_delta(c);
+            int64_t previous = column_value(ticks.front(), c);
+            uint64_t divisor = 0;
+            block.base[c] = delta ? previous : 0;
+            for (size_t i = 0; i < count; ++i) {
+                const int64_t value = column_value(ticks[i], c);
+                // Wrapping difference: 64-bit columns may jump anywhere
+                const uint64_t diff = static_cast<uint64_t>(value) - static_cast<uint64_t>(previous);
+                column[i] = delta ? diff : static_cast<uint64_t>(value);
+                divisor = std::gcd(divisor, static_cast<int64_t>(diff) < 0 ? 0 - diff : diff);
+                previous = value;
+            }
+            block.scale[c] = delta && divisor > 1 && divisor <= UINT32_MAX ? static_cast<uint32_t>(divisor) : 1;
+
+            uint64_t any = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (delta) {
+                    column[i] = zigzag_encode(static_cast<int64_t>(column[i]) / block.scale[c]);
+                }
+                any |= column[i];
+            }
+            std::fill(column + count, column + padded, 0);
+            block.width[c] = static_cast<uint8_t>(bit_width(any));
+        }
+        block.bytes = static_cast<uint32_t>(archive_block_bytes(block.width, count));
+
+        buffer_.assign(block.bytes / sizeof(uint64_t), 0);
+        std::memcpy(buffer_.data(), &block, sizeof(block));
+        uint64_t* out = buffer_.data() + ARCHIVE_BLOCK_HEADER_SIZE / sizeof(uint64_t);
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            for (size_t i = 0; i < padded; i += MINIBLOCK_VALUES) {
+                pack_miniblock(values_.data() + c * ARCHIVE_BLOCK_TICKS + i, block.width[c], out);
+                out += BITPACK_LANES * block.width[c];
+            }
+        }
+
+        index_.push_back({block.symbol_id, block.ticks, block.first_ts_ns, block.last_ts_ns, offset_});
+        header_.tick_count += count;
+        header_.first_ts_ns = std::min(header_.first_ts_ns, block.first_ts_ns);
+        header_.last_ts_ns = std::max(header_.last_ts_ns, block.last_ts_ns);
+        ticks.clear();
+        return write_all(buffer_.data(), block.bytes);
+    }
+
+    bool write_all(const void* data, size_t size) {
+#ifdef __linux__
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        size_t left = size;
+        while (left > 0) {
+            const ssize_t n = ::write(fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return fail("write " + path_);
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+#endif
+        offset_ += size;
+        return true;
+    }
+
+    // A failed archive is useless: drop it rather than leave a stub
+    SAGE_COLD
+    void abort_file() noexcept {
+#ifdef __linux__
+        ::close(fd_);
+        ::unlink(path_.c_str());
+#endif
+        fd_ = -1;
+        pending_.clear();
+    }
+
+    SAGE_COLD
+    bool fail(const std::string& what) {
+        error_ = what + ": " + std::strerror(errno);
+        return false;
+    }
+
+    ArchiveFileHeader header_{};
+    std::unordered_map<uint32_t, std::vector<SageMessage>> pending_;
+    std::vector<ArchiveIndexEntry> index_;
+    std::vector<uint64_t> values_;       // One block's transformed columns
+    std::vector<uint64_t> buffer_;       // One encoded block
+    std::string path_;
+    std::string error_;
+    uint64_t offset_ = 0;
+    uint64_t skipped_ = 0;
+    int fd_ = -1;
+};
+
+} // namespace rec
+} // namespace sage
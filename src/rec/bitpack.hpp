@@ -0,0 +1,252 @@
+#pragma once
+
+/**
+ * SAGE Bit Packing
+ * Fixed-width integer packing for the tick archive, with AVX2 decode
+ *
+ * Values are packed 256 at a time (a miniblock) at one width W of 0..64
+ * bits, in four interleaved 64-bit lanes: value i is field i / 4 of lane
+ * i % 4, LSB first. 64 fields of W bits fill exactly W words per lane, so
+ * a miniblock is 4 × W words with no slack, and word k of all four lanes
+ * is one 32-byte load:
+ *
+ *   words:   [lane0 w0][lane1 w0][lane2 w0][lane3 w0][lane0 w1] ...
+ *   field 0:   value 0   value 1   value 2   value 3
+ *
+ * Each decode step yields four consecutive values in one register (shift,
+ * OR in the next word where a field straddles two, mask): no gathers, no
+ * byte shuffles. Kernels are instantiated per width, fully unrolled with
+ * constant shifts, and picked from a table at run time.
+ *
+ * Delta columns undo zigzag, a common factor (a price column's tick size,
+ * say) and the delta (a 4-lane prefix sum carried from step to step) in
+ * the same pass, so a column costs one read of its packed words and one
+ * write of its values.
+ *
+ * The AVX2 kernels are used when the build targets AVX2. The scalar kernel
+ * (any width, one value at a time) is the fallback and is always there.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../core/compiler.hpp"
+
+namespace sage {
+namespace rec {
+
+constexpr size_t BITPACK_LANES = 4;
+constexpr size_t MINIBLOCK_VALUES = 256;     // 64 fields per lane
+
+/**
+ * Which decode kernels unpack() runs
+ */
+enum class UnpackPath : uint8_t {
+    NATIVE = 0,     // AVX2 when built for it, else scalar
+    SCALAR = 1
+};
+
+// ============================================================================
+// Encoding (archive writing is offline: scalar)
+// ============================================================================
+
+constexpr uint64_t zigzag_encode(int64_t value) noexcept {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t zigzag_decode(uint64_t value) noexcept {
+    return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+/**
+ * Bits needed to hold value (0 for 0)
+ */
+constexpr unsigned bit_width(uint64_t value) noexcept {
+    return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value));
+}
+
+/**
+ * Packed words for count values at width bits (whole miniblocks)
+ */
+constexpr size_t packed_words(size_t count, unsigned width) noexcept {
+    return (count + MINIBLOCK_VALUES - 1) / MINIBLOCK_VALUES * BITPACK_LANES * width;
+}
+
+/**
+ * Pack one miniblock
+ * @param in   256 values, each below 2^width
+ * @param out  4 × width words
+ */
+inline void pack_miniblock(const uint64_t* in, unsigned width, uint64_t* out) noexcept {
+    if (width == 0) {
+        return;
+    }
+    std::memset(out, 0, BITPACK_LANES * width * sizeof(uint64_t));
+    for (size_t i = 0; i < MINIBLOCK_VALUES; ++i) {
+        const size_t bit = (i / BITPACK_LANES) * width;
+        const size_t word = (bit / 64) * BITPACK_LANES + i % BITPACK_LANES;
+        const unsigned shift = bit % 64;
+        out[word] |= in[i] << shift;
+        if (shift + width > 64) {
+            out[word + BITPACK_LANES] |= in[i] >> (64 - shift);
+        }
+    }
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+namespace detail {
+
+/**
+ * Scalar kernel: any width, one value at a time (the fallback)
+ */
+SAGE_HOT
+inline void unpack_scalar(const uint64_t* SAGE_RESTRICT in, unsigned width, size_t miniblocks, bool delta,
+                          int64_t base, uint32_t scale, int64_t* SAGE_RESTRICT out) noexcept {
+    const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    uint64_t sum = static_cast<uint64_t>(base);   // Wraps like the encoder's difference
+    for (size_t m = 0; m < miniblocks; ++m) {
+        for (size_t i = 0; i < MINIBLOCK_VALUES; ++i) {
+            const size_t bit = (i / BITPACK_LANES) * width;
+            const size_t word = (bit / 64) * BITPACK_LANES + i % BITPACK_LANES;
+            const unsigned shift = bit % 64;
+            uint64_t value = width == 0 ? 0 : in[word] >> shift;
+            if (shift + width > 64) {
+                value |= in[word + BITPACK_LANES] << (64 - shift);
+            }
+            value &= mask;
+            out[i] = static_cast<int64_t>(delta ? sum += static_cast<uint64_t>(zigzag_decode(value)) * scale : value);
+        }
+        in += BITPACK_LANES * width;
+        out += MINIBLOCK_VALUES;
+    }
+}
+
+#if defined(__AVX2__)
+// (v >> 1) ^ -(v & 1)
+SAGE_ALWAYS_INLINE
+__m256i unzigzag(__m256i v) noexcept {
+    const __m256i sign = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi64x(1)));
+    return _mm256_xor_si256(_mm256_srli_epi64(v, 1), sign);
+}
+
+// Low 64 bits of v × scale (AVX2 has no 64-bit multiply; scale < 2^32)
+SAGE_ALWAYS_INLINE
+__m256i mul_scale(__m256i v, __m256i scale) noexcept {
+    const __m256i lo = _mm256_mul_epu32(v, scale);
+    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), scale);
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+}
+
+// [a b c d] -> [a a+b b+c c+d] -> [a a+b a+b+c a+b+c+d], plus carry;
+// carry becomes the last lane
+SAGE_ALWAYS_INLINE
+__m256i prefix_sum(__m256i v, __m256i& carry) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x90), zero, 0x03));
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x40), zero, 0x0F));
+    v = _mm256_add_epi64(v, carry);
+    carry = _mm256_permute4x64_epi64(v, 0xFF);
+    return v;
+}
+
+/**
+ * Field K of every lane: values 4K .. 4K+3 of the miniblock
+ */
+template <unsigned W, size_t K>
+SAGE_ALWAYS_INLINE
+void unpack_step(const uint64_t* SAGE_RESTRICT in, int64_t* SAGE_RESTRICT out, bool delta,
+                 __m256i scale, __m256i& carry) noexcept {
+    constexpr size_t bit = K * W;
+    constexpr size_t word = bit / 64;
+    constexpr unsigned shift = bit % 64;
+    __m256i v = _mm256_srli_epi64(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + word * BITPACK_LANES)), shift);
+    if constexpr (shift + W > 64) {
+        v = _mm256_or_si256(v, _mm256_slli_epi64(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + (word + 1) * BITPACK_LANES)), 64 - shift));
+    }
+    if constexpr (W < 64) {
+        v = _mm256_and_si256(v, _mm256_set1_epi64x(static_cast<long long>((uint64_t{1} << W) - 1)));
+    }
+    if (delta) {
+        v = prefix_sum(mul_scale(unzigzag(v), scale), carry);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + K * BITPACK_LANES), v);
+}
+
+template <unsigned W, size_t... K>
+SAGE_ALWAYS_INLINE
+void unpack_miniblock(const uint64_t* SAGE_RESTRICT in, int64_t* SAGE_RESTRICT out, bool delta,
+                      __m256i scale, __m256i& carry, std::index_sequence<K...>) noexcept {
+    (unpack_step<W, K>(in, out, delta, scale, carry), ...);
+}
+
+/**
+ * AVX2 kernel for one width (shifts and masks constant, fully unrolled)
+ */
+template <unsigned W>
+SAGE_HOT
+void unpack_avx2(const uint64_t* SAGE_RESTRICT in, size_t miniblocks, bool delta, int64_t base,
+                 uint32_t scale, int64_t* SAGE_RESTRICT out) noexcept {
+    const __m256i factor = _mm256_set1_epi64x(scale);
+    __m256i carry = _mm256_set1_epi64x(base);
+    for (size_t m = 0; m < miniblocks; ++m) {
+        if constexpr (W == 0) {
+            // Every delta 0 (the base repeats), or every value 0
+            const __m256i v = delta ? carry : _mm256_setzero_si256();
+            for (size_t i = 0; i < MINIBLOCK_VALUES; i += BITPACK_LANES) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+            }
+        } else {
+            unpack_miniblock<W>(in, out, delta, factor, carry,
+                                std::make_index_sequence<MINIBLOCK_VALUES / BITPACK_LANES>{});
+        }
+        in += BITPACK_LANES * W;
+        out += MINIBLOCK_VALUES;
+    }
+}
+
+using UnpackFn = void (*)(const uint64_t*, size_t, bool, int64_t, uint32_t, int64_t*) noexcept;
+
+template <size_t... W>
+constexpr std::array<UnpackFn, sizeof...(W)> make_unpack_table(std::index_sequence<W...>) noexcept {
+    return {{&unpack_avx2<static_cast<unsigned>(W)>...}};
+}
+
+inline constexpr std::array<UnpackFn, 65> UNPACK_AVX2 = make_unpack_table(std::make_index_sequence<65>{});
+#endif
+
+} // namespace detail
+
+/**
+ * Decode whole miniblocks (256 values each) of width-bit values
+ * @param width  0..64
+ * @param delta  Values are zigzag deltas in units of scale: out gets
+ *               base plus their running sum times scale
+ * @param out    miniblocks × 256 values
+ */
+SAGE_ALWAYS_INLINE
+void unpack(const uint64_t* in, unsigned width, size_t miniblocks, bool delta, int64_t base,
+            uint32_t scale, int64_t* out, UnpackPath path = UnpackPath::NATIVE) noexcept {
+#if defined(__AVX2__)
+    if (path == UnpackPath::NATIVE) {
+        detail::UNPACK_AVX2[width](in, miniblocks, delta, base, scale, out);
+        return;
+    }
+#endif
+    (void)path;
+    detail::unpack_scalar(in, width, miniblocks, delta, base, scale, out);
+}
+
+} // namespace rec
+} // namespace sage
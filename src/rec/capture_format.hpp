@@ -0,0 +1,167 @@
+#pragma once
+
+/**
+ * SAGE Capture File Format
+ * Fixed-layout binary capture of the normalized SageMessage stream
+ *
+ * A capture is a series of rotating files. Each file is preallocated to its
+ * full size and written through a shared mapping:
+ *
+ *   ┌────────────────────────────────────────┐
+ *   │ CaptureFileHeader (4KB)                │  schema, symbol map, TSC
+ *   ├────────────────────────────────────────┤
+ *   │ chunk 0: CaptureIndexBlock (128B)      │  time / sequence / symbols
+ *   │          chunk_records × SageMessage   │  64B records, as published
+ *   ├────────────────────────────────────────┤
+ *   │ chunk 1: ...                           │
+ *   └────────────────────────────────────────┘
+ *
+ * Records are SageMessage bytes verbatim (schema = this header's
+ * schema_version + shm_layout_version), in the order ADE consumed them.
+ * Every chunk opens with an index block, so a reader can seek by time or
+ * symbol by striding over index blocks without touching the records.
+ *
+ * The header's record_count is the committed extent: the writer bumps it
+ * after records (and their chunk's index block) are in place, so a reader
+ * of a live or crashed capture never sees a torn record. A file closed
+ * cleanly has closed = 1 and is truncated after its last record.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../core/constants.hpp"
+#include "../core/timing.hpp"
+#include "../types/sage_message.hpp"
+
+namespace sage {
+namespace rec {
+
+/// Bump on any change to the structures below
+constexpr uint32_t CAPTURE_SCHEMA_VERSION = 1;
+
+constexpr size_t CAPTURE_HEADER_SIZE = 4096;
+constexpr size_t CAPTURE_INDEX_SIZE = 128;
+constexpr size_t CAPTURE_RECORD_SIZE = sizeof(SageMessage);
+constexpr size_t CAPTURE_MAX_SYMBOLS = 64;
+
+/**
+ * One SymbolMapping as recorded
+ */
+struct CaptureSymbol {
+    uint32_t symbol_id;
+    uint8_t venue;           // ExchangeId
+    uint8_t reserved[3];
+    char name[24];           // NUL-terminated (longer names are truncated)
+};
+static_assert(sizeof(CaptureSymbol) == 32, "CaptureSymbol must be 32 bytes");
+
+/**
+ * File header (first page of every capture file)
+ */
+struct CaptureFileHeader {
+    // Identity (written once at open)
+    uint64_t magic;                  // MAGIC_CAPTURE_FILE
+    uint32_t schema_version;         // CAPTURE_SCHEMA_VERSION
+    uint32_t shm_layout_version;     // SHM_LAYOUT_VERSION (SageMessage layout)
+    uint32_t header_size;            // CAPTURE_HEADER_SIZE
+    uint32_t index_size;             // CAPTURE_INDEX_SIZE
+    uint32_t record_size;            // CAPTURE_RECORD_SIZE
+    uint32_t chunk_records;          // Records per chunk
+    uint64_t file_size;              // Preallocated size
+    uint64_t file_index;             // Position in the capture's rotation (0, 1, ...)
+    uint64_t created_ns;             // CLOCK_REALTIME
+    timing::TSCCalibration tsc;      // Recording host's TSC mapping
+    uint32_t symbol_count;
+    uint32_t reserved0;
+    CaptureSymbol symbols[CAPTURE_MAX_SYMBOLS];
+
+    // Progress (written as records commit)
+    uint64_t record_count;           // Committed records
+    uint64_t first_ts_ns;            // timestamp_ns of the first / last record
+    uint64_t last_ts_ns;
+    uint32_t closed;                 // 1 once the writer finished the file
+    uint32_t reserved1;
+
+    uint8_t padding[CAPTURE_HEADER_SIZE - 96 - CAPTURE_MAX_SYMBOLS * sizeof(CaptureSymbol) - 32];
+};
+static_assert(sizeof(CaptureFileHeader) == CAPTURE_HEADER_SIZE, "CaptureFileHeader must be one page");
+
+/**
+ * Index block at the start of every chunk
+ * Filled when the chunk's first record is written and completed when the
+ * chunk is sealed; for the chunk still being written, record_count and the
+ * last_* fields trail the file header's record_count.
+ */
+struct CaptureIndexBlock {
+    uint64_t magic;                  // MAGIC_CAPTURE_INDEX
+    uint64_t chunk;                  // Chunk number in the file
+    uint64_t first_record;           // File record number of the chunk's first record
+    uint32_t record_count;           // Records in the chunk (when sealed)
+    uint32_t reserved;
+    uint64_t first_ts_ns;
+    uint64_t last_ts_ns;
+    uint64_t first_sequence;         // SageMessage::sequence_id
+    uint64_t last_sequence;
+    uint64_t symbols[4];             // Market data symbol_ids present (bit per id, mod 256)
+    uint8_t padding[CAPTURE_INDEX_SIZE - 96];
+
+    bool has_symbol(uint32_t symbol_id) const noexcept {
+        return (symbols[(symbol_id >> 6) & 3] >> (symbol_id & 63)) & 1;
+    }
+};
+static_assert(sizeof(CaptureIndexBlock) == CAPTURE_INDEX_SIZE, "CaptureIndexBlock must be 128 bytes");
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+constexpr size_t chunk_bytes(uint32_t chunk_records) noexcept {
+    return CAPTURE_INDEX_SIZE + static_cast<size_t>(chunk_records) * CAPTURE_RECORD_SIZE;
+}
+
+/**
+ * Records a file of file_size bytes holds (whole chunks only)
+ */
+constexpr uint64_t file_capacity(uint64_t file_size, uint32_t chunk_records) noexcept {
+    return file_size <= CAPTURE_HEADER_SIZE || chunk_records == 0 ? 0
+        : (file_size - CAPTURE_HEADER_SIZE) / chunk_bytes(chunk_records) * chunk_records;
+}
+
+constexpr size_t index_offset(uint64_t chunk, uint32_t chunk_records) noexcept {
+    return CAPTURE_HEADER_SIZE + static_cast<size_t>(chunk) * chunk_bytes(chunk_records);
+}
+
+constexpr size_t record_offset(uint64_t record, uint32_t chunk_records) noexcept {
+    return index_offset(record / chunk_records, chunk_records) + CAPTURE_INDEX_SIZE +
+           static_cast<size_t>(record % chunk_records) * CAPTURE_RECORD_SIZE;
+}
+
+/**
+ * Check a mapped file's header against this build
+ * @return nullptr if valid, else what is wrong
+ */
+inline const char* validate_header(const CaptureFileHeader& header, size_t mapped_size) noexcept {
+    if (mapped_size < CAPTURE_HEADER_SIZE || header.magic != MAGIC_CAPTURE_FILE) {
+        return "not a SAGE capture file";
+    }
+    if (header.schema_version != CAPTURE_SCHEMA_VERSION ||
+        header.header_size != CAPTURE_HEADER_SIZE || header.index_size != CAPTURE_INDEX_SIZE) {
+        return "unsupported capture schema version";
+    }
+    if (header.record_size != CAPTURE_RECORD_SIZE || header.shm_layout_version != SHM_LAYOUT_VERSION) {
+        return "recorded with a different SageMessage layout";
+    }
+    if (header.chunk_records == 0 || header.symbol_count > CAPTURE_MAX_SYMBOLS) {
+        return "corrupt capture header";
+    }
+    if (header.record_count > 0 &&
+        record_offset(header.record_count - 1, header.chunk_records) + CAPTURE_RECORD_SIZE > mapped_size) {
+        return "capture file truncated";
+    }
+    return nullptr;
+}
+
+} // namespace rec
+} // namespace sage
@@ -0,0 +1,242 @@
+#pragma once
+
+/**
+ * SAGE Capture Reader
+ * Read-only, memory-mapped view of one capture file
+ *
+ * Records are served in place: span() hands out each chunk's records as
+ * one contiguous run of SageMessages, so a reader copies nothing until it
+ * pushes them somewhere. Index blocks make seek() by time a stride over
+ * chunk headers rather than a scan of the records.
+ *
+ * A file still being written is fine: records() follows the writer's
+ * committed count (acquire), and the mapping covers the whole
+ * preallocated file.
+ *
+ * Not thread-safe: one reader thread per instance.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../types/sage_message.hpp"
+#include "capture_format.hpp"
+
+namespace sage {
+namespace rec {
+
+class CaptureReader {
+public:
+    CaptureReader() noexcept = default;
+
+    ~CaptureReader() noexcept {
+        close();
+    }
+
+    // Non-copyable (owns a mapping)
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    /**
+     * Map a capture file and check its header against this build
+     * @return false (see last_error()) if unreadable or incompatible
+     */
+    SAGE_COLD
+    bool open(const std::string& path) {
+        close();
+        path_ = path;
+#ifdef __linux__
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return fail("open");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return fail("stat");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* ptr = size_ >= CAPTURE_HEADER_SIZE
+            ? ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            size_ = 0;
+            error_ = path + ": not a SAGE capture file";
+            return false;
+        }
+        base_ = static_cast<const uint8_t*>(ptr);
+        ::madvise(ptr, size_, MADV_SEQUENTIAL);
+#else
+        return fail("capture files need Linux");
+#endif
+        header_ = reinterpret_cast<const CaptureFileHeader*>(base_);
+        if (const char* problem = validate_header(*header_, size_)) {
+            error_ = path + ": " + problem;
+            close();
+            return false;
+        }
+        chunk_records_ = header_->chunk_records;
+        const uint64_t body = size_ - CAPTURE_HEADER_SIZE;
+        const uint64_t tail = body % chunk_bytes(chunk_records_);
+        mapped_records_ = body / chunk_bytes(chunk_records_) * chunk_records_ +
+                          (tail > CAPTURE_INDEX_SIZE ? (tail - CAPTURE_INDEX_SIZE) / CAPTURE_RECORD_SIZE : 0);
+        return true;
+    }
+
+    void close() noexcept {
+#ifdef __linux__
+        if (base_ != nullptr) {
+            ::munmap(const_cast<uint8_t*>(base_), size_);
+        }
+#endif
+        base_ = nullptr;
+        header_ = nullptr;
+        size_ = 0;
+    }
+
+    // ========================================================================
+    // Records
+    // ========================================================================
+
+    /**
+     * Committed records (grows while the writer is live)
+     */
+    uint64_t records() const noexcept {
+        // Never past the mapping, whatever the header claims
+        return std::min(__atomic_load_n(&header_->record_count, __ATOMIC_ACQUIRE), mapped_records_);
+    }
+
+    SAGE_ALWAYS_INLINE
+    const SageMessage& record(uint64_t i) const noexcept {
+        return *reinterpret_cast<const SageMessage*>(base_ + record_offset(i, chunk_records_));
+    }
+
+    /**
+     * Contiguous records from `first` to the end of its chunk (or of the
+     * committed records); asks the kernel to start reading the next chunk
+     * when `first` opens one
+     * @return Number of records at `out` (0 at the end)
+     */
+    SAGE_HOT
+    size_t span(uint64_t first, const SageMessage*& out) const noexcept {
+        const uint64_t end = records();
+        if (first >= end) {
+            return 0;
+        }
+        const uint64_t chunk_end = (first / chunk_records_ + 1) * chunk_records_;
+        out = &record(first);
+#ifdef __linux__
+        if (first % chunk_records_ == 0 && chunk_end < end) {
+            const uintptr_t next = reinterpret_cast<uintptr_t>(base_ + index_offset(first / chunk_records_ + 1, chunk_records_));
+            const uintptr_t page = next & ~(PAGE_SIZE - 1);
+            const size_t length = std::min<size_t>(chunk_bytes(chunk_records_) + (next - page),
+                                                   reinterpret_cast<uintptr_t>(base_) + size_ - page);
+            ::madvise(reinterpret_cast<void*>(page), length, MADV_WILLNEED);
+        }
+#endif
+        return static_cast<size_t>(std::min(chunk_end, end) - first);
+    }
+
+    // ========================================================================
+    // Index
+    // ========================================================================
+
+    uint64_t chunks() const noexcept {
+        return (records() + chunk_records_ - 1) / chunk_records_;
+    }
+
+    const CaptureIndexBlock& index(uint64_t chunk) const noexcept {
+        return *reinterpret_cast<const CaptureIndexBlock*>(base_ + index_offset(chunk, chunk_records_));
+    }
+
+    /**
+     * First record stamped at or after timestamp_ns (records() if none)
+     * Skips whole chunks by their index blocks, then scans one chunk.
+     */
+    uint64_t seek(uint64_t timestamp_ns) const noexcept {
+        const uint64_t end = records();
+        const uint64_t count = chunks();
+        for (uint64_t chunk = 0; chunk < count; ++chunk) {
+            const CaptureIndexBlock& block = index(chunk);
+            const uint64_t first = chunk * chunk_records_;
+            const uint64_t last = std::min(first + chunk_records_, end);
+            // The open chunk's index may trail the records: scan it
+            if (block.last_ts_ns < timestamp_ns && block.record_count == last - first) {
+                continue;
+            }
+            for (uint64_t i = first; i < last; ++i) {
+                if (record(i).timestamp_ns >= timestamp_ns) {
+                    return i;
+                }
+            }
+        }
+        return end;
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    bool is_open() const noexcept { return base_ != nullptr; }
+    const CaptureFileHeader& header() const noexcept { return *header_; }
+    const std::string& path() const noexcept { return path_; }
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    SAGE_COLD
+    bool fail(const char* what) {
+        error_ = path_ + ": " + what + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const uint8_t* base_ = nullptr;
+    const CaptureFileHeader* header_ = nullptr;
+    size_t size_ = 0;
+    uint32_t chunk_records_ = 1;
+    uint64_t mapped_records_ = 0;    // Records that fit in the mapping
+    std::string path_;
+    std::string error_;
+};
+
+/**
+ * Expand a capture argument: a file as is, a directory to the *.cap files
+ * in it in name order (= recording order)
+ * @return false if path is neither
+ */
+SAGE_COLD
+inline bool list_capture_files(const std::string& path, std::vector<std::string>& out) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (fs::is_regular_file(path, error)) {
+        out.push_back(path);
+        return true;
+    }
+    if (!fs::is_directory(path, error)) {
+        return false;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : fs::directory_iterator(path, error)) {
+        if (entry.path().extension() == ".cap") {
+            found.push_back(entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    out.insert(out.end(), found.begin(), found.end());
+    return true;
+}
+
+} // namespace rec
+} // namespace sage
@@ -0,0 +1,358 @@
+#pragma once
+
+/**
+ * SAGE Capture Writer
+ * Appends SageMessage records to preallocated, memory-mapped capture files
+ *
+ * Each file is created at its full size (posix_fallocate, so running out
+ * of disk fails at rotation rather than as SIGBUS mid-chunk), mapped
+ * MAP_SHARED and filled front to back with memcpy - no write() per batch.
+ * See capture_format.hpp for the layout.
+ *
+ * Keeping the page cache out of the way at multi-million msgs/sec:
+ * - The next chunk is faulted in when the previous one seals, so appends
+ *   never take a page fault on the recording thread's critical loop.
+ * - A sealed chunk is handed to writeback immediately
+ *   (sync_file_range WRITE), so dirty pages never pile up into a stall.
+ * - Two chunks behind, writeback is waited for and the pages are dropped
+ *   from the cache (the capture is write-once; nobody rereads it hot).
+ *
+ * When a file is full the writer closes it (closed = 1, truncated after
+ * its last record) and opens the next in the rotation:
+ *   <directory>/<prefix>-YYYYmmdd-HHMMSS-NNNN.cap   (UTC, NNNN = file_index)
+ *
+ * Not thread-safe: one writer thread. Readers of a live file go by the
+ * header's record_count (release-stored after the records).
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../core/config.hpp"
+#include "../core/memory.hpp"
+#include "../core/timing.hpp"
+#include "../types/sage_message.hpp"
+#include "../types/symbol_map.hpp"
+#include "capture_format.hpp"
+
+namespace sage {
+namespace rec {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct CaptureConfig {
+    std::string directory = "capture";
+    std::string prefix = "sage";
+    uint64_t file_size = 1ULL << 30;      // Preallocated bytes per file
+    uint32_t chunk_records = 16384;       // Records per index block (1MB chunks)
+};
+
+/**
+ * Read [rec] (directory, prefix, file_size_mb, chunk_records)
+ * @return false (with error set) if a file cannot hold one chunk
+ */
+SAGE_COLD
+inline bool read_capture_config(const config::ConfigFile& file, CaptureConfig& out, std::string& error) {
+    out = CaptureConfig{};
+    out.directory = file.get_string("rec.directory", out.directory);
+    out.prefix = file.get_string("rec.prefix", out.prefix);
+    const int64_t file_size_mb = file.get_int("rec.file_size_mb",
+                                              static_cast<int64_t>(out.file_size >> 20));
+    const int64_t chunk_records = file.get_int("rec.chunk_records", out.chunk_records);
+    if (file_size_mb <= 0 || chunk_records <= 0 || chunk_records > UINT32_MAX) {
+        error = "rec.file_size_mb and rec.chunk_records must be positive";
+        return false;
+    }
+    out.file_size = static_cast<uint64_t>(file_size_mb) << 20;
+    out.chunk_records = static_cast<uint32_t>(chunk_records);
+    if (file_capacity(out.file_size, out.chunk_records) == 0) {
+        error = "rec.file_size_mb: too small for one chunk of rec.chunk_records";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Capture Writer
+// ============================================================================
+
+class CaptureWriter {
+public:
+    CaptureWriter() noexcept = default;
+
+    ~CaptureWriter() noexcept {
+        close();
+    }
+
+    // Non-copyable (owns a mapping)
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * Create the directory if needed and open the first file
+     * @param symbols      Symbol table recorded in every file header
+     * @param calibration  Recording host's TSC mapping
+     * @return false (see last_error()) if the file cannot be created
+     */
+    SAGE_COLD
+    bool open(const CaptureConfig& config, const SymbolMapping* symbols, size_t symbol_count,
+              const timing::TSCCalibration& calibration) {
+        close();
+        if (file_capacity(config.file_size, config.chunk_records) == 0) {
+            error_ = "file_size too small for one chunk";
+            return false;
+        }
+        config_ = config;
+        calibration_ = calibration;
+        symbol_count_ = 0;
+        for (size_t i = 0; i < symbol_count && symbol_count_ < CAPTURE_MAX_SYMBOLS; ++i) {
+            CaptureSymbol& s = symbols_[symbol_count_++];
+            s = CaptureSymbol{};
+            s.symbol_id = symbols[i].symbol_id;
+            s.venue = static_cast<uint8_t>(symbols[i].venue);
+            std::strncpy(s.name, symbols[i].name, sizeof(s.name) - 1);
+        }
+        records_ = 0;
+        files_ = 0;
+#ifdef __linux__
+        if (::mkdir(config_.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            return fail("mkdir " + config_.directory);
+        }
+#endif
+        return open_file(0);
+    }
+
+    /**
+     * Append records, rotating files as they fill
+     * @return Records written (short only if the next file could not be
+     *         opened; the writer is then closed, see last_error())
+     */
+    SAGE_HOT
+    size_t append(const SageMessage* messages, size_t count) noexcept {
+        size_t done = 0;
+        while (done < count && base_ != nullptr) {
+            if (file_records_ == capacity_) [[unlikely]] {
+                if (!rotate()) {
+                    break;
+                }
+            }
+            const uint32_t in_chunk = static_cast<uint32_t>(file_records_ % config_.chunk_records);
+            const size_t room = static_cast<size_t>(
+                std::min<uint64_t>(config_.chunk_records - in_chunk, capacity_ - file_records_));
+            const size_t n = std::min(count - done, room);
+
+            CaptureIndexBlock* index = index_block(file_records_ / config_.chunk_records);
+            if (in_chunk == 0) {
+                start_chunk(*index, messages[done]);
+            }
+            std::memcpy(base_ + record_offset(file_records_, config_.chunk_records),
+                        messages + done, n * CAPTURE_RECORD_SIZE);
+            for (size_t i = done; i < done + n; ++i) {
+                if (messages[i].msg_type == MessageType::MARKET_DATA) {
+                    const uint32_t id = messages[i].payload.market_data.symbol_id;
+                    index->symbols[(id >> 6) & 3] |= 1ULL << (id & 63);
+                }
+            }
+            const SageMessage& last = messages[done + n - 1];
+            index->record_count = in_chunk + static_cast<uint32_t>(n);
+            index->last_ts_ns = last.timestamp_ns;
+            index->last_sequence = last.sequence_id;
+
+            file_records_ += n;
+            records_ += n;
+            done += n;
+
+            // Commit: records and index block before the count readers go by
+            header_->last_ts_ns = last.timestamp_ns;
+            __atomic_store_n(&header_->record_count, file_records_, __ATOMIC_RELEASE);
+
+            if (index->record_count == config_.chunk_records) {
+                seal_chunk(file_records_ / config_.chunk_records - 1);
+            }
+        }
+        return done;
+    }
+
+    /**
+     * Finish the current file (closed = 1, truncated to its records)
+     */
+    SAGE_COLD
+    void close() noexcept {
+        if (base_ == nullptr) {
+            return;
+        }
+        const uint64_t used = used_bytes();
+        header_->closed = 1;
+#ifdef __linux__
+        ::munmap(base_, config_.file_size);
+        if (::ftruncate(fd_, static_cast<off_t>(used)) != 0) {
+            fail("ftruncate " + path_);
+        }
+        ::close(fd_);
+#endif
+        base_ = nullptr;
+        header_ = nullptr;
+        fd_ = -1;
+    }
+
+    // ========================================================================
+    // Accessors
+    // ========================================================================
+
+    bool is_open() const noexcept { return base_ != nullptr; }
+    uint64_t records() const noexcept { return records_; }          // Across all files
+    uint64_t bytes() const noexcept { return records_ * CAPTURE_RECORD_SIZE; }
+    uint64_t files() const noexcept { return files_; }              // Files opened
+    const std::string& path() const noexcept { return path_; }      // Current / last file
+    const std::string& last_error() const noexcept { return error_; }
+
+private:
+    SAGE_COLD
+    bool open_file(uint64_t file_index) {
+        const uint64_t created_ns = timing::get_realtime_ns();
+        const std::time_t seconds = static_cast<std::time_t>(created_ns / NANOS_PER_SEC);
+        std::tm utc{};
+        gmtime_r(&seconds, &utc);
+        char name[64];
+        std::snprintf(name, sizeof(name), "-%04d%02d%02d-%02d%02d%02d-%04llu.cap",
+                      utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+                      utc.tm_hour, utc.tm_min, utc.tm_sec,
+                      static_cast<unsigned long long>(file_index));
+        path_ = config_.directory + "/" + config_.prefix + name;
+
+#ifdef __linux__
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return fail("open " + path_);
+        }
+        // posix_fallocate returns the error rather than setting errno
+        if (const int rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(config_.file_size)); rc != 0) {
+            errno = rc;
+            ::close(fd_);
+            fd_ = -1;
+            return fail("fallocate " + path_);
+        }
+        void* ptr = ::mmap(nullptr, config_.file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd_);
+            fd_ = -1;
+            return fail("mmap " + path_);
+        }
+        base_ = static_cast<uint8_t*>(ptr);
+#else
+        return fail("capture files need Linux");
+#endif
+        header_ = reinterpret_cast<CaptureFileHeader*>(base_);
+        std::memset(header_, 0, sizeof(CaptureFileHeader));
+        header_->magic = MAGIC_CAPTURE_FILE;
+        header_->schema_version = CAPTURE_SCHEMA_VERSION;
+        header_->shm_layout_version = SHM_LAYOUT_VERSION;
+        header_->header_size = CAPTURE_HEADER_SIZE;
+        header_->index_size = CAPTURE_INDEX_SIZE;
+        header_->record_size = CAPTURE_RECORD_SIZE;
+        header_->chunk_records = config_.chunk_records;
+        header_->file_size = config_.file_size;
+        header_->file_index = file_index;
+        header_->created_ns = created_ns;
+        header_->tsc = calibration_;
+        header_->symbol_count = static_cast<uint32_t>(symbol_count_);
+        std::memcpy(header_->symbols, symbols_, symbol_count_ * sizeof(CaptureSymbol));
+
+        capacity_ = file_capacity(config_.file_size, config_.chunk_records);
+        file_records_ = 0;
+        file_index_ = file_index;
+        ++files_;
+        memory::populate_pages(index_block(0), chunk_bytes(config_.chunk_records));
+        return true;
+    }
+
+    SAGE_COLD
+    bool rotate() noexcept {
+        close();
+        return open_file(file_index_ + 1);
+    }
+
+    CaptureIndexBlock* index_block(uint64_t chunk) const noexcept {
+        return reinterpret_cast<CaptureIndexBlock*>(base_ + index_offset(chunk, config_.chunk_records));
+    }
+
+    void start_chunk(CaptureIndexBlock& index, const SageMessage& first) noexcept {
+        std::memset(&index, 0, sizeof(index));
+        index.magic = MAGIC_CAPTURE_INDEX;
+        index.chunk = file_records_ / config_.chunk_records;
+        index.first_record = file_records_;
+        index.first_ts_ns = first.timestamp_ns;
+        index.first_sequence = first.sequence_id;
+        if (file_records_ == 0) {
+            header_->first_ts_ns = first.timestamp_ns;
+        }
+    }
+
+    /**
+     * Full chunk: start its writeback, retire the one two behind, fault in
+     * the next
+     */
+    SAGE_COLD
+    void seal_chunk(uint64_t chunk) noexcept {
+        const size_t bytes = chunk_bytes(config_.chunk_records);
+#ifdef __linux__
+        ::sync_file_range(fd_, static_cast<off_t>(index_offset(chunk, config_.chunk_records)),
+                          static_cast<off_t>(bytes), SYNC_FILE_RANGE_WRITE);
+        if (chunk >= 2) {
+            const off_t old = static_cast<off_t>(index_offset(chunk - 2, config_.chunk_records));
+            ::sync_file_range(fd_, old, static_cast<off_t>(bytes),
+                              SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                              SYNC_FILE_RANGE_WAIT_AFTER);
+            ::posix_fadvise(fd_, old, static_cast<off_t>(bytes), POSIX_FADV_DONTNEED);
+        }
+#endif
+        if (file_records_ < capacity_) {
+            memory::populate_pages(index_block(chunk + 1), bytes);
+        }
+    }
+
+    uint64_t used_bytes() const noexcept {
+        return file_records_ == 0 ? CAPTURE_HEADER_SIZE
+                                  : record_offset(file_records_ - 1, config_.chunk_records) + CAPTURE_RECORD_SIZE;
+    }
+
+    SAGE_COLD
+    bool fail(const std::string& what) {
+        error_ = what + ": " + std::strerror(errno);
+        return false;
+    }
+
+    CaptureConfig config_;
+    timing::TSCCalibration calibration_{};
+    CaptureSymbol symbols_[CAPTURE_MAX_SYMBOLS]{};
+    size_t symbol_count_ = 0;
+
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    CaptureFileHeader* header_ = nullptr;
+    uint64_t capacity_ = 0;          // Records per file
+    uint64_t file_records_ = 0;      // Records in the current file
+    uint64_t file_index_ = 0;
+    uint64_t records_ = 0;
+    uint64_t files_ = 0;
+    std::string path_;
+    std::string error_;
+};
+
+} // namespace rec
+} // namespace sage
@@ -0,0 +1,173 @@
+/**
+ * SAGE REC - Tick Recorder
+ * Appends the normalized market data stream to rotating capture files
+ *
+ * Architecture Notes:
+ * - Reads ADE's CAL tap (SHM_CAL_TAP) as a LOSSY broadcast consumer: the
+ *   live path never waits for the recorder. If the recorder falls a full
+ *   tap behind, the overwritten messages are skipped and counted
+ *   (overruns), never blocked on.
+ * - Records are the SageMessages exactly as ADE consumed them, conflated
+ *   lane included, so a capture replays what ADE saw.
+ * - Files are preallocated and memory-mapped (capture_writer.hpp); the
+ *   recording loop is memcpy plus an index block update per batch.
+ * - Runs on the OS core: recording is not latency critical, only
+ *   throughput critical.
+ */
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/config.hpp"
+#include "../core/timing.hpp"
+#include "../core/cpu_affinity.hpp"
+#include "../core/shutdown.hpp"
+#include "../infra/shm_segment.hpp"
+#include "../types/sage_message.hpp"
+#include "../types/symbol_map.hpp"
+#include "capture_writer.hpp"
+
+using namespace sage;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+constexpr size_t BATCH_SIZE = 256;      // Records per append (16KB)
+
+// ============================================================================
+// Global State
+// ============================================================================
+
+// Input: ADE's tap of the CAL stream (created by ADE)
+static ShmBroadcastRing<SageMessage, SHM_CAL_TAP_CAPACITY> g_cal_tap;
+static int g_consumer_id = -1;
+
+static rec::CaptureWriter g_writer;
+static timing::TSCCalibrator g_tsc_calibrator;
+
+// Metrics (read by the stats thread)
+static std::atomic<uint64_t> g_records{0};
+static std::atomic<uint64_t> g_files{0};
+
+// ============================================================================
+// Stats Thread
+// ============================================================================
+
+static void stats_thread() {
+    uint64_t last_records = 0;
+    while (!ShutdownManager::instance().is_shutdown_requested()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        const uint64_t records = g_records.load();
+        std::cout << "[REC] Stats: records=" << records
+                  << " rate=" << records - last_records << "/s"
+                  << " MB/s=" << (records - last_records) * rec::CAPTURE_RECORD_SIZE / (1024 * 1024)
+                  << " files=" << g_files.load()
+                  << " overruns=" << g_cal_tap->overruns(g_consumer_id)
+                  << " lag=" << g_cal_tap->lag(g_consumer_id)
+                  << std::endl;
+        last_records = records;
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    std::cout << "[REC] Starting Tick Recorder..." << std::endl;
+
+    // Capture settings from sage.toml: argv[1], else $SAGE_CONFIG, else config/sage.toml
+    const char* config_path = (argc > 1) ? argv[1] : std::getenv("SAGE_CONFIG");
+    if (config_path == nullptr) {
+        config_path = "config/sage.toml";
+    }
+    config::ConfigFile config_file;
+    rec::CaptureConfig capture_config;
+    std::string config_error;
+    if (!config_file.load(config_path)) {
+        std::cerr << "[REC] " << config_path << ": " << config_file.last_error() << std::endl;
+        return 1;
+    }
+    if (!rec::read_capture_config(config_file, capture_config, config_error)) {
+        std::cerr << "[REC] " << config_path << ": " << config_error << std::endl;
+        return 1;
+    }
+
+    // Throughput, not latency: share the OS core
+    if (cpu::pin_to_core(CORE_OS) == 0) {
+        std::cout << "[REC] Pinned to core " << CORE_OS << std::endl;
+    }
+
+    ShutdownManager::instance().install_signal_handlers();
+
+    std::cout << "[REC] Waiting for " << SHM_CAL_TAP << "..." << std::endl;
+    if (!g_cal_tap.attach_blocking(SHM_CAL_TAP, [] {
+            return ShutdownManager::instance().is_shutdown_requested();
+        })) {
+        std::cerr << "[REC] Failed to attach " << SHM_CAL_TAP << std::endl;
+        return 1;
+    }
+    g_consumer_id = g_cal_tap->add_consumer(ConsumerMode::LOSSY);
+    if (g_consumer_id < 0) {
+        std::cerr << "[REC] No free consumer slot on " << SHM_CAL_TAP << std::endl;
+        return 1;
+    }
+
+    if (!g_writer.open(capture_config, SYMBOLS, std::size(SYMBOLS), g_tsc_calibrator.calibration())) {
+        std::cerr << "[REC] " << g_writer.last_error() << std::endl;
+        g_cal_tap->remove_consumer(g_consumer_id);
+        return 1;
+    }
+    std::cout << "[REC] Recording to " << g_writer.path()
+              << " (" << (capture_config.file_size >> 20) << "MB files, "
+              << capture_config.chunk_records << " records per chunk)" << std::endl;
+
+    std::thread stats(stats_thread);
+
+    // Main loop: drain the tap in batches, back off when idle
+    SageMessage batch[BATCH_SIZE];
+    uint32_t idle = 0;
+    while (!ShutdownManager::instance().is_shutdown_requested()) {
+        const size_t count = g_cal_tap->try_consume_batch(g_consumer_id, batch, BATCH_SIZE);
+        if (count == 0) {
+            // Quiet market: spin briefly, then sleep (no core of our own)
+            if (++idle < 1024) {
+                cpu::pause();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            continue;
+        }
+        idle = 0;
+
+        if (g_writer.append(batch, count) != count) [[unlikely]] {
+            std::cerr << "[REC] " << g_writer.last_error() << std::endl;
+            ShutdownManager::instance().signal_shutdown();
+            break;
+        }
+        g_records.store(g_writer.records(), std::memory_order_relaxed);
+        g_files.store(g_writer.files(), std::memory_order_relaxed);
+    }
+
+    std::cout << "[REC] Shutting down..." << std::endl;
+    stats.join();
+
+    g_cal_tap->remove_consumer(g_consumer_id);
+    g_writer.close();
+
+    std::cout << "[REC] Final: records=" << g_writer.records()
+              << " files=" << g_writer.files()
+              << " overruns=" << g_cal_tap->overruns(g_consumer_id)
+              << " last=" << g_writer.path()
+              << std::endl;
+
+    return 0;
+}
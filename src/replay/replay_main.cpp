@@ -0,0 +1,282 @@
+/**
+ * SAGE Replay - Capture Playback
+ * Feeds recorded market data through the live pipeline in place of CAL
+ *
+ * Architecture Notes:
+ * - Creates CAL's segments (/sage_cal_to_ade and its conflation lane) and
+ *   pushes capture records into the queue exactly as recorded, so ADE,
+ *   RME and POE run unmodified: their real process_market_data,
+ *   process_signal and process_order handle every record.
+ * - Never drops: a full queue is waited on (ADE sets the pace), so nothing
+ *   is conflated and every run sees the same input.
+ * - Start ADE, RME and POE with SAGE_REPLAY=1: they run on virtual time
+ *   (timing.hpp), so what they emit depends on the capture alone, not on
+ *   the replay speed. POE writes sage_audit_replay.log instead of the
+ *   live audit log.
+ * - Pacing on the TSC at recorded inter-arrival times, scaled, or as fast
+ *   as ADE consumes (replay_pacer.hpp).
+ * - Refuses to start while a live CAL owns the segments.
+ *
+ * Usage: sage_replay [--speed asap|realtime|N] [--from NS] [--to NS] <file.cap | directory>...
+ *   --speed  asap (default), realtime (= 1), or a multiple of recorded speed
+ *   --from   skip records stamped before NS (CLOCK_REALTIME ns, via the index)
+ *   --to     stop at the first record stamped after NS
+ * Directories replay every *.cap inside in name order (= recording order).
+ */
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <signal.h>
+#endif
+
+#include "../core/compiler.hpp"
+#include "../core/constants.hpp"
+#include "../core/timing.hpp"
+#include "../core/cpu_affinity.hpp"
+#include "../core/shutdown.hpp"
+#include "../infra/shm_segment.hpp"
+#include "../types/sage_message.hpp"
+#include "../types/symbol_map.hpp"
+#include "../rec/capture_reader.hpp"
+#include "replay_pacer.hpp"
+
+using namespace sage;
+
+// ============================================================================
+// Global State
+// ============================================================================
+
+// Output: the segments CAL would create (ADE attaches by name)
+static ShmMpscQueue<SageMessage, 65536> g_cal_to_ade_buffer;
+static ShmConflatingQueue<SageMessage, SHM_CONFLATION_KEYS> g_cal_to_ade_latest;
+
+// ADE's tap: its published count is how far ADE has consumed
+static ShmBroadcastRing<SageMessage, SHM_CAL_TAP_CAPACITY> g_cal_tap;
+
+static timing::TSCCalibrator g_tsc_calibrator;
+
+// Metrics (read by the stats thread)
+static std::atomic<uint64_t> g_pushed{0};
+static std::atomic<uint64_t> g_position_ns{0};    // Recorded time of the last record pushed
+static std::atomic<uint64_t> g_late{0};
+
+struct ReplayOptions {
+    double speed = 0.0;                           // 0 = ASAP
+    uint64_t from_ns = 0;
+    uint64_t to_ns = UINT64_MAX;
+    std::vector<std::string> files;
+};
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+static bool parse_options(int argc, char** argv, ReplayOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if ((arg == "--speed" || arg == "--from" || arg == "--to") && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (arg == "--speed") {
+                out.speed = value == "asap" ? 0.0 : value == "realtime" ? 1.0 : std::strtod(value.c_str(), nullptr);
+                if (value != "asap" && out.speed <= 0.0) {
+                    std::cerr << "[REPLAY] --speed: expected asap, realtime or a positive multiple" << std::endl;
+                    return false;
+                }
+            } else {
+                (arg == "--from" ? out.from_ns : out.to_ns) = std::strtoull(value.c_str(), nullptr, 10);
+            }
+            continue;
+        }
+        if (!rec::list_capture_files(arg, out.files)) {
+            std::cerr << "[REPLAY] " << arg << ": no such capture file or directory" << std::endl;
+            return false;
+        }
+    }
+    if (out.files.empty()) {
+        std::cerr << "Usage: sage_replay [--speed asap|realtime|N] [--from NS] [--to NS] "
+                     "<file.cap | directory>..." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * A live CAL owns the input segments: replaying would unlink them
+ */
+static bool cal_running() noexcept {
+    ShmMpscQueue<SageMessage, 65536> probe;
+    if (!probe.attach(SHM_CAL_TO_ADE)) {
+        return false;
+    }
+#ifdef __linux__
+    const int32_t pid = probe.header().creator_pid;
+    return pid > 0 && ::kill(pid, 0) == 0;
+#else
+    return true;
+#endif
+}
+
+/**
+ * Symbol ids recorded in the file that no longer map the same way
+ */
+static size_t symbol_mismatches(const rec::CaptureFileHeader& header) noexcept {
+    size_t mismatches = 0;
+    for (uint32_t i = 0; i < header.symbol_count; ++i) {
+        const rec::CaptureSymbol& recorded = header.symbols[i];
+        const bool found = std::any_of(std::begin(SYMBOLS), std::end(SYMBOLS), [&](const SymbolMapping& s) {
+            return static_cast<uint8_t>(s.venue) == recorded.venue && s.symbol_id == recorded.symbol_id &&
+                   std::strncmp(s.name, recorded.name, sizeof(recorded.name) - 1) == 0;
+        });
+        mismatches += !found;
+    }
+    return mismatches;
+}
+
+// ============================================================================
+// Stats Thread
+// ============================================================================
+
+static void stats_thread(uint64_t tap_base) {
+    uint64_t last_pushed = 0;
+    while (!ShutdownManager::instance().is_shutdown_requested()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        const uint64_t pushed = g_pushed.load();
+        std::cout << "[REPLAY] Stats: pushed=" << pushed
+                  << " rate=" << pushed - last_pushed << "/s"
+                  << " ade=" << g_cal_tap->published() - tap_base
+                  << " queue=" << g_cal_to_ade_buffer->size_approx()
+                  << " late=" << g_late.load()
+                  << " at=" << g_position_ns.load()
+                  << std::endl;
+        last_pushed = pushed;
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    std::cout << "[REPLAY] Starting Capture Replay..." << std::endl;
+
+    ReplayOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+    std::cout << "[REPLAY] " << options.files.size() << " file(s), speed="
+              << (options.speed > 0.0 ? std::to_string(options.speed) + "x" : std::string("asap"))
+              << std::endl;
+
+    // Replay stands in for CAL: its core is free
+    if (cpu::pin_to_core(CORE_CAL) == 0) {
+        std::cout << "[REPLAY] Pinned to core " << CORE_CAL << std::endl;
+    }
+
+    ShutdownManager::instance().install_signal_handlers();
+
+    if (cal_running()) {
+        std::cerr << "[REPLAY] " << SHM_CAL_TO_ADE << " belongs to a running CAL; stop it first" << std::endl;
+        return 1;
+    }
+    if (!g_cal_to_ade_latest.create(SHM_CAL_TO_ADE_LATEST) || !g_cal_to_ade_buffer.create(SHM_CAL_TO_ADE)) {
+        std::cerr << "[REPLAY] Failed to create shared memory " << SHM_CAL_TO_ADE << std::endl;
+        return 1;
+    }
+
+    // ADE creates its tap before attaching us: once it exists, ADE is up
+    std::cout << "[REPLAY] Waiting for ADE (" << SHM_CAL_TAP << ")..." << std::endl;
+    if (!g_cal_tap.attach_blocking(SHM_CAL_TAP, [] {
+            return ShutdownManager::instance().is_shutdown_requested();
+        })) {
+        std::cerr << "[REPLAY] Failed to attach " << SHM_CAL_TAP << std::endl;
+        return 1;
+    }
+    const uint64_t tap_base = g_cal_tap->published();
+    std::thread stats(stats_thread, tap_base);
+
+    replay::ReplayPacer pacer(g_tsc_calibrator, options.speed);
+    rec::CaptureReader reader;
+    uint64_t pushed = 0;
+    uint64_t first_ns = 0;
+    uint64_t last_ns = 0;
+    bool done = false;
+    const uint64_t start_tsc = timing::rdtsc();
+
+    for (const std::string& path : options.files) {
+        if (done || ShutdownManager::instance().is_shutdown_requested()) {
+            break;
+        }
+        if (!reader.open(path)) {
+            std::cerr << "[REPLAY] " << reader.last_error() << std::endl;
+            continue;
+        }
+        if (const size_t mismatches = symbol_mismatches(reader.header()); mismatches > 0) {
+            std::cerr << "[REPLAY] " << path << ": " << mismatches
+                      << " recorded symbol(s) map differently in this build" << std::endl;
+        }
+        std::cout << "[REPLAY] " << path << ": " << reader.records() << " records" << std::endl;
+
+        uint64_t next = options.from_ns > 0 ? reader.seek(options.from_ns) : 0;
+        const SageMessage* run;
+        size_t count;
+        while (!done && (count = reader.span(next, run)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                const SageMessage& msg = run[i];
+                if (msg.timestamp_ns > options.to_ns) {
+                    done = true;
+                    break;
+                }
+                pacer.wait(msg.timestamp_ns);
+                while (!g_cal_to_ade_buffer->try_push(msg)) [[unlikely]] {
+                    if (ShutdownManager::instance().is_shutdown_requested()) {
+                        done = true;
+                        break;
+                    }
+                    cpu::pause();
+                }
+                if (done) {
+                    break;
+                }
+                first_ns = pushed == 0 ? msg.timestamp_ns : first_ns;
+                last_ns = msg.timestamp_ns;
+                ++pushed;
+            }
+            next += count;
+            g_pushed.store(pushed, std::memory_order_relaxed);
+            g_position_ns.store(last_ns, std::memory_order_relaxed);
+            g_late.store(pacer.late(), std::memory_order_relaxed);
+        }
+    }
+    reader.close();
+
+    // Wait for ADE to consume everything before timing the run
+    while (g_cal_tap->published() - tap_base < pushed &&
+           !ShutdownManager::instance().is_shutdown_requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const uint64_t wall_ns = g_tsc_calibrator.tsc_to_ns(timing::rdtsc() - start_tsc);
+    const uint64_t span_ns = last_ns - first_ns;
+
+    ShutdownManager::instance().signal_shutdown();
+    stats.join();
+
+    std::cout << "[REPLAY] Final: records=" << pushed
+              << " ade=" << g_cal_tap->published() - tap_base
+              << " wall=" << wall_ns / NANOS_PER_MS << "ms"
+              << " recorded=" << span_ns / NANOS_PER_MS << "ms"
+              << " speedup=" << (wall_ns > 0 ? static_cast<double>(span_ns) / static_cast<double>(wall_ns) : 0.0) << "x"
+              << " rate=" << (wall_ns > 0 ? pushed * NANOS_PER_SEC / wall_ns : 0) << "/s"
+              << " late=" << pacer.late()
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * SAGE Replay Pacer
+ * Releases recorded messages on the TSC at their recorded spacing
+ *
+ * Modes:
+ * - ASAP:      no waiting; the consumer's back-pressure sets the pace
+ * - SCALED:    recorded inter-arrival times divided by speed (1.0 = real
+ *              time, 10.0 = ten times faster, 0.5 = half speed)
+ *
+ * The first message anchors recorded time to a TSC reading; each later
+ * one is due at anchor_tsc + (timestamp - anchor_ns) / speed in TSC
+ * ticks. Due times are absolute, so waiting never accumulates drift, and
+ * a message that is already late (the consumer pushed back, or the
+ * capture went backwards across venues) is released at once and counted.
+ *
+ * Waits spin on rdtsc() with PAUSE; gaps longer than a couple of
+ * milliseconds (quiet markets, overnight) sleep most of the way first.
+ */
+
+#include <cstdint>
+#include <thread>
+#include <chrono>
+
+#include "../core/compiler.hpp"
+#include "../core/timing.hpp"
+#include "../core/cpu_affinity.hpp"
+
+namespace sage {
+namespace replay {
+
+enum class PaceMode : uint8_t {
+    ASAP = 0,
+    SCALED = 1
+};
+
+class ReplayPacer {
+public:
+    /**
+     * @param speed  0 = ASAP, else the multiple of recorded speed
+     */
+    ReplayPacer(const timing::TSCCalibrator& tsc, double speed) noexcept
+        : mode_(speed > 0.0 ? PaceMode::SCALED : PaceMode::ASAP),
+          ticks_per_recorded_ns_(speed > 0.0 ? tsc.get_ticks_per_ns() / speed : 0.0),
+          sleep_threshold_ticks_(tsc.ns_to_tsc(2 * NANOS_PER_MS)) {}
+
+    /**
+     * Wait until a message stamped recorded_ns is due
+     */
+    SAGE_HOT
+    void wait(uint64_t recorded_ns) noexcept {
+        if (mode_ == PaceMode::ASAP) {
+            return;
+        }
+        if (!started_) [[unlikely]] {
+            anchor_ns_ = recorded_ns;
+            anchor_tsc_ = timing::rdtsc();
+            started_ = true;
+            return;
+        }
+        if (recorded_ns < anchor_ns_) [[unlikely]] {
+            ++late_;
+            return;
+        }
+        const uint64_t due = anchor_tsc_ + static_cast<uint64_t>(
+            static_cast<double>(recorded_ns - anchor_ns_) * ticks_per_recorded_ns_);
+        uint64_t now = timing::rdtsc();
+        if (now >= due) {
+            late_ += (now - due > sleep_threshold_ticks_);
+            return;
+        }
+        while (due - now > sleep_threshold_ticks_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            now = timing::rdtsc();
+            if (now >= due) {
+                return;
+            }
+        }
+        while (timing::rdtsc() < due) {
+            cpu::pause();
+        }
+    }
+
+    PaceMode mode() const noexcept { return mode_; }
+
+    /**
+     * Messages released more than ~2ms behind schedule, or out of order
+     */
+    uint64_t late() const noexcept { return late_; }
+
+private:
+    PaceMode mode_;
+    double ticks_per_recorded_ns_;
+    uint64_t sleep_threshold_ticks_;
+    bool started_ = false;
+    uint64_t anchor_ns_ = 0;
+    uint64_t anchor_tsc_ = 0;
+    uint64_t late_ = 0;
+};
+
+} // namespace replay
+} // namespace sage
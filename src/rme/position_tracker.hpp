@@ -3,15 +3,16 @@
 /**
  * SAGE Position Tracker
  * Production-grade position management with pre-allocation
+ * Seqlock-published so monitoring and other stages read torn-free snapshots
  */
 
 #include <array>
-#include <atomic>
 #include <cstdint>
 #include <cmath>
 #include "../core/compiler.hpp"
 #include "../core/constants.hpp"
 #include "../types/fixed_point.hpp"
+#include "../infra/seqlock.hpp"
 
 namespace sage {
 namespace rme {
@@ -33,94 +34,133 @@ struct alignas(CACHE_LINE_SIZE) Position {
 
 static_assert(sizeof(Position) == 64, "Position must be cache-line aligned");
 
+/**
+ * Portfolio-wide risk totals (published together so readers never see
+ * exposure from one update and P&L from another)
+ */
+struct RiskTotals {
+    int64_t total_exposure;     // Sum of |quantity| across symbols
+    int64_t daily_pnl;          // Realized P&L for the day
+    uint64_t update_count;      // Position updates applied
+    uint64_t reserved;
+};
+
 /**
  * Pre-allocated position tracker
  * No dynamic allocation, O(1) lookup by symbol index
+ *
+ * Single writer (RME hot loop). Every position and the totals are
+ * SeqlockCells, so any other thread - or another process when the tracker
+ * is placed in a ShmSegment - reads consistent snapshots without locks.
  */
 class PositionTracker {
 public:
+    // Shared-memory descriptor (see ShmSegment)
+    using value_type = Position;
+    static constexpr size_t CAPACITY = MAX_SYMBOLS;
+    static constexpr uint64_t MAGIC = MAGIC_RISK_STATE;
+    
     PositionTracker() noexcept {
         reset();
     }
     
     /**
-     * Reset all positions
+     * Reset all positions (writer thread)
      */
     void reset() noexcept {
         for (auto& pos : positions_) {
-            pos = Position{};
+            pos.store(Position{});
         }
-        total_exposure_.store(0, std::memory_order_relaxed);
-        daily_pnl_.store(0, std::memory_order_relaxed);
+        totals_.store(RiskTotals{});
     }
     
     /**
-     * Update position by delta
-     * Thread-safe for single writer
+     * Update position by delta (writer thread)
      */
     SAGE_HOT
     void update_position(uint64_t symbol_id, int64_t delta) noexcept {
         size_t idx = symbol_id & (MAX_SYMBOLS - 1);
-        Position& pos = positions_[idx];
         
-        int64_t old_qty = pos.quantity;
-        int64_t new_qty = old_qty + delta;
+        int64_t exposure_change = 0;
+        positions_[idx].update([&](Position& pos) {
+            int64_t old_qty = pos.quantity;
+            int64_t new_qty = old_qty + delta;
+            
+            pos.quantity = new_qty;
+            pos.trade_count++;
+            
+            exposure_change = std::abs(new_qty) - std::abs(old_qty);
+        });
         
-        pos.quantity = new_qty;
-        pos.trade_count++;
-        
-        // Update total exposure (atomic for readers)
-        int64_t exposure_change = std::abs(new_qty) - std::abs(old_qty);
-        total_exposure_.fetch_add(exposure_change, std::memory_order_release);
+        totals_.update([exposure_change](RiskTotals& t) {
+            t.total_exposure += exposure_change;
+            t.update_count++;
+        });
     }
     
     /**
-     * Get position quantity
+     * Record realized P&L (writer thread)
+     */
+    void record_pnl(int64_t pnl) noexcept {
+        totals_.update([pnl](RiskTotals& t) {
+            t.daily_pnl += pnl;
+        });
+    }
+    
+    /**
+     * Get position quantity (writer thread: direct read)
      */
     SAGE_ALWAYS_INLINE
     int64_t get_position(uint64_t symbol_id) const noexcept {
         size_t idx = symbol_id & (MAX_SYMBOLS - 1);
-        return positions_[idx].quantity;
+        return positions_[idx].writer_view().quantity;
     }
     
     /**
-     * Get full position info
+     * Consistent copy of one position (any thread)
      */
-    const Position& get_position_info(uint64_t symbol_id) const noexcept {
+    Position get_position_info(uint64_t symbol_id) const noexcept {
         size_t idx = symbol_id & (MAX_SYMBOLS - 1);
-        return positions_[idx];
+        return positions_[idx].load();
+    }
+    
+    /**
+     * Consistent copy of exposure + P&L (any thread)
+     */
+    SAGE_ALWAYS_INLINE
+    RiskTotals totals() const noexcept {
+        return totals_.load();
     }
     
     /**
-     * Get total exposure (thread-safe read)
+     * Get total exposure (any thread)
      */
     SAGE_ALWAYS_INLINE
     int64_t get_total_exposure() const noexcept {
-        return total_exposure_.load(std::memory_order_acquire);
+        return totals_.load().total_exposure;
     }
     
     /**
-     * Get daily P&L (thread-safe read)
+     * Get daily P&L (any thread)
      */
     SAGE_ALWAYS_INLINE
     int64_t get_daily_pnl() const noexcept {
-        return daily_pnl_.load(std::memory_order_acquire);
+        return totals_.load().daily_pnl;
     }
     
     /**
-     * Record realized P&L
+     * Changes whenever any position or the totals change (cheap poll)
      */
-    void record_pnl(int64_t pnl) noexcept {
-        daily_pnl_.fetch_add(pnl, std::memory_order_release);
+    uint64_t version() const noexcept {
+        return totals_.version();
     }
 
 private:
-    // Pre-allocated position array
-    SAGE_CACHE_ALIGNED std::array<Position, MAX_SYMBOLS> positions_;
+    // Pre-allocated per-symbol cells (one writer, many readers)
+    std::array<SeqlockCell<Position>, MAX_SYMBOLS> positions_;
     
-    // Atomic counters for thread-safe reading
-    SAGE_CACHE_ALIGNED std::atomic<int64_t> total_exposure_{0};
-    SAGE_CACHE_ALIGNED std::atomic<int64_t> daily_pnl_{0};
+    // Portfolio totals (one cell: exposure and P&L move together)
+    SeqlockCell<RiskTotals> totals_;
 };
 
 } // namespace rme
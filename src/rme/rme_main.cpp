@@ -13,7 +13,8 @@
 #include "../core/timing.hpp"
 #include "../core/cpu_affinity.hpp"
 #include "../core/shutdown.hpp"
-#include "../infra/ring_buffer.hpp"
+#include "../core/memory.hpp"
+#include "../infra/shm_segment.hpp"
 #include "../types/sage_message.hpp"
 #include "position_tracker.hpp"
 #include "risk_limits.hpp"
@@ -26,6 +27,7 @@ using namespace sage;
 // ============================================================================
 
 constexpr size_t MAX_SYMBOLS = 256;
+constexpr size_t BATCH_SIZE = 16;
 
 // Risk limits (configurable at startup)
 static rme::RiskLimits g_limits{
@@ -39,12 +41,15 @@ static rme::RiskLimits g_limits{
 // Global State
 // ============================================================================
 
-// Ring buffers
-static RingBuffer<SageMessage, 65536> g_ade_to_rme_buffer;
-static RingBuffer<SageMessage, 65536> g_rme_to_poe_buffer;
+// Ring buffers (shared memory: input created by ADE, output created here)
+static ShmRingBuffer<SageMessage, 65536> g_ade_to_rme_buffer;
+static ShmRingBuffer<SageMessage, 65536> g_rme_to_poe_buffer;
 
-// Position tracker (pre-allocated)
-static rme::PositionTracker g_position_tracker;
+// Position tracker (shared memory, RME writes; monitoring / MIND read)
+static ShmSegment<rme::PositionTracker> g_position_tracker;
+
+// Startup memory provisioning (huge pages, prefault, mlock)
+static memory::MemoryProvisioner g_provisioner;
 
 // Circuit breaker
 static rme::CircuitBreaker g_circuit_breaker;
@@ -87,7 +92,7 @@ static bool check_risk_fast(uint64_t symbol_id, int64_t order_value) noexcept {
     }
     
     // Get current position
-    int64_t current_position = g_position_tracker.get_position(symbol_id);
+    int64_t current_position = g_position_tracker->get_position(symbol_id);
     int64_t new_position = current_position + order_value;
     
     // Check position limit (branchless)
@@ -96,12 +101,14 @@ static bool check_risk_fast(uint64_t symbol_id, int64_t order_value) noexcept {
     // Check order size limit
     bool size_ok = std::abs(order_value) <= g_limits.max_order_size;
     
+    // Exposure and P&L from one consistent snapshot
+    const rme::RiskTotals totals = g_position_tracker->totals();
+    
     // Check total exposure
-    int64_t total_exposure = g_position_tracker.get_total_exposure();
-    bool exposure_ok = total_exposure + std::abs(order_value) <= g_limits.max_total_exposure;
+    bool exposure_ok = totals.total_exposure + std::abs(order_value) <= g_limits.max_total_exposure;
     
     // Check daily PnL
-    bool pnl_ok = g_position_tracker.get_daily_pnl() > -g_limits.max_daily_loss;
+    bool pnl_ok = totals.daily_pnl > -g_limits.max_daily_loss;
     
     return position_ok && size_ok && exposure_ok && pnl_ok;
 }
@@ -145,16 +152,16 @@ static void process_signal(const SageMessage& msg) noexcept {
     order.time_in_force = 1;  // IOC
     
     SageMessage out_msg;
-    out_msg.timestamp_ns = timing::get_monotonic_ns();
+    out_msg.timestamp_ns = timing::get_realtime_ns();
     out_msg.sequence_id = g_sequence;
     out_msg.msg_type = MessageType::ORDER_REQUEST;
     out_msg.payload.order = order;
     
     // Update position (before sending)
-    g_position_tracker.update_position(signal.symbol_id, order_value);
+    g_position_tracker->update_position(signal.symbol_id, order_value);
     
     // Push to POE
-    if (g_rme_to_poe_buffer.try_push(out_msg)) {
+    if (g_rme_to_poe_buffer->try_push(out_msg)) {
         g_orders_approved.fetch_add(1, std::memory_order_relaxed);
     }
     
@@ -180,6 +187,7 @@ static void heartbeat_thread() {
         uint64_t approved = g_orders_approved.load();
         uint64_t rejected = g_orders_rejected.load();
         uint64_t total_latency = g_total_latency_ns.load();
+        const rme::RiskTotals totals = g_position_tracker->totals();
         
         double avg_latency_ns = (received > 0) ? 
             static_cast<double>(total_latency) / received : 0.0;
@@ -188,12 +196,13 @@ static void heartbeat_thread() {
                   << " approved=" << approved
                   << " rejected=" << rejected
                   << " avg_latency=" << avg_latency_ns << "ns"
-                  << " exposure=" << g_position_tracker.get_total_exposure()
-                  << " pnl=" << g_position_tracker.get_daily_pnl()
+                  << " exposure=" << totals.total_exposure
+                  << " pnl=" << totals.daily_pnl
+                  << " faults=" << g_provisioner.faults_since_warmup()
                   << std::endl;
         
         // Check for circuit breaker conditions
-        if (g_position_tracker.get_daily_pnl() < -g_limits.max_daily_loss) {
+        if (totals.daily_pnl < -g_limits.max_daily_loss) {
             std::cout << "[RME] CIRCUIT BREAKER: Daily loss limit exceeded!" << std::endl;
             g_circuit_breaker.trip("Daily loss limit");
         }
@@ -223,6 +232,40 @@ int main() {
     
     ShutdownManager::instance().install_signal_handlers();
     
+    // Fed by sage_replay: run on the capture's clock, not the wall clock
+    if (timing::replay_requested()) {
+        timing::enable_virtual_time();
+        std::cout << "[RME] Replay: virtual time from message timestamps" << std::endl;
+    }
+    
+    if (!g_position_tracker.create(SHM_RISK_STATE)) {
+        std::cerr << "[RME] Failed to create shared memory " << SHM_RISK_STATE << std::endl;
+        return 1;
+    }
+    
+    if (!g_rme_to_poe_buffer.create(SHM_RME_TO_POE)) {
+        std::cerr << "[RME] Failed to create shared memory " << SHM_RME_TO_POE << std::endl;
+        return 1;
+    }
+    
+    std::cout << "[RME] Waiting for " << SHM_ADE_TO_RME << "..." << std::endl;
+    if (!g_ade_to_rme_buffer.attach_blocking(SHM_ADE_TO_RME, [] {
+            return ShutdownManager::instance().is_shutdown_requested();
+        })) {
+        std::cerr << "[RME] Failed to attach " << SHM_ADE_TO_RME << std::endl;
+        return 1;
+    }
+    
+    // Fault in and lock everything the hot loop touches
+    g_provisioner.add("ade_to_rme", g_ade_to_rme_buffer.base(), g_ade_to_rme_buffer.mapped_size());
+    g_provisioner.add("rme_to_poe", g_rme_to_poe_buffer.base(), g_rme_to_poe_buffer.mapped_size());
+    g_provisioner.add("positions", g_position_tracker.base(), g_position_tracker.mapped_size());
+    const memory::ProvisionReport mem = g_provisioner.provision();
+    std::cout << "[RME] Memory: " << mem.bytes / 1024 << "KB in " << mem.regions
+              << " regions, huge=" << mem.huge_regions
+              << " locked=" << mem.locked_regions << (mem.all_locked ? " +mlockall" : "")
+              << " warmup_faults=" << mem.after.minor - mem.before.minor << std::endl;
+    
     // Start heartbeat
     std::thread hb_thread(heartbeat_thread);
     
@@ -230,16 +273,26 @@ int main() {
     
     // Main processing loop (tight spin)
     while (!ShutdownManager::instance().is_shutdown_requested()) {
-        SageMessage msg;
-        if (g_ade_to_rme_buffer.try_pop(msg)) {
+        // Read in place; ADE can't reuse the slots until release()
+        const SageMessage* msgs;
+        const size_t count = g_ade_to_rme_buffer->peek_span(msgs, BATCH_SIZE);
+        if (count == 0) {
+            cpu::pause();
+            continue;
+        }
+        
+        for (size_t i = 0; i < count; ++i) {
+            const SageMessage& msg = msgs[i];
+            if (timing::virtual_time()) [[unlikely]] {
+                timing::advance_virtual_time(msg.timestamp_ns);
+            }
             if (msg.msg_type == MessageType::SIGNAL) {
                 process_signal(msg);
             } else if (msg.msg_type == MessageType::HEARTBEAT) {
-                g_rme_to_poe_buffer.try_push(msg);
+                g_rme_to_poe_buffer->try_push(msg);
             }
-        } else {
-            cpu::pause();
         }
+        g_ade_to_rme_buffer->release(count);
     }
     
     std::cout << "[RME] Shutting down..." << std::endl;
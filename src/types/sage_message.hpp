@@ -10,6 +10,7 @@
 #include "fixed_point.hpp"
 #include "../core/constants.hpp"
 #include "../core/compiler.hpp"
+#include "../core/timing.hpp"
 
 namespace sage {
 
@@ -27,26 +28,70 @@ enum class MessageType : uint8_t {
     ORDER_CANCEL = 6,
     RISK_ALERT = 7,
     HEARTBEAT = 8,
-    SHUTDOWN = 9
+    SHUTDOWN = 9,
+    CONSOLIDATED_QUOTE = 10
 };
 
+/**
+ * Venue identifiers (MarketData::exchange_id)
+ */
+enum class ExchangeId : uint8_t {
+    UNKNOWN = 0,
+    BINANCE = 1,
+    COINBASE = 2
+};
+
+// MarketData::flags
+constexpr uint16_t MD_FLAG_BID = 0x01;
+constexpr uint16_t MD_FLAG_ASK = 0x02;
+constexpr uint16_t MD_FLAG_TRADE = 0x04;
+constexpr uint16_t MD_FLAG_OUTLIER = 0x08;   // Outside CAL's price band (see PriceBandValidator)
+constexpr uint16_t MD_FLAG_STALE = 0x10;     // Venue sequence gap before this tick was not recovered
+constexpr uint16_t MD_FLAG_RESYNCED = 0x20;  // Delivered late by gap recovery (see FeedRecovery)
+constexpr uint16_t MD_FLAG_DEPTH = 0x40;     // Order book level: quantity is the level's new size
+constexpr uint16_t MD_FLAG_BOOK_RESET = 0x80; // First level of a book snapshot: drop the old book
+
 // ============================================================================
 // Message Payloads
 // ============================================================================
 
 /**
  * Market data tick (trade or quote)
- * 32 bytes
+ * 40 bytes (fills the SageMessage payload)
+ *
+ * exchange_ts_ns is the venue's own event time (CLOCK_REALTIME by the
+ * venue's clock, at the venue's resolution); against SageMessage's receive
+ * time it gives exchange -> CAL latency (see cal/feed_latency.hpp).
  */
 struct MarketData {
-    FixedPoint price;      // 8 bytes
-    FixedPoint quantity;   // 8 bytes
-    uint64_t symbol_id;    // 8 bytes
-    uint32_t flags;        // 4 bytes (bid=0x01, ask=0x02, trade=0x04)
-    uint8_t exchange_id;   // 1 byte
-    uint8_t reserved[3];   // 3 bytes padding
+    FixedPoint price;        // 8 bytes
+    FixedPoint quantity;     // 8 bytes
+    uint32_t symbol_id;      // 4 bytes (dense id, see cal::MAX_VALID_SYMBOL_ID)
+    uint16_t flags;          // 2 bytes (MD_FLAG_*)
+    uint8_t exchange_id;     // 1 byte
+    uint8_t reserved;        // 1 byte padding
+    uint64_t venue_seq;      // 8 bytes (venue trade id; 0 = none)
+    uint64_t exchange_ts_ns; // 8 bytes (venue event time; 0 = none)
 };
-static_assert(sizeof(MarketData) == 32, "MarketData must be 32 bytes");
+static_assert(sizeof(MarketData) == 40, "MarketData must be 40 bytes");
+
+/**
+ * Conflation lane of a tick: (symbol, venue, trade/bid/ask)
+ *
+ * Venues share symbol ids, and a bid must never overwrite the ask, so
+ * only a newer tick of the same kind from the same venue supersedes one.
+ * @return SHM_CONFLATION_KEYS if the tick cannot be conflated
+ */
+constexpr size_t conflation_key(const MarketData& md) noexcept {
+    if (md.symbol_id >= SHM_CONFLATION_SYMBOLS || md.exchange_id >= MAX_EXCHANGES) {
+        return SHM_CONFLATION_KEYS;
+    }
+    const size_t side = (md.flags & MD_FLAG_TRADE) ? 0
+                      : (md.flags & MD_FLAG_BID) ? 1
+                      : (md.flags & MD_FLAG_ASK) ? 2 : 3;
+    return (static_cast<size_t>(md.symbol_id) * MAX_EXCHANGES + md.exchange_id) *
+           SHM_CONFLATION_SIDES + side;
+}
 
 /**
  * Trading signal from MIND
@@ -77,6 +122,28 @@ struct OrderRequest {
 };
 static_assert(sizeof(OrderRequest) == 40, "OrderRequest must be 40 bytes");
 
+/**
+ * Cross-venue best bid/offer from ADE (see ade/consolidated_bbo.hpp)
+ * 40 bytes
+ *
+ * Sizes are summed over every venue quoting the best price; *_venue is
+ * the lowest exchange_id among them, *_venues all of them (bit per
+ * exchange_id). A side no venue quotes has price and size 0.
+ */
+struct ConsolidatedQuote {
+    FixedPoint bid_price;    // 8 bytes
+    FixedPoint bid_quantity; // 8 bytes
+    FixedPoint ask_price;    // 8 bytes
+    FixedPoint ask_quantity; // 8 bytes
+    uint32_t symbol_id;      // 4 bytes
+    uint8_t bid_venue;       // 1 byte (ExchangeId)
+    uint8_t ask_venue;       // 1 byte (ExchangeId)
+    uint8_t bid_venues;      // 1 byte (bit per ExchangeId)
+    uint8_t ask_venues;      // 1 byte (bit per ExchangeId)
+};
+static_assert(sizeof(ConsolidatedQuote) == 40, "ConsolidatedQuote must be 40 bytes");
+static_assert(MAX_EXCHANGES <= 8, "ConsolidatedQuote venue masks are 8 bits");
+
 /**
  * Risk alert from RME
  * 40 bytes
@@ -113,24 +180,39 @@ static_assert(sizeof(Heartbeat) == 16, "Heartbeat must be 16 bytes");
  *   [0-7]   timestamp_ns     (8 bytes)
  *   [8-15]  sequence_id      (8 bytes)
  *   [16]    msg_type         (1 byte)
- *   [17-23] reserved         (7 bytes)
+ *   [17]    rx_clock         (1 byte)
+ *   [18-19] parse_ns         (2 bytes)
+ *   [20-23] rx_delta_ns      (4 bytes)
  *   [24-63] payload          (40 bytes)
+ *
+ * CAL stage timing (market data; zero elsewhere):
+ *   kernel/NIC receive = timestamp_ns - rx_delta_ns   (if rx_clock != NONE)
+ *   CAL callback       = timestamp_ns
+ *   parsed             = timestamp_ns + parse_ns
+ * Both deltas saturate (rx_delta_ns at ~4.3s, parse_ns at ~65us).
  */
 struct SAGE_CACHE_ALIGNED SageMessage {
     // Header (24 bytes)
-    uint64_t timestamp_ns;   // 8 bytes - Local receipt time
+    uint64_t timestamp_ns;   // 8 bytes - Local receipt time (CLOCK_REALTIME)
     uint64_t sequence_id;    // 8 bytes - Monotonic sequence
     MessageType msg_type;    // 1 byte
-    uint8_t reserved[7];     // 7 bytes padding
+    timing::RxClock rx_clock;// 1 byte - Source of the receive timestamp
+    uint16_t parse_ns;       // 2 bytes - CAL parse time
+    uint32_t rx_delta_ns;    // 4 bytes - Receive timestamp -> CAL callback
     
     // Payload (40 bytes)
-    union {
+    union Payload {
         MarketData market_data;
         Signal signal;
         OrderRequest order;
+        ConsolidatedQuote quote;
         RiskAlert risk_alert;
         Heartbeat heartbeat;
         uint8_t raw[40];
+
+        // Members with default initializers delete the implicit ctor;
+        // zero the bytes so `SageMessage msg;` and message arrays compile
+        constexpr Payload() noexcept : raw{} {}
     } payload;
     
     // ========================================================================
@@ -163,6 +245,19 @@ struct SAGE_CACHE_ALIGNED SageMessage {
         return msg;
     }
     
+    static SageMessage create_consolidated_quote(
+        uint64_t timestamp,
+        uint64_t seq,
+        const ConsolidatedQuote& quote
+    ) noexcept {
+        SageMessage msg{};
+        msg.timestamp_ns = timestamp;
+        msg.sequence_id = seq;
+        msg.msg_type = MessageType::CONSOLIDATED_QUOTE;
+        msg.payload.quote = quote;
+        return msg;
+    }
+    
     static SageMessage create_heartbeat(
         uint64_t timestamp,
         uint64_t seq,
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * SAGE Symbol Map
+ * Venue symbol names -> symbol_id, one id per instrument across venues
+ *
+ * symbol_id is the dense id every component indexes by (MarketData,
+ * Signal, positions). CAL registers these names with its parsers; the
+ * recorder writes the table into each capture file so a capture stays
+ * readable after the table changes.
+ */
+
+#include <cstdint>
+
+#include "sage_message.hpp"
+
+namespace sage {
+
+struct SymbolMapping {
+    ExchangeId venue;
+    const char* name;
+    uint32_t symbol_id;   // Dense, < cal::MAX_VALID_SYMBOL_ID
+};
+
+inline constexpr SymbolMapping SYMBOLS[] = {
+    {ExchangeId::BINANCE, "BTCUSDT", 1}, {ExchangeId::COINBASE, "BTC-USD", 1},
+    {ExchangeId::BINANCE, "ETHUSDT", 2}, {ExchangeId::COINBASE, "ETH-USD", 2},
+    {ExchangeId::BINANCE, "SOLUSDT", 3}, {ExchangeId::COINBASE, "SOL-USD", 3},
+};
+
+} // namespace sage
@@ -0,0 +1,222 @@
+/**
+ * SAGE Tick Archive Benchmark
+ * Compression and decode throughput of the columnar tick archive over a
+ * synthetic multi-symbol tick stream
+ *
+ * Usage: benchmark_archive [ticks] [passes]
+ *   defaults: 4,000,000 ticks over 8 symbols, 10 decode passes
+ *
+ * The stream imitates a busy crypto session: ticks arrive every ~2us
+ * (exponential gaps) spread over 8 symbols on two venues, each symbol's
+ * price takes a random walk of a few ticks, sizes are random lots, venue
+ * event time trails receive time by ~200us of jittered latency, and venue
+ * trade ids advance by 1-3. The archive is written to the temp directory,
+ * then read back through ArchiveReader (page cache warm).
+ *
+ * "decode" unpacks every column of every block into an ArchiveBlock, the
+ * way a backtest reads it; GB/s counts the ticks as 64-byte SageMessages
+ * (what the same data costs as a capture). "scalar" is the fallback
+ * kernel, for the gain of the AVX2 path. "decode + messages" also
+ * rebuilds each SageMessage. Budget: >= 4 GB/s decode (a month of one
+ * busy venue, ~10^10 ticks, in under three minutes per core).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include <memory>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/timing.hpp"
+#include "../src/types/sage_message.hpp"
+#include "../src/rec/archive_writer.hpp"
+#include "../src/rec/archive_reader.hpp"
+
+using namespace sage;
+
+namespace {
+
+constexpr double BUDGET_GBPS = 4.0;
+constexpr uint32_t SYMBOLS = 8;
+constexpr int64_t TICK = PRICE_SCALE / 100;      // 0.01
+constexpr int64_t LOT = PRICE_SCALE / 1000;      // 0.001
+
+std::vector<SageMessage> make_stream(size_t count) {
+    std::mt19937_64 rng(42);
+    std::exponential_distribution<double> gap(1.0 / 2000.0);   // ns, mean 2us
+    std::uniform_int_distribution<uint32_t> symbol(0, SYMBOLS - 1);
+    std::uniform_int_distribution<int> step(-2, 2);
+    std::uniform_int_distribution<int64_t> lots(1, 500);
+    std::uniform_int_distribution<uint64_t> latency(180000, 230000);
+    std::uniform_int_distribution<uint64_t> trade_ids(1, 3);
+    std::uniform_int_distribution<int> kind(0, 2);
+    std::uniform_int_distribution<uint32_t> parse(100, 400);
+    std::uniform_int_distribution<uint32_t> rx_delta(1000, 20000);
+
+    int64_t mid[SYMBOLS];
+    uint64_t venue_seq[SYMBOLS];
+    for (uint32_t s = 0; s < SYMBOLS; ++s) {
+        mid[s] = (1000 + 5000 * static_cast<int64_t>(s)) * 100;
+        venue_seq[s] = 3'000'000'000ULL + s * 1'000'000ULL;
+    }
+
+    std::vector<SageMessage> stream;
+    stream.reserve(count);
+    uint64_t ts = 1'700'000'000ULL * NANOS_PER_SEC;
+    for (size_t i = 0; i < count; ++i) {
+        ts += static_cast<uint64_t>(gap(rng));
+        const uint32_t s = symbol(rng);
+        mid[s] += step(rng);
+        venue_seq[s] += trade_ids(rng);
+        static constexpr uint16_t FLAGS[] = {MD_FLAG_TRADE, MD_FLAG_BID, MD_FLAG_ASK};
+
+        MarketData data{};
+        data.price = FixedPoint(mid[s] * TICK);
+        data.quantity = FixedPoint(lots(rng) * LOT);
+        data.symbol_id = s + 1;
+        data.flags = FLAGS[kind(rng)];
+        data.exchange_id = static_cast<uint8_t>(s < SYMBOLS / 2 ? ExchangeId::BINANCE : ExchangeId::COINBASE);
+        data.venue_seq = venue_seq[s];
+        data.exchange_ts_ns = ts - latency(rng);
+        SageMessage msg = SageMessage::create_market_data(ts, i, data);
+        msg.rx_clock = timing::RxClock::SOFTWARE;
+        msg.parse_ns = static_cast<uint16_t>(parse(rng));
+        msg.rx_delta_ns = rx_delta(rng);
+        stream.push_back(msg);
+    }
+    return stream;
+}
+
+void print_rate(const char* label, uint64_t ticks, uint64_t elapsed_ns, bool budget) {
+    const double seconds = static_cast<double>(std::max<uint64_t>(elapsed_ns, 1)) / 1e9;
+    const double gbps = static_cast<double>(ticks * sizeof(SageMessage)) / seconds / 1e9;
+    std::cout << "  " << std::left << std::setw(18) << label << std::right
+              << std::fixed << std::setprecision(2)
+              << " " << std::setw(7) << gbps << " GB/s"
+              << " " << std::setw(7) << static_cast<double>(ticks) / seconds / 1e6 << "M ticks/s";
+    if (budget) {
+        std::cout << " " << (gbps >= BUDGET_GBPS ? "PASS" : "FAIL");
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const size_t passes = std::max<size_t>((argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10, 1);
+
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE Tick Archive Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+#if defined(__AVX2__)
+    std::cout << "  Native kernels: AVX2" << std::endl;
+#else
+    std::cout << "  Native kernels: scalar (build without AVX2)" << std::endl;
+#endif
+
+    const std::vector<SageMessage> stream = make_stream(count);
+    const std::string path = (std::filesystem::temp_directory_path() / "sage_benchmark_archive.sarc").string();
+    timing::TSCCalibrator tsc;
+
+    // Encode
+    rec::ArchiveWriter writer;
+    uint64_t start = timing::rdtsc();
+    if (!writer.open(path, nullptr, 0)) {
+        std::cerr << "  " << writer.last_error() << std::endl;
+        return 1;
+    }
+    for (const SageMessage& msg : stream) {
+        writer.append(msg);
+    }
+    if (!writer.close()) {
+        std::cerr << "  " << writer.last_error() << std::endl;
+        return 1;
+    }
+    const uint64_t encode_ns = tsc.tsc_to_ns(timing::rdtsc() - start);
+    std::cout << "  Stream: " << count << " ticks, " << SYMBOLS << " symbols, "
+              << count * sizeof(SageMessage) / (1024 * 1024) << "MB as records" << std::endl;
+    std::cout << "  Archive: " << writer.bytes() / 1024 << "KB in " << writer.blocks() << " blocks, "
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(count * sizeof(SageMessage)) / static_cast<double>(writer.bytes())
+              << "x, " << static_cast<double>(writer.bytes() * 8) / static_cast<double>(count)
+              << " bits/tick" << std::defaultfloat << std::endl;
+
+    rec::ArchiveReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "  " << reader.last_error() << std::endl;
+        return 1;
+    }
+    auto block = std::make_unique<rec::ArchiveBlock>();
+
+    // Bits per tick by column (first block of each symbol)
+    std::cout << "  Widths (bits):";
+    static constexpr const char* COLUMN_NAMES[rec::ARCHIVE_COLUMNS] = {
+        "ts", "seq", "price", "qty", "exch_ts", "venue_seq", "attr", "parse", "rx"};
+    const auto& first = *reinterpret_cast<const rec::ArchiveBlockHeader*>(
+        reinterpret_cast<const uint8_t*>(&reader.header()) + reader.entry(0).offset);
+    for (size_t c = 0; c < rec::ARCHIVE_COLUMNS; ++c) {
+        std::cout << " " << COLUMN_NAMES[c] << "=" << static_cast<int>(first.width[c]);
+    }
+    std::cout << std::endl;
+
+    // Decode: every block, every column
+    int64_t checksum = 0;
+    uint64_t decode_ns[2] = {};
+    const rec::UnpackPath paths[2] = {rec::UnpackPath::NATIVE, rec::UnpackPath::SCALAR};
+    for (size_t p = 0; p < 2; ++p) {
+        start = timing::rdtsc();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (size_t i = 0; i < reader.blocks(); ++i) {
+                reader.decode(i, *block, paths[p]);
+                checksum += block->column(rec::ArchiveColumn::PRICE)[block->count - 1];
+            }
+        }
+        decode_ns[p] = tsc.tsc_to_ns(timing::rdtscp() - start);
+    }
+
+    // Decode and rebuild every SageMessage
+    start = timing::rdtsc();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < reader.blocks(); ++i) {
+            reader.decode(i, *block);
+            for (size_t t = 0; t < block->count; ++t) {
+                const SageMessage msg = block->message(t);
+                checksum += static_cast<int64_t>(msg.timestamp_ns);
+            }
+        }
+    }
+    const uint64_t messages_ns = tsc.tsc_to_ns(timing::rdtscp() - start);
+
+    // Seek: symbol + time through the index
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    constexpr size_t SEEKS = 100000;
+    start = timing::rdtsc();
+    for (size_t i = 0; i < SEEKS; ++i) {
+        const SageMessage& target = stream[pick(rng)];
+        checksum += static_cast<int64_t>(reader.find(target.payload.market_data.symbol_id, target.timestamp_ns));
+    }
+    const uint64_t seek_ns = tsc.tsc_to_ns(timing::rdtscp() - start);
+
+    const uint64_t decoded = static_cast<uint64_t>(count) * passes;
+    print_rate("encode", count, encode_ns, false);
+    print_rate("decode", decoded, decode_ns[0], true);
+    print_rate("decode (scalar)", decoded, decode_ns[1], false);
+    print_rate("decode + messages", decoded, messages_ns, false);
+    std::cout << "  Seek: " << seek_ns / SEEKS << "ns per find() over "
+              << reader.blocks() << " index entries" << std::endl;
+    std::cout << "  (checksum " << checksum << ")" << std::endl;
+
+    reader.close();
+    std::filesystem::remove(path);
+    return 0;
+}
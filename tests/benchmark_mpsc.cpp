@@ -0,0 +1,130 @@
+/**
+ * SAGE MPSC Queue Benchmark
+ * Throughput of MpscQueue<SageMessage> with 2/4/8 producers into one consumer
+ *
+ * Models several exchange connectors feeding a single ADE instance.
+ * Producers and the consumer are pinned to distinct cores when available.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/cpu_affinity.hpp"
+#include "../src/types/sage_message.hpp"
+#include "../src/infra/mpsc_queue.hpp"
+
+using namespace sage;
+
+namespace {
+
+constexpr size_t QUEUE_SIZE = 65536;
+constexpr uint64_t MESSAGES_PER_RUN = 8000000;
+constexpr size_t BATCH_SIZE = 64;
+
+using Queue = MpscQueue<SageMessage, QUEUE_SIZE>;
+
+struct RunResult {
+    double msgs_per_sec;
+    double ns_per_msg;
+    uint64_t full_retries;
+};
+
+RunResult run(Queue& queue, unsigned producers) {
+    const unsigned cores = std::thread::hardware_concurrency();
+    const uint64_t per_producer = MESSAGES_PER_RUN / producers;
+    const uint64_t total = per_producer * producers;
+
+    std::atomic<bool> go{false};
+    std::atomic<uint64_t> full_retries{0};
+
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            if (cores > producers) {
+                cpu::pin_to_core(static_cast<int>(p + 1));
+            }
+            SageMessage msg = SageMessage::create_heartbeat(0, 0, p);
+            uint64_t retries = 0;
+
+            while (!go.load(std::memory_order_acquire)) {
+                cpu::pause();
+            }
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                msg.sequence_id = i;
+                while (!queue.try_push(msg)) {
+                    ++retries;
+                    cpu::pause();
+                }
+            }
+            full_retries.fetch_add(retries, std::memory_order_relaxed);
+        });
+    }
+
+    if (cores > producers) {
+        cpu::pin_to_core(0);
+    }
+
+    SageMessage batch[BATCH_SIZE]{};
+    uint64_t received = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    while (received < total) {
+        const size_t n = queue.try_pop_batch(batch, BATCH_SIZE);
+        if (n == 0) {
+            cpu::pause();
+        }
+        received += n;
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    return {
+        static_cast<double>(total) * 1e9 / ns,
+        ns / static_cast<double>(total),
+        full_retries.load(std::memory_order_relaxed)
+    };
+}
+
+} // namespace
+
+int main() {
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE MPSC Queue Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+    std::cout << "  Messages per run: " << MESSAGES_PER_RUN
+              << " (" << sizeof(SageMessage) << "B each)" << std::endl;
+    std::cout << "  Hardware threads: " << std::thread::hardware_concurrency()
+              << std::endl << std::endl;
+
+    // ~8MB of slots: keep it off the stack
+    auto queue = std::make_unique<Queue>();
+
+    std::cout << std::left << std::setw(12) << "  Producers"
+              << std::setw(16) << "Msgs/sec"
+              << std::setw(12) << "ns/msg"
+              << "Full retries" << std::endl;
+
+    for (unsigned producers : {2u, 4u, 8u}) {
+        const RunResult r = run(*queue, producers);
+        std::cout << "  " << std::left << std::setw(10) << producers
+                  << std::setw(16) << std::fixed << std::setprecision(0) << r.msgs_per_sec
+                  << std::setw(12) << std::setprecision(1) << r.ns_per_msg
+                  << r.full_retries << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * SAGE CAL Network Benchmark
+ * epoll vs io_uring receive path over a local feed generator
+ *
+ * Usage: benchmark_network [connections] [messages] [batch] [gap_us] [backend] [wait]
+ *   defaults: 12 connections, 100000 messages each, 16 frames per write,
+ *   no gap between writes (flat out), every backend ("epoll", "io_uring",
+ *   "io_uring_sqpoll" or "all"), wait "block" ("busy" to spin)
+ *
+ * The feed generator runs one local WebSocket server per connection and
+ * writes Binance-format trades, `batch` frames per send(), sleeping gap_us
+ * between writes. Each trade carries its send TSC in "E". The CAL side is
+ * one NetworkThread on the calling thread, feeding the same parse ->
+ * validate -> try_push path as cal_main, so the numbers include the whole
+ * hot path.
+ *
+ * Reported per backend: throughput, CPU time of the network thread per
+ * message (user / system, from RUSAGE_THREAD), messages per wakeup (epoll
+ * event or recv CQE) and generator-to-handler latency.
+ * - "block" waits up to 1ms in the kernel when idle, so CPU per message
+ *   is the cost of receiving, not of spinning; use it for the syscall /
+ *   CPU comparison
+ * - "busy" spins like production CAL; use it with a gap_us for latency
+ *   (flat out, latency is mostly queueing in the socket buffers)
+ * Pin generator and receiver apart (taskset) for meaningful numbers.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/timing.hpp"
+#include "../src/types/sage_message.hpp"
+#include "../src/infra/ring_buffer.hpp"
+#include "../src/cal/json_parser.hpp"
+#include "../src/cal/validator.hpp"
+#include "../src/cal/network_thread.hpp"
+#include "ws_test_server.hpp"
+
+using namespace sage;
+
+namespace {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct Config {
+    size_t connections = 12;
+    uint64_t messages = 100000;      // Per connection
+    size_t batch = 16;               // Frames per generator write
+    uint64_t gap_us = 0;             // Pause between generator writes
+    bool busy = false;               // Spin instead of blocking when idle
+};
+
+Config g_config;
+timing::TSCCalibrator g_tsc;
+
+// "{"e":"trade","E":" -- the send TSC follows
+constexpr size_t TSC_OFFSET = 17;
+
+// ============================================================================
+// Receive Side (same hot path as cal_main's process_message)
+// ============================================================================
+
+struct Sink {
+    cal::JsonParser parser;
+    RingBuffer<SageMessage, 65536> queue;
+    std::vector<uint64_t> latency_ns;
+    uint64_t received{0};
+    uint64_t published{0};
+    uint64_t sequence{0};
+};
+
+struct BenchHandler {
+    Sink* sink;
+
+    SAGE_HOT void operator()(const char* data, size_t len) const noexcept {
+        const uint64_t now = timing::rdtscp();
+
+        cal::ParsedMessage parsed;
+        const cal::ParseStatus status = sink->parser.parse(data, len, parsed);
+        for (uint32_t i = 0; i < parsed.count && status == cal::ParseStatus::TRADE; ++i) {
+            if (cal::Validator::validate_market_data(parsed.records[i]).status !=
+                cal::ValidationStatus::ACCEPT) {
+                continue;
+            }
+            SageMessage msg{};
+            msg.timestamp_ns = g_tsc.tsc_to_ns(now);
+            msg.sequence_id = ++sink->sequence;
+            msg.msg_type = MessageType::MARKET_DATA;
+            msg.payload.market_data = parsed.records[i];
+            if (sink->queue.try_push(msg)) {
+                ++sink->published;
+            }
+            sink->queue.try_pop(msg);   // Stand-in consumer
+        }
+
+        uint64_t sent = 0;
+        for (size_t i = TSC_OFFSET; i < len && data[i] >= '0' && data[i] <= '9'; ++i) {
+            sent = sent * 10 + static_cast<uint64_t>(data[i] - '0');
+        }
+        if (sink->latency_ns.size() < sink->latency_ns.capacity()) {
+            sink->latency_ns.push_back(g_tsc.tsc_to_ns(now - std::min(sent, now)));
+        }
+        ++sink->received;
+    }
+};
+
+using Client = cal::WebSocketClient<BenchHandler>;
+
+// ============================================================================
+// Feed Generator
+// ============================================================================
+
+void generate(test::WsTestServer& server, size_t connection) {
+    const std::string symbol = (connection % 3 == 0) ? "BTCUSDT"
+                             : (connection % 3 == 1) ? "ETHUSDT" : "SOLUSDT";
+    uint8_t header[cal::ws::MAX_FRAME_HEADER];
+    std::string bytes;
+    for (uint64_t i = 0; i < g_config.messages;) {
+        bytes.clear();
+        const uint64_t tsc = timing::rdtsc();
+        for (size_t b = 0; b < g_config.batch && i < g_config.messages; ++b, ++i) {
+            const std::string text = "{\"e\":\"trade\",\"E\":" + std::to_string(tsc) +
+                ",\"s\":\"" + symbol + "\",\"t\":" + std::to_string(i) +
+                ",\"p\":\"43250." + std::to_string(10 + i % 90) + "000000\""
+                ",\"q\":\"0.01500000\",\"T\":" + std::to_string(tsc) + ",\"m\":true}";
+            const size_t n = cal::ws::encode_frame_header(header, cal::ws::Opcode::TEXT, true,
+                                                          text.size(), false, 0);
+            bytes.append(reinterpret_cast<const char*>(header), n).append(text);
+        }
+        server.send_raw(bytes);
+        if (g_config.gap_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(g_config.gap_us));
+        }
+    }
+
+    // Hold the connection until the receiver closes it
+    cal::ws::Opcode opcode;
+    std::string payload;
+    server.read_frame(opcode, payload);
+}
+
+// ============================================================================
+// Run
+// ============================================================================
+
+uint64_t thread_cpu_us(bool system) {
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+    const timeval& tv = system ? usage.ru_stime : usage.ru_utime;
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000 + static_cast<uint64_t>(tv.tv_usec);
+}
+
+uint64_t percentile(std::vector<uint64_t>& samples, double pct) {
+    if (samples.empty()) return 0;
+    const size_t index = std::min(samples.size() - 1,
+        static_cast<size_t>(static_cast<double>(samples.size()) * pct / 100.0));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<long>(index), samples.end());
+    return samples[index];
+}
+
+void run(const char* label, cal::IoBackend backend, bool sqpoll) {
+    const uint64_t expected = g_config.connections * g_config.messages;
+
+    auto sink = std::make_unique<Sink>();   // 4MB queue: keep it off the stack
+    sink->parser.add_symbol("BTCUSDT", 1);
+    sink->parser.add_symbol("ETHUSDT", 2);
+    sink->parser.add_symbol("SOLUSDT", 3);
+    sink->latency_ns.reserve(expected);
+
+    std::vector<std::unique_ptr<test::WsTestServer>> servers;
+    std::vector<std::unique_ptr<Client>> clients;
+    cal::NetworkConfig config;
+    config.backend = backend;
+    config.sqpoll = sqpoll;
+    config.buffer_count = 1024;
+    cal::NetworkThread<Client, 64> net(config);
+
+    for (size_t c = 0; c < g_config.connections; ++c) {
+        servers.push_back(std::make_unique<test::WsTestServer>());
+        servers.back()->start([c](test::WsTestServer& s) { generate(s, c); });
+
+        cal::WebSocketConfig ws_config;
+        ws_config.url = servers.back()->url("/ws");
+        clients.push_back(std::make_unique<Client>(ws_config, BenchHandler{sink.get()}));
+        net.add(*clients.back());
+    }
+
+    if (!net.init()) {
+        std::cout << "  " << label << ": no backend available" << std::endl;
+        return;
+    }
+    if (net.backend() != backend) {
+        std::cout << "  " << label << ": unavailable (" << net.fallback_reason()
+                  << "), skipped" << std::endl;
+        net.shutdown();
+        for (auto& server : servers) server->join();
+        return;
+    }
+
+    const uint64_t user_start = thread_cpu_us(false);
+    const uint64_t system_start = thread_cpu_us(true);
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::seconds(60);
+    const int timeout_ms = g_config.busy ? 0 : 1;
+    while (sink->received < expected && std::chrono::steady_clock::now() < deadline) {
+        net.poll(timeout_ms);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t user_us = thread_cpu_us(false) - user_start;
+    const uint64_t system_us = thread_cpu_us(true) - system_start;
+    const uint64_t wakeups = net.stats().wakeups.load();
+
+    net.shutdown();
+    for (auto& server : servers) server->join();
+
+    const double received = static_cast<double>(std::max<uint64_t>(sink->received, 1));
+    std::cout << "  " << std::left << std::setw(15) << label << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(7) << received / seconds / 1e6 << " M msg/s"
+              << "  cpu/msg user=" << std::setw(6) << 1000.0 * static_cast<double>(user_us) / received
+              << "ns sys=" << std::setw(6) << 1000.0 * static_cast<double>(system_us) / received
+              << "ns  msgs/wakeup=" << std::setprecision(1)
+              << received / static_cast<double>(std::max<uint64_t>(wakeups, 1))
+              << std::endl;
+    std::cout << "  " << std::setw(15) << "" << "  latency p50=" << percentile(sink->latency_ns, 50.0)
+              << " p99=" << percentile(sink->latency_ns, 99.0)
+              << " p99.9=" << percentile(sink->latency_ns, 99.9) << " (ns)"
+              << "  published=" << sink->published
+              << (sink->received < expected ? "  INCOMPLETE" : "") << std::endl;
+}
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    if (argc > 1) g_config.connections = std::clamp<size_t>(std::strtoull(argv[1], nullptr, 10), 1, 64);
+    if (argc > 2) g_config.messages = std::strtoull(argv[2], nullptr, 10);
+    if (argc > 3) g_config.batch = std::max<size_t>(std::strtoull(argv[3], nullptr, 10), 1);
+    if (argc > 4) g_config.gap_us = std::strtoull(argv[4], nullptr, 10);
+    const std::string which = (argc > 5) ? argv[5] : "all";
+    g_config.busy = (argc > 6) && std::strcmp(argv[6], "busy") == 0;
+
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE CAL Network Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+    std::cout << "  " << g_config.connections << " connections x " << g_config.messages
+              << " trades, " << g_config.batch << " frames per write, gap "
+              << g_config.gap_us << "us, " << (g_config.busy ? "busy-poll" : "blocking")
+              << std::endl;
+
+    if (which == "all" || which == "epoll") {
+        run("epoll", cal::IoBackend::EPOLL, false);
+    }
+    if (which == "all" || which == "io_uring") {
+        run("io_uring", cal::IoBackend::IO_URING, false);
+    }
+    if (which == "all" || which == "io_uring_sqpoll") {
+        run("io_uring+sqpoll", cal::IoBackend::IO_URING, true);
+    }
+    return 0;
+}
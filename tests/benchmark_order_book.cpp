@@ -0,0 +1,248 @@
+/**
+ * SAGE ADE Order Book Benchmark
+ * Per-update latency of the L2 book over a synthetic depth stream, and
+ * of the consolidated cross-venue BBO over synthetic venue quotes
+ *
+ * Usage: benchmark_order_book [updates] [levels_per_message]
+ *   defaults: 2,000,000 updates, 20 levels per depth message
+ *
+ * The stream imitates a liquid venue's diff feed (Binance depth@100ms,
+ * Coinbase level2): the mid takes a random walk of a few ticks per
+ * message, most changes land within a few ticks of the touch, about a
+ * third remove a level, and levels the mid moves through are removed
+ * (so the touch is frequently emptied and the best-price rescan is
+ * exercised, and the window follows the drift). Updates are generated up
+ * front and replayed, so only the book is timed.
+ *
+ * "update" times one level (update + read of both bests, as ADE does);
+ * "update + features" adds spread / microprice / 5-level imbalance, ADE's
+ * per-level cost while the book is synced. Throughput is the whole stream
+ * applied back to back without timers. "consolidated BBO" times one
+ * venue top-of-book change across 8 venue lanes (update + move check).
+ * Budget (within ADE's ~100ns per message): <100ns p50 per level,
+ * timer overhead included.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <cstdlib>
+#include <memory>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/timing.hpp"
+#include "../src/ade/order_book.hpp"
+#include "../src/ade/consolidated_bbo.hpp"
+
+using namespace sage;
+
+namespace {
+
+constexpr uint64_t BUDGET_NS = 100;
+constexpr int64_t TICK = PRICE_SCALE / 100;   // 0.01
+constexpr int64_t START_TICK = 4215000;       // 42150.00
+
+using Book = ade::L2Book<1024>;
+
+struct Update {
+    ade::BookSide side;
+    FixedPoint price;
+    FixedPoint quantity;
+};
+
+struct Stats {
+    std::vector<uint64_t> samples;
+
+    uint64_t percentile(double pct) {
+        if (samples.empty()) return 0;
+        const size_t index = std::min(samples.size() - 1,
+            static_cast<size_t>(static_cast<double>(samples.size()) * pct / 100.0));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<long>(index), samples.end());
+        return samples[index];
+    }
+
+    void print(const char* label) {
+        const uint64_t p50 = percentile(50.0);
+        std::cout << "  " << std::left << std::setw(18) << label << std::right
+                  << " p50=" << std::setw(5) << p50
+                  << " p90=" << std::setw(5) << percentile(90.0)
+                  << " p99=" << std::setw(5) << percentile(99.0)
+                  << " p99.9=" << std::setw(6) << percentile(99.9)
+                  << " (ns) " << (p50 < BUDGET_NS ? "PASS" : "FAIL") << std::endl;
+    }
+};
+
+/**
+ * Depth messages of `per_message` levels around a random-walking mid
+ * (a venue keeps its book uncrossed: levels the mid passes are removed)
+ */
+std::vector<Update> make_stream(size_t count, size_t per_message) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> step(-3, 3);
+    std::geometric_distribution<int> distance(0.15);   // Ticks from the touch, mean ~6
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int64_t> size(1, 500);
+
+    std::vector<Update> stream;
+    stream.reserve(count + 1024);
+    std::set<int64_t> held[2];   // Ticks the book holds per side
+    auto emit = [&](ade::BookSide side, int64_t tick, int64_t quantity) {
+        std::set<int64_t>& ticks = held[static_cast<size_t>(side)];
+        quantity == 0 ? (void)ticks.erase(tick) : (void)ticks.insert(tick);
+        stream.push_back({side, FixedPoint(tick * TICK), FixedPoint(quantity)});
+    };
+    int64_t mid = START_TICK;
+    while (stream.size() < count) {
+        mid += step(rng);
+        while (!held[0].empty() && *held[0].rbegin() >= mid) {
+            emit(ade::BookSide::BID, *held[0].rbegin(), 0);
+        }
+        while (!held[1].empty() && *held[1].begin() <= mid) {
+            emit(ade::BookSide::ASK, *held[1].begin(), 0);
+        }
+        for (size_t i = 0; i < per_message; ++i) {
+            const bool bid = percent(rng) < 50;
+            const int64_t away = 1 + std::min(distance(rng), 400);
+            const bool remove = percent(rng) < 35;
+            emit(bid ? ade::BookSide::BID : ade::BookSide::ASK, bid ? mid - away : mid + away,
+                 remove ? 0 : size(rng) * (PRICE_SCALE / 1000));
+        }
+    }
+    stream.resize(count);
+    return stream;
+}
+
+/**
+ * Top-of-book changes from 8 venues quoting around a shared random walk
+ */
+struct VenueQuote {
+    uint8_t venue;
+    ade::BookSide side;
+    FixedPoint price;
+    FixedPoint quantity;
+};
+
+std::vector<VenueQuote> make_quotes(size_t count) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> step(-1, 1);
+    std::uniform_int_distribution<int> venue(0, static_cast<int>(ade::ConsolidatedBBO::LANES) - 1);
+    std::uniform_int_distribution<int> offset(0, 3);
+    std::uniform_int_distribution<int64_t> size(1, 500);
+
+    std::vector<VenueQuote> quotes;
+    quotes.reserve(count);
+    int64_t mid = START_TICK;
+    for (size_t i = 0; i < count; ++i) {
+        mid += step(rng);
+        const bool bid = (i & 1) == 0;
+        const int64_t tick = bid ? mid - 1 - offset(rng) : mid + 1 + offset(rng);
+        quotes.push_back({static_cast<uint8_t>(venue(rng)), bid ? ade::BookSide::BID : ade::BookSide::ASK,
+                          FixedPoint(tick * TICK), FixedPoint(size(rng) * (PRICE_SCALE / 1000))});
+    }
+    return quotes;
+}
+
+// Both sides 50 levels deep around the start, as a venue snapshot
+void load_snapshot(Book& book) {
+    std::vector<ade::BookLevel> bids;
+    std::vector<ade::BookLevel> asks;
+    for (int64_t i = 1; i <= 50; ++i) {
+        bids.push_back({FixedPoint((START_TICK - i) * TICK), FixedPoint(PRICE_SCALE)});
+        asks.push_back({FixedPoint((START_TICK + i) * TICK), FixedPoint(PRICE_SCALE)});
+    }
+    book.apply_snapshot(bids.data(), bids.size(), asks.data(), asks.size());
+}
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const size_t per_message = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 20;
+
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE ADE Order Book Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    const std::vector<Update> stream = make_stream(count, std::max<size_t>(per_message, 1));
+    auto book = std::make_unique<Book>(FixedPoint(TICK));
+    std::cout << "  Stream: " << stream.size() << " updates, " << per_message
+              << " per message, book " << sizeof(Book) / 1024 << "KB" << std::endl;
+
+    timing::TSCCalibrator tsc;
+    Stats update;
+    Stats with_features;
+    update.samples.reserve(stream.size());
+    with_features.samples.reserve(stream.size());
+
+    // Cost of the rdtsc/rdtscp pair itself (included in every sample)
+    Stats overhead;
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t start = timing::rdtsc();
+        const uint64_t end = timing::rdtscp();
+        overhead.samples.push_back(tsc.tsc_to_ns(end - start));
+    }
+
+    int64_t checksum = 0;
+    load_snapshot(*book);
+    for (const Update& u : stream) {
+        const uint64_t start = timing::rdtsc();
+        book->update(u.side, u.price, u.quantity);
+        checksum += book->best_bid().price.raw() + book->best_ask().price.raw();
+        const uint64_t end = timing::rdtscp();
+        update.samples.push_back(tsc.tsc_to_ns(end - start));
+    }
+
+    load_snapshot(*book);
+    for (const Update& u : stream) {
+        const uint64_t start = timing::rdtsc();
+        book->update(u.side, u.price, u.quantity);
+        checksum += book->features().microprice.raw();
+        const uint64_t end = timing::rdtscp();
+        with_features.samples.push_back(tsc.tsc_to_ns(end - start));
+    }
+
+    load_snapshot(*book);
+    const uint64_t start = timing::rdtsc();
+    for (const Update& u : stream) {
+        book->update(u.side, u.price, u.quantity);
+    }
+    const uint64_t elapsed_ns = tsc.tsc_to_ns(timing::rdtscp() - start);
+    checksum += book->best_bid().price.raw();
+
+    const std::vector<VenueQuote> quotes = make_quotes(count);
+    auto bbo = std::make_unique<ade::ConsolidatedBBO>();
+    Stats consolidated;
+    consolidated.samples.reserve(quotes.size());
+    uint64_t moves = 0;
+    for (const VenueQuote& q : quotes) {
+        const uint64_t start_quote = timing::rdtsc();
+        moves += bbo->update(q.venue, q.side, q.price, q.quantity);
+        const uint64_t end_quote = timing::rdtscp();
+        consolidated.samples.push_back(tsc.tsc_to_ns(end_quote - start_quote));
+    }
+    checksum += bbo->best(ade::BookSide::BID).price.raw();
+
+    std::cout << "  Timer overhead p50=" << overhead.percentile(50.0) << "ns" << std::endl;
+    update.print("update");
+    with_features.print("update + features");
+    std::cout << "  Throughput: "
+              << static_cast<uint64_t>(static_cast<double>(stream.size()) * 1e3 /
+                                       static_cast<double>(std::max<uint64_t>(elapsed_ns, 1)))
+              << "M updates/s" << std::endl;
+    consolidated.print("consolidated BBO");
+    std::cout << "  BBO: " << quotes.size() << " venue quotes, top moved on "
+              << moves * 100 / std::max<size_t>(quotes.size(), 1) << "%" << std::endl;
+    std::cout << "  Book: bid_levels=" << book->depth(ade::BookSide::BID)
+              << " ask_levels=" << book->depth(ade::BookSide::ASK)
+              << " dropped=" << book->dropped() << " evicted=" << book->evicted() << std::endl;
+    std::cout << "  (checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * SAGE CAL Parser Benchmark
+ * Per-message parse and parse + validate latency over a corpus of
+ * Binance / Coinbase trade and quote messages
+ *
+ * Usage: benchmark_parser [corpus.jsonl] [passes]
+ *   defaults: tests/data/market_data_corpus.jsonl, 2000 passes
+ *
+ * Each message is timed individually (rdtsc -> rdtscp), one frame per call
+ * as CAL receives them. "venue parser" times each trade/quote with the
+ * parser CAL's connectors use for its venue (BinanceParser /
+ * CoinbaseParser) instead of the venue-inferring JsonParser. "validate"
+ * is CAL's frame check: stateless checks plus the per-symbol price band.
+ * Budget (README): CAL parse + validate <500ns p50.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/timing.hpp"
+#include "../src/cal/json_parser.hpp"
+#include "../src/cal/validator.hpp"
+
+#ifndef SAGE_TEST_DATA_DIR
+#define SAGE_TEST_DATA_DIR "tests/data"
+#endif
+
+using namespace sage;
+
+namespace {
+
+constexpr uint64_t BUDGET_NS = 500;
+
+struct Stats {
+    std::vector<uint64_t> samples;
+
+    uint64_t percentile(double pct) {
+        if (samples.empty()) return 0;
+        const size_t index = std::min(samples.size() - 1,
+            static_cast<size_t>(static_cast<double>(samples.size()) * pct / 100.0));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<long>(index), samples.end());
+        return samples[index];
+    }
+
+    void print(const char* label) {
+        const uint64_t p50 = percentile(50.0);
+        std::cout << "  " << std::left << std::setw(18) << label << std::right
+                  << " p50=" << std::setw(5) << p50
+                  << " p90=" << std::setw(5) << percentile(90.0)
+                  << " p99=" << std::setw(5) << percentile(99.0)
+                  << " p99.9=" << std::setw(6) << percentile(99.9)
+                  << " (ns) " << (p50 < BUDGET_NS ? "PASS" : "FAIL") << std::endl;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const std::string path = (argc > 1) ? argv[1]
+                                        : SAGE_TEST_DATA_DIR "/market_data_corpus.jsonl";
+    const int passes = (argc > 2) ? std::atoi(argv[2]) : 2000;
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open corpus " << path << std::endl;
+        return 1;
+    }
+    std::vector<std::string> corpus;
+    size_t corpus_bytes = 0;
+    for (std::string line; std::getline(file, line);) {
+        if (!line.empty()) {
+            corpus_bytes += line.size();
+            corpus.push_back(std::move(line));
+        }
+    }
+
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE CAL Parser Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    cal::JsonParser parser;
+    parser.add_symbol("BTCUSDT", 1);
+    parser.add_symbol("BTC-USD", 1);
+    parser.add_symbol("ETHUSDT", 2);
+    parser.add_symbol("ETH-USD", 2);
+    parser.add_symbol("SOLUSDT", 3);
+    parser.add_symbol("SOL-USD", 3);
+
+    cal::BinanceParser binance;
+    binance.add_symbol("BTCUSDT", 1);
+    binance.add_symbol("ETHUSDT", 2);
+    binance.add_symbol("SOLUSDT", 3);
+    cal::CoinbaseParser coinbase;
+    coinbase.add_symbol("BTC-USD", 1);
+    coinbase.add_symbol("ETH-USD", 2);
+    coinbase.add_symbol("SOL-USD", 3);
+
+    // Classify once (and sanity-check the corpus)
+    size_t by_status[6] = {};
+    std::vector<ExchangeId> venues;
+    cal::ParsedMessage parsed;
+    for (const auto& msg : corpus) {
+        const cal::ParseStatus status = parser.parse(msg.data(), msg.size(), parsed);
+        by_status[static_cast<size_t>(status)]++;
+        venues.push_back(parsed.count > 0 ? static_cast<ExchangeId>(parsed.records[0].exchange_id)
+                                          : ExchangeId::UNKNOWN);
+    }
+    std::cout << "  Corpus: " << corpus.size() << " messages, avg "
+              << corpus_bytes / std::max<size_t>(corpus.size(), 1) << "B"
+              << " (trade=" << by_status[0] << " quote=" << by_status[1]
+              << " ignored=" << by_status[2] << " malformed=" << by_status[3]
+              << " unknown_symbol=" << by_status[4] << " depth=" << by_status[5] << ")"
+              << std::endl;
+
+    timing::TSCCalibrator tsc;
+    Stats parse_only;
+    Stats parse_validate;
+    auto band = std::make_unique<cal::PriceBandValidator>();
+    Stats venue_parse;
+    parse_only.samples.reserve(corpus.size() * static_cast<size_t>(passes));
+    parse_validate.samples.reserve(corpus.size() * static_cast<size_t>(passes));
+    venue_parse.samples.reserve(corpus.size() * static_cast<size_t>(passes));
+
+    // Cost of the rdtsc/rdtscp pair itself (included in every sample)
+    Stats overhead;
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t start = timing::rdtsc();
+        const uint64_t end = timing::rdtscp();
+        overhead.samples.push_back(tsc.tsc_to_ns(end - start));
+    }
+
+    uint64_t checksum = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const auto& msg : corpus) {
+            uint64_t start = timing::rdtsc();
+            cal::ParseStatus status = parser.parse(msg.data(), msg.size(), parsed);
+            uint64_t end = timing::rdtscp();
+            parse_only.samples.push_back(tsc.tsc_to_ns(end - start));
+            checksum += static_cast<uint64_t>(status);
+
+            start = timing::rdtsc();
+            status = parser.parse(msg.data(), msg.size(), parsed);
+            if (status == cal::ParseStatus::TRADE || status == cal::ParseStatus::QUOTE) {
+                checksum += band->validate_batch(parsed.records, parsed.count);
+            }
+            end = timing::rdtscp();
+            parse_validate.samples.push_back(tsc.tsc_to_ns(end - start));
+        }
+
+        for (size_t m = 0; m < corpus.size(); ++m) {
+            if (venues[m] == ExchangeId::UNKNOWN) {
+                continue;
+            }
+            const std::string& msg = corpus[m];
+            const uint64_t start = timing::rdtsc();
+            const cal::ParseStatus status = (venues[m] == ExchangeId::BINANCE)
+                ? binance.parse(msg.data(), msg.size(), parsed)
+                : coinbase.parse(msg.data(), msg.size(), parsed);
+            const uint64_t end = timing::rdtscp();
+            venue_parse.samples.push_back(tsc.tsc_to_ns(end - start));
+            checksum += static_cast<uint64_t>(status);
+        }
+    }
+
+    std::cout << "  " << parse_only.samples.size() << " samples per scenario, timer overhead p50="
+              << overhead.percentile(50.0) << "ns" << std::endl;
+    parse_only.print("parse");
+    parse_validate.print("parse + validate");
+    venue_parse.print("venue parser");
+    std::cout << "  (checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+/**
+ * SAGE Cross-Core SPSC Benchmark
+ * One-way latency, round-trip ping-pong and saturated throughput of
+ * RingBuffer between two pinned cores
+ *
+ * Usage: benchmark_spsc [producer_core] [consumer_core] [samples]
+ *   defaults: cores 2 and 3, 1000000 samples
+ *
+ * Run it once per core pair of interest (SMT siblings, same L3, cross
+ * socket; see lscpu -e) to size rings and place CAL/ADE/RME/POE.
+ *
+ * Timestamps are TSC (rdtsc on send, rdtscp on receive) converted with
+ * TSCCalibrator, so the TSC must be invariant and synchronized across the
+ * chosen cores (constant_tsc + nonstop_tsc in /proc/cpuinfo).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <memory>
+
+#include "../src/core/compiler.hpp"
+#include "../src/core/timing.hpp"
+#include "../src/core/cpu_affinity.hpp"
+#include "../src/infra/ring_buffer.hpp"
+
+using namespace sage;
+
+namespace {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct Config {
+    int producer_core = 2;
+    int consumer_core = 3;
+    uint64_t samples = 1000000;
+};
+
+Config g_config;
+timing::TSCCalibrator g_tsc;
+
+constexpr uint64_t PACING_NS = 1000;        // Gap between one-way samples
+constexpr uint64_t WARMUP_SAMPLES = 10000;
+
+/**
+ * Message of a given total size; first 8 bytes carry the send TSC
+ */
+template<size_t Bytes>
+struct alignas(8) Message {
+    static_assert(Bytes > 16, "Message must hold a timestamp, a sequence and a payload");
+    uint64_t tsc;
+    uint64_t seq;
+    char payload[Bytes - 16];
+};
+
+// Header only (a zero-length payload array is ill-formed)
+template<>
+struct alignas(8) Message<16> {
+    uint64_t tsc;
+    uint64_t seq;
+};
+
+// ============================================================================
+// Histogram (1ns resolution to 1us, then 64 sub-buckets per power of two)
+// ============================================================================
+
+class Histogram {
+public:
+    static constexpr size_t LINEAR = 1024;
+    static constexpr size_t SUB_BUCKETS = 64;
+    static constexpr size_t OCTAVES = 30;    // Up to ~1s
+    static constexpr size_t NUM_BUCKETS = LINEAR + OCTAVES * SUB_BUCKETS;
+
+    void record(uint64_t ns) noexcept {
+        buckets_[index(ns)]++;
+        count_++;
+        sum_ += ns;
+        if (ns > max_) max_ = ns;
+    }
+
+    uint64_t percentile(double pct) const noexcept {
+        const uint64_t target = static_cast<uint64_t>(
+            static_cast<double>(count_) * pct / 100.0);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            cumulative += buckets_[i];
+            if (cumulative > target) {
+                const uint64_t bound = upper_bound(i);
+                return bound < max_ ? bound : max_;
+            }
+        }
+        return max_;
+    }
+
+    uint64_t count() const noexcept { return count_; }
+    uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept {
+        return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+private:
+    static size_t index(uint64_t ns) noexcept {
+        if (ns < LINEAR) {
+            return static_cast<size_t>(ns);
+        }
+        const unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+        const size_t octave = msb - 10;                          // 2^10 == LINEAR
+        if (octave >= OCTAVES) {
+            return NUM_BUCKETS - 1;
+        }
+        const size_t sub = static_cast<size_t>((ns >> (msb - 6)) & (SUB_BUCKETS - 1));
+        return LINEAR + octave * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t upper_bound(size_t i) noexcept {
+        if (i < LINEAR) {
+            return i;
+        }
+        const size_t octave = (i - LINEAR) / SUB_BUCKETS;
+        const size_t sub = (i - LINEAR) % SUB_BUCKETS;
+        const uint64_t base = uint64_t{1} << (octave + 10);
+        return base + ((sub + 1) << (octave + 4)) - 1;
+    }
+
+    uint64_t buckets_[NUM_BUCKETS]{};
+    uint64_t count_{0};
+    uint64_t sum_{0};
+    uint64_t max_{0};
+};
+
+void print_distribution(const char* label, const Histogram& h) {
+    std::cout << "    " << std::left << std::setw(10) << label << std::right
+              << " mean=" << std::setw(7) << std::fixed << std::setprecision(1) << h.mean()
+              << " p50=" << std::setw(6) << h.percentile(50.0)
+              << " p90=" << std::setw(6) << h.percentile(90.0)
+              << " p99=" << std::setw(6) << h.percentile(99.0)
+              << " p99.9=" << std::setw(6) << h.percentile(99.9)
+              << " p99.99=" << std::setw(7) << h.percentile(99.99)
+              << " max=" << h.max() << " (ns)" << std::endl;
+}
+
+void pin(int core) {
+    if (cpu::pin_to_core(core) != 0) {
+        std::cerr << "    (could not pin to core " << core << ")" << std::endl;
+    }
+}
+
+SAGE_ALWAYS_INLINE void spin_until_tsc(uint64_t deadline) noexcept {
+    while (timing::rdtsc() < deadline) {
+        cpu::pause();
+    }
+}
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+/**
+ * One-way latency: paced sends so the ring is (almost) always empty
+ */
+template<size_t Bytes, size_t N>
+void bench_one_way() {
+    using Msg = Message<Bytes>;
+    auto ring = std::make_unique<RingBuffer<Msg, N>>();
+    auto hist = std::make_unique<Histogram>();
+    const uint64_t total = WARMUP_SAMPLES + g_config.samples;
+    const uint64_t pacing_tsc = g_tsc.ns_to_tsc(PACING_NS);
+
+    std::thread consumer([&] {
+        pin(g_config.consumer_core);
+        Msg msg;
+        for (uint64_t i = 0; i < total; ++i) {
+            while (!ring->try_pop(msg)) {
+                cpu::pause();
+            }
+            const uint64_t now = timing::rdtscp();
+            if (i >= WARMUP_SAMPLES) {
+                hist->record(g_tsc.tsc_to_ns(now - msg.tsc));
+            }
+        }
+    });
+
+    pin(g_config.producer_core);
+    Msg msg;
+    std::memset(&msg, 0, sizeof(msg));
+    for (uint64_t i = 0; i < total; ++i) {
+        msg.seq = i;
+        msg.tsc = timing::rdtsc();
+        ring->push_blocking(msg);
+        spin_until_tsc(msg.tsc + pacing_tsc);
+    }
+    consumer.join();
+
+    print_distribution("one-way", *hist);
+}
+
+/**
+ * Round trip: ping on one ring, echo back on another
+ */
+template<size_t Bytes, size_t N>
+void bench_ping_pong() {
+    using Msg = Message<Bytes>;
+    auto ping = std::make_unique<RingBuffer<Msg, N>>();
+    auto pong = std::make_unique<RingBuffer<Msg, N>>();
+    auto hist = std::make_unique<Histogram>();
+    const uint64_t total = WARMUP_SAMPLES + g_config.samples;
+
+    std::thread echo([&] {
+        pin(g_config.consumer_core);
+        Msg msg;
+        for (uint64_t i = 0; i < total; ++i) {
+            while (!ping->try_pop(msg)) {
+                cpu::pause();
+            }
+            pong->push_blocking(msg);
+        }
+    });
+
+    pin(g_config.producer_core);
+    Msg msg;
+    std::memset(&msg, 0, sizeof(msg));
+    for (uint64_t i = 0; i < total; ++i) {
+        msg.seq = i;
+        msg.tsc = timing::rdtsc();
+        ping->push_blocking(msg);
+        while (!pong->try_pop(msg)) {
+            cpu::pause();
+        }
+        const uint64_t now = timing::rdtscp();
+        if (i >= WARMUP_SAMPLES) {
+            hist->record(g_tsc.tsc_to_ns(now - msg.tsc));
+        }
+    }
+    echo.join();
+
+    print_distribution("round-trip", *hist);
+}
+
+/**
+ * Saturated throughput: producer floods, consumer drains in batches
+ */
+template<size_t Bytes, size_t N>
+void bench_throughput() {
+    using Msg = Message<Bytes>;
+    constexpr size_t BATCH = 64;
+    auto ring = std::make_unique<RingBuffer<Msg, N>>();
+    const uint64_t total = g_config.samples * 10;
+    std::atomic<bool> go{false};
+    uint64_t checksum = 0;
+
+    std::thread consumer([&] {
+        pin(g_config.consumer_core);
+        Msg batch[BATCH];
+        uint64_t received = 0;
+        while (!go.load(std::memory_order_acquire)) {
+            cpu::pause();
+        }
+        while (received < total) {
+            const size_t n = ring->try_pop_batch(batch, BATCH);
+            for (size_t i = 0; i < n; ++i) {
+                checksum += batch[i].seq;
+            }
+            received += n;
+        }
+    });
+
+    pin(g_config.producer_core);
+    Msg msg;
+    std::memset(&msg, 0, sizeof(msg));
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (uint64_t i = 0; i < total; ++i) {
+        msg.seq = i;
+        ring->push_blocking(msg);
+    }
+    consumer.join();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double secs = std::chrono::duration<double>(end - start).count();
+    const double mps = static_cast<double>(total) / secs;
+    std::cout << "    throughput " << std::fixed << std::setprecision(1)
+              << mps / 1e6 << " M msgs/s, "
+              << mps * static_cast<double>(sizeof(Msg)) / 1e9 << " GB/s"
+              << (checksum == total * (total - 1) / 2 ? "" : "  (CHECKSUM MISMATCH)")
+              << std::endl;
+}
+
+template<size_t Bytes, size_t N>
+void run_suite() {
+    std::cout << "\n  [" << Bytes << "B messages, ring=" << N << "]" << std::endl;
+    bench_one_way<Bytes, N>();
+    bench_ping_pong<Bytes, N>();
+    bench_throughput<Bytes, N>();
+}
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    if (argc > 1) g_config.producer_core = std::atoi(argv[1]);
+    if (argc > 2) g_config.consumer_core = std::atoi(argv[2]);
+    if (argc > 3) g_config.samples = std::strtoull(argv[3], nullptr, 10);
+
+    std::cout << "====================================" << std::endl;
+    std::cout << "SAGE Cross-Core SPSC Benchmark" << std::endl;
+    std::cout << "====================================" << std::endl;
+    std::cout << "  Producer core: " << g_config.producer_core
+              << ", consumer core: " << g_config.consumer_core
+              << ", samples: " << g_config.samples << std::endl;
+    std::cout << "  TSC: " << std::setprecision(3) << g_tsc.get_ticks_per_ns()
+              << " ticks/ns" << std::endl;
+    if (g_config.producer_core == g_config.consumer_core) {
+        std::cout << "  WARNING: same core - results measure context switches" << std::endl;
+    }
+
+    run_suite<16, 1024>();
+    run_suite<64, 1024>();
+    run_suite<64, 65536>();
+    run_suite<256, 1024>();
+    run_suite<256, 16384>();
+
+    return 0;
+}
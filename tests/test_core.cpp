@@ -7,13 +7,48 @@
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
 
 #include "../src/core/compiler.hpp"
 #include "../src/core/constants.hpp"
 #include "../src/core/timing.hpp"
+#include "../src/core/memory.hpp"
+#include "../src/core/config.hpp"
 #include "../src/types/fixed_point.hpp"
 #include "../src/types/sage_message.hpp"
 #include "../src/infra/ring_buffer.hpp"
+#include "../src/infra/shm_segment.hpp"
+#include "../src/infra/broadcast_ring.hpp"
+#include "../src/infra/mpsc_queue.hpp"
+#include "../src/infra/byte_ring.hpp"
+#include "../src/infra/wait_strategy.hpp"
+#include "../src/infra/conflating_queue.hpp"
+#include "../src/infra/seqlock.hpp"
+#include "../src/rme/position_tracker.hpp"
+#include "../src/cal/symbol_interner.hpp"
+#include "../src/cal/validator.hpp"
+#include "../src/cal/feed_recovery.hpp"
+#include "../src/cal/feed_arbiter.hpp"
+#include "../src/cal/json_parser.hpp"
+#include "../src/cal/websocket_client.hpp"
+#include "../src/cal/network_thread.hpp"
+#include "../src/cal/connector_manager.hpp"
+#include "../src/ade/order_book.hpp"
+#include "../src/ade/consolidated_bbo.hpp"
+#include "../src/rec/capture_writer.hpp"
+#include "../src/rec/capture_reader.hpp"
+#include "../src/rec/archive_writer.hpp"
+#include "../src/rec/archive_reader.hpp"
+#include "../src/replay/replay_pacer.hpp"
+#include "ws_test_server.hpp"
 
 using namespace sage;
 
@@ -112,6 +147,16 @@ void test_sage_message() {
     assert(msg.payload.market_data.quantity.to_double() == 0.1);
     assert(msg.is_valid());
     
+    // CAL stage timing lives in the former header padding
+    static_assert(offsetof(SageMessage, rx_clock) == 17, "rx_clock at byte 17");
+    static_assert(offsetof(SageMessage, parse_ns) == 18, "parse_ns at byte 18");
+    static_assert(offsetof(SageMessage, rx_delta_ns) == 20, "rx_delta_ns at byte 20");
+    static_assert(offsetof(SageMessage, payload) == 24, "payload at byte 24");
+    static_assert(offsetof(MarketData, venue_seq) == 24, "venue_seq at payload byte 24");
+    static_assert(offsetof(MarketData, exchange_ts_ns) == 32, "exchange_ts_ns at payload byte 32");
+    assert(msg.rx_clock == timing::RxClock::NONE);
+    assert(msg.parse_ns == 0 && msg.rx_delta_ns == 0);
+    
     std::cout << "  SageMessage: PASSED" << std::endl;
 }
 
@@ -217,6 +262,1844 @@ void test_ring_buffer_batch() {
     std::cout << "  RingBuffer batch: PASSED" << std::endl;
 }
 
+void test_ring_buffer_zero_copy() {
+    std::cout << "  Testing RingBuffer claim/commit and peek/release..." << std::endl;
+    
+    RingBuffer<int, 16> rb;
+    
+    // Claimed slots are invisible until commit
+    int* slots = nullptr;
+    assert(rb.try_claim(10, slots) == 10);
+    for (int i = 0; i < 10; ++i) {
+        slots[i] = i;
+    }
+    const int* items = nullptr;
+    assert(rb.peek_span(items, 16) == 0);
+    rb.commit(10);
+    
+    // Spans read in place and stop at the physical end of the buffer
+    assert(rb.peek_span(items, 4) == 4);
+    assert(items[0] == 0 && items[3] == 3);
+    rb.release(4);
+    
+    assert(rb.try_claim(16, slots) == 6);    // 10..15 before wrap
+    for (int i = 0; i < 6; ++i) {
+        slots[i] = 10 + i;
+    }
+    rb.commit(6);
+    assert(rb.try_claim(16, slots) == 4);    // Only the 4 released slots
+    rb.commit(0);
+    
+    assert(rb.peek_span(items, 16) == 12);
+    for (int i = 0; i < 12; ++i) {
+        assert(items[i] == 4 + i);
+    }
+    rb.release(12);
+    assert(rb.empty_approx());
+    
+    // Batch publish wraps and stops when full
+    int batch[20];
+    for (int i = 0; i < 20; ++i) {
+        batch[i] = 100 + i;
+    }
+    assert(rb.try_push_batch(batch, 20) == 16);
+    assert(rb.try_push_batch(batch, 1) == 0);
+    
+    int val;
+    for (int i = 0; i < 16; ++i) {
+        assert(rb.try_pop(val));
+        assert(val == 100 + i);
+    }
+    
+    std::cout << "  RingBuffer zero-copy: PASSED" << std::endl;
+}
+
+void test_shm_ring_buffer() {
+    std::cout << "  Testing ShmRingBuffer create/attach..." << std::endl;
+    
+    const char* name = "/sage_test_shm_ring";
+    
+    {
+        ShmRingBuffer<uint64_t, 64> producer;
+        ShmRingBuffer<uint64_t, 64> consumer;
+        
+        // Nothing to attach to yet
+        memory::shm_remove(name);
+        assert(!consumer.attach(name));
+        assert(consumer.status() == ShmStatus::OPEN_FAILED);
+        
+        assert(producer.create(name));
+        assert(producer.is_owner());
+        assert(producer.header().magic == MAGIC_SHM);
+        assert(producer.header().object_magic == MAGIC_RING_BUFFER);
+        assert(producer.header().capacity == 64);
+        assert(producer.header().element_size == sizeof(uint64_t));
+        
+        // Second mapping sees the same ring (as another process would)
+        assert(consumer.attach(name));
+        assert(!consumer.is_owner());
+        assert(&producer.get() != &consumer.get());
+        
+        for (uint64_t i = 0; i < 40; ++i) {
+            assert(producer->try_push(i * 3));
+        }
+        assert(consumer->size_approx() == 40);
+        
+        for (uint64_t i = 0; i < 40; ++i) {
+            uint64_t val = 0;
+            assert(consumer->try_pop(val));
+            assert(val == i * 3);
+        }
+        assert(producer->empty_approx());
+        
+        // Mismatched capacity / element size must be rejected
+        ShmRingBuffer<uint64_t, 128> wrong_capacity;
+        assert(!wrong_capacity.attach(name));
+        assert(wrong_capacity.status() == ShmStatus::LAYOUT_MISMATCH);
+        
+        ShmRingBuffer<uint32_t, 64> wrong_element;
+        assert(!wrong_element.attach(name));
+        assert(!wrong_element.is_attached());
+    }
+    
+    // Creator unlinks on detach
+    ShmRingBuffer<uint64_t, 64> late;
+    assert(!late.attach(name));
+    
+    std::cout << "  ShmRingBuffer: PASSED" << std::endl;
+}
+
+void test_broadcast_ring() {
+    std::cout << "  Testing BroadcastRing fan-out..." << std::endl;
+    
+    BroadcastRing<int, 16, 4> ring;
+    
+    int ade = ring.add_consumer(ConsumerMode::GATING);
+    int risk = ring.add_consumer(ConsumerMode::GATING);
+    int recorder = ring.add_consumer(ConsumerMode::LOSSY);
+    assert(ade == 0 && risk == 1 && recorder == 2);
+    assert(ring.consumer_count() == 3);
+    
+    // Every consumer sees every message
+    for (int i = 0; i < 10; ++i) {
+        assert(ring.try_publish(i));
+    }
+    for (int id : {ade, risk, recorder}) {
+        for (int i = 0; i < 10; ++i) {
+            int val = -1;
+            assert(ring.try_consume(id, val));
+            assert(val == i);
+        }
+        int val;
+        assert(!ring.try_consume(id, val));
+    }
+    
+    // Producer gates on the slowest gating consumer only
+    for (int i = 0; i < 16; ++i) {
+        assert(ring.try_publish(100 + i));
+    }
+    int items[16];
+    assert(ring.try_consume_batch(ade, items, 16) == 16);
+    assert(!ring.try_publish(999));          // risk is a full ring behind
+    assert(ring.lag(risk) == 16);
+    
+    assert(ring.try_consume_batch(risk, items, 4) == 4);
+    for (int i = 0; i < 4; ++i) {
+        assert(ring.try_publish(200 + i));   // recorder is lossy: ignored
+    }
+    
+    // Lossy consumer fell a full lap behind: skipped forward and counted
+    assert(ring.try_consume_batch(recorder, items, 16) > 0);
+    assert(ring.overruns(recorder) > 0);
+    assert(items[0] >= 100);
+    
+    // Removing the laggard releases the producer
+    ring.remove_consumer(risk);
+    assert(ring.try_consume_batch(ade, items, 16) == 4);
+    assert(ring.try_publish(300));
+    
+    std::cout << "  BroadcastRing: PASSED" << std::endl;
+}
+
+void test_mpsc_queue() {
+    std::cout << "  Testing MpscQueue..." << std::endl;
+    
+    MpscQueue<uint64_t, 16> q;
+    
+    // Single-threaded: FIFO, full, wrap
+    for (uint64_t i = 0; i < 16; ++i) {
+        assert(q.try_push(i));
+    }
+    assert(!q.try_push(99));
+    
+    uint64_t val;
+    for (uint64_t i = 0; i < 16; ++i) {
+        assert(q.try_pop(val));
+        assert(val == i);
+    }
+    assert(!q.try_pop(val));
+    
+    // Full queue, consumer stalled: racing pushes fail without claiming
+    // slots, so one pop frees exactly one push
+    for (uint64_t i = 0; i < 16; ++i) {
+        assert(q.try_push(i));
+    }
+    std::atomic<uint64_t> pushed{0};
+    std::vector<std::thread> racers;
+    for (int t = 0; t < 4; ++t) {
+        racers.emplace_back([&q, &pushed] {
+            for (int i = 0; i < 10000; ++i) {
+                pushed.fetch_add(q.try_push(99) ? 1 : 0, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : racers) {
+        t.join();
+    }
+    assert(pushed.load() == 0);
+    assert(q.size_approx() == 16);
+    assert(q.try_pop(val) && val == 0);
+    assert(q.try_push(16));
+    assert(!q.try_push(17));
+    for (uint64_t i = 1; i <= 16; ++i) {
+        assert(q.try_pop(val) && val == i);
+    }
+    
+    // Concurrent producers: every item arrives exactly once, per-producer order kept
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 100000;
+    MpscQueue<uint64_t, 1024> mq;
+    
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&mq, p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                mq.push_blocking((p << 32) | i);
+            }
+        });
+    }
+    
+    uint64_t next[PRODUCERS] = {};
+    uint64_t received = 0;
+    uint64_t batch[64];
+    while (received < PRODUCERS * PER_PRODUCER) {
+        size_t n = mq.try_pop_batch(batch, 64);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t p = batch[i] >> 32;
+            assert(p < PRODUCERS);
+            assert((batch[i] & 0xFFFFFFFF) == next[p]);
+            ++next[p];
+        }
+        received += n;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    assert(!mq.try_pop(val));
+    
+    std::cout << "  MpscQueue: PASSED" << std::endl;
+}
+
+void test_byte_ring() {
+    std::cout << "  Testing ByteRing..." << std::endl;
+    
+    ByteRing<1024> ring;
+    size_t len = 0;
+    assert(ring.try_peek(len) == nullptr);
+    
+    // Reserve more than needed, commit the actual length
+    uint8_t* dst = ring.try_reserve(100);
+    assert(dst != nullptr);
+    std::memcpy(dst, "8=FIX.4.2", 9);
+    ring.commit(9);
+    
+    const uint8_t* src = ring.try_peek(len);
+    assert(src != nullptr && len == 9);
+    assert(std::memcmp(src, "8=FIX.4.2", 9) == 0);
+    ring.release();
+    assert(ring.empty_approx());
+    
+    // Oversized records are rejected up front
+    assert(ring.try_reserve(ByteRing<1024>::MAX_RECORD_SIZE + 1) == nullptr);
+    
+    // Variable sizes across many wraps: every record stays contiguous
+    char frame[300];
+    char out[300];
+    for (int i = 0; i < 200; ++i) {
+        const size_t n = 1 + static_cast<size_t>(i * 37) % 299;
+        std::memset(frame, 'a' + (i % 26), n);
+        assert(ring.try_write(frame, n));
+        if (i % 2 == 1) {
+            assert(ring.try_write(frame, n));
+            assert(ring.try_read(out, sizeof(out)) > 0);
+        }
+        const size_t got = ring.try_read(out, sizeof(out));
+        assert(got == n);
+        assert(std::memcmp(out, frame, n) == 0);
+    }
+    assert(ring.empty_approx());
+    
+    // Full ring refuses, draining frees space again
+    int written = 0;
+    while (ring.try_write(frame, 200)) {
+        ++written;
+    }
+    assert(written >= 4);
+    assert(ring.try_read(out, sizeof(out)) == 200);
+    assert(ring.try_write(frame, 200));
+    
+    std::cout << "  ByteRing: PASSED" << std::endl;
+}
+
+template<typename Wait>
+static void run_wait_strategy(Wait wait) {
+    static RingBuffer<uint64_t, 1024> rb;
+    constexpr uint64_t COUNT = 20000;
+    
+    std::thread producer([] {
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            rb.push_blocking(i);
+            if (i % 5000 == 0) {
+                // Give the consumer time to park
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    });
+    
+    uint64_t expected = 0;
+    while (expected < COUNT) {
+        uint64_t val;
+        if (rb.try_pop(val)) {
+            assert(val == expected);
+            ++expected;
+            wait.reset();
+        } else {
+            wait.idle(rb);
+        }
+    }
+    producer.join();
+}
+
+void test_wait_strategies() {
+    std::cout << "  Testing consumer wait strategies..." << std::endl;
+    
+    run_wait_strategy(BusySpinWait{});
+    run_wait_strategy(BackoffWait{});
+    run_wait_strategy(SleepingWait{100, 1000});
+    
+    // Producer only wakes when a sleeper is flagged
+    RingBuffer<uint64_t, 16> rb;
+    WaitSignal& signal = rb.wait_signal();
+    assert(rb.try_push(1));
+    assert(signal.epoch.load() == 0);
+    
+    signal.sleepers.store(1);
+    assert(rb.try_push(2));
+    assert(signal.epoch.load() == 1);
+    signal.sleepers.store(0);
+    
+    std::cout << "  Wait strategies: PASSED" << std::endl;
+}
+
+void test_conflating_queue() {
+    std::cout << "  Testing ConflatingQueue..." << std::endl;
+    
+    ConflatingQueue<uint64_t, 16> q;
+    uint64_t val;
+    uint32_t conflated;
+    assert(!q.try_pop(val));
+    assert(!q.publish(16, 1));   // Key out of range
+    
+    // Latest value per key, keys in first-update order
+    for (uint64_t i = 1; i <= 5; ++i) {
+        assert(q.publish(3, 300 + i));
+    }
+    assert(q.publish(7, 700));
+    assert(q.pending_approx() == 2);
+    assert(q.conflated_total() == 4);
+    
+    assert(q.try_pop(val, conflated));
+    assert(val == 305 && conflated == 4);
+    assert(q.try_pop(val, conflated));
+    assert(val == 700 && conflated == 0);
+    assert(!q.try_pop(val));
+    
+    // Key re-arms after being read
+    assert(q.publish(3, 306));
+    assert(q.try_pop(val) && val == 306);
+    
+    // Concurrent producers: consumer only ever sees increasing values per key
+    constexpr uint64_t PER_KEY = 100000;
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < 4; ++p) {
+        producers.emplace_back([&q, p] {
+            for (uint64_t i = 1; i <= PER_KEY; ++i) {
+                q.publish(p, (p << 32) | i);
+            }
+        });
+    }
+    
+    uint64_t last[4] = {};
+    bool done = false;
+    while (!done) {
+        if (q.try_pop(val)) {
+            const uint64_t key = val >> 32;
+            const uint64_t seq = val & 0xFFFFFFFF;
+            assert(key < 4);
+            assert(seq > last[key]);
+            last[key] = seq;
+        }
+        done = last[0] == PER_KEY && last[1] == PER_KEY &&
+               last[2] == PER_KEY && last[3] == PER_KEY;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    assert(!q.try_pop(val));
+    
+    // CAL's overload lane: both venues' bid and ask for one symbol each
+    // keep their own slot; only the same (venue, side) supersedes
+    auto lane = std::make_unique<ConflatingQueue<SageMessage, SHM_CONFLATION_KEYS>>();
+    auto quote = [](ExchangeId venue, uint16_t side, int64_t price) {
+        MarketData md{};
+        md.symbol_id = 42;
+        md.exchange_id = static_cast<uint8_t>(venue);
+        md.flags = side;
+        md.price = FixedPoint(price);
+        return md;
+    };
+    const MarketData quotes[] = {
+        quote(ExchangeId::BINANCE, MD_FLAG_BID, 100),
+        quote(ExchangeId::BINANCE, MD_FLAG_ASK, 101),
+        quote(ExchangeId::COINBASE, MD_FLAG_BID, 99),
+        quote(ExchangeId::COINBASE, MD_FLAG_ASK, 102),
+        quote(ExchangeId::BINANCE, MD_FLAG_BID, 98),   // Supersedes Binance's 100
+    };
+    for (const MarketData& md : quotes) {
+        assert(lane->publish(conflation_key(md), SageMessage::create_market_data(0, 0, md)));
+    }
+    MarketData far = quotes[0];
+    far.symbol_id = SHM_CONFLATION_SYMBOLS;
+    assert(conflation_key(far) == SHM_CONFLATION_KEYS);
+    assert(!lane->publish(conflation_key(far), SageMessage::create_market_data(0, 0, far)));
+    
+    SageMessage msg{};
+    int64_t seen[2][2] = {};   // [venue][ask]
+    size_t popped = 0;
+    while (lane->try_pop(msg)) {
+        const MarketData& md = msg.payload.market_data;
+        const size_t venue = md.exchange_id == static_cast<uint8_t>(ExchangeId::COINBASE) ? 1 : 0;
+        const size_t ask = (md.flags & MD_FLAG_ASK) ? 1 : 0;
+        assert(seen[venue][ask] == 0);
+        seen[venue][ask] = md.price.raw();
+        ++popped;
+    }
+    assert(popped == 4 && lane->conflated_total() == 1);
+    assert(seen[0][0] == 98 && seen[0][1] == 101);
+    assert(seen[1][0] == 99 && seen[1][1] == 102);
+    
+    std::cout << "  ConflatingQueue: PASSED" << std::endl;
+}
+
+void test_seqlock_cell() {
+    std::cout << "  Testing SeqlockCell..." << std::endl;
+    
+    struct Snapshot {
+        uint64_t a, b, c, d, e, f, g, h;
+    };
+    
+    SeqlockCell<Snapshot> cell;
+    assert(cell.version() == 0);
+    cell.store(Snapshot{1, 1, 1, 1, 1, 1, 1, 1});
+    assert(cell.version() == 1);
+    assert(cell.load().h == 1);
+    
+    // Readers never observe a half-written value
+    constexpr uint64_t WRITES = 200000;
+    std::thread writer([&cell] {
+        for (uint64_t i = 2; i <= WRITES; ++i) {
+            cell.update([i](Snapshot& v) {
+                v = Snapshot{i, i, i, i, i, i, i, i};
+            });
+        }
+    });
+    
+    uint64_t last = 0;
+    while (last < WRITES) {
+        const Snapshot v = cell.load();
+        assert(v.a == v.b && v.a == v.c && v.a == v.d &&
+               v.a == v.e && v.a == v.f && v.a == v.g && v.a == v.h);
+        assert(v.a >= last);
+        last = v.a;
+    }
+    writer.join();
+    
+    // Position tracker published through shared memory
+    const char* name = "/sage_test_risk_state";
+    ShmSegment<rme::PositionTracker> rme_side;
+    assert(rme_side.create(name));
+    ShmSegment<rme::PositionTracker> monitor;
+    assert(monitor.attach(name));
+    
+    rme_side->update_position(7, 500);
+    rme_side->update_position(7, -200);
+    rme_side->update_position(9, -100);
+    rme_side->record_pnl(-42);
+    
+    const rme::Position pos = monitor->get_position_info(7);
+    assert(pos.quantity == 300 && pos.trade_count == 2);
+    const rme::RiskTotals totals = monitor->totals();
+    assert(totals.total_exposure == 400);
+    assert(totals.daily_pnl == -42);
+    assert(totals.update_count == 3);
+    
+    monitor.detach();
+    rme_side.detach();
+    
+    std::cout << "  SeqlockCell: PASSED" << std::endl;
+}
+
+void test_memory_provisioning() {
+    std::cout << "  Testing memory provisioning..." << std::endl;
+    
+    // Arena objects are constructed in place on (huge-page sized) memory
+    memory::HugePageArena arena;
+    assert(arena.reserve(3 * 1024 * 1024));
+    assert(arena.capacity() == 2 * HUGE_PAGE_SIZE);
+    assert(reinterpret_cast<uintptr_t>(arena.data()) % HUGE_PAGE_SIZE == 0);
+    
+    auto* table = arena.create<std::array<uint64_t, 1024>>();
+    assert(table != nullptr);
+    (*table)[1023] = 42;
+    auto* ring = arena.create<RingBuffer<SageMessage, 1024>>();
+    assert(ring != nullptr && ring->empty_approx());
+    assert(reinterpret_cast<uintptr_t>(ring) % CACHE_LINE_SIZE == 0);
+    using Oversized = std::array<char, 4 * 1024 * 1024>;
+    assert(arena.create<Oversized>() == nullptr);
+    
+    // Provisioning never changes live contents
+    memory::MemoryProvisioner provisioner;
+    assert(provisioner.add("arena", arena.data(), arena.capacity(), arena.is_hugetlb()));
+    const memory::ProvisionReport report = provisioner.provision(false);
+    assert(report.regions == 1);
+    assert(report.bytes == arena.capacity());
+    assert(!report.all_locked);
+    assert((*table)[1023] == 42);
+    
+    // Once provisioned, the whole region is resident: touching it takes no
+    // faults (checked per region, not with the process-wide counter, which
+    // sanitizer shadow memory also moves)
+    const size_t pages = arena.capacity() / PAGE_SIZE;
+    assert(memory::resident_pages(arena.data(), arena.capacity()) == pages);
+    char* bytes = static_cast<char*>(arena.data());
+    for (size_t i = 0; i < arena.capacity(); i += PAGE_SIZE) {
+        bytes[i] = 1;
+    }
+    assert(memory::resident_pages(arena.data(), arena.capacity()) == pages);
+    
+    std::cout << "  Memory provisioning: PASSED" << std::endl;
+}
+
+// ============================================================================
+// CAL Parser Tests
+// ============================================================================
+
+static bool decimal(const char* text, int64_t& raw) {
+    FixedPoint value;
+    const size_t len = std::strlen(text);
+    if (!cal::parse_decimal(text, len, text + len, value)) {
+        return false;
+    }
+    raw = value.raw();
+    return true;
+}
+
+void test_decimal_parsing() {
+    std::cout << "  Testing decimal -> FixedPoint..." << std::endl;
+    
+    int64_t raw = 0;
+    assert(decimal("1", raw) && raw == PRICE_SCALE);
+    assert(decimal("0.00000001", raw) && raw == 1);
+    assert(decimal("67012.34", raw) && raw == 6701234000000LL);
+    assert(decimal("42150.12345678", raw) && raw == 4215012345678LL);
+    assert(decimal("0.5", raw) && raw == 50000000);
+    assert(decimal("-2.25", raw) && raw == -225000000);
+    assert(decimal("0000000000000001.0", raw) && raw == PRICE_SCALE);
+    assert(decimal("12345678901234567890.5", raw) == false);  // > 16 integer digits
+    
+    // Exact where double is not: 0.1 + 0.2 style prices survive bit-exact
+    assert(decimal("0.30000000", raw) && raw == 30000000);
+    assert(decimal("92233720367.99999999", raw) && raw == 9223372036799999999LL);
+    
+    // Beyond 8 decimals: truncated, not rounded
+    assert(decimal("0.123456789", raw) && raw == 12345678);
+    
+    // Rejected
+    assert(!decimal("", raw));
+    assert(!decimal(".5", raw));
+    assert(!decimal("5.", raw));
+    assert(!decimal("1e5", raw));
+    assert(!decimal("12a", raw));
+    assert(!decimal("92233720368", raw));   // Overflow
+    
+    // Digits continuing past the span (SIMD sees them) are not consumed
+    const char* text = "123.45678901234567890123456789";
+    FixedPoint value;
+    assert(cal::parse_decimal(text, 5, text + std::strlen(text), value));
+    assert(value.raw() == 12340000000LL);
+    
+    // Vector path (16 readable bytes) and scalar path (exact buffer) agree
+    const char* samples[] = {"0.00000001", "42150.12345678", "7", "9999999.99999999",
+                             "12345678.5", "0.123456789", "1.", "-3.5", "1.2.3", ".",
+                             "", "12345", "00.10", "1234567.0000000001"};
+    for (const char* sample : samples) {
+        const size_t len = std::strlen(sample);
+        char padded[32];
+        std::memset(padded, '"', sizeof(padded));
+        std::memcpy(padded, sample, len);
+        FixedPoint exact, vector;
+        const bool exact_ok = cal::parse_decimal(sample, len, sample + len, exact);
+        const bool vector_ok = cal::parse_decimal(padded, len, padded + sizeof(padded), vector);
+        assert(exact_ok == vector_ok);
+        assert(!exact_ok || exact.raw() == vector.raw());
+    }
+    
+    std::cout << "  Decimal parsing: PASSED" << std::endl;
+}
+
+void test_symbol_interner() {
+    std::cout << "  Testing symbol interner..." << std::endl;
+    
+    cal::SymbolInterner symbols;
+    uint32_t id = 0;
+    assert(!symbols.find(ExchangeId::BINANCE, "BTCUSDT", id));   // Empty table
+    
+    assert(symbols.add(ExchangeId::BINANCE, "BTCUSDT", 1));
+    assert(symbols.add(ExchangeId::COINBASE, "BTC-USD", 1));
+    assert(symbols.add(ExchangeId::COINBASE, "BTCUSDT", 7));     // Same name, other venue
+    assert(symbols.add(ExchangeId::BINANCE, "ABCDEFGHIJKLMNOPQRSTUVWX", 9));   // 24 chars
+    assert(!symbols.add(ExchangeId::BINANCE, "ABCDEFGHIJKLMNOPQRSTUVWXY", 9));
+    assert(!symbols.add(ExchangeId::BINANCE, "", 2));
+    assert(!symbols.add(ExchangeId::BINANCE, "ETHUSDT", cal::MAX_VALID_SYMBOL_ID));
+    assert(symbols.size() == 4);
+    
+    assert(symbols.find(ExchangeId::BINANCE, "BTCUSDT", id) && id == 1);
+    assert(symbols.find(ExchangeId::COINBASE, "BTCUSDT", id) && id == 7);
+    assert(symbols.find(ExchangeId::COINBASE, "BTC-USD", id) && id == 1);
+    assert(symbols.find(ExchangeId::BINANCE, "ABCDEFGHIJKLMNOPQRSTUVWX", id) && id == 9);
+    assert(!symbols.find(ExchangeId::BINANCE, "BTC-USD", id));
+    assert(!symbols.find(ExchangeId::BINANCE, "BTCUSD", id));    // Prefix
+    assert(!symbols.find(ExchangeId::BINANCE, "BTCUSDTX", id));  // Extension
+    
+    // Re-pointing keeps the key count
+    assert(symbols.add(ExchangeId::BINANCE, "BTCUSDT", 3));
+    assert(symbols.size() == 4);
+    assert(symbols.find(ExchangeId::BINANCE, "BTCUSDT", id) && id == 3);
+    
+    // In place: bytes after the name (SIMD load) must not matter, at any
+    // distance from the end of the buffer (scalar fallback)
+    const std::string json = R"({"s":"BTCUSDT","p":"1"})";
+    assert(symbols.find(ExchangeId::BINANCE, json.data() + 6, 7, json.data() + json.size(), id));
+    assert(id == 3);
+    for (size_t tail = 0; tail < 40; ++tail) {
+        std::string buffer = "BTC-USD" + std::string(tail, 'Z');
+        id = 0;
+        assert(symbols.find(ExchangeId::COINBASE, buffer.data(), 7,
+                            buffer.data() + buffer.size(), id) && id == 1);
+    }
+    
+    // Full table: every key resolves to its own id, near misses do not
+    cal::SymbolInterner full;
+    for (uint32_t i = 0; i < cal::SymbolInterner::MAX_KEYS; ++i) {
+        const ExchangeId venue = (i % 2) ? ExchangeId::COINBASE : ExchangeId::BINANCE;
+        assert(full.add(venue, "SYM" + std::to_string(i), i % cal::MAX_VALID_SYMBOL_ID));
+    }
+    assert(!full.add(ExchangeId::BINANCE, "ONE-TOO-MANY", 1));
+    assert(full.size() == cal::SymbolInterner::MAX_KEYS);
+    for (uint32_t i = 0; i < cal::SymbolInterner::MAX_KEYS; ++i) {
+        const ExchangeId venue = (i % 2) ? ExchangeId::COINBASE : ExchangeId::BINANCE;
+        const ExchangeId other = (i % 2) ? ExchangeId::BINANCE : ExchangeId::COINBASE;
+        const std::string name = "SYM" + std::to_string(i);
+        assert(full.find(venue, name, id) && id == i % cal::MAX_VALID_SYMBOL_ID);
+        assert(!full.find(other, name, id));
+        assert(!full.find(venue, name + "!", id));
+    }
+    
+    // Id bitmap
+    cal::SymbolTable table;
+    table.add_symbol(1);
+    table.add_symbol(1);
+    table.add_symbol(255);
+    table.add_symbol(256);
+    assert(table.count() == 2);
+    assert(table.is_valid(1) && table.is_valid(255));
+    assert(!table.is_valid(0) && !table.is_valid(256) && !table.is_valid(~0ULL));
+    table.clear();
+    assert(table.count() == 0 && !table.is_valid(1));
+    
+    std::cout << "  Symbol interner: PASSED" << std::endl;
+}
+
+void test_json_parser() {
+    std::cout << "  Testing JSON trade/quote parser..." << std::endl;
+    
+    cal::JsonParser parser;
+    assert(parser.add_symbol("BTCUSDT", 1));
+    assert(parser.add_symbol("BTC-USD", 1));
+    assert(parser.add_symbol("ETHUSDT", 2));
+    assert(!parser.add_symbol("", 3));
+    assert(parser.symbols().size() == 3);
+    
+    cal::ParsedMessage out;
+    auto parse = [&](const char* json) {
+        return parser.parse(json, std::strlen(json), out);
+    };
+    
+    // Binance trade
+    assert(parse(R"({"e":"trade","E":1705312800000,"s":"BTCUSDT","t":3375000001,)"
+                 R"("p":"42150.12000000","q":"0.00150000","T":1705312799999,"m":true,"M":true})")
+           == cal::ParseStatus::TRADE);
+    assert(out.count == 1);
+    assert(out.records[0].symbol_id == 1);
+    assert(out.records[0].price.raw() == 4215012000000LL);
+    assert(out.records[0].quantity.raw() == 150000);
+    assert(out.records[0].flags == MD_FLAG_TRADE);
+    assert(out.records[0].exchange_id == static_cast<uint8_t>(ExchangeId::BINANCE));
+    assert(out.records[0].venue_seq == 3375000001ULL);
+    assert(out.records[0].exchange_ts_ns == 1705312800000ULL * 1000000);   // "E", ms
+    
+    // Binance aggTrade: "a" is the aggregate trade id, never an ask price
+    assert(parse(R"({"e":"aggTrade","E":1705312800000,"s":"BTCUSDT","a":26129,"p":"42150.12",)"
+                 R"("q":"0.5","f":100,"l":105,"T":1705312799999,"m":true})")
+           == cal::ParseStatus::TRADE);
+    assert(out.count == 1 && out.records[0].flags == MD_FLAG_TRADE);
+    assert(out.records[0].venue_seq == 26129);
+    assert(out.records[0].price.raw() == 4215012000000LL);
+    assert(parse(R"({"a":26130,"s":"BTCUSDT","p":"42150.13","q":"0.5","e":"aggTrade"})")
+           == cal::ParseStatus::TRADE);   // Id before the event type
+    assert(out.records[0].venue_seq == 26130);
+    
+    // Combined-stream wrapper, whitespace
+    assert(parse(R"({"stream":"ethusdt@trade", "data": {"e": "trade", "s": "ETHUSDT", )"
+                 R"("p": "2530.5", "q": "1"}})") == cal::ParseStatus::TRADE);
+    assert(out.records[0].symbol_id == 2 && out.records[0].price.raw() == 253050000000LL);
+    assert(out.records[0].venue_seq == 0);   // No trade id: not sequenced
+    
+    // Binance spot bookTicker (no event type) -> bid + ask
+    assert(parse(R"({"u":400900217,"s":"BTCUSDT","b":"42149.99","B":"31.21","a":"42150.01","A":"40.66"})")
+           == cal::ParseStatus::QUOTE);
+    assert(out.count == 2);
+    assert(out.records[0].venue_seq == 400900217 && out.records[1].venue_seq == 400900217);
+    assert(out.records[0].exchange_ts_ns == 0);   // Spot bookTicker has no event time
+    assert(out.records[0].flags == MD_FLAG_BID && out.records[0].price.raw() == 4214999000000LL);
+    assert(out.records[1].flags == MD_FLAG_ASK && out.records[1].quantity.raw() == 4066000000LL);
+    
+    // Coinbase match and ticker
+    assert(parse(R"({"type":"match","trade_id":10,"maker_order_id":"a\"b","side":"sell",)"
+                 R"("size":"5.23512","price":"400.23","product_id":"BTC-USD","sequence":50,)"
+                 R"("time":"2024-01-15T10:00:01.982951Z"})")
+           == cal::ParseStatus::TRADE);
+    assert(out.records[0].symbol_id == 1 && out.records[0].quantity.raw() == 523512000);
+    assert(out.records[0].exchange_id == static_cast<uint8_t>(ExchangeId::COINBASE));
+    assert(out.records[0].venue_seq == 10);
+    assert(out.records[0].exchange_ts_ns == 1705312801982951000ULL);
+    assert(parse(R"({"type":"ticker","product_id":"BTC-USD","price":"400.23","best_bid":"400.22",)"
+                 R"("best_bid_size":"1.5","best_ask":"400.24","best_ask_size":"0.25"})")
+           == cal::ParseStatus::QUOTE);
+    assert(out.records[1].price.raw() == 40024000000LL);
+    assert(out.records[1].exchange_ts_ns == 0);
+    
+    // ISO 8601 event times (UTC only)
+    auto iso = [](const char* text) { return cal::parse_iso8601_ns(text, std::strlen(text)); };
+    assert(iso("2000-02-29T23:59:59.5Z") == 951868799500000000ULL);
+    assert(iso("2024-01-15T10:00:01Z") == 1705312801000000000ULL);
+    assert(iso("2024-01-15T10:00:01.1234567891Z") == 1705312801123456789ULL);
+    assert(iso("2024-01-15 10:00:01Z") == 0);
+    assert(iso("2024-01-15T10:00:01+01:00") == 0);
+    assert(iso("2024-13-15T10:00:01Z") == 0);
+    assert(iso("2024-01-15T10:00:01.Z") == 0);
+    
+    // Not market data
+    assert(parse(R"({"result":null,"id":1})") == cal::ParseStatus::IGNORED);
+    assert(parse(R"({"type":"subscriptions","channels":[{"name":"matches"}]})")
+           == cal::ParseStatus::IGNORED);
+    
+    // Failures
+    assert(parse(R"({"e":"trade","s":"DOGEUSDT","p":"0.08","q":"100"})")
+           == cal::ParseStatus::UNKNOWN_SYMBOL);
+    assert(parse(R"({"e":"trade","s":"BTCUSDT","p":"4215)") == cal::ParseStatus::MALFORMED);
+    assert(parse(R"({"e":"trade","s":"BTCUSDT","p":"1e5","q":"1"})") == cal::ParseStatus::MALFORMED);
+    assert(parse(R"({"e":"trade","s":"BTCUSDT","q":"1"})") == cal::ParseStatus::MALFORMED);
+    
+    // parse_trade: trades only
+    const char* quote = R"({"s":"BTCUSDT","b":"1","B":"1","a":"2","A":"1"})";
+    assert(!parser.parse_trade(quote, std::strlen(quote)));
+    const char* trade = R"({"e":"trade","s":"BTCUSDT","p":"1.5","q":"2"})";
+    const auto md = parser.parse_trade(trade, std::strlen(trade));
+    assert(md && md->price.raw() == 150000000);
+    
+    // Per-venue parsers: stamp their own venue, ignore the other venue's schema
+    cal::BinanceParser binance;
+    cal::CoinbaseParser coinbase;
+    assert(binance.add_symbol("BTCUSDT", 1) && coinbase.add_symbol("BTC-USD", 1));
+    const char* cb_match = R"({"type":"match","size":"1","price":"400.23","product_id":"BTC-USD"})";
+    const char* bn_trade = R"({"e":"trade","s":"BTCUSDT","p":"42150.5","q":"2"})";
+    assert(coinbase.parse(cb_match, std::strlen(cb_match), out) == cal::ParseStatus::TRADE);
+    assert(out.records[0].exchange_id == static_cast<uint8_t>(ExchangeId::COINBASE));
+    assert(binance.parse(bn_trade, std::strlen(bn_trade), out) == cal::ParseStatus::TRADE);
+    const char* bn_agg = R"({"e":"aggTrade","s":"BTCUSDT","a":7,"p":"1","q":"2"})";
+    assert(binance.parse_trade(bn_agg, std::strlen(bn_agg))->venue_seq == 7);
+    assert(out.records[0].exchange_id == static_cast<uint8_t>(ExchangeId::BINANCE));
+    assert(binance.parse(cb_match, std::strlen(cb_match), out) != cal::ParseStatus::TRADE);
+    assert(coinbase.parse(bn_trade, std::strlen(bn_trade), out) != cal::ParseStatus::TRADE);
+    
+    // Depth: parse() defers to parse_depth(), levels come out of for_each()
+    cal::DepthMessage depth;
+    std::vector<MarketData> levels;
+    auto parse_depth = [&](const char* json) {
+        levels.clear();
+        const cal::ParseStatus status = parser.parse_depth(json, std::strlen(json), depth);
+        if (status == cal::ParseStatus::DEPTH &&
+            depth.for_each([&](const MarketData& level) { levels.push_back(level); }) < 0) {
+            return cal::ParseStatus::MALFORMED;
+        }
+        return status;
+    };
+    const char* bn_depth = R"({"e":"depthUpdate","E":1705312800000,"s":"BTCUSDT","U":157,"u":160,)"
+                           R"("b":[["42150.10","0.5"],["42150.00","0"]],"a":[["42150.20","1.25"]]})";
+    assert(parse(bn_depth) == cal::ParseStatus::DEPTH);
+    assert(parse_depth(bn_depth) == cal::ParseStatus::DEPTH);
+    assert(!depth.snapshot && depth.first_id == 157 && depth.last_id == 160);
+    assert(depth.venue == ExchangeId::BINANCE && depth.event_ns == 1705312800000ULL * 1000000);
+    assert(levels.size() == 3);
+    assert(levels[0].flags == (MD_FLAG_DEPTH | MD_FLAG_BID) && levels[0].price.raw() == 4215010000000LL);
+    assert(levels[1].quantity.raw() == 0);
+    assert(levels[2].flags == (MD_FLAG_DEPTH | MD_FLAG_ASK) && levels[2].quantity.raw() == 125000000);
+    assert(levels[2].symbol_id == 1 && levels[2].venue_seq == 160);
+    
+    assert(parse_depth(R"({"type":"snapshot","product_id":"BTC-USD","bids":[["400.22","1.5"]],)"
+                       R"("asks":[["400.24","0.25"],["400.25","2"]]})") == cal::ParseStatus::DEPTH);
+    assert(depth.snapshot && depth.venue == ExchangeId::COINBASE && levels.size() == 3);
+    assert(levels[0].flags == (MD_FLAG_DEPTH | MD_FLAG_BID | MD_FLAG_BOOK_RESET));
+    assert(levels[1].flags == (MD_FLAG_DEPTH | MD_FLAG_ASK));
+    assert(parse_depth(R"({"type":"l2update","product_id":"BTC-USD","changes":[["buy","400.21","3"],)"
+                       R"(["sell","400.24","0"]],"time":"2024-01-15T10:00:01.982951Z"})")
+           == cal::ParseStatus::DEPTH);
+    assert(levels.size() == 2 && levels[0].flags == (MD_FLAG_DEPTH | MD_FLAG_BID));
+    assert(levels[1].flags == (MD_FLAG_DEPTH | MD_FLAG_ASK) && levels[1].quantity.raw() == 0);
+    assert(depth.event_ns == 1705312801982951000ULL);
+    
+    assert(parse_depth(bn_trade) == cal::ParseStatus::IGNORED);
+    assert(parse_depth(R"({"e":"depthUpdate","s":"DOGEUSDT","b":[],"a":[]})")
+           == cal::ParseStatus::UNKNOWN_SYMBOL);
+    assert(parse_depth(R"({"e":"depthUpdate","s":"BTCUSDT","u":1})") == cal::ParseStatus::MALFORMED);
+    assert(parse_depth(R"({"type":"l2update","product_id":"BTC-USD","changes":[["hold","1","1"]]})")
+           == cal::ParseStatus::MALFORMED);
+    assert(parse_depth(R"({"e":"depthUpdate","s":"BTCUSDT","b":[["1","1"],["2")")
+           == cal::ParseStatus::MALFORMED);
+    
+    std::cout << "  JSON parser: PASSED" << std::endl;
+}
+
+MarketData make_tick(uint32_t symbol_id, int64_t price_raw, int64_t qty_raw = PRICE_SCALE) {
+    MarketData md{};
+    md.symbol_id = symbol_id;
+    md.price = FixedPoint(price_raw);
+    md.quantity = FixedPoint(qty_raw);
+    md.flags = MD_FLAG_TRADE;
+    return md;
+}
+
+// Stand-in for a venue REST snapshot: synthesizes the requested trades
+struct TestSnapshotSource {
+    std::atomic<uint32_t> fetches{0};
+    std::atomic<uint64_t> cover_until{0};   // Next answer stops here (once); 0: full range
+    std::atomic<bool> fail{false};
+
+    bool fetch(const cal::SnapshotRequest& request, cal::Snapshot& out) {
+        fetches.fetch_add(1);
+        if (fail.load()) {
+            return false;
+        }
+        const uint64_t limit = cover_until.exchange(0);
+        out.last_seq = (limit != 0 && limit < request.to_seq) ? limit : request.to_seq;
+        for (uint64_t seq = request.from_seq; seq <= out.last_seq; ++seq) {
+            MarketData md = make_tick(request.symbol_id, static_cast<int64_t>(seq) * PRICE_SCALE);
+            md.venue_seq = seq;
+            out.records.push_back(md);
+        }
+        return true;
+    }
+};
+
+void test_feed_recovery() {
+    std::cout << "  Testing feed recovery..." << std::endl;
+    
+    using Recovery = cal::FeedRecovery<TestSnapshotSource>;
+    cal::RecoveryConfig config;
+    config.timeout_ns = 1000;
+    config.max_attempts = 2;
+    
+    std::vector<uint64_t> emitted;
+    std::vector<uint16_t> emitted_flags;
+    auto emit = [&](MarketData& md) {
+        emitted.push_back(md.venue_seq);
+        emitted_flags.push_back(md.flags);
+    };
+    auto trade = [](uint32_t symbol, uint64_t seq) {
+        MarketData md = make_tick(symbol, 100 * PRICE_SCALE);
+        md.venue_seq = seq;
+        return md;
+    };
+    // Poll until the worker has answered and the stream is LIVE again
+    auto settle = [&](Recovery& recovery, uint64_t symbol, uint64_t now) {
+        for (int i = 0; i < 2000 && recovery.recovering(symbol); ++i) {
+            recovery.poll(now, emit);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+    
+    // In order, duplicates, untracked ticks
+    {
+        auto recovery = std::make_unique<Recovery>(ExchangeId::BINANCE, config);
+        MarketData md = trade(1, 100);
+        assert(recovery->admit(md, 0) && recovery->next_seq(1) == 101);
+        md = trade(1, 101);
+        assert(recovery->admit(md, 0) && md.flags == MD_FLAG_TRADE);
+        md = trade(1, 101);
+        assert(!recovery->admit(md, 0) && recovery->stats().duplicates == 1);
+        md = trade(1, 0);
+        assert(recovery->admit(md, 0));                    // No trade id
+        md = make_tick(1, 100 * PRICE_SCALE);
+        md.flags = MD_FLAG_BID;
+        md.venue_seq = 5000;
+        assert(recovery->admit(md, 0));                    // Quotes are not tracked
+        assert(recovery->poll(0, emit) == 0 && recovery->stats().gaps == 0);
+    }
+    
+    // Gap -> buffer -> snapshot -> ordered replay flagged RESYNCED
+    {
+        auto recovery = std::make_unique<Recovery>(ExchangeId::BINANCE, config);
+        recovery->start();
+        MarketData md = trade(1, 10);
+        assert(recovery->admit(md, 0));
+        md = trade(1, 14);                                 // 11..13 missing
+        assert(!recovery->admit(md, 0) && recovery->recovering(1));
+        md = trade(1, 15);
+        assert(!recovery->admit(md, 0));                   // Buffered behind the gap
+        md = trade(2, 7);
+        assert(recovery->admit(md, 0));                    // Other symbols unaffected
+        
+        settle(*recovery, 1, 0);
+        assert(!recovery->recovering(1));
+        assert((emitted == std::vector<uint64_t>{11, 12, 13, 14, 15}));
+        for (uint16_t flags : emitted_flags) {
+            assert(flags == (MD_FLAG_TRADE | MD_FLAG_RESYNCED));
+        }
+        assert(recovery->stats().gaps == 1 && recovery->stats().recovered == 1);
+        assert(recovery->stats().replayed == 5);
+        
+        md = trade(1, 16);
+        assert(recovery->admit(md, 0) && md.flags == MD_FLAG_TRADE);
+        
+        // Snapshot ends early: the rest of the hole is requested again
+        emitted.clear();
+        recovery->source().cover_until = 18;
+        md = trade(1, 20);
+        assert(!recovery->admit(md, 0));
+        settle(*recovery, 1, 0);
+        assert(!recovery->recovering(1));
+        assert((emitted == std::vector<uint64_t>{17, 18, 19, 20}));
+        assert(recovery->source().fetches == 3);
+        recovery->stop();
+    }
+    
+    // The hole fills live (late frames, another leg) before any snapshot
+    {
+        auto recovery = std::make_unique<Recovery>(ExchangeId::BINANCE, config);
+        emitted.clear();
+        emitted_flags.clear();
+        MarketData md = trade(5, 10);
+        assert(recovery->admit(md, 0));
+        md = trade(5, 14);
+        assert(!recovery->admit(md, 0));
+        md = trade(5, 13);
+        assert(!recovery->admit(md, 0));                   // Buffered in order
+        md = trade(5, 11);
+        assert(recovery->admit(md, 0));                    // Next expected: published now
+        md = trade(5, 12);
+        assert(recovery->admit(md, 0));
+        md = trade(5, 11);
+        assert(!recovery->admit(md, 0));                   // Duplicate
+        assert(recovery->poll(0, emit) == 2 && !recovery->recovering(5));
+        assert((emitted == std::vector<uint64_t>{13, 14}));
+        assert(emitted_flags[0] == (MD_FLAG_TRADE | MD_FLAG_RESYNCED));
+        assert(recovery->next_seq(5) == 15 && recovery->stats().recovered == 1);
+    }
+    
+    // Snapshot failures: retried, then released with the first tick STALE
+    {
+        auto recovery = std::make_unique<Recovery>(ExchangeId::COINBASE, config);
+        recovery->source().fail = true;
+        recovery->start();
+        emitted.clear();
+        emitted_flags.clear();
+        MarketData md = trade(3, 1);
+        assert(recovery->admit(md, 0));
+        md = trade(3, 5);
+        assert(!recovery->admit(md, 0));
+        md = trade(3, 6);
+        assert(!recovery->admit(md, 0));
+        
+        settle(*recovery, 3, 0);
+        assert(!recovery->recovering(3));
+        assert(recovery->source().fetches == config.max_attempts);
+        assert((emitted == std::vector<uint64_t>{5, 6}));
+        assert(emitted_flags[0] == (MD_FLAG_TRADE | MD_FLAG_STALE));
+        assert(emitted_flags[1] == MD_FLAG_TRADE);
+        assert(recovery->stats().stale == 1 && recovery->next_seq(3) == 7);
+        recovery->stop();
+    }
+    
+    // No worker: attempts time out; buffer overflow re-baselines
+    {
+        cal::RecoveryConfig small = config;
+        small.max_buffered = 2;
+        auto recovery = std::make_unique<Recovery>(ExchangeId::BINANCE, small);
+        emitted.clear();
+        emitted_flags.clear();
+        MarketData md = trade(4, 1);
+        assert(recovery->admit(md, 0));
+        for (uint64_t seq = 3; seq <= 5; ++seq) {
+            md = trade(4, seq);
+            assert(!recovery->admit(md, 0));               // 5 overflows
+        }
+        assert(recovery->stats().overflows == 1);
+        recovery->poll(100, emit);
+        assert(!recovery->recovering(4));
+        assert((emitted == std::vector<uint64_t>{3, 4}) && (emitted_flags[0] & MD_FLAG_STALE));
+        md = trade(4, 9);
+        assert(recovery->admit(md, 200) && (md.flags & MD_FLAG_STALE));
+        assert(recovery->next_seq(4) == 10);
+    }
+    
+    // No snapshot endpoint: the gap's tick goes out at once, flagged STALE
+    {
+        static_assert(!cal::can_fetch_v<cal::NoSnapshotSource>);
+        static_assert(cal::can_fetch_v<TestSnapshotSource>);
+        auto recovery = std::make_unique<cal::FeedRecovery<cal::NoSnapshotSource>>(
+            ExchangeId::COINBASE, config);
+        recovery->start();                                 // No worker to start
+        MarketData md = trade(6, 1);
+        assert(recovery->admit(md, 0));
+        md = trade(6, 4);
+        assert(recovery->admit(md, 0) && (md.flags & MD_FLAG_STALE));
+        assert(!recovery->recovering(6) && recovery->recovering_count() == 0);
+        assert(recovery->stats().gaps == 1 && recovery->stats().stale == 1);
+        md = trade(6, 5);
+        assert(recovery->admit(md, 0) && md.flags == MD_FLAG_TRADE);
+        md = trade(6, 3);
+        assert(!recovery->admit(md, 0));                   // Behind the gap: duplicate
+        assert(recovery->next_seq(6) == 6);
+        recovery->stop();
+    }
+    
+    std::cout << "  Feed recovery: PASSED" << std::endl;
+}
+
+void test_feed_arbiter() {
+    std::cout << "  Testing feed arbiter..." << std::endl;
+    
+    auto arbiter = std::make_unique<cal::FeedArbiter>();
+    auto trade = [](uint32_t symbol, uint64_t seq) {
+        MarketData md = make_tick(symbol, 100 * PRICE_SCALE);
+        md.venue_seq = seq;
+        return md;
+    };
+    
+    // One leg: everything passes, nothing is tracked
+    assert(arbiter->accept(trade(1, 5), 0, 0) && arbiter->accept(trade(1, 5), 0, 0));
+    assert(arbiter->leg(0).wins == 0);
+    
+    arbiter->configure(2);
+    assert(arbiter->legs() == 2);
+    
+    // A wins 100, B wins 101; each later copy is dropped and its lag recorded
+    assert(arbiter->accept(trade(1, 100), 0, 1000));
+    assert(!arbiter->accept(trade(1, 100), 1, 1000 + 3000));   // B 3us late
+    assert(arbiter->accept(trade(1, 101), 1, 5000));
+    assert(!arbiter->accept(trade(1, 101), 0, 5000 + 500));    // A 0.5us late
+    assert(arbiter->leg(0).wins == 1 && arbiter->leg(0).duplicates == 1);
+    assert(arbiter->leg(1).wins == 1 && arbiter->leg(1).duplicates == 1);
+    assert(arbiter->leg(0).win_rate() == 0.5);
+    assert(arbiter->leg(1).lag.buckets[2] == 1);   // [2us, 4us)
+    assert(arbiter->leg(0).lag.buckets[0] == 1);   // < 1us
+    assert(arbiter->leg(1).lag.percentile(50.0) == 4096);
+    
+    // B lost 102 and 103: A's copies are first even though they trail 104
+    assert(arbiter->accept(trade(1, 104), 1, 6000));
+    assert(arbiter->accept(trade(1, 102), 0, 6100));
+    assert(arbiter->accept(trade(1, 103), 0, 6200));
+    assert(!arbiter->accept(trade(1, 104), 0, 6300));
+    assert(!arbiter->accept(trade(1, 103), 1, 6400));
+    
+    // Beyond the window: long delivered
+    assert(arbiter->accept(trade(1, 104 + cal::FeedArbiter::WINDOW), 0, 7000));
+    assert(!arbiter->accept(trade(1, 104), 1, 7100));
+    
+    // Streams are independent: per symbol, trades apart from quotes
+    assert(arbiter->accept(trade(2, 100), 1, 8000));
+    MarketData bid = trade(1, 100);
+    bid.flags = MD_FLAG_BID;
+    assert(arbiter->accept(bid, 1, 8000) && !arbiter->accept(bid, 0, 8100));
+    
+    // No venue id: preferred leg only
+    assert(arbiter->accept(trade(1, 0), 0, 9000));
+    assert(!arbiter->accept(trade(1, 0), 1, 9000));
+    assert(arbiter->unsequenced_dropped() == 1);
+    
+    std::cout << "  Feed arbiter: PASSED" << std::endl;
+}
+
+void test_feed_latency() {
+    std::cout << "  Testing feed latency..." << std::endl;
+    
+    auto latency = std::make_unique<cal::FeedLatency>();
+    const uint64_t event_ns = 1705312800000ULL * 1000000;
+    latency->record(0, event_ns);                      // No event time: ignored
+    latency->record(event_ns, event_ns + 3000000);     // 3ms
+    latency->record(event_ns, event_ns + 5000000);     // 5ms
+    latency->record(event_ns + 1000, event_ns);        // Venue clock ahead
+    
+    assert(latency->count() == 2 && latency->ahead() == 1);
+    assert(latency->mean() == 4000000);
+    assert(latency->histogram().buckets[12] == 1);     // [2^11, 2^12) ~us
+    assert(latency->histogram().buckets[13] == 1);     // [2^12, 2^13) ~us
+    assert(latency->percentile(25.0) == 1024ULL << 12);
+    assert(latency->percentile(99.0) == 1024ULL << 13);
+    
+    // Minutes behind land in the open-ended last bucket
+    latency->record(event_ns, event_ns + 60 * NANOS_PER_SEC);
+    assert(latency->histogram().buckets[cal::FeedLatency::Histogram::NUM_BUCKETS - 1] == 1);
+    
+    std::cout << "  Feed latency: PASSED" << std::endl;
+}
+
+void test_price_band() {
+    std::cout << "  Testing price band validator..." << std::endl;
+    
+    using cal::ValidationStatus;
+    constexpr int64_t P = 100 * PRICE_SCALE;
+    auto band = std::make_unique<cal::PriceBandValidator>();   // +/-10%, reject, re-anchor after 3
+    auto check = [&](uint32_t symbol, int64_t price) {
+        MarketData md = make_tick(symbol, price);
+        return band->validate(md).status;
+    };
+    
+    // First tick seeds; the band follows the last accepted price
+    assert(check(1, P) == ValidationStatus::ACCEPT);
+    assert(band->reference(1).raw() == P);
+    assert(check(1, P * 109 / 100) == ValidationStatus::ACCEPT);
+    assert(check(1, P) == ValidationStatus::ACCEPT);
+    assert(check(1, P * 111 / 100) == ValidationStatus::REJECT);
+    assert(check(1, P * 89 / 100) == ValidationStatus::REJECT);
+    assert(band->reference(1).raw() == P);
+    assert(check(2, 5 * P) == ValidationStatus::ACCEPT);   // Independent symbols
+    
+    // Stateless checks still apply
+    assert(check(cal::MAX_VALID_SYMBOL_ID, P) == ValidationStatus::REJECT);
+    assert(check(1, 0) == ValidationStatus::REJECT);
+    
+    // A lone bad print does not move the reference; agreeing ones re-anchor
+    assert(check(1, 2 * P) == ValidationStatus::REJECT);
+    assert(check(1, P) == ValidationStatus::ACCEPT);            // Breaks the run
+    assert(check(1, 2 * P) == ValidationStatus::REJECT);
+    assert(check(1, 3 * P) == ValidationStatus::REJECT);        // Disagrees: new run
+    assert(check(1, 3 * P + P / 100) == ValidationStatus::REJECT);
+    assert(check(1, 3 * P - P / 100) == ValidationStatus::WARN); // Third agreeing
+    assert(band->reference(1).raw() == 3 * P - P / 100);
+    assert(band->reanchors() == 1);
+    
+    // Flag mode passes outliers through marked
+    cal::PriceBandConfig flag_config;
+    flag_config.band_bps = 100;
+    flag_config.action = cal::BandAction::FLAG;
+    auto flag = std::make_unique<cal::PriceBandValidator>(flag_config);
+    MarketData md = make_tick(3, P);
+    assert(flag->validate(md).status == ValidationStatus::ACCEPT);
+    md = make_tick(3, P * 102 / 100);
+    assert(flag->validate(md).status == ValidationStatus::WARN);
+    assert(md.flags == (MD_FLAG_TRADE | MD_FLAG_OUTLIER));
+    assert(flag->reference(3).raw() == P && flag->outliers() == 1);
+    
+    // Batch: stateless failures, in-band, out-of-band, past the SIMD width
+    band->configure({});
+    MarketData frame[7] = {
+        make_tick(4, P),             // Seeds 4 (all unseeded in-band)
+        make_tick(~0u, P),           // Huge id (shares its lane with the flags)
+        make_tick(5, P, 0),          // Zero qty
+        make_tick(5, -P),            // Negative price
+        make_tick(4, 2 * P),         // Unseeded at frame start -> in band
+        make_tick(6, P),
+        make_tick(cal::MAX_VALID_SYMBOL_ID, P),
+    };
+    assert(band->validate_batch(frame, 7) == 0b0110001);
+    assert(band->reference(4).raw() == 2 * P);   // Last accepted in the frame
+    MarketData second[5] = {
+        make_tick(4, 2 * P + 1), make_tick(6, 2 * P), make_tick(4, P),
+        make_tick(6, P + 1), make_tick(4, 2 * P - 1),
+    };
+    assert(band->validate_batch(second, 5) == 0b11001);
+    
+    // Frames of one record behave exactly like validate()
+    auto scalar = std::make_unique<cal::PriceBandValidator>();
+    auto batched = std::make_unique<cal::PriceBandValidator>();
+    uint64_t state = 12345;
+    for (int i = 0; i < 20000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const uint32_t symbol = static_cast<uint32_t>(state >> 60) % 4;
+        const int64_t price = P + static_cast<int64_t>((state >> 20) % 40) * P / 100;   // +0..39%
+        MarketData a = make_tick(symbol, price);
+        MarketData b = a;
+        const bool accepted = scalar->validate(a).status != ValidationStatus::REJECT;
+        assert(batched->validate_batch(&b, 1) == (accepted ? 1u : 0u));
+        assert(scalar->reference(symbol).raw() == batched->reference(symbol).raw());
+    }
+    
+    std::cout << "  Price band: PASSED" << std::endl;
+}
+
+void test_websocket_protocol() {
+    std::cout << "  Testing WebSocket framing..." << std::endl;
+    
+    // RFC 6455 section 1.3 example
+    char accept[cal::ws::ACCEPT_KEY_LENGTH + 1];
+    cal::ws::websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ==", 24, accept);
+    assert(std::strcmp(accept, "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == 0);
+    
+    // Header round trip across the 7-bit / 16-bit / 64-bit length forms
+    for (uint64_t length : {0ull, 125ull, 126ull, 65535ull, 65536ull, 5000000000ull}) {
+        uint8_t header[cal::ws::MAX_FRAME_HEADER];
+        const size_t n = cal::ws::encode_frame_header(header, cal::ws::Opcode::BINARY, false,
+                                                      length, true, 0xA1B2C3D4);
+        cal::ws::FrameHeader decoded;
+        assert(cal::ws::parse_frame_header(header, n - 1, decoded) == cal::ws::FrameStatus::INCOMPLETE);
+        assert(cal::ws::parse_frame_header(header, n, decoded) == cal::ws::FrameStatus::COMPLETE);
+        assert(decoded.payload_length == length && decoded.header_length == n);
+        assert(decoded.opcode == cal::ws::Opcode::BINARY && !decoded.fin);
+        assert(decoded.masked && decoded.mask_key == 0xA1B2C3D4);
+    }
+    
+    // Reserved bits, unknown opcodes and fragmented control frames are errors
+    cal::ws::FrameHeader decoded;
+    const uint8_t rsv[2] = {0xC1, 0x00};
+    const uint8_t opcode3[2] = {0x83, 0x00};
+    const uint8_t fragmented_ping[2] = {0x09, 0x00};
+    assert(cal::ws::parse_frame_header(rsv, 2, decoded) == cal::ws::FrameStatus::PROTOCOL_ERROR);
+    assert(cal::ws::parse_frame_header(opcode3, 2, decoded) == cal::ws::FrameStatus::PROTOCOL_ERROR);
+    assert(cal::ws::parse_frame_header(fragmented_ping, 2, decoded) == cal::ws::FrameStatus::PROTOCOL_ERROR);
+    
+    // Vector masking matches the byte-wise definition, in one go or in pieces
+    std::vector<uint8_t> data(301), expected(301);
+    const uint32_t key = 0x11223344;
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+        expected[i] = data[i] ^ static_cast<uint8_t>(key >> ((i % 4) * 8));
+    }
+    std::vector<uint8_t> whole = data;
+    cal::ws::apply_mask(whole.data(), whole.size(), key);
+    assert(whole == expected);
+    std::vector<uint8_t> pieces = data;
+    cal::ws::apply_mask(pieces.data(), 37, key, 0);
+    cal::ws::apply_mask(pieces.data() + 37, 101, key, 37);
+    cal::ws::apply_mask(pieces.data() + 138, 163, key, 138);
+    assert(pieces == expected);
+    
+    std::cout << "  WebSocket framing: PASSED" << std::endl;
+}
+
+struct CollectingHandler {
+    std::vector<std::string>* messages;
+    void operator()(const char* data, size_t len) const noexcept {
+        messages->emplace_back(data, len);
+    }
+};
+
+void test_websocket_client() {
+    std::cout << "  Testing WebSocket client against local server..." << std::endl;
+    
+    // Host: carries the port unless it is the scheme's default
+    cal::WebSocketUrl parsed;
+    assert(cal::parse_websocket_url("wss://stream.binance.com:9443/ws", parsed));
+    assert(parsed.tls && parsed.port == "9443" && parsed.path == "/ws");
+    assert(cal::websocket_host(parsed) == "stream.binance.com:9443");
+    assert(cal::parse_websocket_url("wss://ws-feed.exchange.coinbase.com", parsed));
+    assert(cal::websocket_host(parsed) == "ws-feed.exchange.coinbase.com");
+    assert(cal::parse_websocket_url("ws://127.0.0.1:80/", parsed));
+    assert(cal::websocket_host(parsed) == "127.0.0.1");
+    
+    const std::string large_text(200, 'x');
+    const std::string huge_binary(70000, 'y');
+    std::atomic<bool> got_subscribe{false};
+    std::atomic<bool> got_pong{false};
+    std::atomic<bool> got_close{false};
+    
+    test::WsTestServer server;
+    server.start([&](test::WsTestServer& s) {
+        cal::ws::Opcode opcode;
+        std::string payload;
+        got_subscribe = s.read_frame(opcode, payload) && opcode == cal::ws::Opcode::TEXT &&
+                        payload == R"({"subscribe":"trades"})";
+        
+        s.send_text("hello");
+        s.send_text(large_text);
+        s.send_frame(cal::ws::Opcode::BINARY, huge_binary);
+        
+        // Fragmented message with a ping in the middle
+        s.send_frame(cal::ws::Opcode::TEXT, "frag-1|", false);
+        s.send_frame(cal::ws::Opcode::PING, "p1");
+        s.send_frame(cal::ws::Opcode::CONTINUATION, "frag-2|", false);
+        s.send_frame(cal::ws::Opcode::CONTINUATION, "frag-3", true);
+        got_pong = s.read_frame(opcode, payload) && opcode == cal::ws::Opcode::PONG &&
+                   payload == "p1";
+        
+        // Two frames split across three TCP writes
+        uint8_t header[cal::ws::MAX_FRAME_HEADER];
+        std::string bytes;
+        for (const char* text : {"split-a", "split-b"}) {
+            const size_t n = cal::ws::encode_frame_header(header, cal::ws::Opcode::TEXT, true,
+                                                          std::strlen(text), false, 0);
+            bytes.append(reinterpret_cast<const char*>(header), n).append(text);
+        }
+        s.send_raw(bytes.substr(0, 1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        s.send_raw(bytes.substr(1, 10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        s.send_raw(bytes.substr(11));
+        
+        s.send_close(cal::ws::CLOSE_NORMAL);
+        got_close = s.read_frame(opcode, payload) && opcode == cal::ws::Opcode::CLOSE;
+    });
+    
+    std::vector<std::string> messages;
+    cal::WebSocketConfig config;
+    config.url = server.url("/ws/btcusdt@trade");
+    config.subscribe_message = R"({"subscribe":"trades"})";
+    config.busy_poll = false;
+    cal::WebSocketClient<CollectingHandler, 256 * 1024> client(config, CollectingHandler{&messages});
+    
+    assert(client.connect());
+    assert(client.connected());
+    
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.poll(10) >= 0 && std::chrono::steady_clock::now() < deadline) {
+    }
+    server.join();
+    
+    assert(server.handshake_ok());
+    assert(server.request().find("GET /ws/btcusdt@trade HTTP/1.1") == 0);
+    assert(got_subscribe && got_pong && got_close);
+    
+    assert(messages.size() == 6);
+    assert(messages[0] == "hello");
+    assert(messages[1] == large_text);
+    assert(messages[2] == huge_binary);
+    assert(messages[3] == "frag-1|frag-2|frag-3");
+    assert(messages[4] == "split-a" && messages[5] == "split-b");
+    assert(client.stats().messages.load() == 6);
+    assert(client.stats().pings.load() == 1);
+    
+    // wss:// is refused: TLS belongs to a local terminator
+    cal::WebSocketConfig bad = config;
+    bad.url = "wss://127.0.0.1:1/";
+    cal::WebSocketClient<CollectingHandler, 16 * 1024> tls_client(bad, CollectingHandler{&messages});
+    assert(!tls_client.connect());
+    
+    std::cout << "  WebSocket client: PASSED" << std::endl;
+}
+
+static void run_network_thread(cal::IoBackend backend) {
+    constexpr size_t CONNECTIONS = 3;
+    constexpr int BURST = 300;
+    const std::string big(5000, 'z');
+    
+    std::atomic<int> finished{0};
+    std::atomic<int> pongs{0};
+    test::WsTestServer servers[CONNECTIONS];
+    for (size_t c = 0; c < CONNECTIONS; ++c) {
+        servers[c].start([&, c](test::WsTestServer& s) {
+            // Many frames coalesced into one write: several per provided
+            // buffer, some straddling two
+            std::string burst;
+            uint8_t header[cal::ws::MAX_FRAME_HEADER];
+            for (int i = 0; i < BURST; ++i) {
+                const std::string text = std::to_string(c) + ":" + std::to_string(i);
+                const size_t n = cal::ws::encode_frame_header(header, cal::ws::Opcode::TEXT, true,
+                                                              text.size(), false, 0);
+                burst.append(reinterpret_cast<const char*>(header), n).append(text);
+            }
+            s.send_raw(burst);
+            s.send_text(big);
+            s.send_frame(cal::ws::Opcode::TEXT, "frag-1|", false);
+            s.send_frame(cal::ws::Opcode::PING, "p");
+            s.send_frame(cal::ws::Opcode::CONTINUATION, "frag-2", true);
+            
+            cal::ws::Opcode opcode;
+            std::string payload;
+            if (s.read_frame(opcode, payload) && opcode == cal::ws::Opcode::PONG) {
+                pongs.fetch_add(1);
+            }
+            s.send_text("last");
+            s.send_close(cal::ws::CLOSE_NORMAL);
+            s.read_frame(opcode, payload);
+            finished.fetch_add(1);
+        });
+    }
+    
+    using Client = cal::WebSocketClient<CollectingHandler, 64 * 1024>;
+    std::vector<std::string> messages[CONNECTIONS];
+    std::vector<std::unique_ptr<Client>> clients;
+    
+    cal::NetworkConfig config;
+    config.backend = backend;
+    config.buffer_count = 16;
+    config.buffer_size = 1024;
+    cal::NetworkThread<Client> net(config);
+    for (size_t c = 0; c < CONNECTIONS; ++c) {
+        cal::WebSocketConfig ws_config;
+        ws_config.url = servers[c].url("/ws");
+        ws_config.connect_timeout_ms = 200;
+        clients.push_back(std::make_unique<Client>(ws_config, CollectingHandler{&messages[c]}));
+        assert(net.add(*clients.back()));
+    }
+    
+    assert(net.init());
+    if (net.backend() != backend) {
+        std::cout << "    (" << cal::to_string(backend) << " unavailable: "
+                  << net.fallback_reason() << ", ran on " << cal::to_string(net.backend())
+                  << ")" << std::endl;
+    }
+    
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (finished.load() < static_cast<int>(CONNECTIONS) &&
+           std::chrono::steady_clock::now() < deadline) {
+        net.poll(10);
+    }
+    net.shutdown();
+    for (auto& server : servers) {
+        server.join();
+    }
+    
+    assert(finished.load() == static_cast<int>(CONNECTIONS));
+    assert(pongs.load() == static_cast<int>(CONNECTIONS));
+    for (size_t c = 0; c < CONNECTIONS; ++c) {
+        assert(messages[c].size() == BURST + 3);
+        for (int i = 0; i < BURST; ++i) {
+            assert(messages[c][static_cast<size_t>(i)] ==
+                   std::to_string(c) + ":" + std::to_string(i));
+        }
+        assert(messages[c][BURST] == big);
+        assert(messages[c][BURST + 1] == "frag-1|frag-2");
+        assert(messages[c][BURST + 2] == "last");
+    }
+    assert(net.stats().disconnects.load() >= CONNECTIONS);
+}
+
+void test_network_thread() {
+    std::cout << "  Testing network thread (epoll, io_uring)..." << std::endl;
+    
+    cal::IoBackend backend;
+    assert(cal::parse_io_backend("epoll", backend) && backend == cal::IoBackend::EPOLL);
+    assert(cal::parse_io_backend("io_uring", backend) && backend == cal::IoBackend::IO_URING);
+    assert(!cal::parse_io_backend("select", backend));
+    
+    run_network_thread(cal::IoBackend::EPOLL);
+    run_network_thread(cal::IoBackend::IO_URING);
+    
+    std::cout << "  Network thread: PASSED" << std::endl;
+}
+
+struct RxStampHandler {
+    std::vector<timing::RxTimestamp>* stamps;
+    void operator()(const char*, size_t, const timing::RxTimestamp& rx) const noexcept {
+        stamps->push_back(rx);
+    }
+};
+
+static size_t put_cmsg(uint8_t* control, int type, const void* data, size_t len) {
+    cmsghdr header{};
+    header.cmsg_level = SOL_SOCKET;
+    header.cmsg_type = type;
+    header.cmsg_len = CMSG_LEN(len);
+    std::memcpy(control, &header, sizeof(header));
+    std::memcpy(control + CMSG_LEN(0), data, len);
+    return CMSG_SPACE(len);
+}
+
+static void assert_stamped(const std::vector<timing::RxTimestamp>& stamps,
+                           uint64_t before_ns, uint64_t after_ns) {
+    assert(stamps.size() == 3);
+    for (const auto& rx : stamps) {
+        assert(rx.clock != timing::RxClock::NONE);
+        assert(rx.realtime_ns >= before_ns && rx.realtime_ns <= after_ns);
+    }
+}
+
+void test_rx_timestamps() {
+    std::cout << "  Testing kernel receive timestamps..." << std::endl;
+    
+    // Control message decoding
+    alignas(cmsghdr) uint8_t control[cal::RX_CONTROL_SIZE] = {};
+    timing::RxTimestamp rx;
+    struct timespec stamps[3] = {{1, 5}, {0, 0}, {0, 0}};
+    size_t len = put_cmsg(control, SCM_TIMESTAMPING, stamps, sizeof(stamps));
+    assert(cal::read_rx_timestamp(control, len, rx));
+    assert(rx.clock == timing::RxClock::SOFTWARE && rx.realtime_ns == 1000000005ULL);
+    
+    stamps[2] = {2, 7};   // Raw hardware stamp wins over software
+    len = put_cmsg(control, SCM_TIMESTAMPING, stamps, sizeof(stamps));
+    assert(cal::read_rx_timestamp(control, len, rx));
+    assert(rx.clock == timing::RxClock::HARDWARE && rx.realtime_ns == 2000000007ULL);
+    
+    const int fd = 0;     // Unrelated message ahead of SO_TIMESTAMPNS
+    const struct timespec ns = {3, 9};
+    len = put_cmsg(control, SCM_RIGHTS, &fd, sizeof(fd));
+    len += put_cmsg(control + len, SCM_TIMESTAMPNS, &ns, sizeof(ns));
+    assert(cal::read_rx_timestamp(control, len, rx));
+    assert(rx.clock == timing::RxClock::SOFTWARE && rx.realtime_ns == 3000000009ULL);
+    assert(!cal::read_rx_timestamp(control, 0, rx));
+    
+    // Frames sent with the handshake response would arrive unstamped:
+    // wait for the subscription first
+    auto serve = [](test::WsTestServer& s) {
+        cal::ws::Opcode opcode;
+        std::string payload;
+        s.read_frame(opcode, payload);
+        for (const char* text : {"a", "b", "c"}) {
+            s.send_text(text);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        s.send_close(cal::ws::CLOSE_NORMAL);
+        s.read_frame(opcode, payload);
+    };
+    
+    // Epoll-style client: recvmsg with a control buffer
+    {
+        const uint64_t before_ns = timing::get_realtime_ns();
+        test::WsTestServer server;
+        server.start(serve);
+        
+        std::vector<timing::RxTimestamp> received;
+        cal::WebSocketConfig config;
+        config.url = server.url("/ws");
+        config.subscribe_message = "sub";
+        config.busy_poll = false;
+        cal::WebSocketClient<RxStampHandler, 16 * 1024> client(config, RxStampHandler{&received});
+        assert(client.connect());
+        assert(client.rx_timestamps());
+        
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (client.poll(10) >= 0 && std::chrono::steady_clock::now() < deadline) {
+        }
+        server.join();
+        assert_stamped(received, before_ns, timing::get_realtime_ns());
+    }
+    
+    // io_uring network thread: multishot recvmsg
+    {
+        const uint64_t before_ns = timing::get_realtime_ns();
+        test::WsTestServer server;
+        server.start(serve);
+        
+        using Client = cal::WebSocketClient<RxStampHandler, 16 * 1024>;
+        std::vector<timing::RxTimestamp> received;
+        cal::WebSocketConfig ws_config;
+        ws_config.url = server.url("/ws");
+        ws_config.subscribe_message = "sub";
+        Client client(ws_config, RxStampHandler{&received});
+        
+        cal::NetworkConfig config;
+        config.backend = cal::IoBackend::IO_URING;
+        config.buffer_count = 16;
+        config.buffer_size = 1024;
+        cal::NetworkThread<Client> net(config);
+        assert(net.add(client));
+        assert(net.init());
+        
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (received.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+            net.poll(10);
+        }
+        net.shutdown();
+        server.join();
+        assert_stamped(received, before_ns, timing::get_realtime_ns());
+    }
+    
+    // The TSC mapping lands on the same clock
+    static const timing::TSCCalibrator calibrator;
+    const uint64_t realtime_ns = timing::get_realtime_ns();
+    const uint64_t mapped_ns = calibrator.tsc_to_realtime_ns(timing::rdtscp());
+    const uint64_t skew_ns = mapped_ns > realtime_ns ? mapped_ns - realtime_ns : realtime_ns - mapped_ns;
+    assert(skew_ns < 1000000);
+    
+    std::cout << "  Receive timestamps: PASSED" << std::endl;
+}
+
+void test_config_file() {
+    std::cout << "  Testing sage.toml reader..." << std::endl;
+    
+    config::ConfigFile file;
+    assert(file.parse("# comment\n"
+                      "name = \"SAGE\"  # trailing\n"
+                      "\n"
+                      "[risk]\n"
+                      "limit = 1_000_000\n"
+                      "ratio = 0.25\n"
+                      "negative = -3\n"
+                      "\n"
+                      "[exchanges.binance]\n"
+                      "enabled = true\n"
+                      "subscribe = '{\"a\":[1,2]}'\n"
+                      "escaped = \"x\\\"y\"\n"
+                      "cores = [1, 6, -1]\n"
+                      "[exchanges.coinbase]\n"
+                      "enabled = false\n"));
+    assert(file.get_string("name") == "SAGE");
+    assert(file.get_int("risk.limit") == 1000000);
+    assert(file.get_double("risk.ratio") == 0.25);
+    assert(file.get_double("risk.limit") == 1e6);
+    assert(file.get_int("risk.negative") == -3);
+    assert(file.get_bool("exchanges.binance.enabled"));
+    assert(!file.get_bool("exchanges.coinbase.enabled", true));
+    assert(file.get_string("exchanges.binance.subscribe") == "{\"a\":[1,2]}");
+    assert(file.get_string("exchanges.binance.escaped") == "x\"y");
+    std::vector<int64_t> cores;
+    assert(file.get_int_array("exchanges.binance.cores", cores));
+    assert(cores.size() == 3 && cores[1] == 6 && cores[2] == -1);
+    
+    // Missing -> default; wrong type -> default and an error
+    assert(file.get_int("risk.missing", 7) == 7 && file.last_error().empty());
+    assert(file.get_int("name", 7) == 7 && !file.last_error().empty());
+    
+    const std::vector<std::string> exchanges = file.subtables("exchanges");
+    assert(exchanges.size() == 2 && exchanges[0] == "binance" && exchanges[1] == "coinbase");
+    
+    // Unsupported or malformed input is rejected with its line
+    assert(!file.parse("a = 1\nb = {x = 1}\n"));
+    assert(file.last_error().compare(0, 6, "line 2") == 0);
+    assert(!file.parse("a = 1\na = 2\n"));
+    assert(!file.parse("[table\n"));
+    assert(!file.parse("a = \"open\n"));
+    assert(!file.parse("a = 12abc\n"));
+    assert(!file.parse("a = [1,\n2]\n"));
+    assert(!file.parse("a = [\"x\" \"y\"]\n"));
+    assert(file.parse("a = [ 1 , 2, ]\n") && file.get_int_array("a", cores) && cores.size() == 2);
+    
+    // The shipped config is readable (located relative to this source file)
+    const std::string source = __FILE__;
+    const std::string tests_dir = source.substr(0, source.find_last_of('/') + 1);
+    assert(file.load(tests_dir + "../config/sage.toml"));
+    assert(file.get_bool("exchanges.binance.enabled"));
+    
+    std::cout << "  sage.toml reader: PASSED" << std::endl;
+}
+
+// Records every message with the venue its connector was bound to
+struct VenueSink {
+    cal::BinanceParser binance;
+    cal::CoinbaseParser coinbase;
+    std::mutex mutex;
+    std::vector<MarketData> records;
+    std::atomic<uint32_t> received{0};
+    
+    template<ExchangeId Venue>
+    void on_message(const char* data, size_t len, uint32_t, const timing::RxTimestamp&) noexcept {
+        cal::ParsedMessage parsed;
+        const cal::ParseStatus status = (Venue == ExchangeId::BINANCE)
+            ? binance.parse(data, len, parsed) : coinbase.parse(data, len, parsed);
+        if (status == cal::ParseStatus::TRADE) {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.push_back(parsed.records[0]);
+        }
+        received.fetch_add(1, std::memory_order_release);
+    }
+};
+
+// Counts timer ticks per venue and leg
+struct TickSink {
+    uint32_t ticks[2][2] = {};
+    
+    template<ExchangeId Venue>
+    void on_message(const char*, size_t, uint32_t, const timing::RxTimestamp&) noexcept {}
+    
+    template<ExchangeId Venue>
+    void on_tick(uint32_t leg) noexcept {
+        ++ticks[Venue == ExchangeId::COINBASE][leg];
+    }
+};
+
+void test_connector_manager() {
+    std::cout << "  Testing connector manager..." << std::endl;
+    
+    assert(cal::exchange_from_name("binance") == ExchangeId::BINANCE);
+    assert(cal::exchange_from_name("kraken") == ExchangeId::UNKNOWN);
+    assert(std::strcmp(cal::to_string(ExchangeId::COINBASE), "coinbase") == 0);
+    
+    // Timer ticks reach the sink with the connector's venue and leg, even
+    // from a network thread with nothing connected (a sink without
+    // on_tick just doesn't get them)
+    {
+        TickSink ticks;
+        cal::NetworkConfig network;
+        network.backend = cal::IoBackend::EPOLL;
+        cal::NetworkThread<cal::WebSocketClient<cal::VenueHandler<TickSink>>> net(network);
+        cal::WebSocketConfig ws;
+        ws.url = "ws://127.0.0.1:1/";
+        ws.connect_timeout_ms = 10;
+        cal::WebSocketClient<cal::VenueHandler<TickSink>> binance(ws, {&ticks, ExchangeId::BINANCE, 0});
+        cal::WebSocketClient<cal::VenueHandler<TickSink>> coinbase(ws, {&ticks, ExchangeId::COINBASE, 1});
+        assert(net.add(binance) && net.add(coinbase) && net.init());
+        assert(net.poll(0) == 0 && net.poll(0) == 0);
+        assert(ticks.ticks[0][0] == 2 && ticks.ticks[1][1] == 2);
+        assert(ticks.ticks[0][1] == 0 && ticks.ticks[1][0] == 0);
+        net.shutdown();
+        
+        VenueSink silent;
+        cal::VenueHandler<VenueSink>{&silent, ExchangeId::BINANCE, 0}.tick();
+    }
+    
+    // Both venues send both schemas; each connector must only accept its own
+    auto feed = [](test::WsTestServer& server) {
+        server.send_text(R"({"e":"trade","s":"BTCUSDT","p":"42150.5","q":"2"})");
+        server.send_text(R"({"type":"match","size":"1","price":"400.23","product_id":"BTC-USD"})");
+        cal::ws::Opcode opcode;
+        std::string payload;
+        server.read_frame(opcode, payload);   // Hold until the client goes away
+    };
+    test::WsTestServer binance_server;
+    test::WsTestServer coinbase_server;
+    binance_server.start(feed);
+    coinbase_server.start(feed);
+    
+    config::ConfigFile file;
+    assert(file.parse("[cal]\n"
+                      "io_backend = \"epoll\"\n"
+                      "busy_poll = false\n"
+                      "network_cores = [-1, -1]\n"
+                      "[exchanges.binance]\n"
+                      "enabled = true\n"
+                      "websocket_url = \"wss://stream.binance.com:9443/ws\"\n"
+                      "connect_url = \"" + binance_server.url("/ws") + "\"\n"
+                      "[exchanges.coinbase]\n"
+                      "enabled = true\n"
+                      "connect_url = \"" + coinbase_server.url("/") + "\"\n"
+                      "subscribe = '{\"type\":\"subscribe\"}'\n"
+                      "[exchanges.kraken]\n"
+                      "enabled = false\n"));
+    cal::CalConfig cal_config;
+    std::string error;
+    assert(cal::read_cal_config(file, cal_config, error));
+    assert(cal_config.network.backend == cal::IoBackend::EPOLL && !cal_config.network.busy_poll);
+    assert(cal_config.connectors.size() == 2);
+    assert(cal_config.connectors[0].venue == ExchangeId::BINANCE);
+    assert(cal_config.connectors[0].websocket.host_header == "stream.binance.com:9443");
+    assert(cal_config.connectors[1].websocket.subscribe_message == "{\"type\":\"subscribe\"}");
+    
+    auto sink = std::make_unique<VenueSink>();
+    assert(sink->binance.add_symbol("BTCUSDT", 1) && sink->coinbase.add_symbol("BTC-USD", 1));
+    {
+        cal::ConnectorManager<VenueSink> manager;
+        assert(manager.configure(cal_config, *sink));
+        assert(manager.thread_count() == 2);
+        assert(manager.connectors()[0].thread == 0 && manager.connectors()[1].thread == 1);
+        
+        manager.start();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (sink->received.load(std::memory_order_acquire) < 4 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        manager.stop();
+    }
+    binance_server.join();
+    coinbase_server.join();
+    
+    assert(sink->received.load() == 4);
+    assert(sink->records.size() == 2);
+    bool saw_binance = false;
+    bool saw_coinbase = false;
+    for (const MarketData& record : sink->records) {
+        saw_binance |= record.exchange_id == static_cast<uint8_t>(ExchangeId::BINANCE) &&
+                       record.price.raw() == 4215050000000LL;
+        saw_coinbase |= record.exchange_id == static_cast<uint8_t>(ExchangeId::COINBASE) &&
+                        record.price.raw() == 40023000000LL;
+    }
+    assert(saw_binance && saw_coinbase);
+    assert(coinbase_server.request().find("Host: 127.0.0.1") != std::string::npos);
+    
+    // Rejected configurations
+    assert(file.parse("[exchanges.kraken]\nenabled = true\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[exchanges.binance]\nenabled = true\nwebsocket_url = \"wss://x/ws\"\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(error.find("TLS") != std::string::npos);
+    assert(file.parse("[cal]\nio_backend = \"select\"\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[cal]\nprice_band_action = \"ignore\"\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[cal]\nbuffer_count = -256\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(error.find("cal.buffer_count") != std::string::npos);
+    assert(file.parse("[cal]\nbuffer_count = 100\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[cal]\nbuffer_size = 0\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[cal]\nprice_band_bps = -5\n"));
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(file.parse("[cal]\nbusy_poll = \"yes\"\n"));   // No exchange enabled: still an error
+    assert(!cal::read_cal_config(file, cal_config, error));
+    assert(error.find("cal.busy_poll") != std::string::npos);
+    assert(file.parse("[cal]\nprice_band_action = \"flag\"\nprice_band_bps = 250\n"));
+    assert(cal::read_cal_config(file, cal_config, error));
+    assert(cal_config.price_band.action == cal::BandAction::FLAG);
+    assert(cal_config.price_band.band_bps == 250);
+    assert(file.parse("[exchanges.binance]\nenabled = true\nconnect_url = \"ws://h/\"\n"
+                      "cal_thread = 3\n"));
+    assert(cal::read_cal_config(file, cal_config, error));
+    cal::ConnectorManager<VenueSink> manager;
+    assert(!manager.configure(cal_config, *sink));
+    assert(manager.last_error().find("out of range") != std::string::npos);
+    
+    // Redundant legs: numbered per venue, kept on the venue's thread
+    const std::string legs = "[cal]\nnetwork_cores = [-1, -1]\n"
+                             "[exchanges.binance]\nenabled = true\nconnect_url = \"ws://h/\"\n"
+                             "[exchanges.coinbase]\nenabled = true\nconnect_url = \"ws://h/\"\n"
+                             "[exchanges.binance_b]\nenabled = true\nvenue = \"binance\"\n"
+                             "connect_url = \"ws://h2/\"\n";
+    assert(file.parse(legs));
+    assert(cal::read_cal_config(file, cal_config, error));
+    assert(cal_config.connectors.size() == 3 && cal_config.legs(ExchangeId::BINANCE) == 2);
+    assert(cal_config.connectors[2].venue == ExchangeId::BINANCE);
+    assert(cal_config.connectors[0].leg == 0 && cal_config.connectors[2].leg == 1);
+    assert(cal_config.connectors[1].leg == 0);
+    {
+        cal::ConnectorManager<VenueSink> legs_manager;
+        assert(legs_manager.configure(cal_config, *sink));
+        assert(legs_manager.connectors()[0].thread == 0);
+        assert(legs_manager.connectors()[1].thread == 1);
+        assert(legs_manager.connectors()[2].thread == 0);
+    }
+    assert(file.parse(legs + "cal_thread = 1\n"));
+    assert(cal::read_cal_config(file, cal_config, error));
+    {
+        cal::ConnectorManager<VenueSink> split_manager;
+        assert(!split_manager.configure(cal_config, *sink));
+        assert(split_manager.last_error().find("splits binance") != std::string::npos);
+    }
+    
+    std::cout << "  Connector manager: PASSED" << std::endl;
+}
+
 // ============================================================================
 // Timing Tests
 // ============================================================================
@@ -248,6 +2131,20 @@ void test_timing() {
     }
     assert(latency > 0);
     
+    // Virtual time (replay): every wall-clock read follows the messages,
+    // never backwards; TSC durations stay real
+    timing::TSCCalibrator calibrator;
+    timing::enable_virtual_time(1000);
+    assert(timing::virtual_time());
+    assert(timing::get_realtime_ns() == 1000 && timing::get_monotonic_ns() == 1000);
+    timing::advance_virtual_time(5000);
+    timing::advance_virtual_time(3000);   // Out-of-order venue
+    assert(timing::get_realtime_ns() == 5000);
+    assert(calibrator.tsc_to_realtime_ns(timing::rdtsc()) == 5000);
+    assert(calibrator.tsc_to_ns(calibrator.ns_to_tsc(1000000)) > 900000);
+    timing::disable_virtual_time();
+    assert(!timing::virtual_time() && timing::get_realtime_ns() > 5000);
+    
     std::cout << "  Timing: PASSED" << std::endl;
 }
 
@@ -283,11 +2180,13 @@ void benchmark_ring_buffer() {
     
     uint64_t cycles_per_op = (push_end - push_start) / ITERATIONS;
     
-    // Approximate nanoseconds (assuming ~3GHz)
-    double ns_per_op = cycles_per_op / 3.0;
+    // Convert with the measured TSC rate (same-thread only; see
+    // benchmark_spsc for cross-core handoff)
+    static const timing::TSCCalibrator calibrator;
+    double ns_per_op = static_cast<double>(cycles_per_op) / calibrator.get_ticks_per_ns();
     
     std::cout << "  Push+Pop: ~" << cycles_per_op << " cycles (~" 
-              << ns_per_op << "ns @3GHz)" << std::endl;
+              << ns_per_op << "ns @" << calibrator.get_ticks_per_ns() << " ticks/ns)" << std::endl;
     
     // Target: <50 cycles per push+pop
     if (cycles_per_op < 100) {
@@ -331,6 +2230,499 @@ void benchmark_fixed_point() {
     (void)sink;
 }
 
+// ============================================================================
+// ADE Tests
+// ============================================================================
+
+void test_order_book() {
+    std::cout << "  Testing L2 order book..." << std::endl;
+    
+    using Book = ade::L2Book<1024>;
+    auto cents = [](int64_t c) { return FixedPoint(c * (PRICE_SCALE / 100)); };
+    auto book = std::make_unique<Book>(cents(1));
+    assert(!book->synced() && book->empty(ade::BookSide::BID));
+    assert(book->best_ask().quantity.raw() == 0);
+    
+    // Snapshot: best first per side
+    const ade::BookLevel bids[] = {{cents(10000), FixedPoint::from_int(2)},
+                                   {cents(9999), FixedPoint::from_int(1)},
+                                   {cents(9995), FixedPoint::from_int(3)}};
+    const ade::BookLevel asks[] = {{cents(10002), FixedPoint::from_int(1)},
+                                   {cents(10005), FixedPoint::from_int(4)}};
+    book->apply_snapshot(bids, 3, asks, 2);
+    assert(book->synced());
+    assert(book->depth(ade::BookSide::BID) == 3 && book->depth(ade::BookSide::ASK) == 2);
+    assert(book->best_bid().price == cents(10000) && book->best_bid().quantity == FixedPoint::from_int(2));
+    assert(book->best_ask().price == cents(10002));
+    
+    ade::BookLevel top[5];
+    assert(book->top(ade::BookSide::BID, top, 5) == 3);
+    assert(top[0].price == cents(10000) && top[1].price == cents(9999) && top[2].price == cents(9995));
+    assert(book->top(ade::BookSide::ASK, top, 1) == 1 && top[0].price == cents(10002));
+    
+    // Spread 0.02, mid 100.01, microprice leans to the thinner ask, 6 vs 5 on depth
+    const ade::BookFeatures f = book->features();
+    assert(f.spread == cents(2) && f.mid == cents(10001));
+    assert(f.microprice.raw() == 10001333333LL);
+    assert(f.imbalance.raw() == PRICE_SCALE / 11);
+    
+    // Removing the best rescans to the next level; better prices take over
+    assert(book->update(ade::BookSide::BID, cents(10000), FixedPoint(0)));
+    assert(book->best_bid().price == cents(9999) && book->depth(ade::BookSide::BID) == 2);
+    assert(book->update(ade::BookSide::ASK, cents(10001), FixedPoint::from_int(5)));
+    assert(book->best_ask().price == cents(10001));
+    assert(book->update(ade::BookSide::ASK, cents(10001), FixedPoint::from_int(7)));   // Resize
+    assert(book->best_ask().quantity == FixedPoint::from_int(7) && book->depth(ade::BookSide::ASK) == 3);
+    assert(book->update(ade::BookSide::BID, cents(9999), FixedPoint(0)));
+    assert(book->update(ade::BookSide::BID, cents(9995), FixedPoint(0)));
+    assert(book->empty(ade::BookSide::BID) && book->features().spread.raw() == 0);
+    assert(book->update(ade::BookSide::BID, cents(9990), FixedPoint(0)));   // Not held
+    
+    // Off the tick grid, or too far from the market
+    assert(!book->update(ade::BookSide::BID, FixedPoint(cents(10000).raw() + 1), FixedPoint::from_int(1)));
+    assert(!book->update(ade::BookSide::ASK, cents(20000), FixedPoint::from_int(1)));
+    assert(book->dropped() == 2);
+    
+    // The window follows the market: deep levels left behind are evicted
+    book->begin_snapshot();
+    assert(book->synced() && book->empty(ade::BookSide::ASK));
+    book->update(ade::BookSide::BID, cents(10000), FixedPoint::from_int(1));   // Window 94.88..105.11
+    book->update(ade::BookSide::BID, cents(9500), FixedPoint::from_int(1));
+    book->update(ade::BookSide::ASK, cents(10002), FixedPoint::from_int(1));
+    book->update(ade::BookSide::BID, cents(10400), FixedPoint::from_int(1));
+    book->update(ade::BookSide::ASK, cents(10402), FixedPoint::from_int(1));
+    book->update(ade::BookSide::BID, cents(10000), FixedPoint(0));
+    book->update(ade::BookSide::ASK, cents(10002), FixedPoint(0));
+    assert(book->update(ade::BookSide::ASK, cents(10600), FixedPoint::from_int(2)));
+    assert(book->evicted() == 1 && book->depth(ade::BookSide::BID) == 1);
+    assert(book->best_bid().price == cents(10400) && book->best_ask().price == cents(10402));
+    assert(book->top(ade::BookSide::ASK, top, 5) == 2 && top[1].price == cents(10600));
+    
+    // A lost delta: unusable until the next snapshot, which may be anywhere
+    book->invalidate();
+    assert(!book->synced());
+    book->begin_snapshot();
+    assert(book->update(ade::BookSide::ASK, cents(50000), FixedPoint::from_int(1)));
+    assert(book->update(ade::BookSide::BID, cents(49990), FixedPoint::from_int(1)));
+    assert(book->best_bid().price == cents(49990) && book->best_ask().price == cents(50000));
+    assert(book->features().spread == cents(10));
+    
+    std::cout << "  L2 order book: PASSED" << std::endl;
+}
+
+void test_consolidated_bbo() {
+    std::cout << "  Testing consolidated BBO..." << std::endl;
+    
+    using ade::BookSide;
+    auto cents = [](int64_t c) { return FixedPoint(c * (PRICE_SCALE / 100)); };
+    const FixedPoint one = FixedPoint::from_int(1);
+    const FixedPoint two = FixedPoint::from_int(2);
+    auto bbo = std::make_unique<ade::ConsolidatedBBO>();
+    assert(bbo->best(BookSide::BID).price.raw() == 0 && bbo->venues(BookSide::ASK) == 0);
+    assert(!bbo->crossed());
+    
+    // First quotes move the top; a worse venue does not
+    assert(bbo->update(1, BookSide::BID, cents(10000), one));
+    assert(bbo->update(1, BookSide::ASK, cents(10002), one));
+    assert(!bbo->update(2, BookSide::BID, cents(9999), two));
+    assert(!bbo->update(2, BookSide::ASK, cents(10003), two));
+    assert(bbo->best(BookSide::BID).price == cents(10000) && bbo->venue(BookSide::BID) == 1);
+    assert(bbo->venue_quote(2, BookSide::BID).price == cents(9999));
+    
+    // A better venue takes the side; matching it sums size, lowest id leads
+    assert(bbo->update(7, BookSide::ASK, cents(10001), two));
+    assert(bbo->venue(BookSide::ASK) == 7 && bbo->best(BookSide::ASK).price == cents(10001));
+    assert(bbo->update(2, BookSide::ASK, cents(10001), one));   // Venue 2 now leads the tie
+    assert(bbo->venue(BookSide::ASK) == 2 && bbo->venues(BookSide::ASK) == ((1u << 2) | (1u << 7)));
+    assert(bbo->best(BookSide::ASK).quantity == FixedPoint::from_int(3));
+    
+    // Size-only changes at the best are tracked, not reported
+    assert(!bbo->update(7, BookSide::ASK, cents(10001), FixedPoint::from_int(5)));
+    assert(bbo->best(BookSide::ASK).quantity == FixedPoint::from_int(6));
+    
+    // Withdrawals fall back to the next venue
+    assert(bbo->update(2, BookSide::ASK, cents(10001), FixedPoint(0)));
+    assert(bbo->venue(BookSide::ASK) == 7 && bbo->best(BookSide::ASK).quantity == FixedPoint::from_int(5));
+    assert(bbo->withdraw(7));
+    assert(bbo->best(BookSide::ASK).price == cents(10002) && bbo->venue(BookSide::ASK) == 1);
+    assert(!bbo->update(8, BookSide::BID, cents(20000), one));   // No such lane
+    
+    // A venue bidding through another's offer: crossed
+    assert(bbo->update(3, BookSide::BID, cents(10005), one));
+    assert(bbo->crossed());
+    const ConsolidatedQuote quote = bbo->quote(42);
+    assert(quote.symbol_id == 42 && quote.bid_venue == 3 && quote.ask_venue == 1);
+    assert(quote.bid_price == cents(10005) && quote.ask_price == cents(10002));
+    assert(quote.bid_venues == (1u << 3));
+    
+    // Everyone gone: empty sides
+    bbo->withdraw(1);
+    bbo->withdraw(2);
+    assert(bbo->withdraw(3));
+    assert(bbo->venues(BookSide::BID) == 0 && bbo->best(BookSide::ASK).quantity.raw() == 0);
+    assert(!bbo->crossed());
+    
+    std::cout << "  Consolidated BBO: PASSED" << std::endl;
+}
+
+void test_capture_writer() {
+    std::cout << "  Testing capture writer..." << std::endl;
+    
+    namespace fs = std::filesystem;
+    const fs::path dir = "test_capture";
+    fs::remove_all(dir);
+    
+    // Three chunks of 4 records per file: 30 records rotate through 3 files
+    rec::CaptureConfig config;
+    config.directory = dir.string();
+    config.prefix = "test";
+    config.chunk_records = 4;
+    config.file_size = rec::CAPTURE_HEADER_SIZE + 3 * rec::chunk_bytes(4) + 100;   // Partial chunk unused
+    assert(rec::file_capacity(config.file_size, config.chunk_records) == 12);
+    
+    std::vector<SageMessage> messages;
+    for (uint64_t i = 0; i < 30; ++i) {
+        MarketData data{};
+        data.price = FixedPoint(static_cast<int64_t>(i) * PRICE_SCALE);
+        data.quantity = FixedPoint(PRICE_SCALE);
+        data.symbol_id = static_cast<uint32_t>(1 + i % 3);
+        data.exchange_id = static_cast<uint8_t>(ExchangeId::BINANCE);
+        messages.push_back(SageMessage::create_market_data(1000 + i, i, data));
+    }
+    
+    timing::TSCCalibrator tsc;
+    {
+        rec::CaptureWriter writer;
+        assert(writer.open(config, SYMBOLS, std::size(SYMBOLS), tsc.calibration()));
+        for (size_t i = 0; i < messages.size(); i += 7) {
+            const size_t n = std::min<size_t>(7, messages.size() - i);
+            assert(writer.append(messages.data() + i, n) == n);
+        }
+        assert(writer.records() == 30 && writer.files() == 3);
+        writer.close();
+        assert(!writer.is_open() && writer.last_error().empty());
+    }
+    
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());   // Names end in the file index
+    assert(files.size() == 3);
+    
+    uint64_t next = 0;
+    for (size_t f = 0; f < files.size(); ++f) {
+        std::ifstream in(files[f], std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const auto& header = *reinterpret_cast<const rec::CaptureFileHeader*>(bytes.data());
+        assert(rec::validate_header(header, bytes.size()) == nullptr);
+        assert(header.file_index == f && header.closed == 1 && header.chunk_records == 4);
+        assert(header.symbol_count == std::size(SYMBOLS));
+        assert(std::strcmp(header.symbols[1].name, "BTC-USD") == 0 && header.symbols[1].symbol_id == 1);
+        assert(header.tsc.ticks_per_ns_fp16 == tsc.calibration().ticks_per_ns_fp16);
+        
+        // Truncated after the last record: 12, 12, then 6 (one full chunk + 2)
+        const uint64_t count = header.record_count;
+        assert(count == (f < 2 ? 12u : 6u));
+        assert(bytes.size() == rec::record_offset(count - 1, 4) + rec::CAPTURE_RECORD_SIZE);
+        assert(header.first_ts_ns == 1000 + next && header.last_ts_ns == 1000 + next + count - 1);
+        
+        for (uint64_t chunk = 0; chunk * 4 < count; ++chunk) {
+            const auto& index = *reinterpret_cast<const rec::CaptureIndexBlock*>(
+                bytes.data() + rec::index_offset(chunk, 4));
+            assert(index.magic == MAGIC_CAPTURE_INDEX && index.chunk == chunk);
+            assert(index.first_record == chunk * 4);
+            assert(index.record_count == std::min<uint64_t>(4, count - chunk * 4));
+            assert(index.first_sequence == next + chunk * 4);
+            assert(index.last_sequence == index.first_sequence + index.record_count - 1);
+            assert(index.has_symbol(static_cast<uint32_t>(1 + index.first_sequence % 3)) && !index.has_symbol(4));
+        }
+        for (uint64_t r = 0; r < count; ++r, ++next) {
+            assert(std::memcmp(bytes.data() + rec::record_offset(r, 4), &messages[next],
+                               sizeof(SageMessage)) == 0);
+        }
+        
+        // A different build's view of the file is refused
+        rec::CaptureFileHeader other = header;
+        other.record_size = 32;
+        assert(rec::validate_header(other, bytes.size()) != nullptr);
+        assert(rec::validate_header(header, bytes.size() - 1) != nullptr);   // Torn tail
+    }
+    assert(next == 30);
+    fs::remove_all(dir);
+    
+    // [rec] settings: a file must hold at least one chunk
+    config::ConfigFile file;
+    rec::CaptureConfig parsed;
+    std::string error;
+    assert(file.parse("[rec]\ndirectory = \"/data/capture\"\nfile_size_mb = 64\nchunk_records = 8192\n"));
+    assert(rec::read_capture_config(file, parsed, error));
+    assert(parsed.directory == "/data/capture" && parsed.file_size == 64ULL << 20 && parsed.chunk_records == 8192);
+    assert(file.parse("[rec]\nfile_size_mb = 1\nchunk_records = 1000000\n"));
+    assert(!rec::read_capture_config(file, parsed, error) && !error.empty());
+    
+    std::cout << "  Capture writer: PASSED" << std::endl;
+}
+
+void test_capture_reader() {
+    std::cout << "  Testing capture reader..." << std::endl;
+    
+    namespace fs = std::filesystem;
+    const fs::path dir = "test_capture_reader";
+    fs::remove_all(dir);
+    
+    rec::CaptureConfig config;
+    config.directory = dir.string();
+    config.prefix = "test";
+    config.chunk_records = 8;
+    config.file_size = rec::CAPTURE_HEADER_SIZE + 4 * rec::chunk_bytes(8);
+    
+    std::vector<SageMessage> messages;
+    for (uint64_t i = 0; i < 20; ++i) {
+        MarketData data{};
+        data.price = FixedPoint(static_cast<int64_t>(100 + i) * PRICE_SCALE);
+        data.symbol_id = i < 8 ? 1 : 2;
+        messages.push_back(SageMessage::create_market_data(1000 + 10 * i, i, data));
+    }
+    
+    timing::TSCCalibrator tsc;
+    rec::CaptureWriter writer;
+    assert(writer.open(config, SYMBOLS, std::size(SYMBOLS), tsc.calibration()));
+    assert(writer.append(messages.data(), 12) == 12);
+    
+    // Live file: the reader sees what the writer committed so far
+    rec::CaptureReader reader;
+    assert(reader.open(writer.path()));
+    assert(reader.records() == 12 && reader.chunks() == 2 && reader.header().closed == 0);
+    assert(writer.append(messages.data() + 12, 8) == 8);
+    assert(reader.records() == 20 && reader.chunks() == 3);
+    
+    // Spans: one chunk at a time, contiguous, in recorded order
+    const SageMessage* run;
+    uint64_t next = 0;
+    size_t runs = 0;
+    while (const size_t count = reader.span(next, run)) {
+        assert(count == (next < 16 ? 8u : 4u));
+        assert(std::memcmp(run, &messages[next], count * sizeof(SageMessage)) == 0);
+        next += count;
+        ++runs;
+    }
+    assert(next == 20 && runs == 3);
+    assert(reader.span(5, run) == 3 && run->sequence_id == 5);   // Rest of chunk 0
+    
+    // Seeking by time and the per-chunk symbol index
+    assert(reader.seek(0) == 0);
+    assert(reader.seek(1095) == 10 && reader.record(reader.seek(1095)).timestamp_ns == 1100);
+    assert(reader.seek(1190) == 19);
+    assert(reader.seek(5000) == 20);
+    assert(reader.index(0).has_symbol(1) && !reader.index(0).has_symbol(2));
+    assert(reader.index(1).has_symbol(2) && reader.index(2).first_record == 16);
+    
+    // Closed and truncated: same records, now from the shorter file
+    writer.close();
+    assert(reader.open(writer.path()));
+    assert(reader.header().closed == 1 && reader.records() == 20);
+    assert(reader.record(19).sequence_id == 19);
+    
+    // Not a capture file
+    { std::ofstream junk(dir / "junk.cap"); junk << "not a capture"; }
+    assert(!reader.open((dir / "junk.cap").string()) && !reader.last_error().empty());
+    assert(!reader.open((dir / "missing.cap").string()));
+    
+    reader.close();
+    fs::remove_all(dir);
+    std::cout << "  Capture reader: PASSED" << std::endl;
+}
+
+void test_bitpack() {
+    std::cout << "  Testing bit packing..." << std::endl;
+    
+    assert(rec::zigzag_encode(0) == 0 && rec::zigzag_encode(-1) == 1 && rec::zigzag_encode(1) == 2);
+    assert(rec::zigzag_decode(rec::zigzag_encode(INT64_MIN)) == INT64_MIN);
+    assert(rec::zigzag_decode(rec::zigzag_encode(INT64_MAX)) == INT64_MAX);
+    assert(rec::bit_width(0) == 0 && rec::bit_width(1) == 1 && rec::bit_width(UINT64_MAX) == 64);
+    
+    // Every width, raw and delta (unit and tick-size scale), native (AVX2)
+    // and scalar kernels
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    const size_t miniblocks = 2;
+    std::vector<uint64_t> values(miniblocks * rec::MINIBLOCK_VALUES);
+    std::vector<int64_t> expected(values.size());
+    std::vector<int64_t> native(values.size());
+    std::vector<int64_t> scalar(values.size());
+    for (unsigned width = 0; width <= 64; ++width) {
+        std::vector<uint64_t> packed(rec::packed_words(values.size(), width));
+        assert(packed.size() == miniblocks * rec::BITPACK_LANES * width);
+        for (uint64_t& v : values) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            v = width == 0 ? 0 : width == 64 ? state : state >> (64 - width);
+        }
+        for (size_t m = 0; m < miniblocks; ++m) {
+            rec::pack_miniblock(values.data() + m * rec::MINIBLOCK_VALUES, width,
+                                packed.data() + m * rec::BITPACK_LANES * width);
+        }
+        for (const uint32_t scale : {0u, 1u, 1000000u}) {
+            const bool delta = scale > 0;
+            uint64_t sum = 12345;
+            for (size_t i = 0; i < values.size(); ++i) {
+                expected[i] = static_cast<int64_t>(
+                    delta ? sum += static_cast<uint64_t>(rec::zigzag_decode(values[i])) * scale : values[i]);
+            }
+            rec::unpack(packed.data(), width, miniblocks, delta, 12345, scale, native.data());
+            rec::unpack(packed.data(), width, miniblocks, delta, 12345, scale, scalar.data(),
+                        rec::UnpackPath::SCALAR);
+            assert(native == expected && scalar == expected);
+        }
+    }
+    
+    std::cout << "  Bit packing: PASSED" << std::endl;
+}
+
+void test_tick_archive() {
+    std::cout << "  Testing tick archive..." << std::endl;
+    
+    namespace fs = std::filesystem;
+    const fs::path dir = "test_archive";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path = (dir / "test.sarc").string();
+    
+    // Symbol 1: 5000 ticks (a full block and a partial one), symbol 2: 300,
+    // symbol 3: one; interleaved, plus a heartbeat that is not archived
+    std::vector<SageMessage> messages;
+    uint64_t ts = 1'700'000'000ULL * NANOS_PER_SEC;
+    for (uint64_t i = 0; i < 5301; ++i) {
+        const uint32_t symbol_id = i == 2000 ? 3 : (i % 17 == 0 && i < 17 * 300 ? 2 : 1);
+        MarketData data{};
+        data.price = FixedPoint((42150 + static_cast<int64_t>(i % 7) - 3) * (PRICE_SCALE / 100));
+        data.quantity = FixedPoint(static_cast<int64_t>(i % 13) * (PRICE_SCALE / 1000));
+        data.symbol_id = symbol_id;
+        data.flags = (i & 1) ? MD_FLAG_BID : MD_FLAG_ASK | MD_FLAG_TRADE;
+        data.exchange_id = static_cast<uint8_t>(ExchangeId::BINANCE);
+        data.venue_seq = i == 4000 ? UINT64_MAX : 900000 + i;       // One wild jump
+        data.exchange_ts_ns = i == 2000 ? 0 : ts - 250000 - (i % 11) * 1000;
+        ts += 1000 + (i % 3) * 500 - (i == 3000 ? 5000 : 0);         // One step back in time
+        SageMessage msg = SageMessage::create_market_data(ts, 10 + i, data);
+        msg.rx_clock = timing::RxClock::SOFTWARE;
+        msg.parse_ns = static_cast<uint16_t>(150 + i % 40);
+        msg.rx_delta_ns = static_cast<uint32_t>(i * 7 % 3000);
+        messages.push_back(msg);
+    }
+    
+    rec::CaptureSymbol symbols[2] = {};
+    symbols[0].symbol_id = 1;
+    std::strncpy(symbols[0].name, "BTCUSDT", sizeof(symbols[0].name) - 1);
+    symbols[1].symbol_id = 2;
+    
+    rec::ArchiveWriter writer;
+    rec::ArchiveReader reader;
+    assert(writer.open(path, symbols, 2));
+    for (size_t i = 0; i < messages.size(); ++i) {
+        assert(writer.append(messages[i]));
+        if (i == 100) {
+            assert(writer.append(SageMessage::create_heartbeat(ts, 0, 1)));
+        }
+    }
+    
+    // Unfinished: no index yet
+    assert(!reader.open(path));
+    assert(reader.last_error().find("incomplete") != std::string::npos);
+    
+    assert(writer.close());
+    assert(writer.ticks() == 5301 && writer.skipped() == 1 && writer.blocks() == 4);
+    assert(writer.bytes() == fs::file_size(path));
+    assert(writer.bytes() * 3 < 5301 * sizeof(SageMessage));         // Even with the 64-bit jump
+    
+    assert(reader.open(path));
+    const rec::ArchiveFileHeader& header = reader.header();
+    assert(header.tick_count == 5301 && header.block_count == 4 && header.symbol_count == 2);
+    assert(std::strcmp(header.symbols[0].name, "BTCUSDT") == 0);
+    
+    // Index: by symbol, then time
+    assert(reader.blocks() == 4);
+    assert(reader.entry(0).symbol_id == 1 && reader.entry(0).ticks == 4096);
+    assert(reader.entry(1).symbol_id == 1 && reader.entry(1).ticks == 5000 - 4096);
+    assert(reader.entry(2).symbol_id == 2 && reader.entry(2).ticks == 300);
+    assert(reader.entry(3).symbol_id == 3 && reader.entry(3).ticks == 1);
+    assert(reader.entry(0).last_ts_ns < reader.entry(1).last_ts_ns);
+    
+    // Every tick decodes to its original bytes, in recorded order per symbol
+    auto block = std::make_unique<rec::ArchiveBlock>();
+    for (const rec::UnpackPath unpack_path : {rec::UnpackPath::NATIVE, rec::UnpackPath::SCALAR}) {
+        for (uint32_t symbol_id = 1; symbol_id <= 3; ++symbol_id) {
+            auto original = messages.begin();
+            for (size_t i = reader.find(symbol_id); i < reader.blocks() && reader.entry(i).symbol_id == symbol_id; ++i) {
+                assert(reader.decode(i, *block, unpack_path) == reader.entry(i).ticks);
+                assert(block->symbol_id == symbol_id);
+                for (size_t tick = 0; tick < block->count; ++tick) {
+                    original = std::find_if(original, messages.end(), [&](const SageMessage& m) {
+                        return m.payload.market_data.symbol_id == symbol_id;
+                    });
+                    const SageMessage decoded = block->message(tick);
+                    assert(std::memcmp(&decoded, &*original++, sizeof(SageMessage)) == 0);
+                }
+            }
+            assert(std::none_of(original, messages.end(), [&](const SageMessage& m) {
+                return m.payload.market_data.symbol_id == symbol_id;
+            }));
+        }
+    }
+    assert(block->symbol_id == 3 && block->count == 1);
+    assert(block->price(0) == messages[2000].payload.market_data.price && block->timestamp_ns(0) == messages[2000].timestamp_ns);
+    
+    // Seeking by time within a symbol
+    const uint64_t late_ts = messages[4900].timestamp_ns;
+    assert(reader.find(1) == 0);
+    assert(reader.find(1, late_ts) == 1);
+    assert(reader.find(1, UINT64_MAX) == 2);                          // Past symbol 1: symbol 2's block
+    assert(reader.find(3, 0) == 3 && reader.find(9, 0) == 4);
+    
+    // Not an archive
+    { std::ofstream junk(dir / "junk.sarc"); junk << "not an archive"; }
+    assert(!reader.open((dir / "junk.sarc").string()));
+    
+    reader.close();
+    fs::remove_all(dir);
+    std::cout << "  Tick archive: PASSED" << std::endl;
+}
+
+// ============================================================================
+// Replay Tests
+// ============================================================================
+
+void test_replay_pacer() {
+    std::cout << "  Testing replay pacer..." << std::endl;
+    
+    timing::TSCCalibrator tsc;
+    
+    // ASAP: never waits
+    replay::ReplayPacer asap(tsc, 0.0);
+    assert(asap.mode() == replay::PaceMode::ASAP);
+    uint64_t start = timing::rdtsc();
+    asap.wait(0);
+    asap.wait(NANOS_PER_SEC);
+    assert(tsc.tsc_to_ns(timing::rdtsc() - start) < NANOS_PER_MS);
+    
+    // 10x: 30ms recorded in ~3ms, spacing kept against the first message
+    replay::ReplayPacer fast(tsc, 10.0);
+    const uint64_t base = 1'700'000'000ULL * NANOS_PER_SEC;
+    start = timing::rdtsc();
+    fast.wait(base);
+    fast.wait(base + 10 * NANOS_PER_MS);
+    const uint64_t first_ns = tsc.tsc_to_ns(timing::rdtsc() - start);
+    fast.wait(base + 30 * NANOS_PER_MS);
+    const uint64_t total_ns = tsc.tsc_to_ns(timing::rdtsc() - start);
+    assert(first_ns >= NANOS_PER_MS && total_ns >= 3 * NANOS_PER_MS);
+    assert(total_ns < 30 * NANOS_PER_MS);
+    
+    // Out of order (earlier than the anchor): released at once, counted late
+    start = timing::rdtsc();
+    fast.wait(base - NANOS_PER_SEC);
+    assert(tsc.tsc_to_ns(timing::rdtsc() - start) < NANOS_PER_MS && fast.late() == 1);
+    
+    std::cout << "  Replay pacer: PASSED" << std::endl;
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -352,6 +2744,43 @@ int main() {
     test_ring_buffer_full();
     test_ring_buffer_wrap();
     test_ring_buffer_batch();
+    test_ring_buffer_zero_copy();
+    test_shm_ring_buffer();
+    test_broadcast_ring();
+    test_mpsc_queue();
+    test_byte_ring();
+    test_wait_strategies();
+    test_conflating_queue();
+    test_seqlock_cell();
+    test_memory_provisioning();
+    
+    std::cout << "\n[CAL Tests]" << std::endl;
+    test_decimal_parsing();
+    test_symbol_interner();
+    test_json_parser();
+    test_price_band();
+    test_feed_recovery();
+    test_feed_arbiter();
+    test_feed_latency();
+    test_websocket_protocol();
+    test_websocket_client();
+    test_network_thread();
+    test_rx_timestamps();
+    test_config_file();
+    test_connector_manager();
+    
+    std::cout << "\n[ADE Tests]" << std::endl;
+    test_order_book();
+    test_consolidated_bbo();
+    
+    std::cout << "\n[REC Tests]" << std::endl;
+    test_capture_writer();
+    test_capture_reader();
+    test_bitpack();
+    test_tick_archive();
+    
+    std::cout << "\n[Replay Tests]" << std::endl;
+    test_replay_pacer();
     
     std::cout << "\n[Timing Tests]" << std::endl;
     test_timing();
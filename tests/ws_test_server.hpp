@@ -0,0 +1,209 @@
+#pragma once
+
+/**
+ * Local stand-in WebSocket server for tests
+ *
+ * Listens on 127.0.0.1 (ephemeral port), accepts one client, performs the
+ * server side of the opening handshake and then runs a test-supplied
+ * script with blocking frame helpers. Not for production use: blocking
+ * sockets, one client, 5s receive timeout so a broken client fails the
+ * test instead of hanging it.
+ *
+ * Usage:
+ *   WsTestServer server;
+ *   server.start([](WsTestServer& s) {
+ *       s.send_text("{\"e\":\"trade\"}");
+ *       s.send_close(1000);
+ *   });
+ *   ... connect a client to server.url("/ws") ...
+ *   server.join();
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "../src/cal/websocket_protocol.hpp"
+
+namespace sage {
+namespace test {
+
+class WsTestServer {
+public:
+    using Script = std::function<void(WsTestServer&)>;
+
+    WsTestServer() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 1);
+
+        socklen_t length = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+    }
+
+    ~WsTestServer() {
+        join();
+        if (client_fd_ >= 0) ::close(client_fd_);
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+    }
+
+    uint16_t port() const noexcept { return port_; }
+
+    std::string url(const std::string& path = "/") const {
+        return "ws://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    /**
+     * Accept one client on a background thread, handshake, run script
+     */
+    void start(Script script) {
+        thread_ = std::thread([this, script = std::move(script)] {
+            client_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+            if (client_fd_ < 0) return;
+            const int one = 1;
+            setsockopt(client_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            timeval timeout{5, 0};
+            setsockopt(client_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+            handshake_ok_ = handshake();
+            if (handshake_ok_) {
+                script(*this);
+            }
+            ::shutdown(client_fd_, SHUT_WR);
+        });
+    }
+
+    void join() {
+        if (thread_.joinable()) thread_.join();
+    }
+
+    bool handshake_ok() const noexcept { return handshake_ok_; }
+    const std::string& request() const noexcept { return request_; }
+
+    // ========================================================================
+    // Script Helpers (server frames are unmasked)
+    // ========================================================================
+
+    void send_frame(cal::ws::Opcode opcode, const std::string& payload, bool fin = true) {
+        uint8_t header[cal::ws::MAX_FRAME_HEADER];
+        const size_t length = cal::ws::encode_frame_header(header, opcode, fin, payload.size(),
+                                                           false, 0);
+        std::string frame(reinterpret_cast<const char*>(header), length);
+        frame += payload;
+        send_raw(frame);
+    }
+
+    void send_text(const std::string& payload) {
+        send_frame(cal::ws::Opcode::TEXT, payload);
+    }
+
+    void send_close(uint16_t code) {
+        const char payload[2] = {static_cast<char>(code >> 8), static_cast<char>(code)};
+        send_frame(cal::ws::Opcode::CLOSE, std::string(payload, 2));
+    }
+
+    /**
+     * Write bytes as-is (for split or coalesced frames)
+     */
+    void send_raw(const std::string& bytes) {
+        size_t sent = 0;
+        while (sent < bytes.size()) {
+            const ssize_t n = ::send(client_fd_, bytes.data() + sent, bytes.size() - sent,
+                                     MSG_NOSIGNAL);
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    /**
+     * Read one client frame (must be masked), unmasking its payload
+     * @return false on timeout, disconnect or an unmasked frame
+     */
+    bool read_frame(cal::ws::Opcode& opcode, std::string& payload) {
+        uint8_t header[cal::ws::MAX_FRAME_HEADER];
+        if (!read_exact(header, 2)) return false;
+
+        size_t length = 2;
+        const uint8_t len7 = header[1] & 0x7F;
+        length += (len7 == 126) ? 2 : (len7 == 127) ? 8 : 0;
+        length += (header[1] & 0x80) ? 4 : 0;
+        if (!read_exact(header + 2, length - 2)) return false;
+
+        cal::ws::FrameHeader frame;
+        if (cal::ws::parse_frame_header(header, length, frame) != cal::ws::FrameStatus::COMPLETE ||
+            !frame.masked) {
+            return false;
+        }
+
+        payload.resize(frame.payload_length);
+        if (!read_exact(reinterpret_cast<uint8_t*>(payload.data()), payload.size())) return false;
+        cal::ws::apply_mask(reinterpret_cast<uint8_t*>(payload.data()), payload.size(),
+                            frame.mask_key);
+        opcode = frame.opcode;
+        return true;
+    }
+
+private:
+    bool read_exact(uint8_t* out, size_t length) {
+        size_t got = 0;
+        while (got < length) {
+            const ssize_t n = ::recv(client_fd_, out + got, length - got, 0);
+            if (n <= 0) return false;
+            got += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool handshake() {
+        char buffer[4096];
+        size_t used = 0;
+        while (request_.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t n = ::recv(client_fd_, buffer, sizeof(buffer), 0);
+            if (n <= 0) return false;
+            used += static_cast<size_t>(n);
+            request_.append(buffer, static_cast<size_t>(n));
+            if (used > 8192) return false;
+        }
+
+        const std::string field = "Sec-WebSocket-Key: ";
+        const size_t at = request_.find(field);
+        if (at == std::string::npos) return false;
+        const size_t end = request_.find("\r\n", at);
+        const std::string key = request_.substr(at + field.size(), end - at - field.size());
+
+        char accept[cal::ws::ACCEPT_KEY_LENGTH + 1];
+        cal::ws::websocket_accept_key(key.data(), key.size(), accept);
+        send_raw(std::string("HTTP/1.1 101 Switching Protocols\r\n"
+                             "Upgrade: websocket\r\n"
+                             "Connection: Upgrade\r\n"
+                             "Sec-WebSocket-Accept: ") + accept + "\r\n\r\n");
+        return true;
+    }
+
+    int listen_fd_{-1};
+    int client_fd_{-1};
+    uint16_t port_{0};
+    bool handshake_ok_{false};
+    std::string request_;
+    std::thread thread_;
+};
+
+} // namespace test
+} // namespace sage